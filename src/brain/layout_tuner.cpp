@@ -19,6 +19,8 @@
 #include "catalog/schema.h"
 #include "common/logger.h"
 #include "common/timer.h"
+#include "gc/gc_manager_factory.h"
+#include "gc/tile_group_compactor.h"
 #include "storage/data_table.h"
 
 namespace peloton {
@@ -29,9 +31,7 @@ LayoutTuner& LayoutTuner::GetInstance() {
   return layout_tuner;
 }
 
-LayoutTuner::LayoutTuner() {
-  // Nothing to do here !
-}
+LayoutTuner::LayoutTuner() : reorganized_tile_group_count(0) {}
 
 LayoutTuner::~LayoutTuner() {}
 
@@ -150,6 +150,27 @@ void LayoutTuner::UpdateDefaultPartition(storage::DataTable* table) {
   table->SetDefaultLayout(layout);
 }
 
+void LayoutTuner::ReorganizeTable(storage::DataTable* table) {
+  // without gc, the old versions of the moved tuples are never reclaimed.
+  // the existing tile groups then keep their layout, as transforming them in
+  // place would lose the writes made in the meantime.
+  if (gc::GCManagerFactory::GetGCType() == GarbageCollectionType::OFF) {
+    return;
+  }
+
+  // the tuples of the picked tile groups are moved by regular updates into
+  // new tile groups, which are created with the default layout
+  auto &rounds = rounds_since_reorganization[table->GetOid()];
+  if (++rounds < reorganization_period) {
+    return;
+  }
+  rounds = 0;
+
+  auto& compactor = gc::TileGroupCompactor::GetInstance();
+  reorganized_tile_group_count += compactor.ReorganizeTable(
+      table, theta, reorganization_batch_size);
+}
+
 void LayoutTuner::Tune() {
   Timer<std::milli> timer;
   // Continue till signal is not false
@@ -157,11 +178,7 @@ void LayoutTuner::Tune() {
     // Go over all tables
     for (auto table : tables) {
       // Transform
-      auto tile_group_count = table->GetTileGroupCount();
-      auto tile_group_offset = rand() % tile_group_count;
-
-      LOG_TRACE("Transforming tile group at offset: %lu", tile_group_offset);
-      table->TransformTileGroup(tile_group_offset, theta);
+      ReorganizeTable(table);
 
       // Update partitioning periodically
       UpdateDefaultPartition(table);
@@ -195,6 +212,7 @@ void LayoutTuner::ClearTables() {
   {
     std::lock_guard<std::mutex> lock(layout_tuner_mutex);
     tables.clear();
+    rounds_since_reorganization.clear();
   }
 }
 
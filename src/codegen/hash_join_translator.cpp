@@ -317,6 +317,10 @@ std::string HashJoinTranslator::GetName() const {
       name.append("Semi");
       break;
     }
+    case JoinType::ANTI: {
+      name.append("Anti");
+      break;
+    }
     case JoinType::INVALID:
       throw Exception{"Invalid join type"};
   }
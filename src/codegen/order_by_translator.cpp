@@ -95,8 +95,14 @@ OrderByTranslator::OrderByTranslator(const planner::OrderByPlan &plan,
     sort_key_info_.push_back(sort_key_info);
   }
 
-  // Create the sorter
-  sorter_ = Sorter{codegen, tuple_desc};
+  // Create the sorter. With a limit over unordered input, only the first
+  // offset + limit tuples are kept while the child is consumed.
+  uint64_t top_k = codegen::utils::Sorter::kNoLimit;
+  if (plan_.GetLimit() && !plan_.GetUnderlyingOrder()) {
+    top_k = plan_.GetLimitOffset() + plan_.GetLimitNumber();
+    LOG_DEBUG("Keeping the top %lu tuples in the sorter", top_k);
+  }
+  sorter_ = Sorter{codegen, tuple_desc, top_k};
 
   // Create the output selection vector
   output_vector_id_ = runtime_state.RegisterState(
@@ -109,7 +115,8 @@ OrderByTranslator::OrderByTranslator(const planner::OrderByPlan &plan,
 
 // Initialize the sorter instance
 void OrderByTranslator::InitializeState() {
-  sorter_.Init(GetCodeGen(), LoadStatePtr(sorter_id_), compare_func_);
+  sorter_.Init(GetCodeGen(), LoadStatePtr(sorter_id_), compare_func_,
+               GetCompilationContext().GetExecutorContextPtr());
 }
 
 //===----------------------------------------------------------------------===//
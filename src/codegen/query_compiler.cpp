@@ -16,6 +16,7 @@
 #include "planner/seq_scan_plan.h"
 #include "planner/aggregate_plan.h"
 #include "planner/hash_join_plan.h"
+#include "storage/data_table.h"
 
 namespace peloton {
 namespace codegen {
@@ -77,6 +78,12 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan,
   switch (plan.GetPlanNodeType()) {
     case PlanNodeType::SEQSCAN: {
       auto &scan_plan = static_cast<const planner::SeqScanPlan &>(plan);
+      // Compiled scans read tuples in place and do not see pending deltas
+      auto *table = scan_plan.GetTable();
+      if (table != nullptr &&
+          table->GetVersionStorageType() == VersionStorageType::DELTA) {
+        return false;
+      }
       pred = scan_plan.GetPredicate();
       break;
     }
@@ -16,9 +16,11 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "planner/seq_scan_plan.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
 #include "storage/tile.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace codegen {
@@ -67,6 +69,19 @@ storage::TileGroup *RuntimeFunctions::GetTileGroup(storage::DataTable *table,
   return tile_group.get();
 }
 
+//===----------------------------------------------------------------------===//
+// Check whether some tuple of the tile group may satisfy the predicate of the
+// scan, using the min/max synopses of the tile group
+//===----------------------------------------------------------------------===//
+bool RuntimeFunctions::TileGroupMayMatch(storage::TileGroup *tile_group,
+                                         const planner::SeqScanPlan *scan_plan) {
+  const auto &predicates = scan_plan->GetZoneMapPredicates();
+  if (predicates.empty()) {
+    return true;
+  }
+  return tile_group->GetZoneMap()->MayMatch(predicates);
+}
+
 //===----------------------------------------------------------------------===//
 // For every column in the tile group, fill out the layout information for the
 // column in the provided 'infos' array.  Specifically, we need a pointer to
@@ -69,6 +69,31 @@ llvm::Function *RuntimeFunctionsProxy::_GetTileGroup::GetFunction(
   return codegen.RegisterFunction(kGetTileGroupFnName, fn_type);
 }
 
+//===----------------------------------------------------------------------===//
+// Get the LLVM function definition/wrapper to
+// RuntimeFunctions::TileGroupMayMatch(TileGroup*, SeqScanPlan*)
+//===----------------------------------------------------------------------===//
+llvm::Function *RuntimeFunctionsProxy::_TileGroupMayMatch::GetFunction(
+    CodeGen &codegen) {
+  static const std::string kTileGroupMayMatchFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen16RuntimeFunctions17TileGroupMayMatchEPNS_"
+      "7storage9TileGroupEPKNS_7planner11SeqScanPlanE";
+#else
+      "_ZN7peloton7codegen16RuntimeFunctions17TileGroupMayMatchEPNS_"
+      "7storage9TileGroupEPKNS_7planner11SeqScanPlanE";
+#endif
+  auto *may_match_func = codegen.LookupFunction(kTileGroupMayMatchFnName);
+  if (may_match_func != nullptr) {
+    return may_match_func;
+  }
+  // The scan plan is opaque to the compiled code
+  std::vector<llvm::Type *> fn_args = {
+      TileGroupProxy::GetType(codegen)->getPointerTo(), codegen.CharPtrType()};
+  auto *fn_type = llvm::FunctionType::get(codegen.BoolType(), fn_args, false);
+  return codegen.RegisterFunction(kTileGroupMayMatchFnName, fn_type);
+}
+
 //===----------------------------------------------------------------------===//
 //===----------------------------------------------------------------------===//
 llvm::Type *RuntimeFunctionsProxy::_ColumnLayoutInfo::GetType(
@@ -20,13 +20,14 @@
 namespace peloton {
 namespace codegen {
 
-Sorter::Sorter() {
+Sorter::Sorter() : top_k_(utils::Sorter::kNoLimit) {
   // This constructor shouldn't generally be used at all, but there are
   // cases when the tuple description is not known fully at construction time.
 }
 
 Sorter::Sorter(CodeGen &codegen,
-               const std::vector<type::Type::TypeId> &row_desc) {
+               const std::vector<type::Type::TypeId> &row_desc, uint64_t top_k)
+    : top_k_(top_k) {
   // Configure the storage format using the provided row description
   for (const auto &value_type : row_desc) {
     storage_format_.AddType(value_type);
@@ -37,10 +38,13 @@ Sorter::Sorter(CodeGen &codegen,
 
 // Just make a call to utils::Sorter::Init(...)
 void Sorter::Init(CodeGen &codegen, llvm::Value *sorter_ptr,
-                  llvm::Value *comparison_func) const {
+                  llvm::Value *comparison_func,
+                  llvm::Value *executor_context) const {
   auto *tuple_size = codegen.Const32(storage_format_.GetStorageSize());
-  codegen.CallFunc(SorterProxy::_Init::GetFunction(codegen),
-                   {sorter_ptr, comparison_func, tuple_size});
+  auto *top_k = codegen.Const64(top_k_);
+  codegen.CallFunc(
+      SorterProxy::_Init::GetFunction(codegen),
+      {sorter_ptr, comparison_func, tuple_size, top_k, executor_context});
 }
 
 // Append the given tuple into the sorter instance
@@ -55,6 +59,12 @@ void Sorter::Append(CodeGen &codegen, llvm::Value *sorter_ptr,
   for (uint32_t col_id = 0; col_id < tuple.size(); col_id++) {
     storage_format_.SetValueAt(codegen, space, col_id, tuple[col_id]);
   }
+
+  // With a bound, the tuple then enters the heap of kept tuples or is dropped
+  if (top_k_ != utils::Sorter::kNoLimit) {
+    codegen.CallFunc(SorterProxy::_KeepTopK::GetFunction(codegen),
+                     {sorter_ptr});
+  }
 }
 
 // Just make a call to utils::Sorter::Sort(...). This actually sorts the data
@@ -103,37 +113,52 @@ void Sorter::Iterate(CodeGen &codegen, llvm::Value *sorter_ptr,
   VectorizedIterate(codegen, sorter_ptr, Vector::kDefaultVectorSize, taat_cb);
 }
 
-// Iterate over the tuples in the sorter in batches/vectors of the given size
+// Iterate over the tuples in the sorter in batches/vectors of the given size.
+// If the sorter spilled, its buffer only holds one batch of the sorted tuples
+// at a time, so we iterate over the buffer until no batches are left.
 void Sorter::VectorizedIterate(
     CodeGen &codegen, llvm::Value *sorter_ptr, uint32_t vector_size,
     Sorter::VectorizedIterateCallback &callback) const {
-  llvm::Value *start_pos = GetStartPosition(codegen, sorter_ptr);
+  Loop batch_loop{codegen, codegen.ConstBool(true), {}};
+  {
+    llvm::Value *start_pos = GetStartPosition(codegen, sorter_ptr);
 
-  llvm::Value *num_tuples = GetNumberOfStoredTuples(codegen, sorter_ptr);
+    llvm::Value *num_tuples = GetNumberOfStoredTuples(codegen, sorter_ptr);
 
-  // Determine the number of bytes to skip per vector
-  llvm::Value *vec_sz = codegen.Const32(vector_size);
-  llvm::Value *tuple_size = GetTupleSize(codegen);
-  llvm::Value *skip = codegen->CreateMul(vec_sz, tuple_size);
+    // Determine the number of bytes to skip per vector
+    llvm::Value *vec_sz = codegen.Const32(vector_size);
+    llvm::Value *tuple_size = GetTupleSize(codegen);
+    llvm::Value *skip = codegen->CreateMul(vec_sz, tuple_size);
 
-  VectorizedLoop loop{codegen, num_tuples, vector_size, {{"pos", start_pos}}};
-  {
-    llvm::Value *curr_pos = loop.GetLoopVar(0);
-    auto curr_range = loop.GetCurrentRange();
+    VectorizedLoop loop{codegen, num_tuples, vector_size, {{"pos", start_pos}}};
+    {
+      llvm::Value *curr_pos = loop.GetLoopVar(0);
+      auto curr_range = loop.GetCurrentRange();
 
-    // Provide an accessor into the sorted space
-    SorterAccess sorter_access{*this, start_pos};
+      // Provide an accessor into the sorted space
+      SorterAccess sorter_access{*this, start_pos};
 
-    // Issue the callback
-    callback.ProcessEntries(codegen, curr_range.start, curr_range.end,
-                            sorter_access);
+      // Issue the callback
+      callback.ProcessEntries(codegen, curr_range.start, curr_range.end,
+                              sorter_access);
 
-    // Bump the pointer by the size of a tuple
-    llvm::Value *next_pos = codegen->CreateInBoundsGEP(curr_pos, skip);
-    loop.LoopEnd(codegen, {next_pos});
+      // Bump the pointer by the size of a tuple
+      llvm::Value *next_pos = codegen->CreateInBoundsGEP(curr_pos, skip);
+      loop.LoopEnd(codegen, {next_pos});
+    }
+
+    // Move on to the next batch of sorted tuples, if any
+    batch_loop.LoopEnd(NextBatch(codegen, sorter_ptr), {});
   }
 }
 
+// Just make a call to utils::Sorter::NextBatch(...)
+llvm::Value *Sorter::NextBatch(CodeGen &codegen,
+                               llvm::Value *sorter_ptr) const {
+  return codegen.CallFunc(SorterProxy::_NextBatch::GetFunction(codegen),
+                          {sorter_ptr});
+}
+
 // Just make a call to utils::Sorter::Destroy(...)
 void Sorter::Destroy(CodeGen &codegen, llvm::Value *sorter_ptr) const {
   codegen.CallFunc(SorterProxy::_Destroy::GetFunction(codegen), {sorter_ptr});
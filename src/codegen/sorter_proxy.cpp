@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "codegen/sorter_proxy.h"
+#include "codegen/executor_context_proxy.h"
 #include "codegen/utils/sorter.h"
 
 namespace peloton {
@@ -25,17 +26,16 @@ llvm::Type *SorterProxy::GetType(CodeGen &codegen) {
   }
 
   // Do a compile-time assertion to make sure what we build here and what
-  // the actual layout of the Sorter class is actually match
-  /*
+  // the actual layout of the Sorter class is actually match. The tuple size
+  // is padded to the alignment of the comparison function pointer.
   static const uint32_t sorter_size =
-      sizeof(char *) + sizeof(char *) + sizeof(char *) + sizeof(uint32_t) +
-      sizeof(utils::Sorter::ComparisonFunction) +
-      sizeof(storage::StorageManager *);
+      sizeof(char *) + sizeof(char *) + sizeof(char *) + sizeof(char *) +
+      sizeof(utils::Sorter::ComparisonFunction) + sizeof(uint64_t) +
+      sizeof(uint64_t) + sizeof(char *);
   static_assert(
       sorter_size == sizeof(utils::Sorter),
       "The LLVM memory layout of Sorter doesn't match the pre-compiled "
-      "version. Did you forget to update codegen/sorter_proxy.h?");
-  */
+      "version. Did you forget to update codegen/sorter_proxy.cpp?");
 
   // Ensure function pointers work
   static_assert(
@@ -48,7 +48,10 @@ llvm::Type *SorterProxy::GetType(CodeGen &codegen) {
       codegen.CharPtrType(),  // buffer position
       codegen.CharPtrType(),  // buffer end
       codegen.Int32Type(),    // tuple size
-      codegen.CharPtrType()   // comparison function pointer
+      codegen.CharPtrType(),  // comparison function pointer
+      codegen.Int64Type(),    // number of tuples kept
+      codegen.Int64Type(),    // memory budget
+      codegen.CharPtrType()   // spilled runs
   };
   sorter_type = llvm::StructType::create(codegen.GetContext(), sorter_fields,
                                          kSorterTypeName);
@@ -61,9 +64,11 @@ llvm::Type *SorterProxy::GetType(CodeGen &codegen) {
 const std::string &SorterProxy::_Init::GetFunctionName() {
   static const std::string kInitFnName =
 #ifdef __APPLE__
-      "_ZN7peloton7codegen5utils6Sorter4InitEPFiPKvS4_Ej";
+      "_ZN7peloton7codegen5utils6Sorter4InitEPFiPKvS4_EjmPNS_8executor"
+      "15ExecutorContextE";
 #else
-      "_ZN7peloton7codegen5utils6Sorter4InitEPFiPKvS4_Ej";
+      "_ZN7peloton7codegen5utils6Sorter4InitEPFiPKvS4_EjmPNS_8executor"
+      "15ExecutorContextE";
 #endif
   return kInitFnName;
 }
@@ -87,11 +92,14 @@ llvm::Function *SorterProxy::_Init::GetFunction(CodeGen &codegen) {
   // We need to create a function type whose signature matches
   // codegen::utils::Sorter::Init(...). It should match:
   //
-  // void Init(Sorter *, int(*)(void *, void *), uint32_t)
+  // void Init(Sorter *, int(*)(void *, void *), uint32_t, uint64_t,
+  //           ExecutorContext *)
 
   std::vector<llvm::Type *> fn_args = {
       SorterProxy::GetType(codegen)->getPointerTo(),
-      comparison_fn_type->getPointerTo(), codegen.Int32Type()};
+      comparison_fn_type->getPointerTo(), codegen.Int32Type(),
+      codegen.Int64Type(),
+      ExecutorContextProxy::GetType(codegen)->getPointerTo()};
   llvm::FunctionType *fn_type =
       llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
   return codegen.RegisterFunction(fn_name, fn_type);
@@ -129,6 +137,38 @@ llvm::Function *SorterProxy::_StoreInputTuple::GetFunction(CodeGen &codegen) {
   return codegen.RegisterFunction(fn_name, fn_type);
 }
 
+//===--------------------------------------------------------------------===//
+// The proxy for codegen::utils::Sorter::KeepTopK()
+//===--------------------------------------------------------------------===//
+const std::string &SorterProxy::_KeepTopK::GetFunctionName() {
+  static const std::string kKeepTopKFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen5utils6Sorter8KeepTopKEv";
+#else
+      "_ZN7peloton7codegen5utils6Sorter8KeepTopKEv";
+#endif
+  return kKeepTopKFnName;
+}
+
+llvm::Function *SorterProxy::_KeepTopK::GetFunction(CodeGen &codegen) {
+  const std::string &fn_name = GetFunctionName();
+
+  // Has the function already been registered?
+  llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+  if (llvm_fn != nullptr) {
+    return llvm_fn;
+  }
+
+  // The function hasn't been registered, let's do it now ...
+  // We need to create a function type whose signature matches
+  // codegen::utils::Sorter::KeepTopK(...)
+  std::vector<llvm::Type *> fn_args = {
+      SorterProxy::GetType(codegen)->getPointerTo()};
+  llvm::FunctionType *fn_type =
+      llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+  return codegen.RegisterFunction(fn_name, fn_type);
+}
+
 //===--------------------------------------------------------------------===//
 // The proxy for codegen::utils::Sorter::Sort()
 //===--------------------------------------------------------------------===//
@@ -161,6 +201,38 @@ llvm::Function *SorterProxy::_Sort::GetFunction(CodeGen &codegen) {
   return codegen.RegisterFunction(fn_name, fn_type);
 }
 
+//===--------------------------------------------------------------------===//
+// The proxy for codegen::utils::Sorter::NextBatch()
+//===--------------------------------------------------------------------===//
+const std::string &SorterProxy::_NextBatch::GetFunctionName() {
+  static const std::string kNextBatchFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen5utils6Sorter9NextBatchEv";
+#else
+      "_ZN7peloton7codegen5utils6Sorter9NextBatchEv";
+#endif
+  return kNextBatchFnName;
+}
+
+llvm::Function *SorterProxy::_NextBatch::GetFunction(CodeGen &codegen) {
+  const std::string &fn_name = GetFunctionName();
+
+  // Has the function already been registered?
+  llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+  if (llvm_fn != nullptr) {
+    return llvm_fn;
+  }
+
+  // The function hasn't been registered, let's do it now ...
+  // We need to create a function type whose signature matches
+  // codegen::utils::Sorter::NextBatch(...)
+  std::vector<llvm::Type *> fn_args = {
+      SorterProxy::GetType(codegen)->getPointerTo()};
+  llvm::FunctionType *fn_type =
+      llvm::FunctionType::get(codegen.BoolType(), fn_args, false);
+  return codegen.RegisterFunction(fn_name, fn_type);
+}
+
 //===--------------------------------------------------------------------===//
 // The proxy for codegen::utils::Sorter::Destroy()
 //===--------------------------------------------------------------------===//
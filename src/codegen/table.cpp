@@ -14,6 +14,7 @@
 
 #include "catalog/schema.h"
 #include "codegen/data_table_proxy.h"
+#include "codegen/if.h"
 #include "codegen/loop.h"
 #include "codegen/runtime_functions_proxy.h"
 #include "storage/data_table.h"
@@ -52,19 +53,21 @@ llvm::Value *Table::GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
 // scan consumer.
 void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
                          ScanConsumer &consumer) const {
-  DoGenerateScan(codegen, table_ptr, 1, consumer);
+  DoGenerateScan(codegen, table_ptr, 1, nullptr, consumer);
 }
 
 // Generate a vectorized scan
 void Table::GenerateVectorizedScan(CodeGen &codegen, llvm::Value *table_ptr,
                                    uint32_t vector_size,
-                                   ScanConsumer &consumer) const {
-  DoGenerateScan(codegen, table_ptr, vector_size, consumer);
+                                   ScanConsumer &consumer,
+                                   llvm::Value *scan_plan_ptr) const {
+  DoGenerateScan(codegen, table_ptr, vector_size, scan_plan_ptr, consumer);
 }
 
 // Generate a scan over all tile groups
 void Table::DoGenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
-                           uint32_t vector_size, ScanConsumer &consumer) const {
+                           uint32_t vector_size, llvm::Value *scan_plan_ptr,
+                           ScanConsumer &consumer) const {
   // First get the columns from the table the consumer needs. For every column,
   // we'll need to have a ColumnInfoLayout struct
   llvm::Value *column_layouts = codegen->CreateAlloca(
@@ -85,22 +88,23 @@ void Table::DoGenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
     llvm::Value *tile_group_ptr =
         GetTileGroup(codegen, table_ptr, tile_group_idx);
 
-    // Invoke the consumer to let her know that we're starting to iterate over
-    // the tile group now
-    consumer.TileGroupStart(codegen, tile_group_idx, tile_group_ptr);
-
-    // Generate the scan cover over the given tile group
-    if (vector_size > 1) {
-      tile_group_.GenerateVectorizedTidScan(codegen,
-          tile_group_ptr, column_layouts, vector_size, consumer);
+    if (scan_plan_ptr != nullptr) {
+      // Only scan the tile group if its zone map admits the predicate
+      auto *may_match_func =
+          RuntimeFunctionsProxy::_TileGroupMayMatch::GetFunction(codegen);
+      llvm::Value *may_match =
+          codegen.CallFunc(may_match_func, {tile_group_ptr, scan_plan_ptr});
+      If tile_group_may_match{codegen, may_match, "tileGroupMayMatch"};
+      {
+        GenerateTileGroupScan(codegen, tile_group_idx, tile_group_ptr,
+                              column_layouts, vector_size, consumer);
+      }
+      tile_group_may_match.EndIf();
     } else {
-      tile_group_.GenerateTidScan(codegen, tile_group_ptr,
-          column_layouts, consumer);
+      GenerateTileGroupScan(codegen, tile_group_idx, tile_group_ptr,
+                            column_layouts, vector_size, consumer);
     }
 
-    // Invoke the consumer to let her know that we're done with this tile group
-    consumer.TileGroupFinish(codegen, tile_group_ptr);
-
     // Move to next tile group in the table
     tile_group_idx = codegen->CreateAdd(tile_group_idx, codegen.Const64(1));
     loop.LoopEnd(codegen->CreateICmpULT(tile_group_idx, num_tile_groups),
@@ -108,5 +112,29 @@ void Table::DoGenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
   }
 }
 
+void Table::GenerateTileGroupScan(CodeGen &codegen,
+                                  llvm::Value *tile_group_idx,
+                                  llvm::Value *tile_group_ptr,
+                                  llvm::Value *column_layouts,
+                                  uint32_t vector_size,
+                                  ScanConsumer &consumer) const {
+  // Invoke the consumer to let her know that we're starting to iterate over
+  // the tile group now
+  consumer.TileGroupStart(codegen, tile_group_idx, tile_group_ptr);
+
+  // Generate the scan cover over the given tile group
+  if (vector_size > 1) {
+    tile_group_.GenerateVectorizedTidScan(codegen, tile_group_ptr,
+                                          column_layouts, vector_size,
+                                          consumer);
+  } else {
+    tile_group_.GenerateTidScan(codegen, tile_group_ptr, column_layouts,
+                                consumer);
+  }
+
+  // Invoke the consumer to let her know that we're done with this tile group
+  consumer.TileGroupFinish(codegen, tile_group_ptr);
+}
+
 }  // namespace codegen
 }  // namespace peloton
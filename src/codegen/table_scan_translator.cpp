@@ -75,10 +75,20 @@ void TableScanTranslator::Produce() const {
   Vector selection_vector{LoadStateValue(selection_vector_id_),
                           Vector::kDefaultVectorSize, codegen.Int32Type()};
 
+  // Tile groups are checked against the zone map terms of the predicate. The
+  // plan outlives the compiled query, so it is passed in as a constant.
+  llvm::Value *scan_plan_ptr = nullptr;
+  if (GetScanPlan().GetZoneMapPredicates().empty() == false) {
+    scan_plan_ptr = codegen->CreateIntToPtr(
+        codegen.Const64(reinterpret_cast<int64_t>(&GetScanPlan())),
+        codegen.CharPtrType());
+  }
+
   // Do the vectorized scan
   ScanConsumer scan_consumer{*this, selection_vector};
   table_.GenerateVectorizedScan(codegen, table_ptr,
-                                selection_vector.GetCapacity(), scan_consumer);
+                                selection_vector.GetCapacity(), scan_consumer,
+                                scan_plan_ptr);
 
   LOG_DEBUG("TableScan on [%u] finished producing tuples ...", table.GetOid());
 }
@@ -30,13 +30,20 @@ uint32_t TransactionRuntime::PerformVectorizedRead(
   // Check visibility of tuples in the range [tid_start, tid_end), storing all
   // visible tuple IDs in the provided selection vector
   uint32_t out_idx = 0;
-  for (uint32_t i = tid_start; i < tid_end; i++) {
-    // Perform the visibility check
-    auto visibility = txn_manager.IsVisible(&txn, tile_group_header, i);
-
-    // Update the output position
-    selection_vector[out_idx] = i;
-    out_idx += (visibility == VisibilityType::OK);
+  if (tile_group_header->IsFrozen()) {
+    // All tuples in a frozen tile group are visible
+    for (uint32_t i = tid_start; i < tid_end; i++) {
+      selection_vector[out_idx++] = i;
+    }
+  } else {
+    for (uint32_t i = tid_start; i < tid_end; i++) {
+      // Perform the visibility check
+      auto visibility = txn_manager.IsVisible(&txn, tile_group_header, i);
+
+      // Update the output position
+      selection_vector[out_idx] = i;
+      out_idx += (visibility == VisibilityType::OK);
+    }
   }
 
   uint32_t tile_group_idx = tile_group.GetTileGroupId();
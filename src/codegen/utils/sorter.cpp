@@ -12,10 +12,15 @@
 
 #include "codegen/utils/sorter.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "common/logger.h"
 #include "common/timer.h"
+#include "configuration/configuration.h"
+#include "executor/executor_context.h"
+#include "executor/order_by_executor.h"
+#include "executor/spill_file.h"
 #include "storage/storage_manager.h"
 
 namespace peloton {
@@ -29,44 +34,93 @@ Sorter::Sorter()
       buffer_pos_(nullptr),
       buffer_end_(nullptr),
       tuple_size_(std::numeric_limits<uint32_t>::max()),
-      cmp_func_(nullptr) {}
+      cmp_func_(nullptr),
+      top_k_(kNoLimit),
+      memory_budget_(0),
+      spill_state_(nullptr) {}
 
 // Destruction calls the destroy method to clean up the resources.
 Sorter::~Sorter() { Destroy(); }
 
 // It'd be nice if calls could hint the size of the buffer space they'd need
 // when initializing the sorter. Till then ...
-void Sorter::Init(ComparisonFunction func, uint32_t tuple_size) {
+void Sorter::Init(ComparisonFunction func, uint32_t tuple_size,
+                  uint64_t top_k, executor::ExecutorContext *executor_context) {
   LOG_DEBUG("Initializing Sorter ...");
 
   tuple_size_ = tuple_size;
   cmp_func_ = func;
+  top_k_ = top_k;
+  memory_budget_ = (executor_context != nullptr)
+                       ? executor_context->GetMemoryBudget()
+                       : FLAGS_work_mem * 1024;
+  spill_state_ = nullptr;
+
+  // Start with a buffer within the budget, unless it would be tiny
+  uint64_t buffer_size = kInitialBufferSize;
+  while (buffer_size > memory_budget_ && buffer_size / 2 >= kMinBufferSize &&
+         buffer_size / 2 > 2 * tuple_size_) {
+    buffer_size /= 2;
+  }
 
   auto &storage_manager = storage::StorageManager::GetInstance();
 
   buffer_start_ = reinterpret_cast<char *>(
-      storage_manager.Allocate(BackendType::MM, kInitialBufferSize));
+      storage_manager.Allocate(BackendType::MM, buffer_size));
   buffer_pos_ = buffer_start_;
-  buffer_end_ = buffer_start_ + kInitialBufferSize;
+  buffer_end_ = buffer_start_ + buffer_size;
 
   LOG_INFO("Initialized Sorter with size %lu KB for tuples of size %u...",
-           kInitialBufferSize / 1024, tuple_size_);
+           buffer_size / 1024, tuple_size_);
 }
 
 // StoreValue a tuple of the given size in this sorter. We return a buffer that
 // has room to store tuple_size bytes.  We should also resize the existing
-// buffer space if we don't have sufficient room for the incoming tuple.
+// buffer space if we don't have sufficient room for the incoming tuple, or
+// spill its tuples if a larger buffer would exceed the memory budget.
 char *Sorter::StoreInputTuple() {
   if (!EnoughSpace(tuple_size_)) {
-    Resize();
+    if (top_k_ == kNoLimit && GetUsedSpace() > 0 &&
+        (GetAllocatedSpace() << 1) > memory_budget_) {
+      SpillRun();
+    } else {
+      Resize();
+    }
   }
   char *ret = buffer_pos_;
   buffer_pos_ += tuple_size_;
   return ret;
 }
 
-// Sort the buffer
+// The tuple stored last joins the heap while there are fewer than top_k
+// tuples. After that, it replaces the top of the heap (the last of the kept
+// tuples) if it sorts before it, and is dropped otherwise.
+void Sorter::KeepTopK() {
+  uint64_t num_tuples = GetNumTuples();
+  if (num_tuples <= top_k_) {
+    SiftUp(num_tuples - 1);
+    return;
+  }
+
+  char *new_tuple = buffer_pos_ - tuple_size_;
+  if (top_k_ > 0 && cmp_func_(new_tuple, buffer_start_) < 0) {
+    PL_MEMCPY(buffer_start_, new_tuple, tuple_size_);
+    SiftDown(0, top_k_);
+  }
+  buffer_pos_ -= tuple_size_;
+}
+
+// Sort the buffer, or merge the runs if any were spilled
 void Sorter::Sort() {
+  if (spill_state_ != nullptr) {
+    if (GetUsedSpace() > 0) {
+      SpillRun();
+    }
+    StartMerge();
+    FillBuffer();
+    return;
+  }
+
   // Nothing to sort if nothing has been stored
   if (GetUsedSpace() <= 0) {
     return;
@@ -87,13 +141,128 @@ void Sorter::Sort() {
   LOG_INFO("Sorted %lu tuples in %.2f ms", num_tuples, timer.GetDuration());
 }
 
-// Release any memory we allocated from the storage manager.
+bool Sorter::NextBatch() {
+  if (spill_state_ == nullptr) {
+    return false;
+  }
+  return FillBuffer();
+}
+
+// Release any memory we allocated from the storage manager, and remove the
+// spilled runs.
 void Sorter::Destroy() {
   if (buffer_start_ != nullptr) {
     auto &storage_manager = storage::StorageManager::GetInstance();
     storage_manager.Release(BackendType::MM, buffer_start_);
   }
   buffer_start_ = buffer_pos_ = buffer_end_ = nullptr;
+
+  delete spill_state_;
+  spill_state_ = nullptr;
+}
+
+void Sorter::SpillRun() {
+  uint64_t num_tuples = GetNumTuples();
+  std::qsort(buffer_start_, num_tuples, tuple_size_, cmp_func_);
+
+  std::unique_ptr<executor::SpillFile> run(new executor::SpillFile());
+  for (uint64_t idx = 0; idx < num_tuples; idx++) {
+    run->AppendBytes(GetTuple(idx), tuple_size_);
+  }
+
+  LOG_DEBUG("Spilled a sorted run of %lu tuples (%lu bytes)",
+            run->GetRowCount(), run->GetSize());
+
+  if (spill_state_ == nullptr) {
+    spill_state_ = new SpillState();
+  }
+  spill_state_->runs.push_back(std::move(run));
+  buffer_pos_ = buffer_start_;
+}
+
+void Sorter::StartMerge() {
+  auto &runs = spill_state_->runs;
+  auto &merge_runs = spill_state_->merge_runs;
+
+  // Merge the oldest runs into one until few enough are left to be merged
+  // at once
+  std::vector<char> tuple(tuple_size_);
+  while (runs.size() > SORT_MERGE_FAN_IN) {
+    merge_runs.assign(std::make_move_iterator(runs.begin()),
+                      std::make_move_iterator(runs.begin() +
+                                              SORT_MERGE_FAN_IN));
+    runs.erase(runs.begin(), runs.begin() + SORT_MERGE_FAN_IN);
+    InitMergeHeap();
+
+    std::unique_ptr<executor::SpillFile> run(new executor::SpillFile());
+    while (NextMergedTuple(tuple.data()) == true) {
+      run->AppendBytes(tuple.data(), tuple_size_);
+    }
+    runs.push_back(std::move(run));
+  }
+
+  merge_runs = std::move(runs);
+  runs.clear();
+  InitMergeHeap();
+
+  LOG_DEBUG("Merging %lu sorted runs", merge_runs.size());
+}
+
+void Sorter::InitMergeHeap() {
+  auto &merge_runs = spill_state_->merge_runs;
+  auto &merge_tuples = spill_state_->merge_tuples;
+  auto &merge_heap = spill_state_->merge_heap;
+
+  merge_tuples.resize(merge_runs.size() * tuple_size_);
+  merge_heap.clear();
+  for (size_t run_itr = 0; run_itr < merge_runs.size(); run_itr++) {
+    merge_runs[run_itr]->Rewind();
+    if (merge_runs[run_itr]->NextBytes(&merge_tuples[run_itr * tuple_size_],
+                                       tuple_size_) == true) {
+      merge_heap.push_back(run_itr);
+    }
+  }
+  std::make_heap(merge_heap.begin(), merge_heap.end(),
+                 MergeHeapComparer(*this));
+}
+
+bool Sorter::NextMergedTuple(char *tuple) {
+  auto &merge_runs = spill_state_->merge_runs;
+  auto &merge_tuples = spill_state_->merge_tuples;
+  auto &merge_heap = spill_state_->merge_heap;
+
+  if (merge_heap.empty() == true) {
+    return false;
+  }
+
+  // The top of the heap is the run with the first tuple
+  MergeHeapComparer heap_comp(*this);
+  std::pop_heap(merge_heap.begin(), merge_heap.end(), heap_comp);
+  size_t run_itr = merge_heap.back();
+  char *run_tuple = &merge_tuples[run_itr * tuple_size_];
+  PL_MEMCPY(tuple, run_tuple, tuple_size_);
+  if (merge_runs[run_itr]->NextBytes(run_tuple, tuple_size_) == true) {
+    std::push_heap(merge_heap.begin(), merge_heap.end(), heap_comp);
+  } else {
+    merge_heap.pop_back();
+  }
+  return true;
+}
+
+bool Sorter::MergeHeapComparer::operator()(const size_t &a,
+                                           const size_t &b) const {
+  // The heap keeps the run with the first tuple on top
+  auto &merge_tuples = sorter.spill_state_->merge_tuples;
+  return sorter.cmp_func_(&merge_tuples[b * sorter.tuple_size_],
+                          &merge_tuples[a * sorter.tuple_size_]) < 0;
+}
+
+bool Sorter::FillBuffer() {
+  buffer_pos_ = buffer_start_;
+  while (EnoughSpace(tuple_size_) && NextMergedTuple(buffer_pos_) == true) {
+    buffer_pos_ += tuple_size_;
+  }
+  return GetUsedSpace() > 0;
 }
 
 // Resize the buffer by allocating a space that is double its current size.
@@ -134,6 +303,38 @@ void Sorter::Resize() {
   storage_manager.Release(BackendType::MM, old_buffer_start);
 }
 
+// In the max-heap, no tuple sorts after its parent
+void Sorter::SiftUp(uint64_t idx) {
+  while (idx > 0) {
+    uint64_t parent_idx = (idx - 1) / 2;
+    if (cmp_func_(GetTuple(parent_idx), GetTuple(idx)) >= 0) {
+      break;
+    }
+    SwapTuples(GetTuple(parent_idx), GetTuple(idx));
+    idx = parent_idx;
+  }
+}
+
+void Sorter::SiftDown(uint64_t idx, uint64_t num_tuples) {
+  while (2 * idx + 1 < num_tuples) {
+    // The child that sorts last
+    uint64_t child_idx = 2 * idx + 1;
+    if (child_idx + 1 < num_tuples &&
+        cmp_func_(GetTuple(child_idx + 1), GetTuple(child_idx)) > 0) {
+      child_idx++;
+    }
+    if (cmp_func_(GetTuple(idx), GetTuple(child_idx)) >= 0) {
+      break;
+    }
+    SwapTuples(GetTuple(idx), GetTuple(child_idx));
+    idx = child_idx;
+  }
+}
+
+void Sorter::SwapTuples(char *left_tuple, char *right_tuple) {
+  std::swap_ranges(left_tuple, left_tuple + tuple_size_, right_tuple);
+}
+
 //===----------------------------------------------------------------------===//
 // Iterators
 //===----------------------------------------------------------------------===//
@@ -20,6 +20,7 @@
 #include "brain/layout_tuner.h"
 #include "concurrency/epoch_manager_factory.h"
 #include "gc/gc_manager_factory.h"
+#include "gc/tile_group_compactor.h"
 #include "storage/data_table.h"
 
 #include <google/protobuf/stubs/common.h>
@@ -50,6 +51,11 @@ void PelotonInit::Initialize() {
   // start GC.
   gc::GCManagerFactory::GetInstance().StartGC();
 
+  // start tile group compactor
+  if (FLAGS_tile_group_compaction == true) {
+    gc::TileGroupCompactor::GetInstance().Start();
+  }
+
   // start index tuner
   if (FLAGS_index_tuner == true) {
     // Set the default visibility flag for all indexes to false
@@ -92,6 +98,11 @@ void PelotonInit::Shutdown() {
     layout_tuner.Stop();
   }
 
+  // shut down tile group compactor
+  if (FLAGS_tile_group_compaction == true) {
+    gc::TileGroupCompactor::GetInstance().Stop();
+  }
+
   // shut down GC.
   gc::GCManagerFactory::GetInstance().StopGC();
 
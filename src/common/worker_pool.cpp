@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// worker_pool.cpp
+//
+// Identification: src/common/worker_pool.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Worker Pool
+//===--------------------------------------------------------------------===//
+
+WorkerPool &WorkerPool::GetInstance() {
+  static WorkerPool worker_pool;
+  return worker_pool;
+}
+
+// the callers are workers themselves
+WorkerPool::WorkerPool() {
+  size_t worker_count = std::max(std::thread::hardware_concurrency(), 1U);
+  for (size_t worker_itr = 1; worker_itr < worker_count; worker_itr++) {
+    workers_.emplace_back(&WorkerPool::Run, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  job_added_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void WorkerPool::Submit(std::function<void()> &&job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+  }
+  job_added_.notify_one();
+}
+
+void WorkerPool::Run() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      job_added_.wait(lock,
+                      [this]() { return stopped_ || jobs_.empty() == false; });
+      if (jobs_.empty() == true) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job();
+  }
+}
+
+void WorkerPool::RunTasks(const size_t &unit_count,
+                          const std::function<void(size_t)> &task,
+                          size_t helper_count) {
+  helper_count = std::min(helper_count, GetWorkerCount());
+  if (unit_count > 0) {
+    helper_count = std::min(helper_count, unit_count - 1);
+  }
+  if (helper_count == 0) {
+    for (size_t unit = 0; unit < unit_count; unit++) {
+      task(unit);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next_unit(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto run_units = [&](size_t) {
+    try {
+      size_t unit;
+      while ((unit = next_unit++) < unit_count) {
+        task(unit);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+      next_unit = unit_count;
+    }
+  };
+
+  // the calling thread is one of the workers, and the helpers still queued
+  // once it is done are not waited for
+  WorkerGroup worker_group;
+  worker_group.Start(helper_count, run_units);
+  run_units(0);
+  worker_group.Join();
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Worker Group
+//===--------------------------------------------------------------------===//
+
+// Shared with the pool jobs of the helpers, which may outlive the group
+struct WorkerGroup::State {
+  std::function<void(size_t)> job;
+
+  std::function<void()> on_start;
+
+  std::mutex mutex;
+
+  std::condition_variable helpers_done;
+
+  // number of helpers that started
+  size_t started_count = 0;
+
+  // number of helpers running the job
+  size_t running_count = 0;
+
+  // set once the group is joined
+  bool closed = false;
+};
+
+WorkerGroup::WorkerGroup() {}
+
+WorkerGroup::~WorkerGroup() { Join(); }
+
+size_t WorkerGroup::Start(size_t helper_count,
+                          std::function<void(size_t)> job,
+                          std::function<void()> on_start) {
+  Join();
+
+  auto &worker_pool = WorkerPool::GetInstance();
+  helper_count = std::min(helper_count, worker_pool.GetWorkerCount());
+
+  state_.reset(new State());
+  state_->job = std::move(job);
+  state_->on_start = std::move(on_start);
+
+  std::shared_ptr<State> state = state_;
+  for (size_t helper_itr = 0; helper_itr < helper_count; helper_itr++) {
+    worker_pool.Submit([state]() {
+      size_t helper_id;
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->closed == true) {
+          return;
+        }
+        helper_id = state->started_count++;
+        state->running_count++;
+        if (state->on_start != nullptr) {
+          state->on_start();
+        }
+      }
+      state->job(helper_id);
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (--state->running_count == 0) {
+        state->helpers_done.notify_all();
+      }
+    });
+  }
+
+  return helper_count;
+}
+
+size_t WorkerGroup::Join() {
+  if (state_ == nullptr) {
+    return 0;
+  }
+
+  size_t started_count;
+  {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->closed = true;
+    state_->helpers_done.wait(
+        lock, [this]() { return state_->running_count == 0; });
+    started_count = state_->started_count;
+  }
+  state_.reset();
+
+  return started_count;
+}
+
+}  // namespace peloton
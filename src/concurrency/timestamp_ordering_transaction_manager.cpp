@@ -19,6 +19,7 @@
 #include "concurrency/transaction.h"
 #include "gc/gc_manager_factory.h"
 #include "logging/log_manager_factory.h"
+#include "storage/delta_storage.h"
 
 namespace peloton {
 namespace concurrency {
@@ -183,6 +184,12 @@ bool TimestampOrderingTransactionManager::AcquireOwnership(
     } else {
       GetSpinlockField(tile_group_header, tuple_id)->Unlock();
 
+      // the version is about to be replaced, so the tile group is no longer
+      // all visible. this must follow the ownership, see TileGroupCompactor.
+      if (tile_group_header->IsUnfrozen() == false) {
+        const_cast<storage::TileGroupHeader *>(tile_group_header)->Unfreeze();
+      }
+
       return true;
     }
   }
@@ -634,6 +641,34 @@ void TimestampOrderingTransactionManager::PerformUpdate(
   }
 }
 
+void TimestampOrderingTransactionManager::PerformDeltaUpdate(
+    Transaction *const current_txn, const ItemPointer &location,
+    const std::vector<oid_t> &column_ids,
+    const std::vector<type::Value> &values) {
+  PL_ASSERT(current_txn->GetIsolationLevel() != IsolationLevelType::READ_ONLY);
+
+  auto &manager = catalog::Manager::GetInstance();
+  auto tile_group_header = manager.GetTileGroup(location.block)->GetHeader();
+
+  // the tuple must be the latest committed version owned by the current txn.
+  PL_ASSERT(tile_group_header->GetTransactionId(location.offset) ==
+            current_txn->GetTransactionId());
+  PL_ASSERT(tile_group_header->GetBeginCommitId(location.offset) != MAX_CID);
+  PL_ASSERT(tile_group_header->GetEndCommitId(location.offset) == MAX_CID);
+
+  storage::DeltaStorage::GetInstance().InstallDelta(
+      current_txn, tile_group_header, location, column_ids, values);
+
+  // the delta is committed or dropped together with the tuple's update entry.
+  current_txn->RecordUpdate(location);
+
+  // Increment table update op stats
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementTableUpdates(
+        location.block);
+  }
+}
+
 void TimestampOrderingTransactionManager::PerformDelete(
     Transaction *const current_txn, const ItemPointer &location,
     const ItemPointer &new_location) {
@@ -778,6 +813,7 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
 
   auto &manager = catalog::Manager::GetInstance();
   auto &log_manager = logging::LogManager::GetInstance();
+  auto &delta_storage = storage::DeltaStorage::GetInstance();
 
   log_manager.StartLogging();
   
@@ -814,6 +850,23 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
         // update/delete yet
         // Yield the ownership
         YieldOwnership(current_txn, tile_group_header, tuple_slot);
+      } else if (tuple_entry.second == RWType::UPDATE &&
+                 storage::DeltaStorage::HasPendingDelta(
+                     tile_group_header, tuple_slot,
+                     current_txn->GetTransactionId())) {
+        // the update is stored as a delta of the tuple itself.
+        // it becomes visible as soon as the delta carries the commit id.
+        delta_storage.CommitDelta(current_txn, tile_group_header, tuple_slot);
+
+        // we should set the version before releasing the lock.
+        COMPILER_MEMORY_FENCE;
+
+        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+
+        // nothing to be added to gc set. the delta is merged by the gc.
+
+        log_manager.LogUpdate(ItemPointer(tile_group_id, tuple_slot));
+
       } else if (tuple_entry.second == RWType::UPDATE) {
         // we must guarantee that, at any time point, only one version is
         // visible.
@@ -847,6 +900,9 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
         log_manager.LogUpdate(new_version);
 
       } else if (tuple_entry.second == RWType::DELETE) {
+        // a delta written before deleting the tuple is of no use anymore.
+        delta_storage.AbortDelta(current_txn, tile_group_header, tuple_slot);
+
         ItemPointer new_version =
             tile_group_header->GetPrevItemPointer(tuple_slot);
 
@@ -916,6 +972,25 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
     }
   }
 
+  // install the tuples of bulk loads, a whole tile group at a time.
+  for (auto tile_group_id : current_txn->GetBulkLoadSet()) {
+    auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+    auto tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+
+    for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+      PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
+                current_txn->GetTransactionId());
+      tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
+    }
+
+    // we should set the versions before releasing the locks.
+    COMPILER_MEMORY_FENCE;
+
+    for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+    }
+  }
+
   ResultType result = current_txn->GetResult();
 
   log_manager.LogEnd();
@@ -938,6 +1013,7 @@ ResultType TimestampOrderingTransactionManager::AbortTransaction(
 
   LOG_TRACE("Aborting peloton txn : %lu ", current_txn->GetTransactionId());
   auto &manager = catalog::Manager::GetInstance();
+  auto &delta_storage = storage::DeltaStorage::GetInstance();
 
   auto &rw_set = current_txn->GetReadWriteSet();
 
@@ -962,6 +1038,17 @@ ResultType TimestampOrderingTransactionManager::AbortTransaction(
         // update/delete yet
         // Yield the ownership
         YieldOwnership(current_txn, tile_group_header, tuple_slot);
+      } else if (tuple_entry.second == RWType::UPDATE &&
+                 delta_storage.AbortDelta(current_txn, tile_group_header,
+                                          tuple_slot) == true) {
+        // the update was stored as a delta, which is already unlinked.
+        // the tuple itself has never been modified.
+
+        // we should set the version before releasing the lock.
+        COMPILER_MEMORY_FENCE;
+
+        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+
       } else if (tuple_entry.second == RWType::UPDATE) {
         ItemPointer new_version =
             tile_group_header->GetPrevItemPointer(tuple_slot);
@@ -1021,6 +1108,9 @@ ResultType TimestampOrderingTransactionManager::AbortTransaction(
         gc_set->operator[](new_version.block)[new_version.offset] = false;
 
       } else if (tuple_entry.second == RWType::DELETE) {
+        // drop the delta written before deleting the tuple, if any.
+        delta_storage.AbortDelta(current_txn, tile_group_header, tuple_slot);
+
         ItemPointer new_version =
             tile_group_header->GetPrevItemPointer(tuple_slot);
 
@@ -1102,6 +1192,19 @@ ResultType TimestampOrderingTransactionManager::AbortTransaction(
     }
   }
 
+  // drop the tuples of bulk loads. like aborted inserts, they are deleted
+  // from the indexes by the gc, including the entries of a load that stopped
+  // at a constraint violation.
+  for (auto tile_group_id : current_txn->GetBulkLoadSet()) {
+    auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+    auto tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+
+    for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
+      gc_set->operator[](tile_group_id)[tuple_slot] = true;
+    }
+  }
+
   current_txn->SetResult(ResultType::ABORTED);
   EndTransaction(current_txn);
 
@@ -46,6 +46,13 @@ namespace concurrency {
  *    i : insert
  */
 
+void Transaction::RecordBulkLoad(const oid_t &tile_group_id) {
+  bulk_load_lock_.Lock();
+  bulk_load_set_.push_back(tile_group_id);
+  is_written_ = true;
+  bulk_load_lock_.Unlock();
+}
+
 RWType Transaction::GetRWType(const ItemPointer &location) {
   oid_t tile_group_id = location.block;
   oid_t tuple_id = location.offset;
@@ -17,6 +17,7 @@
 #include "statistics/stats_aggregator.h"
 #include "logging/log_manager.h"
 #include "gc/gc_manager_factory.h"
+#include "storage/delta_storage.h"
 #include "storage/tile_group.h"
 
 
@@ -189,6 +190,27 @@ VisibilityType TransactionManager::IsVisible(
     const storage::TileGroupHeader *const tile_group_header,
     const oid_t &tuple_id, 
     const VisibilityIdType type) {
+  return CheckVisibility(current_txn, tile_group_header, tuple_id, type, true);
+}
+
+VisibilityType TransactionManager::IsVisibleUnowned(
+    Transaction *const current_txn,
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t &tuple_id) {
+  return CheckVisibility(current_txn, tile_group_header, tuple_id,
+                         VisibilityIdType::READ_ID, false);
+}
+
+VisibilityType TransactionManager::CheckVisibility(
+    Transaction *const current_txn,
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t &tuple_id, const VisibilityIdType type,
+    const bool resolve_owned) {
+  // all versions in a frozen tile group are visible
+  if (tile_group_header->IsFrozen() == true) {
+    return VisibilityType::OK;
+  }
+
   txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
   cid_t tuple_begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
   cid_t tuple_end_cid = tile_group_header->GetEndCommitId(tuple_id);
@@ -225,7 +247,10 @@ VisibilityType TransactionManager::IsVisible(
   // there are exactly two versions that can be owned by a transaction,
   // unless it is an insertion/select-for-update
   if (own == true) {
-    if (tuple_begin_cid == MAX_CID && tuple_end_cid != INVALID_CID) {
+    if (resolve_owned == false) {
+      // the read/write set belongs to the thread of the transaction
+      return VisibilityType::INVALID;
+    } else if (tuple_begin_cid == MAX_CID && tuple_end_cid != INVALID_CID) {
       PL_ASSERT(tuple_end_cid == MAX_CID);
       // the only version that is visible is the newly inserted/updated one.
       return VisibilityType::OK;
@@ -233,6 +258,11 @@ VisibilityType TransactionManager::IsVisible(
                RWType::READ_OWN) {
       // the ownership is from a select-for-update read operation
       return VisibilityType::OK;
+    } else if (tuple_end_cid == MAX_CID &&
+               storage::DeltaStorage::HasPendingDelta(
+                   tile_group_header, tuple_id, tuple_txn_id)) {
+      // the tuple is updated through a delta, so it stays the latest version
+      return VisibilityType::OK;
     } else if (tuple_end_cid == INVALID_CID) {
       // tuple being deleted by current txn
       return VisibilityType::DELETED;
@@ -37,6 +37,9 @@ void PrintConfiguration(){
   LOG_INFO("%30s: %10s",  "Socket Family", FLAGS_socket_family.c_str());
   LOG_INFO("%30s: %10lu", "Statistics", FLAGS_stats_mode);
   LOG_INFO("%30s: %10lu", "Max Connections", FLAGS_max_connections);
+  LOG_INFO("%30s: %10lu", "Work Memory (KB)", FLAGS_work_mem);
+  LOG_INFO("%30s: %10s",  "Late Materialization",
+           FLAGS_late_materialization ? "on" : "off");
   LOG_INFO("%30s: %10s",  "Code-generation", FLAGS_codegen ? "on" : "off");
 
   LOG_INFO(" ");
@@ -71,6 +74,16 @@ DEFINE_string(socket_family,
 // RESOURCE USAGE
 //===----------------------------------------------------------------------===//
 
+DEFINE_uint64(work_mem,
+              65536,
+              "Memory in KB each sort or hash aggregation may use before "
+              "spilling to temporary files (default: 65536)");
+
+DEFINE_bool(late_materialization,
+            true,
+            "Leave the columns a projection passes through in their base "
+            "tiles until they are read (default: true)");
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
@@ -107,6 +120,10 @@ DEFINE_bool(layout_tuner,
             false,
             "Enable layout tuner (default: false)");
 
+DEFINE_bool(tile_group_compaction,
+            false,
+            "Enable tile group compaction (default: false)");
+
 //===----------------------------------------------------------------------===//
 //
 //===----------------------------------------------------------------------===//
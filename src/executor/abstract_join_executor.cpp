@@ -381,7 +381,9 @@ bool AbstractJoinExecutor::BuildOuterJoinOutput() {
       break;
     }
 
-    case JoinType::INNER: { return false; }
+    case JoinType::INNER:
+    case JoinType::SEMI:
+    case JoinType::ANTI: { return false; }
 
     default: {
       throw Exception("Unsupported join type : " + JoinTypeToString(join_type_));
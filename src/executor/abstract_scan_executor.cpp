@@ -18,12 +18,17 @@
 #include <vector>
 
 #include "type/types.h"
+#include "executor/bloom_filter.h"
 #include "executor/logical_tile.h"
+#include "executor/radix_hash_table.h"
 #include "executor/logical_tile_factory.h"
 #include "expression/abstract_expression.h"
 #include "common/container_tuple.h"
 #include "storage/data_table.h"
+#include "storage/delta_storage.h"
+#include "storage/delta_tuple.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 
 #include "common/logger.h"
 
@@ -38,6 +43,13 @@ AbstractScanExecutor::AbstractScanExecutor(const planner::AbstractPlan *node,
                                            ExecutorContext *executor_context)
     : AbstractExecutor(node, executor_context) {}
 
+AbstractScanExecutor::~AbstractScanExecutor() {
+  for (auto &tile_group : version_tile_groups_) {
+    storage::DeltaStorage::ReleaseVersionTileGroup(
+        tile_group->GetTileGroupId());
+  }
+}
+
 /**
  * @brief Extract predicate and simple projections
  * @return true on success, false otherwise.
@@ -54,8 +66,67 @@ bool AbstractScanExecutor::DInit() {
 
   column_ids_ = std::move(node.GetColumnIds());
 
+  bloom_filters_.clear();
+
   return true;
 }
 
+void AbstractScanExecutor::AddBloomFilter(
+    const std::shared_ptr<const BloomFilter> &filter,
+    const std::vector<oid_t> &key_column_offsets) {
+  // Only the scans of a table can filter their tuples before they are
+  // materialized
+  std::vector<oid_t> key_column_ids;
+  for (auto column_offset : key_column_offsets) {
+    if (column_offset >= column_ids_.size()) {
+      return;
+    }
+    key_column_ids.push_back(column_ids_[column_offset]);
+  }
+
+  LOG_TRACE("Scan filtered by a bloom filter of %lu bytes", filter->GetSize());
+  bloom_filters_.emplace_back(filter, std::move(key_column_ids));
+}
+
+void AbstractScanExecutor::ApplyBloomFilters(
+    storage::TileGroup *tile_group, std::vector<oid_t> &position_list) const {
+  for (auto &bloom_filter : bloom_filters_) {
+    // Same hash as the hash table of the join
+    auto &filter = *bloom_filter.first;
+    auto &key_column_ids = bloom_filter.second;
+    size_t output_offset = 0;
+    for (auto tuple_id : position_list) {
+      size_t hash_code = 0;
+      for (auto column_id : key_column_ids) {
+        tile_group->GetValue(tuple_id, column_id).HashCombine(hash_code);
+      }
+      if (filter.MayContain(RadixHashTable::HashKey(hash_code))) {
+        position_list[output_offset++] = tuple_id;
+      }
+    }
+    position_list.resize(output_offset);
+  }
+}
+
+/**
+ * @brief Materialize the version of a delta-stored tuple visible to the scan.
+ * @return the location of the copy.
+ */
+ItemPointer AbstractScanExecutor::MaterializeDeltaTuple(
+    storage::DataTable *table, const storage::DeltaTuple &tuple,
+    const size_t &capacity) {
+  if (version_tile_groups_.empty() ||
+      version_tile_groups_.back()->GetNextTupleSlot() ==
+          version_tile_groups_.back()->GetAllocatedTupleCount()) {
+    version_tile_groups_.push_back(
+        storage::DeltaStorage::CreateVersionTileGroup(table, capacity));
+  }
+
+  auto tile_group = version_tile_groups_.back().get();
+  oid_t tuple_id = storage::DeltaStorage::MaterializeVersion(tuple, tile_group);
+
+  return ItemPointer(tile_group->GetTileGroupId(), tuple_id);
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -104,9 +104,16 @@ bool AggregateExecutor::DExecute() {
       // Initialize the aggregator
       switch (node.GetAggregateStrategy()) {
         case AggregateType::HASH:
-          LOG_TRACE("Use HashAggregator");
-          aggregator.reset(new HashAggregator(
-              &node, output_table, executor_context_, tile->GetColumnCount()));
+          if (FlatHashAggregator::IsSupported(&node, tile.get())) {
+            LOG_TRACE("Use FlatHashAggregator");
+            aggregator.reset(new FlatHashAggregator(
+                &node, output_table, executor_context_, tile.get()));
+          } else {
+            LOG_TRACE("Use HashAggregator");
+            aggregator.reset(new HashAggregator(&node, output_table,
+                                                executor_context_,
+                                                tile->GetColumnCount()));
+          }
           break;
         case AggregateType::SORTED:
           LOG_TRACE("Use SortedAggregator");
@@ -126,13 +133,8 @@ bool AggregateExecutor::DExecute() {
 
     LOG_TRACE("Looping over tile..");
 
-    for (oid_t tuple_id : *tile) {
-      std::unique_ptr<expression::ContainerTuple<LogicalTile>> cur_tuple(
-          new expression::ContainerTuple<LogicalTile>(tile.get(), tuple_id));
-
-      if (aggregator->Advance(cur_tuple.get()) == false) {
-        return false;
-      }
+    if (aggregator->AdvanceTile(std::move(tile)) == false) {
+      return false;
     }
     LOG_TRACE("Finished processing logical tile");
   }
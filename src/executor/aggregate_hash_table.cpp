@@ -0,0 +1,485 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// aggregate_hash_table.cpp
+//
+// Identification: src/executor/aggregate_hash_table.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/aggregate_hash_table.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/abstract_tuple.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "executor/aggregator.h"
+#include "executor/spill_file.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace executor {
+
+static const uint32_t INVALID_GROUP = UINT32_MAX;
+
+// Spread the bits of a key word over the whole hash (the MurmurHash3
+// finalizer)
+static hash_t MixHash(hash_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// Word holding a non-null value of a fixed width type
+static int64_t GetWord(const type::Value &value) {
+  switch (value.GetTypeId()) {
+    case type::Type::BOOLEAN:
+    case type::Type::TINYINT:
+      return value.GetAs<int8_t>();
+    case type::Type::SMALLINT:
+      return value.GetAs<int16_t>();
+    case type::Type::INTEGER:
+      return value.GetAs<int32_t>();
+    case type::Type::BIGINT:
+      return value.GetAs<int64_t>();
+    case type::Type::DATE:
+      return value.GetAs<uint32_t>();
+    case type::Type::TIMESTAMP:
+      return static_cast<int64_t>(value.GetAs<uint64_t>());
+    default:
+      throw UnknownTypeException(static_cast<int>(value.GetTypeId()),
+                                 "Value does not fit in a word");
+  }
+}
+
+// Value of a fixed width type held by a word
+static type::Value GetValue(const type::Type::TypeId &type_id,
+                            const int64_t &word) {
+  switch (type_id) {
+    case type::Type::BOOLEAN:
+      return type::ValueFactory::GetBooleanValue(static_cast<int8_t>(word));
+    case type::Type::TINYINT:
+      return type::ValueFactory::GetTinyIntValue(static_cast<int8_t>(word));
+    case type::Type::SMALLINT:
+      return type::ValueFactory::GetSmallIntValue(static_cast<int16_t>(word));
+    case type::Type::INTEGER:
+      return type::ValueFactory::GetIntegerValue(static_cast<int32_t>(word));
+    case type::Type::BIGINT:
+      return type::ValueFactory::GetBigIntValue(word);
+    case type::Type::DATE:
+      return type::ValueFactory::GetDateValue(static_cast<uint32_t>(word));
+    case type::Type::TIMESTAMP:
+      return type::ValueFactory::GetTimestampValue(word);
+    default:
+      throw UnknownTypeException(static_cast<int>(type_id),
+                                 "Value does not fit in a word");
+  }
+}
+
+// Add two values of the integer type, with the overflow checks of the type
+static int64_t AddWords(const int64_t &left, const int64_t &right,
+                        const type::Type::TypeId &type_id) {
+  int64_t sum;
+  bool overflow = __builtin_add_overflow(left, right, &sum);
+  switch (type_id) {
+    case type::Type::TINYINT:
+      overflow |= sum < std::numeric_limits<int8_t>::min() ||
+                  sum > std::numeric_limits<int8_t>::max();
+      break;
+    case type::Type::SMALLINT:
+      overflow |= sum < std::numeric_limits<int16_t>::min() ||
+                  sum > std::numeric_limits<int16_t>::max();
+      break;
+    case type::Type::INTEGER:
+      overflow |= sum < std::numeric_limits<int32_t>::min() ||
+                  sum > std::numeric_limits<int32_t>::max();
+      break;
+    default:
+      break;
+  }
+  if (overflow) {
+    throw Exception(EXCEPTION_TYPE_OUT_OF_RANGE, "Numeric value out of range.");
+  }
+  return sum;
+}
+
+AggregateHashTable::AggregateHashTable(
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<type::Type::TypeId> &key_types,
+    const std::vector<Aggregate> &aggregates, size_t memory_budget,
+    size_t spill_level)
+    : key_column_ids_(key_column_ids),
+      key_types_(key_types),
+      aggregates_(aggregates),
+      key_width_(key_column_ids.size() + 1),
+      state_width_(2 * aggregates.size()),
+      memory_budget_(memory_budget),
+      spill_level_(spill_level),
+      buckets_(AGGREGATE_HASH_TABLE_INITIAL_SIZE, INVALID_GROUP),
+      key_words_(key_width_) {
+  PL_ASSERT(key_column_ids_.size() == key_types_.size());
+  PL_ASSERT(key_column_ids_.size() < 64);
+}
+
+AggregateHashTable::~AggregateHashTable() {}
+
+bool AggregateHashTable::IsFixedWidthKey(type::Type::TypeId type_id) {
+  switch (type_id) {
+    case type::Type::BOOLEAN:
+    case type::Type::TINYINT:
+    case type::Type::SMALLINT:
+    case type::Type::INTEGER:
+    case type::Type::BIGINT:
+    case type::Type::DATE:
+    case type::Type::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int64_t AggregateHashTable::GetKeyWord(const type::Value &value) {
+  return GetWord(value);
+}
+
+bool AggregateHashTable::IsIntegerArgument(type::Type::TypeId type_id) {
+  switch (type_id) {
+    case type::Type::TINYINT:
+    case type::Type::SMALLINT:
+    case type::Type::INTEGER:
+    case type::Type::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+size_t AggregateHashTable::GetMemoryUsage() const {
+  return (keys_.size() + states_.size()) * sizeof(int64_t) +
+         hashes_.size() * sizeof(hash_t) + buckets_.size() * sizeof(uint32_t);
+}
+
+hash_t AggregateHashTable::HashKey(const int64_t *key_words) const {
+  hash_t hash = 0;
+  for (size_t word_itr = 0; word_itr < key_width_; word_itr++) {
+    hash = MixHash(hash ^ static_cast<hash_t>(key_words[word_itr]));
+  }
+  return hash;
+}
+
+void AggregateHashTable::Advance(const AbstractTuple *tuple) {
+  // The key words, with the null keys in the last one
+  int64_t null_keys = 0;
+  for (size_t key_itr = 0; key_itr < key_column_ids_.size(); key_itr++) {
+    type::Value value = tuple->GetValue(key_column_ids_[key_itr]);
+    if (value.IsNull()) {
+      null_keys |= (int64_t)1 << key_itr;
+      key_words_[key_itr] = 0;
+    } else {
+      key_words_[key_itr] = GetWord(value);
+    }
+  }
+  key_words_[key_column_ids_.size()] = null_keys;
+
+  size_t group_count = GetGroupCount();
+  uint32_t group =
+      FindOrInsertGroup(key_words_.data(), HashKey(key_words_.data()));
+
+  int64_t *states = &states_[group * state_width_];
+  for (size_t aggregate_itr = 0; aggregate_itr < aggregates_.size();
+       aggregate_itr++) {
+    auto &aggregate = aggregates_[aggregate_itr];
+    int64_t *state = states + 2 * aggregate_itr;
+
+    // the first state word is the aggregate, the second one the number of
+    // non-null arguments
+    switch (aggregate.aggregate_type) {
+      case ExpressionType::AGGREGATE_COUNT_STAR:
+        state[0]++;
+        break;
+      case ExpressionType::AGGREGATE_COUNT:
+        if (aggregate.column_id == INVALID_OID ||
+            tuple->GetValue(aggregate.column_id).IsNull() == false) {
+          state[0]++;
+        }
+        break;
+      default: {
+        type::Value value = tuple->GetValue(aggregate.column_id);
+        if (value.IsNull()) {
+          break;
+        }
+        int64_t word = GetWord(value);
+        if (state[1] == 0) {
+          state[0] = word;
+        } else if (aggregate.aggregate_type == ExpressionType::AGGREGATE_MIN) {
+          state[0] = std::min(state[0], word);
+        } else if (aggregate.aggregate_type == ExpressionType::AGGREGATE_MAX) {
+          state[0] = std::max(state[0], word);
+        } else {
+          state[0] = AddWords(state[0], word, aggregate.value_type);
+        }
+        state[1]++;
+      }
+    }
+  }
+
+  if (GetGroupCount() > group_count &&
+      spill_level_ < HASH_AGGREGATE_MAX_SPILL_LEVEL &&
+      GetMemoryUsage() > memory_budget_) {
+    SpillGroups();
+  }
+}
+
+uint32_t AggregateHashTable::FindOrInsertGroup(const int64_t *key_words,
+                                               const hash_t &hash) {
+  hash_t bucket_mask = buckets_.size() - 1;
+  size_t bucket = hash & bucket_mask;
+  for (; buckets_[bucket] != INVALID_GROUP;
+       bucket = (bucket + 1) & bucket_mask) {
+    uint32_t group = buckets_[bucket];
+    if (hashes_[group] == hash &&
+        std::equal(key_words, key_words + key_width_,
+                   keys_.begin() + group * key_width_)) {
+      return group;
+    }
+  }
+
+  uint32_t group = hashes_.size();
+  PL_ASSERT(group < INVALID_GROUP);
+  keys_.insert(keys_.end(), key_words, key_words + key_width_);
+  states_.resize(states_.size() + state_width_, 0);
+  hashes_.push_back(hash);
+  buckets_[bucket] = group;
+
+  // Keep at least half of the buckets empty
+  if (2 * hashes_.size() > buckets_.size()) {
+    Grow();
+  }
+  return group;
+}
+
+void AggregateHashTable::Grow() {
+  buckets_.assign(2 * buckets_.size(), INVALID_GROUP);
+  hash_t bucket_mask = buckets_.size() - 1;
+  for (uint32_t group = 0; group < hashes_.size(); group++) {
+    size_t bucket = hashes_[group] & bucket_mask;
+    while (buckets_[bucket] != INVALID_GROUP) {
+      bucket = (bucket + 1) & bucket_mask;
+    }
+    buckets_[bucket] = group;
+  }
+}
+
+void AggregateHashTable::MergeStates(int64_t *states,
+                                     const int64_t *other_states) const {
+  for (size_t aggregate_itr = 0; aggregate_itr < aggregates_.size();
+       aggregate_itr++) {
+    auto &aggregate = aggregates_[aggregate_itr];
+    int64_t *state = states + 2 * aggregate_itr;
+    const int64_t *other_state = other_states + 2 * aggregate_itr;
+
+    switch (aggregate.aggregate_type) {
+      case ExpressionType::AGGREGATE_COUNT_STAR:
+      case ExpressionType::AGGREGATE_COUNT:
+        state[0] += other_state[0];
+        break;
+      default:
+        if (other_state[1] == 0) {
+          break;
+        }
+        if (state[1] == 0) {
+          state[0] = other_state[0];
+        } else if (aggregate.aggregate_type == ExpressionType::AGGREGATE_MIN) {
+          state[0] = std::min(state[0], other_state[0]);
+        } else if (aggregate.aggregate_type == ExpressionType::AGGREGATE_MAX) {
+          state[0] = std::max(state[0], other_state[0]);
+        } else {
+          state[0] = AddWords(state[0], other_state[0], aggregate.value_type);
+        }
+        state[1] += other_state[1];
+    }
+  }
+}
+
+void AggregateHashTable::MergeGroup(const int64_t *key_words,
+                                    const hash_t &hash,
+                                    const int64_t *states) {
+  size_t group_count = GetGroupCount();
+  uint32_t group = FindOrInsertGroup(key_words, hash);
+  MergeStates(&states_[group * state_width_], states);
+
+  if (GetGroupCount() > group_count &&
+      spill_level_ < HASH_AGGREGATE_MAX_SPILL_LEVEL &&
+      GetMemoryUsage() > memory_budget_) {
+    SpillGroups();
+  }
+}
+
+void AggregateHashTable::Merge(AggregateHashTable &other) {
+  PL_ASSERT(other.spill_level_ == spill_level_);
+  PL_ASSERT(other.key_width_ == key_width_);
+  PL_ASSERT(other.state_width_ == state_width_);
+
+  for (size_t group = 0; group < other.GetGroupCount(); group++) {
+    MergeGroup(&other.keys_[group * key_width_], other.hashes_[group],
+               &other.states_[group * state_width_]);
+  }
+  other.Clear();
+
+  if (other.spill_partitions_.empty() == false) {
+    spill_partitions_.resize(other.spill_partitions_.size());
+    for (size_t partition = 0; partition < spill_partitions_.size();
+         partition++) {
+      for (auto &file : other.spill_partitions_[partition]) {
+        spill_partitions_[partition].push_back(std::move(file));
+      }
+    }
+    other.spill_partitions_.clear();
+  }
+}
+
+void AggregateHashTable::SpillGroups() {
+  if (spill_partitions_.empty() == true) {
+    LOG_TRACE("Spilling %lu groups (%lu bytes) at level %lu",
+              GetGroupCount(), GetMemoryUsage(), spill_level_);
+    spill_partitions_.resize(1 << HASH_AGGREGATE_SPILL_PARTITION_BITS);
+  }
+
+  // The partition is selected by the next unused high bits of the hash, since
+  // the low ones select the bucket
+  size_t shift = 64 - (spill_level_ + 1) * HASH_AGGREGATE_SPILL_PARTITION_BITS;
+  std::vector<type::Value> row;
+  for (size_t group = 0; group < GetGroupCount(); group++) {
+    auto &files =
+        spill_partitions_[(hashes_[group] >> shift) &
+                          (spill_partitions_.size() - 1)];
+    if (files.empty() == true) {
+      files.emplace_back(new SpillFile());
+    }
+
+    row.clear();
+    for (size_t word_itr = 0; word_itr < key_width_; word_itr++) {
+      row.push_back(type::ValueFactory::GetBigIntValue(
+          keys_[group * key_width_ + word_itr]));
+    }
+    for (size_t word_itr = 0; word_itr < state_width_; word_itr++) {
+      row.push_back(type::ValueFactory::GetBigIntValue(
+          states_[group * state_width_ + word_itr]));
+    }
+    files.back()->Append(row);
+  }
+  Clear();
+}
+
+void AggregateHashTable::Clear() {
+  std::vector<int64_t>().swap(keys_);
+  std::vector<int64_t>().swap(states_);
+  std::vector<hash_t>().swap(hashes_);
+  std::vector<uint32_t>(AGGREGATE_HASH_TABLE_INITIAL_SIZE, INVALID_GROUP)
+      .swap(buckets_);
+}
+
+bool AggregateHashTable::Finalize(const GroupCallback &callback) {
+  // Once some groups are spilled, the partial aggregates of a group can be
+  // in several partition files and in memory
+  if (spill_partitions_.empty() == false) {
+    SpillGroups();
+  }
+
+  std::vector<type::Value> key_values(key_column_ids_.size());
+  std::vector<type::Value> aggregate_values(aggregates_.size());
+  for (size_t group = 0; group < GetGroupCount(); group++) {
+    const int64_t *key_words = &keys_[group * key_width_];
+    int64_t null_keys = key_words[key_column_ids_.size()];
+    for (size_t key_itr = 0; key_itr < key_column_ids_.size(); key_itr++) {
+      if (null_keys & ((int64_t)1 << key_itr)) {
+        key_values[key_itr] =
+            type::ValueFactory::GetNullValueByType(key_types_[key_itr]);
+      } else {
+        key_values[key_itr] = GetValue(key_types_[key_itr], key_words[key_itr]);
+      }
+    }
+
+    const int64_t *states = &states_[group * state_width_];
+    for (size_t aggregate_itr = 0; aggregate_itr < aggregates_.size();
+         aggregate_itr++) {
+      auto &aggregate = aggregates_[aggregate_itr];
+      const int64_t *state = states + 2 * aggregate_itr;
+
+      // Same results as the attribute aggregators
+      switch (aggregate.aggregate_type) {
+        case ExpressionType::AGGREGATE_COUNT_STAR:
+        case ExpressionType::AGGREGATE_COUNT:
+          aggregate_values[aggregate_itr] =
+              type::ValueFactory::GetBigIntValue(state[0]);
+          break;
+        default:
+          if (state[1] == 0) {
+            aggregate_values[aggregate_itr] =
+                type::ValueFactory::GetNullValueByType(type::Type::INTEGER);
+          } else if (aggregate.aggregate_type ==
+                     ExpressionType::AGGREGATE_AVG) {
+            aggregate_values[aggregate_itr] =
+                GetValue(aggregate.value_type, state[0])
+                    .Divide(type::ValueFactory::GetDecimalValue(
+                        static_cast<double>(state[1])));
+          } else {
+            aggregate_values[aggregate_itr] =
+                GetValue(aggregate.value_type, state[0]);
+          }
+      }
+    }
+
+    if (callback(key_values, aggregate_values) == false) {
+      return false;
+    }
+  }
+  Clear();
+
+  // Merge the spilled groups one partition at a time. The groups of a
+  // partition that still do not fit are partitioned again.
+  auto spill_partitions = std::move(spill_partitions_);
+  spill_partitions_.clear();
+
+  std::vector<type::Value> row;
+  std::vector<int64_t> words(key_width_ + state_width_);
+  for (auto &files : spill_partitions) {
+    if (files.empty() == true) {
+      continue;
+    }
+
+    AggregateHashTable table(key_column_ids_, key_types_, aggregates_,
+                             memory_budget_, spill_level_ + 1);
+    for (auto &file : files) {
+      LOG_TRACE("Merging %lu spilled groups at level %lu",
+                file->GetRowCount(), spill_level_ + 1);
+      file->Rewind();
+      while (file->Next(row) == true) {
+        PL_ASSERT(row.size() == words.size());
+        for (size_t word_itr = 0; word_itr < words.size(); word_itr++) {
+          words[word_itr] = row[word_itr].GetAs<int64_t>();
+        }
+        table.MergeGroup(words.data(), HashKey(words.data()),
+                         words.data() + key_width_);
+      }
+      file.reset();
+    }
+
+    if (table.Finalize(callback) == false) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
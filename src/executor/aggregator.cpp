@@ -11,13 +11,18 @@
 //===----------------------------------------------------------------------===//
 #include "executor/aggregator.h"
 
+#include <algorithm>
 #include <set>
 
 #include "catalog/manager.h"
 #include "common/logger.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "executor/aggregate_hash_table.h"
 #include "executor/executor_context.h"
+#include "executor/spill_file.h"
+#include "expression/tuple_value_expression.h"
 #include "storage/abstract_table.h"
+#include "storage/tile.h"
 
 namespace peloton {
 namespace executor {
@@ -82,37 +87,19 @@ type::Value AbstractAttributeAggregator::Finalize() {
 }
 
 /*
- * Helper method responsible for inserting the results of the aggregation
- * into a new tuple in the output tile group as well as passing through any
- * additional columns from the input tile group.
- *
- * Output tuple is projected from two tuples:
- * Left is the 'delegate' tuple, which is usually the first tuple in the group,
- * used to retrieve pass-through values;
- * Right is the tuple holding all aggregated values.
+ * Insert the aggregated values of a group into a new tuple in the output
+ * table, projected with the values passed through from the delegate tuple.
  */
-bool Helper(const planner::AggregatePlan *node, AbstractAttributeAggregator **aggregates,
-            storage::AbstractTable *output_table,
-            const AbstractTuple *delegate_tuple,
-            executor::ExecutorContext *econtext) {
+static bool OutputGroup(const planner::AggregatePlan *node,
+                        std::vector<type::Value> &aggregate_values,
+                        storage::AbstractTable *output_table,
+                        const AbstractTuple *delegate_tuple,
+                        executor::ExecutorContext *econtext) {
   auto schema = output_table->GetSchema();
   std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
 
   /*
-   * 1) Construct a vector of aggregated values
-   */
-  std::vector<type::Value> aggregate_values;
-  auto &aggregate_terms = node->GetUniqueAggTerms();
-  for (oid_t column_itr = 0; column_itr < aggregate_terms.size();
-       column_itr++) {
-    if (aggregates[column_itr] != nullptr) {
-      type::Value final_val = aggregates[column_itr]->Finalize();
-      aggregate_values.push_back(final_val);
-    }
-  }
-
-  /*
-   * 2) Evaluate filter predicate;
+   * 1) Evaluate filter predicate;
    * if fail, just return
    */
   std::unique_ptr<expression::ContainerTuple<std::vector<type::Value>>>
@@ -127,7 +114,7 @@ bool Helper(const planner::AggregatePlan *node, AbstractAttributeAggregator **ag
   }
 
   /*
-   * 3) Construct the tuple to insert using projectInfo
+   * 2) Construct the tuple to insert using projectInfo
    */
   node->GetProjectInfo()->Evaluate(tuple.get(), delegate_tuple,
                                    aggref_tuple.get(), econtext);
@@ -147,6 +134,45 @@ bool Helper(const planner::AggregatePlan *node, AbstractAttributeAggregator **ag
   return true;
 }
 
+/*
+ * Helper method responsible for inserting the results of the aggregation
+ * into a new tuple in the output tile group as well as passing through any
+ * additional columns from the input tile group.
+ *
+ * Output tuple is projected from two tuples:
+ * Left is the 'delegate' tuple, which is usually the first tuple in the group,
+ * used to retrieve pass-through values;
+ * Right is the tuple holding all aggregated values.
+ */
+bool Helper(const planner::AggregatePlan *node, AbstractAttributeAggregator **aggregates,
+            storage::AbstractTable *output_table,
+            const AbstractTuple *delegate_tuple,
+            executor::ExecutorContext *econtext) {
+  // Construct a vector of aggregated values
+  std::vector<type::Value> aggregate_values;
+  auto &aggregate_terms = node->GetUniqueAggTerms();
+  for (oid_t column_itr = 0; column_itr < aggregate_terms.size();
+       column_itr++) {
+    if (aggregates[column_itr] != nullptr) {
+      type::Value final_val = aggregates[column_itr]->Finalize();
+      aggregate_values.push_back(final_val);
+    }
+  }
+
+  return OutputGroup(node, aggregate_values, output_table, delegate_tuple,
+                     econtext);
+}
+
+bool AbstractAggregator::AdvanceTile(std::unique_ptr<LogicalTile> tile) {
+  for (oid_t tuple_id : *tile) {
+    expression::ContainerTuple<LogicalTile> cur_tuple(tile.get(), tuple_id);
+    if (Advance(&cur_tuple) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // Hash Aggregator
 //===--------------------------------------------------------------------===//
@@ -160,7 +186,9 @@ HashAggregator::HashAggregator(const planner::AggregatePlan *node,
 //      type::ValueFactory::GetNullValueByType(type::Type::INTEGER));
 //}
 
-HashAggregator::~HashAggregator() {
+HashAggregator::~HashAggregator() { ClearGroups(); }
+
+void HashAggregator::ClearGroups() {
   for (auto entry : aggregates_map) {
     // Clean up allocated storage
     for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
@@ -169,6 +197,63 @@ HashAggregator::~HashAggregator() {
     delete[] entry.second->aggregates;
     delete entry.second;
   }
+  aggregates_map.clear();
+  memory_usage_ = 0;
+}
+
+// Memory used by a value, including its variable length data
+static size_t GetValueSize(const type::Value &value) {
+  size_t size = sizeof(type::Value);
+  if ((value.GetTypeId() == type::Type::VARCHAR ||
+       value.GetTypeId() == type::Type::VARBINARY) &&
+      value.IsNull() == false) {
+    size += value.GetLength();
+  }
+  return size;
+}
+
+size_t HashAggregator::GetGroupSize(const AggregateList *aggregate_list) const {
+  // The hash table node, the aggregate list and the aggregates
+  size_t size = 4 * sizeof(void *) + sizeof(AggregateList) +
+                node->GetUniqueAggTerms().size() *
+                    (sizeof(AbstractAttributeAggregator *) +
+                     sizeof(AbstractAttributeAggregator) + sizeof(type::Value));
+  for (auto &value : group_by_key_values) {
+    size += GetValueSize(value);
+  }
+  for (auto &value : aggregate_list->first_tuple_values) {
+    size += GetValueSize(value);
+  }
+  return size;
+}
+
+void HashAggregator::SpillTuple(AbstractTuple *tuple) {
+  if (spill_partitions_.empty() == true) {
+    LOG_TRACE("Spilling new groups after %lu groups (%lu bytes) at level %lu",
+              aggregates_map.size(), memory_usage_, spill_level_);
+    spill_partitions_.resize(1 << HASH_AGGREGATE_SPILL_PARTITION_BITS);
+  }
+
+  // Spread the bits of the group key hash over the whole word, and take the
+  // next unused ones for the partition (the MurmurHash3 finalizer)
+  uint64_t hash = ValueVectorHasher()(group_by_key_values);
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  hash >>= spill_level_ * HASH_AGGREGATE_SPILL_PARTITION_BITS;
+  size_t partition = hash & (spill_partitions_.size() - 1);
+
+  if (spill_partitions_[partition] == nullptr) {
+    spill_partitions_[partition].reset(new SpillFile());
+  }
+
+  std::vector<type::Value> values;
+  for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
+    values.push_back(tuple->GetValue(col_id));
+  }
+  spill_partitions_[partition]->Append(values);
 }
 
 bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
@@ -187,6 +272,16 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
 
   // Group not found. Make a new entry in the hash for this new group.
   if (map_itr == aggregates_map.end()) {
+    // Once the groups exceed the memory budget, the tuples of new groups are
+    // set aside and aggregated after the groups in memory
+    if (spill_partitions_.empty() == false ||
+        (executor_context != nullptr &&
+         memory_usage_ > executor_context->GetMemoryBudget() &&
+         spill_level_ < HASH_AGGREGATE_MAX_SPILL_LEVEL)) {
+      SpillTuple(cur_tuple);
+      return true;
+    }
+
     LOG_TRACE("Group-by key not found. Start a new group.");
     // Allocate new aggregate list
     aggregate_list = new AggregateList();
@@ -205,6 +300,7 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
       aggregate_list->aggregates[aggno]->SetDistinct(distinct);
     }
 
+    memory_usage_ += GetGroupSize(aggregate_list);
     aggregates_map.insert(
         HashAggregateMapType::value_type(group_by_key_values, aggregate_list));
   }
@@ -238,9 +334,347 @@ bool HashAggregator::Finalize() {
       return false;
     }
   }
+  ClearGroups();
+
+  // Aggregate the spilled partitions one at a time. The groups of a
+  // partition that still do not fit are partitioned again.
+  auto spill_partitions = std::move(spill_partitions_);
+  spill_partitions_.clear();
+  size_t spill_level = spill_level_;
+
+  std::vector<type::Value> values;
+  expression::ContainerTuple<std::vector<type::Value>> tuple(&values);
+  for (auto &spill_partition : spill_partitions) {
+    if (spill_partition == nullptr) {
+      continue;
+    }
+    LOG_TRACE("Aggregating %lu spilled tuples at level %lu",
+              spill_partition->GetRowCount(), spill_level + 1);
+
+    spill_level_ = spill_level + 1;
+    spill_partition->Rewind();
+    while (spill_partition->Next(values) == true) {
+      if (Advance(&tuple) == false) {
+        return false;
+      }
+    }
+    spill_partition.reset();
+
+    if (Finalize() == false) {
+      return false;
+    }
+  }
+  spill_level_ = spill_level;
+
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Flat Hash Aggregator
+//===--------------------------------------------------------------------===//
+
+// Type of a column of the tile
+static type::Type::TypeId GetColumnType(LogicalTile *tile,
+                                        const oid_t &column_id) {
+  auto &column_info = tile->GetColumnInfo(column_id);
+  return column_info.base_tile->GetSchema()->GetType(
+      column_info.origin_column_id);
+}
+
+// Input column read by an aggregate, or INVALID_OID if its argument is not
+// a column of the input tuple
+static oid_t GetArgumentColumn(const planner::AggregatePlan::AggTerm &term,
+                               LogicalTile *tile) {
+  auto expression = term.expression;
+  if (expression == nullptr ||
+      expression->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    return INVALID_OID;
+  }
+  auto tuple_value =
+      static_cast<const expression::TupleValueExpression *>(expression);
+  if (tuple_value->GetTupleId() != 0 ||
+      (size_t)tuple_value->GetColumnId() >= tile->GetColumnCount()) {
+    return INVALID_OID;
+  }
+  return tuple_value->GetColumnId();
+}
+
+// Whether the expression only reads the columns of the input tuple in the set
+static bool ReadsOnlyColumns(const expression::AbstractExpression *expression,
+                             const std::set<oid_t> &column_ids) {
+  if (expression == nullptr) {
+    return true;
+  }
+  if (expression->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    auto tuple_value =
+        static_cast<const expression::TupleValueExpression *>(expression);
+    if (tuple_value->GetTupleId() == 0 &&
+        column_ids.count(tuple_value->GetColumnId()) == 0) {
+      return false;
+    }
+  }
+  for (size_t child_itr = 0; child_itr < expression->GetChildrenSize();
+       child_itr++) {
+    if (ReadsOnlyColumns(expression->GetChild(child_itr), column_ids) ==
+        false) {
+      return false;
+    }
+  }
   return true;
 }
 
+bool FlatHashAggregator::IsSupported(const planner::AggregatePlan *node,
+                                     LogicalTile *tile) {
+  auto &group_by_col_ids = node->GetGroupbyColIds();
+  if (group_by_col_ids.empty() || group_by_col_ids.size() >= 64) {
+    return false;
+  }
+  for (auto column_id : group_by_col_ids) {
+    if (column_id >= tile->GetColumnCount() ||
+        AggregateHashTable::IsFixedWidthKey(GetColumnType(tile, column_id)) ==
+            false) {
+      return false;
+    }
+  }
+
+  for (auto &term : node->GetUniqueAggTerms()) {
+    if (term.distinct) {
+      return false;
+    }
+    oid_t column_id = GetArgumentColumn(term, tile);
+    switch (term.aggtype) {
+      case ExpressionType::AGGREGATE_COUNT_STAR:
+        break;
+      case ExpressionType::AGGREGATE_COUNT:
+        if (term.expression != nullptr && column_id == INVALID_OID) {
+          return false;
+        }
+        break;
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_AVG:
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX:
+        if (column_id == INVALID_OID ||
+            AggregateHashTable::IsIntegerArgument(
+                GetColumnType(tile, column_id)) == false) {
+          return false;
+        }
+        break;
+      default:
+        return false;
+    }
+  }
+
+  // The groups only keep their keys, not the first tuple of the group
+  std::set<oid_t> key_column_ids(group_by_col_ids.begin(),
+                                 group_by_col_ids.end());
+  if (ReadsOnlyColumns(node->GetPredicate(), key_column_ids) == false) {
+    return false;
+  }
+  auto project_info = node->GetProjectInfo();
+  for (auto &target : project_info->GetTargetList()) {
+    if (ReadsOnlyColumns(target.second.expr, key_column_ids) == false) {
+      return false;
+    }
+  }
+  for (auto &direct_map : project_info->GetDirectMapList()) {
+    if (direct_map.second.first == 0 &&
+        key_column_ids.count(direct_map.second.second) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+FlatHashAggregator::FlatHashAggregator(const planner::AggregatePlan *node,
+                                       storage::AbstractTable *output_table,
+                                       executor::ExecutorContext *econtext,
+                                       LogicalTile *tile)
+    : AbstractAggregator(node, output_table, econtext),
+      num_input_columns_(tile->GetColumnCount()) {
+  PL_ASSERT(IsSupported(node, tile));
+  for (auto column_id : node->GetGroupbyColIds()) {
+    key_types_.push_back(GetColumnType(tile, column_id));
+  }
+  for (auto &term : node->GetUniqueAggTerms()) {
+    oid_t column_id = GetArgumentColumn(term, tile);
+    argument_types_.push_back(column_id == INVALID_OID
+                                  ? type::Type::INVALID
+                                  : GetColumnType(tile, column_id));
+  }
+
+  tables_.emplace_back(CreateTable(GetMemoryBudget()));
+}
+
+FlatHashAggregator::~FlatHashAggregator() {
+  if (tile_queue_ != nullptr) {
+    tile_queue_->Close();
+    worker_group_.Join();
+  }
+}
+
+size_t FlatHashAggregator::GetMemoryBudget() const {
+  if (executor_context == nullptr) {
+    return SIZE_MAX;
+  }
+  return executor_context->GetMemoryBudget();
+}
+
+AggregateHashTable *FlatHashAggregator::CreateTable(
+    size_t memory_budget) const {
+  std::vector<AggregateHashTable::Aggregate> aggregates;
+  auto &aggregate_terms = node->GetUniqueAggTerms();
+  for (size_t aggno = 0; aggno < aggregate_terms.size(); aggno++) {
+    oid_t column_id = INVALID_OID;
+    if (argument_types_[aggno] != type::Type::INVALID) {
+      column_id =
+          static_cast<const expression::TupleValueExpression *>(
+              aggregate_terms[aggno].expression)->GetColumnId();
+    }
+    aggregates.push_back(
+        {aggregate_terms[aggno].aggtype, column_id, argument_types_[aggno]});
+  }
+
+  return new AggregateHashTable(node->GetGroupbyColIds(), key_types_,
+                                aggregates, memory_budget);
+}
+
+bool FlatHashAggregator::Advance(AbstractTuple *next_tuple) {
+  tables_[0]->Advance(next_tuple);
+  return true;
+}
+
+bool FlatHashAggregator::AdvanceTile(std::unique_ptr<LogicalTile> tile) {
+  if (tile_queue_ != nullptr) {
+    if (tile_queue_->TryEnqueue(tile) == true) {
+      return true;
+    }
+
+    // the queue is only closed after an error of a worker
+    if (tile_queue_->IsClosed() == true) {
+      StopWorkers();
+      return true;
+    }
+
+    // the calling thread aggregates the tiles the workers have no room for,
+    // as the pool may be busy with other queries
+    AggregateTile(tables_[0].get(), tile.get());
+    return true;
+  }
+
+  AggregateTile(tables_[0].get(), tile.get());
+
+  tile_count_++;
+  tuple_count_ += tile->GetTupleCount();
+  if (tile_count_ >= HASH_AGGREGATE_PARALLEL_MIN_TILE_COUNT &&
+      tuple_count_ >= HASH_AGGREGATE_PARALLEL_MIN_TUPLE_COUNT &&
+      WorkerPool::GetInstance().GetWorkerCount() > 0) {
+    StartWorkers();
+  }
+  return true;
+}
+
+void FlatHashAggregator::AggregateTile(AggregateHashTable *table,
+                                       LogicalTile *tile) {
+  for (oid_t tuple_id : *tile) {
+    expression::ContainerTuple<LogicalTile> cur_tuple(tile, tuple_id);
+    table->Advance(&cur_tuple);
+  }
+}
+
+void FlatHashAggregator::StartWorkers() {
+  // the calling thread keeps producing the tiles
+  size_t worker_count =
+      std::min<size_t>(WorkerPool::GetInstance().GetWorkerCount(),
+                       tuple_count_ / HASH_AGGREGATE_TUPLE_COUNT_PER_WORKER);
+  size_t memory_budget = GetMemoryBudget() / (worker_count + 1);
+  tables_[0]->SetMemoryBudget(memory_budget);
+
+  error_ = nullptr;
+  tile_queue_.reset(new BoundedQueue<std::unique_ptr<LogicalTile>>(
+      worker_count * HASH_AGGREGATE_QUEUE_SIZE_PER_WORKER, 1));
+  for (size_t worker_itr = 0; worker_itr < worker_count; worker_itr++) {
+    tables_.emplace_back(CreateTable(memory_budget));
+  }
+  worker_group_.Start(worker_count, [this](size_t worker_id) {
+    AggregateTiles(tables_[worker_id + 1].get());
+  });
+
+  LOG_TRACE("Aggregating tiles with %lu workers", worker_count);
+}
+
+void FlatHashAggregator::StopWorkers() {
+  if (tile_queue_ == nullptr) {
+    return;
+  }
+
+  // the calling thread aggregates the tiles left by the workers that did not
+  // get a thread of the pool
+  tile_queue_->FinishProducing();
+  std::unique_ptr<LogicalTile> tile;
+  while (tile_queue_->Dequeue(tile) == true) {
+    AggregateTile(tables_[0].get(), tile.get());
+    tile.reset();
+  }
+  worker_group_.Join();
+  tile_queue_.reset();
+
+  if (error_ != nullptr) {
+    auto error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void FlatHashAggregator::AggregateTiles(AggregateHashTable *table) {
+  try {
+    std::unique_ptr<LogicalTile> tile;
+    while (tile_queue_->Dequeue(tile) == true) {
+      AggregateTile(table, tile.get());
+      tile.reset();
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(error_mutex_);
+      if (error_ == nullptr) {
+        error_ = std::current_exception();
+      }
+    }
+    tile_queue_->Close();
+  }
+}
+
+bool FlatHashAggregator::Finalize() {
+  StopWorkers();
+
+  // Merge the partial aggregates of the workers
+  auto &table = tables_[0];
+  for (size_t table_itr = 1; table_itr < tables_.size(); table_itr++) {
+    table->Merge(*tables_[table_itr]);
+  }
+  tables_.resize(1);
+  table->SetMemoryBudget(GetMemoryBudget());
+
+  // The delegate tuple of a group only holds its keys, which are the only
+  // input columns of the output
+  std::vector<type::Value> delegate_values(
+      num_input_columns_,
+      type::ValueFactory::GetNullValueByType(type::Type::INTEGER));
+  expression::ContainerTuple<std::vector<type::Value>> delegate_tuple(
+      &delegate_values);
+  auto &group_by_col_ids = node->GetGroupbyColIds();
+
+  return table->Finalize([&](const std::vector<type::Value> &key_values,
+                             const std::vector<type::Value> &aggregate_values) {
+    for (size_t key_itr = 0; key_itr < group_by_col_ids.size(); key_itr++) {
+      delegate_values[group_by_col_ids[key_itr]] = key_values[key_itr];
+    }
+    std::vector<type::Value> values(aggregate_values);
+    return OutputGroup(node, values, output_table, &delegate_tuple,
+                       executor_context);
+  });
+}
+
 //===--------------------------------------------------------------------===//
 // Sort Aggregator
 //===--------------------------------------------------------------------===//
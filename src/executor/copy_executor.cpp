@@ -17,9 +17,12 @@
 #include "common/logger.h"
 #include "catalog/catalog.h"
 #include "executor/copy_executor.h"
+#include "executor/csv_loader.h"
 #include "executor/executor_context.h"
 #include "executor/logical_tile_factory.h"
+#include "executor/table_exporter.h"
 #include "planner/copy_plan.h"
+#include "storage/data_table.h"
 #include "storage/table_factory.h"
 #include "common/exception.h"
 #include "common/macros.h"
@@ -44,11 +47,30 @@ CopyExecutor::~CopyExecutor() {}
  * @return true on success, false otherwise.
  */
 bool CopyExecutor::DInit() {
-  PL_ASSERT(children_.size() == 1);
-
   // Grab info from plan node and check it
   const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
 
+  // COPY FROM reads the file itself
+  if (node.is_from) {
+    PL_ASSERT(children_.size() == 0);
+    if (node.target_table == nullptr) {
+      throw ExecutorException("Target table of COPY FROM does not exist");
+    }
+    return true;
+  }
+
+  // Parallel COPY TO scans the table itself
+  if (node.copy_type == CopyType::EXPORT_CSV ||
+      node.copy_type == CopyType::EXPORT_BINARY) {
+    PL_ASSERT(children_.size() == 0);
+    if (node.target_table == nullptr) {
+      throw ExecutorException("Source table of COPY TO does not exist");
+    }
+    return true;
+  }
+
+  PL_ASSERT(children_.size() == 1);
+
   bool success = InitFileHandle(node.file_path.c_str(), "w");
 
   if (success == false) {
@@ -189,6 +211,36 @@ bool CopyExecutor::DExecute() {
     return false;
   }
 
+  const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
+  if (node.is_from) {
+    auto current_txn = executor_context_->GetTransaction();
+    CsvLoader loader(node.target_table, node.delimiter);
+    try {
+      total_tuples_loaded = loader.Load(node.file_path, current_txn);
+    } catch (...) {
+      // a malformed row or a constraint violation fails the statement, and
+      // the rows loaded up to then are dropped with the transaction
+      concurrency::TransactionManagerFactory::GetInstance()
+          .SetTransactionResult(current_txn, ResultType::FAILURE);
+      throw;
+    }
+    LOG_INFO("Loaded %lu tuples into %s", total_tuples_loaded,
+             node.target_table->GetName().c_str());
+    done = true;
+    return true;
+  }
+
+  if (node.copy_type == CopyType::EXPORT_CSV ||
+      node.copy_type == CopyType::EXPORT_BINARY) {
+    TableExporter exporter(node.target_table, node.copy_type, node.delimiter);
+    total_bytes_written = exporter.Export(
+        node.file_path, executor_context_->GetTransaction());
+    LOG_INFO("Exported %lu tuples of %s", exporter.GetExportedTupleCount(),
+             node.target_table->GetName().c_str());
+    done = true;
+    return true;
+  }
+
   while (children_[0]->Execute() == true) {
     // Get input a tile
     std::unique_ptr<LogicalTile> logical_tile(children_[0]->GetOutput());
@@ -0,0 +1,371 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// csv_loader.cpp
+//
+// Identification: src/executor/csv_loader.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/csv_loader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/worker_pool.h"
+#include "storage/data_table.h"
+#include "storage/tuple.h"
+#include "type/arena_pool.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace executor {
+
+// Position of the first occurrence of the character, or the end
+static const char *FindCharacter(const char *position, const char *end,
+                                 char character) {
+  auto location = static_cast<const char *>(
+      memchr(position, character, end - position));
+  return (location == nullptr) ? end : location;
+}
+
+CsvLoader::CsvLoader(storage::DataTable *table, char delimiter,
+                     size_t chunk_size)
+    : table_(table),
+      delimiter_(delimiter),
+      chunk_size_(chunk_size),
+      loaded_tuple_count_(0),
+      has_error_(false) {}
+
+size_t CsvLoader::Load(const std::string &file_path,
+                       concurrency::Transaction *transaction) {
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw ExecutorException("Failed to open file " + file_path +
+                            ". Try absolute path and make sure you have the "
+                            "permission to access this file.");
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    throw ExecutorException("Failed to stat file " + file_path);
+  }
+
+  size_t size = file_stat.st_size;
+  if (size == 0) {
+    close(fd);
+    return 0;
+  }
+
+  void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw ExecutorException("Failed to map file " + file_path + " (" +
+                            strerror(errno) + ")");
+  }
+
+  // each chunk is read front to back
+  madvise(data, size, MADV_SEQUENTIAL);
+
+  size_t loaded_tuple_count = 0;
+  try {
+    loaded_tuple_count =
+        Load(static_cast<const char *>(data), size, transaction);
+  } catch (...) {
+    munmap(data, size);
+    throw;
+  }
+
+  munmap(data, size);
+
+  LOG_DEBUG("Loaded %lu tuples from %s", loaded_tuple_count,
+            file_path.c_str());
+  return loaded_tuple_count;
+}
+
+size_t CsvLoader::Load(const char *data, size_t size,
+                       concurrency::Transaction *transaction) {
+  chunks_.clear();
+  loaded_tuple_count_ = 0;
+  has_error_ = false;
+
+  SplitChunks(data, size);
+
+  // the first error stops the chunks being loaded, and is rethrown
+  WorkerPool::GetInstance().RunTasks(chunks_.size(), [&](size_t chunk_id) {
+    if (has_error_ == true) {
+      return;
+    }
+    try {
+      LoadChunk(chunks_[chunk_id], transaction);
+    } catch (...) {
+      has_error_ = true;
+      throw;
+    }
+  });
+
+  LOG_TRACE("Loaded %lu chunks", chunks_.size());
+  return loaded_tuple_count_;
+}
+
+void CsvLoader::SplitChunks(const char *data, size_t size) {
+  data_begin_ = data;
+  data_end_ = data + size;
+
+  for (size_t offset = 0; offset < size; offset += chunk_size_) {
+    chunks_.push_back(
+        {data + offset, data + std::min(offset + chunk_size_, size), false});
+  }
+
+  // every quote enters or leaves a quoted part, a doubled one included, so a
+  // chunk starts inside one after an odd number of quotes
+  std::vector<size_t> quote_counts(chunks_.size());
+  WorkerPool::GetInstance().RunTasks(chunks_.size(), [&](size_t chunk_id) {
+    quote_counts[chunk_id] =
+        CountQuotes(chunks_[chunk_id].begin, chunks_[chunk_id].end);
+  });
+
+  for (size_t chunk_id = 1; chunk_id < chunks_.size(); chunk_id++) {
+    bool is_odd = (quote_counts[chunk_id - 1] % 2 == 1);
+    chunks_[chunk_id].in_quotes = (chunks_[chunk_id - 1].in_quotes != is_odd);
+  }
+}
+
+const char *CsvLoader::FindRowStart(const Chunk &chunk) const {
+  const char *position = chunk.begin;
+  bool in_quotes = chunk.in_quotes;
+  if (position == data_begin_) {
+    return position;
+  }
+
+  // a row starts after a line feed, or a carriage return without one
+  if (in_quotes == false &&
+      (position[-1] == '\n' || (position[-1] == '\r' && *position != '\n'))) {
+    return position;
+  }
+
+  while (position < data_end_) {
+    if (in_quotes == true) {
+      position = FindCharacter(position, data_end_, '"');
+      if (position == data_end_) {
+        break;
+      }
+      position++;
+      in_quotes = false;
+      continue;
+    }
+
+    position = FindSpecialCharacter(position, data_end_);
+    if (position == data_end_) {
+      break;
+    }
+
+    char character = *position++;
+    if (character == '"') {
+      in_quotes = true;
+    } else if (character == '\n') {
+      return position;
+    } else if (character == '\r') {
+      if (position < data_end_ && *position == '\n') {
+        position++;
+      }
+      return position;
+    }
+  }
+
+  return data_end_;
+}
+
+void CsvLoader::LoadChunk(const Chunk &chunk,
+                          concurrency::Transaction *transaction) {
+  auto schema = table_->GetSchema();
+  size_t batch_size = table_->GetTuplesPerTileGroup();
+
+  // the varlen values of a batch are dropped after it is copied into the table
+  std::unique_ptr<type::ArenaPool> pool(new type::ArenaPool());
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  tuples.reserve(batch_size);
+
+  // the chunk loads the rows that start in it, up to their end
+  const char *position = FindRowStart(chunk);
+  while (position < chunk.end && has_error_ == false) {
+    std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+    position = ParseRow(position, data_end_, tuple.get(), pool.get());
+    tuples.push_back(std::move(tuple));
+
+    if (tuples.size() == batch_size) {
+      table_->BulkLoadTuples(tuples, transaction);
+      loaded_tuple_count_ += tuples.size();
+      tuples.clear();
+      pool.reset(new type::ArenaPool());
+    }
+  }
+
+  if (tuples.empty() == false && has_error_ == false) {
+    table_->BulkLoadTuples(tuples, transaction);
+    loaded_tuple_count_ += tuples.size();
+  }
+}
+
+const char *CsvLoader::ParseRow(const char *position, const char *end,
+                                storage::Tuple *tuple,
+                                type::AbstractPool *pool) {
+  auto schema = table_->GetSchema();
+  oid_t column_count = schema->GetColumnCount();
+  oid_t column_id = 0;
+  std::string field;
+
+  while (true) {
+    field.clear();
+
+    // a quote starts a quoted part anywhere in the field
+    bool is_quoted = false;
+    while (true) {
+      const char *part_end = FindSpecialCharacter(position, end);
+      field.append(position, part_end - position);
+      position = part_end;
+      if (position == end || *position != '"') {
+        break;
+      }
+
+      is_quoted = true;
+      position++;
+      while (true) {
+        auto quote = FindCharacter(position, end, '"');
+        if (quote == end) {
+          throw ExecutorException("Unterminated CSV quoted field");
+        }
+        field.append(position, quote - position);
+        position = quote + 1;
+
+        // a doubled quote stands for one quote
+        if (position < end && *position == '"') {
+          field.push_back('"');
+          position++;
+        } else {
+          break;
+        }
+      }
+    }
+
+    if (column_id == column_count) {
+      throw ExecutorException("Extra data after last expected column");
+    }
+
+    bool is_null = (is_quoted == false && field.empty() == true);
+    tuple->SetValue(column_id, ParseValue(column_id, field, is_null), pool);
+    column_id++;
+
+    if (position < end && *position == delimiter_) {
+      position++;
+      continue;
+    }
+
+    // end of the row
+    if (position < end && *position == '\r') {
+      position++;
+    }
+    if (position < end && *position == '\n') {
+      position++;
+    }
+    break;
+  }
+
+  if (column_id < column_count) {
+    throw ExecutorException("Missing data for column " +
+                            schema->GetColumn(column_id).GetName());
+  }
+
+  return position;
+}
+
+type::Value CsvLoader::ParseValue(const oid_t &column_id,
+                                  const std::string &field,
+                                  bool is_null) const {
+  auto type_id = table_->GetSchema()->GetType(column_id);
+  if (is_null == true) {
+    return type::ValueFactory::GetNullValueByType(type_id);
+  }
+
+  auto value = type::ValueFactory::GetVarcharValue(field);
+  if (type_id == type::Type::VARCHAR) {
+    return value;
+  }
+
+  // the casts throw on malformed text, e.g. through std::stoi
+  try {
+    return value.CastAs(type_id);
+  } catch (std::exception &e) {
+    throw ExecutorException(
+        "Invalid input for column " +
+        table_->GetSchema()->GetColumn(column_id).GetName() + ": \"" + field +
+        "\"");
+  }
+}
+
+const char *CsvLoader::FindSpecialCharacter(const char *position,
+                                            const char *end) const {
+#ifdef __SSE2__
+  // compare 16 characters at a time against all special characters
+  const __m128i delimiters = _mm_set1_epi8(delimiter_);
+  const __m128i quotes = _mm_set1_epi8('"');
+  const __m128i line_feeds = _mm_set1_epi8('\n');
+  const __m128i carriage_returns = _mm_set1_epi8('\r');
+
+  while (end - position >= 16) {
+    __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(position));
+    __m128i matches = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(block, delimiters),
+                     _mm_cmpeq_epi8(block, quotes)),
+        _mm_or_si128(_mm_cmpeq_epi8(block, line_feeds),
+                     _mm_cmpeq_epi8(block, carriage_returns)));
+    int mask = _mm_movemask_epi8(matches);
+    if (mask != 0) {
+      return position + __builtin_ctz(mask);
+    }
+    position += 16;
+  }
+#endif
+
+  while (position < end && IsSpecialCharacter(*position) == false) {
+    position++;
+  }
+  return position;
+}
+
+size_t CsvLoader::CountQuotes(const char *position, const char *end) const {
+  size_t quote_count = 0;
+
+#ifdef __SSE2__
+  const __m128i quotes = _mm_set1_epi8('"');
+  while (end - position >= 16) {
+    __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(position));
+    quote_count +=
+        __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(block, quotes)));
+    position += 16;
+  }
+#endif
+
+  quote_count += std::count(position, end, '"');
+  return quote_count;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -21,6 +21,7 @@
 #include "common/logger.h"
 #include "executor/logical_tile.h"
 #include "storage/data_table.h"
+#include "storage/delta_storage.h"
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
@@ -102,6 +103,20 @@ bool DeleteExecutor::DExecute() {
     LOG_TRACE("Visible Tuple id : %u, Physical Tuple id : %u ",
               visible_tuple_id, physical_tuple_id);
 
+    // the scan may have handed over a copy of a delta-stored tuple.
+    // the tuple it was copied from is the one to delete.
+    if (storage::DeltaStorage::IsMaterializedVersion(tile_group_header,
+                                                     physical_tuple_id)) {
+      old_location = storage::DeltaStorage::GetOrigin(tile_group_header,
+                                                      physical_tuple_id);
+
+      auto &manager = catalog::Manager::GetInstance();
+      tile_group = manager.GetTileGroup(old_location.block).get();
+      tile_group_header = tile_group->GetHeader();
+
+      physical_tuple_id = old_location.offset;
+    }
+
     // if running at snapshot isolation, 
     // then we need to retrieve the latest version of this tuple.
     if (current_txn->GetIsolationLevel() == IsolationLevelType::SNAPSHOT) {
@@ -14,17 +14,22 @@
 #include "type/value.h"
 #include "executor/executor_context.h"
 #include "concurrency/transaction.h"
+#include "configuration/configuration.h"
 
 namespace peloton {
 namespace executor {
 
 ExecutorContext::ExecutorContext(concurrency::Transaction *transaction)
-    : transaction_(transaction) {}
+    : transaction_(transaction),
+      memory_budget_(FLAGS_work_mem * 1024),
+      late_materialization_(FLAGS_late_materialization) {}
 
 ExecutorContext::ExecutorContext(concurrency::Transaction *transaction,
                                  const std::vector<type::Value> &params)
     : transaction_(transaction),
-      params_(params) {}
+      params_(params),
+      memory_budget_(FLAGS_work_mem * 1024),
+      late_materialization_(FLAGS_late_materialization) {}
 
 ExecutorContext::~ExecutorContext() {
   // params will be freed automatically
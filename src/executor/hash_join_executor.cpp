@@ -15,6 +15,8 @@
 
 #include "type/types.h"
 #include "common/logger.h"
+#include "executor/abstract_scan_executor.h"
+#include "executor/bloom_filter.h"
 #include "executor/logical_tile_factory.h"
 #include "executor/hash_join_executor.h"
 #include "expression/abstract_expression.h"
@@ -78,100 +80,55 @@ bool HashJoinExecutor::DExecute() {
         BufferRightTile(children_[1]->GetOutput());
       }
       right_child_done_ = true;
+      PushDownBloomFilter();
     }
 
-    // Get next tile from LEFT child
-    if (children_[0]->Execute() == false) {
+    // Get the next batch of tiles from LEFT child
+    std::vector<LogicalTile *> left_tiles;
+    size_t left_tuple_count = 0;
+    while (left_tuple_count < HASH_JOIN_PROBE_BATCH_SIZE) {
+      // An exhausted left child is never executed again
+      if (children_[0]->Execute() == false) {
+        left_child_done_ = true;
+        break;
+      }
+      LogicalTile *left_tile = children_[0]->GetOutput();
+      BufferLeftTile(left_tile);
+      left_tiles.push_back(left_tile);
+      left_tuple_count += left_tile->GetTupleCount();
+    }
+
+    if (left_tiles.empty() == true) {
       LOG_TRACE("Did not get left tile \n");
-      left_child_done_ = true;
       continue;
     }
+    LOG_TRACE("Got %lu left tiles \n", left_tiles.size());
 
-    BufferLeftTile(children_[0]->GetOutput());
-    LOG_TRACE("Got left tile \n");
-
-    if (right_result_tiles_.size() == 0) {
+    // Without right tiles, only an anti join has output
+    if (right_result_tiles_.size() == 0 && join_type_ != JoinType::ANTI) {
       LOG_TRACE("Did not get any right tiles \n");
       return BuildOuterJoinOutput();
     }
 
-    LogicalTile *left_tile = left_result_tiles_.back().get();
-
     //===------------------------------------------------------------------===//
     // Build Join Tile
     //===------------------------------------------------------------------===//
 
-    // Get the hash table from the hash executor
-    auto &hash_table = hash_executor_->GetHashTable();
-    auto &hashed_col_ids = hash_executor_->GetHashKeyIds();
-
-    oid_t prev_tile = INVALID_OID;
-    std::unique_ptr<LogicalTile> output_tile;
-    LogicalTile::PositionListsBuilder pos_lists_builder;
-
-    // Go over the left tile
-    for (auto left_tile_itr : *left_tile) {
-      const expression::ContainerTuple<executor::LogicalTile> left_tuple(
-          left_tile, left_tile_itr, &hashed_col_ids);
-
-      // Find matching tuples in the hash table built on top of the right table
-      auto right_tuples = hash_table.find(left_tuple);
-
-      if (right_tuples != hash_table.end()) {
-    	// Not yet supported due to assertion in gettomg right_tuples->first
-//    	if (predicate_ != nullptr) {
-//    		auto eval = predicate_->Evaluate(&left_tuple, &right_tuples->first,
-//					executor_context_);
-//			if (eval.IsFalse())
-//				continue;
-//    	}
-
-        RecordMatchedLeftRow(left_result_tiles_.size() - 1, left_tile_itr);
-
-        // Go over the matching right tuples
-        for (auto &location : right_tuples->second) {
-          // Check if we got a new right tile itr
-          if (prev_tile != location.first) {
-            // Check if we have any join tuples
-            if (pos_lists_builder.Size() > 0) {
-              LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
-              output_tile->SetPositionListsAndVisibility(
-                  pos_lists_builder.Release());
-              buffered_output_tiles.push_back(output_tile.release());
-            }
-
-            // Get the logical tile from right child
-            LogicalTile *right_tile = right_result_tiles_[location.first].get();
-
-            // Build output logical tile
-            output_tile = BuildOutputLogicalTile(left_tile, right_tile);
-
-            // Build position lists
-            pos_lists_builder =
-                LogicalTile::PositionListsBuilder(left_tile, right_tile);
-
-            pos_lists_builder.SetRightSource(
-                &right_result_tiles_[location.first]->GetPositionLists());
-          }
-
-          // Add join tuple
-          pos_lists_builder.AddRow(left_tile_itr, location.second);
-
-          RecordMatchedRightRow(location.first, location.second);
-
-          // Cache prev logical tile itr
-          prev_tile = location.first;
-        }
+    // Probe the hash table built on top of the right table with the whole
+    // batch at once
+    std::vector<std::vector<RadixHashTable::Match>> matches;
+    hash_executor_->GetHashTable().Probe(left_tiles, matches);
+
+    size_t first_left_tile_itr = left_result_tiles_.size() - left_tiles.size();
+    for (size_t batch_itr = 0; batch_itr < left_tiles.size(); batch_itr++) {
+      if (join_type_ == JoinType::SEMI || join_type_ == JoinType::ANTI) {
+        BuildSemiJoinTile(left_tiles[batch_itr], matches[batch_itr]);
+      } else {
+        BuildJoinTiles(left_tiles[batch_itr], first_left_tile_itr + batch_itr,
+                       matches[batch_itr]);
       }
     }
 
-    // Check if we have any join tuples
-    if (pos_lists_builder.Size() > 0) {
-      LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
-      output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
-      buffered_output_tiles.push_back(output_tile.release());
-    }
-
     // Check if we have any buffered output tiles
     if (buffered_output_tiles.empty() == false) {
       auto output_tile = buffered_output_tiles.front();
@@ -186,5 +143,123 @@ bool HashJoinExecutor::DExecute() {
   }
 }
 
+/**
+ * @brief Hands a bloom filter of the right keys to the left scan, when the
+ * left tuples without a match are not output, so that the scan drops most of
+ * them before they are materialized and probed.
+ */
+void HashJoinExecutor::PushDownBloomFilter() {
+  if (join_type_ != JoinType::INNER && join_type_ != JoinType::RIGHT &&
+      join_type_ != JoinType::SEMI) {
+    return;
+  }
+
+  auto &hash_table = hash_executor_->GetHashTable();
+  auto left_scan = dynamic_cast<AbstractScanExecutor *>(children_[0]);
+  if (left_scan == nullptr || hash_table.GetSize() == 0) {
+    return;
+  }
+
+  // The left keys are probed in the same columns as the right ones
+  left_scan->AddBloomFilter(hash_table.BuildBloomFilter(),
+                            hash_executor_->GetHashKeyIds());
+}
+
+/**
+ * @brief Buffers the join tiles of a left tile and its matching right tuples.
+ * A new output tile starts whenever the right tile changes.
+ */
+void HashJoinExecutor::BuildJoinTiles(
+    LogicalTile *left_tile, size_t left_tile_itr,
+    const std::vector<RadixHashTable::Match> &matches) {
+  oid_t prev_tile = INVALID_OID;
+  oid_t prev_left_row = INVALID_OID;
+  std::unique_ptr<LogicalTile> output_tile;
+  LogicalTile::PositionListsBuilder pos_lists_builder;
+
+  for (auto &match : matches) {
+    if (prev_left_row != match.probe_offset) {
+      RecordMatchedLeftRow(left_tile_itr, match.probe_offset);
+      prev_left_row = match.probe_offset;
+    }
+
+    // Check if we got a new right tile itr
+    auto &location = match.location;
+    if (prev_tile != location.tile_offset) {
+      // Check if we have any join tuples
+      if (pos_lists_builder.Size() > 0) {
+        LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
+        output_tile->SetPositionListsAndVisibility(
+            pos_lists_builder.Release());
+        buffered_output_tiles.push_back(output_tile.release());
+      }
+
+      // Get the logical tile from right child
+      LogicalTile *right_tile =
+          right_result_tiles_[location.tile_offset].get();
+
+      // Build output logical tile
+      output_tile = BuildOutputLogicalTile(left_tile, right_tile);
+
+      // Build position lists
+      pos_lists_builder =
+          LogicalTile::PositionListsBuilder(left_tile, right_tile);
+
+      pos_lists_builder.SetRightSource(
+          &right_result_tiles_[location.tile_offset]->GetPositionLists());
+    }
+
+    // Add join tuple
+    pos_lists_builder.AddRow(match.probe_offset, location.tuple_offset);
+
+    RecordMatchedRightRow(location.tile_offset, location.tuple_offset);
+
+    // Cache prev logical tile itr
+    prev_tile = location.tile_offset;
+  }
+
+  // Check if we have any join tuples
+  if (pos_lists_builder.Size() > 0) {
+    LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
+    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    buffered_output_tiles.push_back(output_tile.release());
+  }
+}
+
+/**
+ * @brief Buffers the tuples of a left tile that have a match for a semi join,
+ * or the ones that have none for an anti join. Each left tuple is output at
+ * most once, with the columns of the left tile only.
+ */
+void HashJoinExecutor::BuildSemiJoinTile(
+    LogicalTile *left_tile, const std::vector<RadixHashTable::Match> &matches) {
+  bool output_matched = (join_type_ == JoinType::SEMI);
+
+  std::unique_ptr<LogicalTile> output_tile =
+      BuildOutputLogicalTile(left_tile, nullptr, proj_schema_);
+  LogicalTile::PositionListsBuilder pos_lists_builder(
+      &left_tile->GetPositionLists(), nullptr);
+
+  // The matches come in the order of the left tuples
+  auto match_itr = matches.begin();
+  for (oid_t left_row : *left_tile) {
+    bool matched = false;
+    while (match_itr != matches.end() && match_itr->probe_offset == left_row) {
+      matched = true;
+      match_itr++;
+    }
+
+    if (matched == output_matched) {
+      pos_lists_builder.AddRightNullRow(left_row);
+    }
+  }
+
+  if (pos_lists_builder.Size() > 0) {
+    LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
+    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    buffered_output_tiles.push_back(output_tile.release());
+  }
+}
+
 }  // namespace executor
 }  // namespace peloton
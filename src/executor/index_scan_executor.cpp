@@ -12,6 +12,8 @@
 
 #include "executor/index_scan_executor.h"
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <utility>
@@ -29,6 +31,8 @@
 #include "index/index.h"
 #include "planner/index_scan_plan.h"
 #include "storage/data_table.h"
+#include "storage/delta_storage.h"
+#include "storage/delta_tuple.h"
 #include "storage/masked_tuple.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
@@ -47,7 +51,11 @@ IndexScanExecutor::IndexScanExecutor(const planner::AbstractPlan *node,
     : AbstractScanExecutor(node, executor_context) {}
 
 IndexScanExecutor::~IndexScanExecutor() {
-  // Nothing to do here
+  // the result tiles that were not returned may hold the last references to
+  // copies of tuples
+  for (oid_t tile_itr = result_itr_; tile_itr < result_.size(); tile_itr++) {
+    delete result_[tile_itr];
+  }
 }
 
 /**
@@ -88,6 +96,12 @@ bool IndexScanExecutor::DInit() {
   limit_number_ = node.GetLimitNumber();
   limit_offset_ = node.GetLimitOffset();
   descend_ = node.GetDescend();
+  key_ordered_ = node.GetKeyOrdered();
+  scan_cursor_.reset();
+
+  // only the primary index leads to a single version per entry
+  PL_ASSERT(key_ordered_ == false ||
+            index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY);
 
   if (runtime_keys_.size() != 0) {
     PL_ASSERT(runtime_keys_.size() == values_.size());
@@ -123,6 +137,16 @@ bool IndexScanExecutor::DInit() {
 bool IndexScanExecutor::DExecute() {
   LOG_TRACE("Index Scan executor :: 0 child");
 
+  // the index is read a batch at a time, and each batch yields a few tiles
+  if (key_ordered_ == true) {
+    while (result_itr_ >= result_.size()) {
+      if (ExecKeyOrderedLookup() == false) return false;
+    }
+    SetOutput(result_[result_itr_]);
+    result_itr_++;
+    return true;
+  }
+
   if (!done_) {
     if (index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
       auto status = ExecPrimaryIndexLookup();
@@ -155,10 +179,83 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   PL_ASSERT(!done_);
 
   std::vector<ItemPointer *> tuple_location_ptrs;
+  ScanPrimaryIndex(tuple_location_ptrs);
 
-  // Grab info from plan node
-  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
+  if (tuple_location_ptrs.size() == 0) {
+    LOG_TRACE("no tuple is retrieved from index.");
+    return false;
+  }
+
+  std::vector<ItemPointer> visible_tuple_locations;
+  if (ReadPrimaryIndexTuples(tuple_location_ptrs, visible_tuple_locations) ==
+      false) {
+    return false;
+  }
+
+  LOG_TRACE("%ld tuples before pruning boundaries",
+            visible_tuple_locations.size());
+
+  // Check whether the boundaries satisfy the required condition
+  CheckOpenRangeWithReturnedTuples(visible_tuple_locations);
+
+  LOG_TRACE("%ld tuples after pruning boundaries",
+            visible_tuple_locations.size());
+
+  BuildResultTiles(visible_tuple_locations);
+
+  done_ = true;
+
+  LOG_TRACE("Result tiles : %lu", result_.size());
+
+  return true;
+}
+
+/**
+ * @brief Reads the next batch of a key ordered scan from the index, and
+ * wraps its visible tuples in result tiles.
+ * @return false once the scan is over, or on failure.
+ */
+bool IndexScanExecutor::ExecKeyOrderedLookup() {
+  // the tiles of the previous batch have all been handed over
+  result_.clear();
+  result_itr_ = START_OID;
 
+  if (scan_cursor_ == nullptr) {
+    if (0 == key_column_ids_.size()) {
+      scan_cursor_ = index_->ScanAllKeysInBatches();
+    } else {
+      std::vector<ItemPointer *> tuple_location_ptrs;
+      ScanPrimaryIndex(tuple_location_ptrs);
+      CheckOpenRangeWithIndexEntries(tuple_location_ptrs);
+      scan_cursor_.reset(
+          new index::BufferedIndexScanCursor(std::move(tuple_location_ptrs)));
+    }
+  }
+
+  std::vector<ItemPointer> visible_tuple_locations;
+  while (visible_tuple_locations.empty() == true && done_ == false) {
+    std::vector<ItemPointer *> tuple_location_ptrs;
+    done_ = (scan_cursor_->Next(KEY_ORDERED_TILE_SIZE, tuple_location_ptrs) ==
+             false);
+    if (ReadPrimaryIndexTuples(tuple_location_ptrs,
+                               visible_tuple_locations) == false) {
+      return false;
+    }
+  }
+
+  if (visible_tuple_locations.empty() == true) {
+    return false;
+  }
+
+  BuildKeyOrderedTiles(visible_tuple_locations);
+
+  LOG_TRACE("Result tiles : %lu", result_.size());
+
+  return true;
+}
+
+void IndexScanExecutor::ScanPrimaryIndex(
+    std::vector<ItemPointer *> &tuple_location_ptrs) {
   PL_ASSERT(index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY);
 
   if (0 == key_column_ids_.size()) {
@@ -193,19 +290,23 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
 
     LOG_TRACE("tuple_location_ptrs:%lu", tuple_location_ptrs.size());
   }
+}
 
-  if (tuple_location_ptrs.size() == 0) {
-    LOG_TRACE("no tuple is retrieved from index.");
-    return false;
-  }
+bool IndexScanExecutor::ReadPrimaryIndexTuples(
+    const std::vector<ItemPointer *> &tuple_location_ptrs,
+    std::vector<ItemPointer> &visible_tuple_locations) {
+  // Grab info from plan node
+  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
 
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
 
   auto current_txn = executor_context_->GetTransaction();
   auto &manager = catalog::Manager::GetInstance();
-  std::vector<ItemPointer> visible_tuple_locations;
-  std::map<oid_t, std::vector<oid_t>> visible_tuples;
+  auto &delta_storage = storage::DeltaStorage::GetInstance();
+  auto target_table = GetPlanNode<planner::AbstractScan>().GetTable();
+  bool is_delta_table = (target_table->GetVersionStorageType() ==
+                         VersionStorageType::DELTA);
 
 #ifdef LOG_TRACE_ENABLED
   int num_tuples_examined = 0;
@@ -242,14 +343,26 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
         LOG_TRACE("perform read: %u, %u", tuple_location.block,
                   tuple_location.offset);
 
+        // a delta-stored tuple with visible deltas cannot be read in place.
+        storage::DeltaTuple delta_tuple(tile_group.get(),
+                                        tuple_location.offset);
+        bool has_delta =
+            is_delta_table &&
+            delta_storage.GetVisibleDelta(current_txn, tile_group_header,
+                                          tuple_location.offset, &delta_tuple);
+
         bool eval = true;
         // if having predicate, then perform evaluation.
         if (predicate_ != nullptr) {
           LOG_TRACE("perform predicate evaluate");
           expression::ContainerTuple<storage::TileGroup> tuple(
               tile_group.get(), tuple_location.offset);
-          eval =
-              predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
+          const AbstractTuple *candidate_tuple = &tuple;
+          if (has_delta) {
+            candidate_tuple = &delta_tuple;
+          }
+          eval = predicate_->Evaluate(candidate_tuple, nullptr,
+                                      executor_context_).IsTrue();
         }
         // if passed evaluation, then perform write.
         if (eval == true) {
@@ -263,7 +376,12 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
             return res;
           }
           // if perform read is successful, then add to visible tuple vector.
-          visible_tuple_locations.push_back(tuple_location);
+          if (has_delta) {
+            visible_tuple_locations.push_back(MaterializeDeltaTuple(
+                target_table, delta_tuple, tuple_location_ptrs.size()));
+          } else {
+            visible_tuple_locations.push_back(tuple_location);
+          }
         }
 
         break;
@@ -326,40 +444,6 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
             index_->GetName().c_str());
 #endif
 
-  LOG_TRACE("%ld tuples before pruning boundaries",
-            visible_tuple_locations.size());
-
-  // Check whether the boundaries satisfy the required condition
-  CheckOpenRangeWithReturnedTuples(visible_tuple_locations);
-
-  LOG_TRACE("%ld tuples after pruning boundaries",
-            visible_tuple_locations.size());
-
-  for (auto &visible_tuple_location : visible_tuple_locations) {
-    visible_tuples[visible_tuple_location.block]
-        .push_back(visible_tuple_location.offset);
-  }
-
-  // Construct a logical tile for each block
-  for (auto tuples : visible_tuples) {
-    auto &manager = catalog::Manager::GetInstance();
-    auto tile_group = manager.GetTileGroup(tuples.first);
-
-    std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
-    // Add relevant columns to logical tile
-    logical_tile->AddColumns(tile_group, full_column_ids_);
-    logical_tile->AddPositionList(std::move(tuples.second));
-    if (column_ids_.size() != 0) {
-      logical_tile->ProjectColumns(full_column_ids_, column_ids_);
-    }
-
-    result_.push_back(logical_tile.release());
-  }
-
-  done_ = true;
-
-  LOG_TRACE("Result tiles : %lu", result_.size());
-
   return true;
 }
 
@@ -417,8 +501,11 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   auto current_txn = executor_context_->GetTransaction();
 
   std::vector<ItemPointer> visible_tuple_locations;
-  std::map<oid_t, std::vector<oid_t>> visible_tuples;
   auto &manager = catalog::Manager::GetInstance();
+  auto &delta_storage = storage::DeltaStorage::GetInstance();
+  auto target_table = GetPlanNode<planner::AbstractScan>().GetTable();
+  bool is_delta_table = (target_table->GetVersionStorageType() ==
+                         VersionStorageType::DELTA);
 
   // Quickie Hack
   // Sometimes we can get the tuples we need in the same block if they
@@ -471,14 +558,27 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
                   tuple_location.offset);
 
         // Further check if the version has the secondary key
-        expression::ContainerTuple<storage::TileGroup> candidate_tuple(
+        expression::ContainerTuple<storage::TileGroup> container_tuple(
             tile_group.get(), tuple_location.offset);
 
+        // a delta-stored tuple with visible deltas cannot be read in place.
+        storage::DeltaTuple delta_tuple(tile_group.get(),
+                                        tuple_location.offset);
+        bool has_delta =
+            is_delta_table &&
+            delta_storage.GetVisibleDelta(current_txn, tile_group_header,
+                                          tuple_location.offset, &delta_tuple);
+
+        AbstractTuple *candidate_tuple = &container_tuple;
+        if (has_delta) {
+          candidate_tuple = &delta_tuple;
+        }
+
         LOG_TRACE("candidate_tuple size: %s",
-                  candidate_tuple.GetInfo().c_str());
+                  candidate_tuple->GetInfo().c_str());
         // Construct the key tuple
         auto &indexed_columns = index_->GetKeySchema()->GetIndexedColumns();
-        storage::MaskedTuple key_tuple(&candidate_tuple, indexed_columns);
+        storage::MaskedTuple key_tuple(candidate_tuple, indexed_columns);
 
         // Compare the key tuple and the key
         if (index_->Compare(key_tuple, key_column_ids_, expr_types_, values_) ==
@@ -491,7 +591,7 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
         bool eval = true;
         // if having predicate, then perform evaluation.
         if (predicate_ != nullptr) {
-          eval = predicate_->Evaluate(&candidate_tuple, nullptr,
+          eval = predicate_->Evaluate(candidate_tuple, nullptr,
                                       executor_context_).IsTrue();
         }
         // if passed evaluation, then perform write.
@@ -505,7 +605,12 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
             return res;
           }
           // if perform read is successful, then add to visible tuple vector.
-          visible_tuple_locations.push_back(tuple_location);
+          if (has_delta) {
+            visible_tuple_locations.push_back(MaterializeDeltaTuple(
+                target_table, delta_tuple, tuple_location_ptrs.size()));
+          } else {
+            visible_tuple_locations.push_back(tuple_location);
+          }
           LOG_TRACE("passed evaluation, visible_tuple_locations size: %lu",
                     visible_tuple_locations.size());
         } else {
@@ -578,32 +683,154 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   // Check whether the boundaries satisfy the required condition
   CheckOpenRangeWithReturnedTuples(visible_tuple_locations);
 
-  for (auto &visible_tuple_location : visible_tuple_locations) {
-    visible_tuples[visible_tuple_location.block]
-        .push_back(visible_tuple_location.offset);
+  BuildResultTiles(visible_tuple_locations);
+
+  done_ = true;
+
+  LOG_TRACE("Result tiles : %lu", result_.size());
+
+  return true;
+}
+
+/**
+ * @brief Wrap the visible tuples in logical tiles, one for each block.
+ */
+void IndexScanExecutor::BuildResultTiles(
+    const std::vector<ItemPointer> &tuple_locations) {
+  std::map<oid_t, std::vector<oid_t>> visible_tuples;
+  for (auto &tuple_location : tuple_locations) {
+    visible_tuples[tuple_location.block].push_back(tuple_location.offset);
   }
 
-  // Construct a logical tile for each block
-  for (auto tuples : visible_tuples) {
-    auto &manager = catalog::Manager::GetInstance();
+  auto &manager = catalog::Manager::GetInstance();
+  for (auto &tuples : visible_tuples) {
     auto tile_group = manager.GetTileGroup(tuples.first);
+    result_.push_back(BuildLogicalTile(tile_group, std::move(tuples.second)));
+  }
+}
+
+/**
+ * @brief Wrap a batch of visible tuples in logical tiles that keep their key
+ * order. A long run of tuples in the same block is wrapped in place, and the
+ * tuples of the short runs in between are copied together into a new block,
+ * so that a batch yields a few tiles even if the key order is unrelated to
+ * the physical order.
+ */
+void IndexScanExecutor::BuildKeyOrderedTiles(
+    const std::vector<ItemPointer> &tuple_locations) {
+  auto &manager = catalog::Manager::GetInstance();
+  std::vector<ItemPointer> short_run_locations;
+
+  size_t run_begin = 0;
+  for (size_t run_end = 1; run_end <= tuple_locations.size(); run_end++) {
+    if (run_end < tuple_locations.size() &&
+        tuple_locations[run_end].block == tuple_locations[run_begin].block) {
+      continue;
+    }
+
+    if (run_end - run_begin < KEY_ORDERED_MIN_RUN_LENGTH &&
+        run_end - run_begin < tuple_locations.size()) {
+      short_run_locations.insert(short_run_locations.end(),
+                                 tuple_locations.begin() + run_begin,
+                                 tuple_locations.begin() + run_end);
+    } else {
+      if (short_run_locations.empty() == false) {
+        result_.push_back(CopyKeyOrderedTuples(short_run_locations));
+        short_run_locations.clear();
+      }
 
-    std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
-    // Add relevant columns to logical tile
-    logical_tile->AddColumns(tile_group, full_column_ids_);
-    logical_tile->AddPositionList(std::move(tuples.second));
-    if (column_ids_.size() != 0) {
-      logical_tile->ProjectColumns(full_column_ids_, column_ids_);
+      std::vector<oid_t> positions;
+      for (size_t index = run_begin; index < run_end; index++) {
+        positions.push_back(tuple_locations[index].offset);
+      }
+      auto tile_group = manager.GetTileGroup(tuple_locations[run_begin].block);
+      result_.push_back(BuildLogicalTile(tile_group, std::move(positions)));
     }
 
-    result_.push_back(logical_tile.release());
+    run_begin = run_end;
   }
 
-  done_ = true;
+  if (short_run_locations.empty() == false) {
+    result_.push_back(CopyKeyOrderedTuples(short_run_locations));
+  }
+}
 
-  LOG_TRACE("Result tiles : %lu", result_.size());
+LogicalTile *IndexScanExecutor::CopyKeyOrderedTuples(
+    const std::vector<ItemPointer> &tuple_locations) {
+  auto &manager = catalog::Manager::GetInstance();
+  auto target_table = GetPlanNode<planner::AbstractScan>().GetTable();
 
-  return true;
+  // writers follow the copies back to the tuples they were copied from
+  auto copy_tile_group = storage::DeltaStorage::CreateVersionTileGroup(
+      target_table, tuple_locations.size());
+  std::vector<oid_t> positions;
+  for (auto &tuple_location : tuple_locations) {
+    auto tile_group = manager.GetTileGroup(tuple_location.block);
+    storage::DeltaTuple tuple(tile_group.get(), tuple_location.offset);
+    positions.push_back(storage::DeltaStorage::MaterializeVersion(
+        tuple, copy_tile_group.get()));
+  }
+
+  // the tiles handed over share the ownership of the copy, which is
+  // released along with the last of them, e.g. in the output of a parent
+  oid_t copy_tile_group_id = copy_tile_group->GetTileGroupId();
+  std::shared_ptr<storage::Tile> copy_tile(
+      copy_tile_group->GetTile(0),
+      [copy_tile_group, copy_tile_group_id](storage::Tile *) {
+        storage::DeltaStorage::ReleaseVersionTileGroup(copy_tile_group_id);
+      });
+
+  // the copies are stored in a single tile, in the order of the columns
+  std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+  for (oid_t column_id : full_column_ids_) {
+    logical_tile->AddColumn(copy_tile, column_id, 0);
+  }
+  logical_tile->AddPositionList(std::move(positions));
+  if (column_ids_.size() != 0) {
+    logical_tile->ProjectColumns(full_column_ids_, column_ids_);
+  }
+
+  return logical_tile.release();
+}
+
+LogicalTile *IndexScanExecutor::BuildLogicalTile(
+    const std::shared_ptr<storage::TileGroup> &tile_group,
+    std::vector<oid_t> &&positions) {
+  std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+  // Add relevant columns to logical tile
+  logical_tile->AddColumns(tile_group, full_column_ids_);
+  logical_tile->AddPositionList(std::move(positions));
+  if (column_ids_.size() != 0) {
+    logical_tile->ProjectColumns(full_column_ids_, column_ids_);
+  }
+
+  return logical_tile.release();
+}
+
+/**
+ * @brief Drop the index entries at the ends of the range that do not satisfy
+ * the open boundaries. Every version of a tuple has the key of its primary
+ * index entry, so the entries are pruned before the versions are read.
+ */
+void IndexScanExecutor::CheckOpenRangeWithIndexEntries(
+    std::vector<ItemPointer *> &tuple_location_ptrs) {
+  auto tuple_location_itr = tuple_location_ptrs.begin();
+  while (left_open_) {
+    if (tuple_location_itr == tuple_location_ptrs.end() ||
+        CheckKeyConditions(**tuple_location_itr) == true)
+      left_open_ = false;
+    else
+      tuple_location_itr++;
+  }
+  tuple_location_ptrs.erase(tuple_location_ptrs.begin(), tuple_location_itr);
+
+  while (right_open_) {
+    if (tuple_location_ptrs.empty() ||
+        CheckKeyConditions(*tuple_location_ptrs.back()) == true)
+      right_open_ = false;
+    else
+      tuple_location_ptrs.pop_back();
+  }
 }
 
 void IndexScanExecutor::CheckOpenRangeWithReturnedTuples(
@@ -825,12 +1052,19 @@ void IndexScanExecutor::UpdatePredicate(
 }
 
 void IndexScanExecutor::ResetState() {
+  // Free the result tiles that were not returned, when the parent stopped
+  // early, like a semi join
+  for (oid_t tile_itr = result_itr_; tile_itr < result_.size(); tile_itr++) {
+    delete result_[tile_itr];
+  }
   result_.clear();
 
   result_itr_ = START_OID;
 
   done_ = false;
 
+  scan_cursor_.reset();
+
   const planner::IndexScanPlan &node = GetPlanNode<planner::IndexScanPlan>();
 
   left_open_ = node.GetLeftOpen();
@@ -92,14 +92,14 @@ const LogicalTile::PositionList &LogicalTile::GetPositionList(
  */
 void LogicalTile::SetPositionLists(
     LogicalTile::PositionLists &&position_lists) {
-  position_lists_ = position_lists;
+  position_lists_ = std::move(position_lists);
 }
 
 void LogicalTile::SetPositionListsAndVisibility(
     LogicalTile::PositionLists &&position_lists) {
-  position_lists_ = position_lists;
-  if (position_lists.size() > 0) {
-    total_tuples_ = position_lists[0].size();
+  position_lists_ = std::move(position_lists);
+  if (position_lists_.size() > 0) {
+    total_tuples_ = position_lists_[0].size();
     visible_rows_.resize(position_lists_[0].size(), true);
     visible_tuples_ = position_lists_[0].size();
   }
@@ -310,6 +310,42 @@ LogicalTile::~LogicalTile() {
   // Automatically drops reference on base tiles for each column
 }
 
+LogicalTile::PositionList::PositionList(std::vector<oid_t> &&positions) {
+  bool is_range = true;
+  for (size_t offset = 1; offset < positions.size(); offset++) {
+    if (positions[offset] != positions[0] + offset ||
+        positions[offset] == NULL_OID) {
+      is_range = false;
+      break;
+    }
+  }
+
+  if (is_range == true && (positions.empty() || positions[0] != NULL_OID)) {
+    range_first_ = positions.empty() ? 0 : positions[0];
+    range_size_ = positions.size();
+  } else {
+    is_range_ = false;
+    positions_ = std::move(positions);
+  }
+}
+
+LogicalTile::PositionList LogicalTile::PositionList::Range(oid_t first,
+                                                           size_t size) {
+  PositionList position_list;
+  position_list.range_first_ = first;
+  position_list.range_size_ = size;
+  return position_list;
+}
+
+void LogicalTile::PositionList::Expand() {
+  PL_ASSERT(is_range_ == true);
+  positions_.reserve(range_size_ + 1);
+  for (size_t offset = 0; offset < range_size_; offset++) {
+    positions_.push_back(range_first_ + offset);
+  }
+  is_range_ = false;
+}
+
 LogicalTile::PositionListsBuilder::PositionListsBuilder() {
   // Nothing to do here !
 }
@@ -43,6 +43,15 @@ bool MergeJoinExecutor::DInit() {
 
   if (join_clauses_ == nullptr) return false;
 
+  started_ = false;
+  left_cursor_ = ChildCursor();
+  right_cursor_ = ChildCursor();
+  right_group_.clear();
+  output_tile_.reset();
+  output_left_source_.reset();
+  output_right_source_.reset();
+  output_tiles_.clear();
+
   return true;
 }
 
@@ -52,237 +61,289 @@ bool MergeJoinExecutor::DInit() {
  * @return true on success, false otherwise.
  */
 bool MergeJoinExecutor::DExecute() {
-  LOG_TRACE(
-      "********** Merge Join executor :: 2 children "
-      "left:: start: %lu, end: %lu, done: %d "
-      "right:: start: %lu, end: %lu, done: %d",
-      left_start_row, left_end_row, left_child_done_, right_start_row,
-      right_end_row, right_child_done_);
-
-  // Build outer join output when done
-  if (right_child_done_ && left_child_done_) {
-    return BuildOuterJoinOutput();
-  }
+  LOG_TRACE("********** Merge Join executor :: 2 children ");
 
-  //===--------------------------------------------------------------------===//
-  // Pick right and left tiles
-  //===--------------------------------------------------------------------===//
-
-  // Try to get next tile from RIGHT child
-  if (((right_child_done_ == false) && (right_start_row == right_end_row)) ||
-      (left_child_done_ == true)) {
-    if (children_[1]->Execute() == false) {
-      LOG_TRACE("Did not get right tile ");
-      right_child_done_ = true;
-      // Try again
-      return DExecute();
-    }
+  if (started_ == false) {
+    started_ = true;
+    AdvanceCursor(1, right_cursor_);
+    AdvanceCursor(0, left_cursor_);
+  }
 
-    LOG_TRACE("Got right tile ");
+  while (output_tiles_.empty() && MergeNext()) {
+  }
 
-    auto right_tile = children_[1]->GetOutput();
-    BufferRightTile(right_tile);
+  // Return the last rows once the join is done
+  if (output_tiles_.empty()) {
+    FinishOutputTile();
+  }
 
-    right_start_row = 0;
-    right_end_row = Advance(right_tile, right_start_row, false);
-    LOG_TRACE("size of right tiles: %lu", right_result_tiles_.size());
+  if (output_tiles_.empty()) {
+    return false;
   }
 
-  // Try to get next tile from LEFT child
-  if (((left_child_done_ == false) && (left_start_row == left_end_row)) ||
-      (right_child_done_ == true)) {
-    if (children_[0]->Execute() == false) {
-      LOG_TRACE("Did not get left tile ");
-      left_child_done_ = true;
-      // if we know the join type is left join, we don't have to get the
-      // tiles from right child anymore.
-      if (join_type_ == JoinType::LEFT || join_type_ == JoinType::INNER) {
-        return BuildOuterJoinOutput();
-      } else {
-        // otherwise, try again
-        return DExecute();
-      }
+  SetOutput(output_tiles_.front().release());
+  output_tiles_.pop_front();
+  return true;
+}
+
+/**
+ * @brief Move the cursor to the next visible row of the child, fetching the
+ * next tile of the child once the rows of the current one are used up.
+ */
+void MergeJoinExecutor::AdvanceCursor(oid_t child_idx, ChildCursor &cursor) {
+  if (cursor.tile != nullptr && ++cursor.offset < cursor.rows.size()) {
+    return;
+  }
 
-      // Try again
-      return DExecute();
+  cursor.tile.reset();
+  cursor.rows.clear();
+  while (children_[child_idx]->Execute() == true) {
+    std::shared_ptr<LogicalTile> tile(children_[child_idx]->GetOutput());
+    for (oid_t row : *tile) {
+      cursor.rows.push_back(row);
     }
 
-    LOG_TRACE("Got left tile ");
+    if (cursor.rows.empty() == false) {
+      cursor.tile = std::move(tile);
+      cursor.offset = 0;
+      cursor.has_rows = true;
+      return;
+    }
+  }
 
-    auto left_tile = children_[0]->GetOutput();
-    BufferLeftTile(left_tile);
+  LOG_TRACE("%s child is done", child_idx == 0 ? "left" : "right");
+  cursor.done = true;
+}
 
-    left_start_row = 0;
-    left_end_row = Advance(left_tile, left_start_row, true);
-    LOG_TRACE("size of left tiles: %lu", left_result_tiles_.size());
+/**
+ * @brief Join the rows of the next key of the children, or output the next
+ * row that has no match.
+ *
+ * The right rows of the key are buffered, then joined with each left row of
+ * the key in turn.
+ *
+ * @return false once the join is done.
+ */
+bool MergeJoinExecutor::MergeNext() {
+  bool left_outer =
+      (join_type_ == JoinType::LEFT || join_type_ == JoinType::OUTER);
+  bool right_outer =
+      (join_type_ == JoinType::RIGHT || join_type_ == JoinType::OUTER);
+
+  // The remaining right rows have no match
+  if (left_cursor_.done == true) {
+    if (right_cursor_.done == true || right_outer == false) return false;
+
+    AddOutputRow(nullptr, INVALID_OID, right_cursor_.tile,
+                 right_cursor_.GetRow());
+    AdvanceCursor(1, right_cursor_);
+    return true;
   }
 
-  // Check if we have logical tiles to process
-  if (left_result_tiles_.empty() || right_result_tiles_.empty()) {
-    return BuildOuterJoinOutput();
+  // The remaining left rows have no match. Like in the other joins, the left
+  // child is still read to its end, unless the right child was empty.
+  if (right_cursor_.done == true) {
+    if (left_outer == false && right_cursor_.has_rows == false) return false;
+
+    if (left_outer == true) {
+      AddOutputRow(left_cursor_.tile, left_cursor_.GetRow(), nullptr,
+                   INVALID_OID);
+    }
+    AdvanceCursor(0, left_cursor_);
+    return true;
   }
 
-  LogicalTile *left_tile = left_result_tiles_.back().get();
-  LogicalTile *right_tile = right_result_tiles_.back().get();
-
-  //===--------------------------------------------------------------------===//
-  // Build Join Tile
-  //===--------------------------------------------------------------------===//
-
-  // Build output logical tile
-  auto output_tile = BuildOutputLogicalTile(left_tile, right_tile);
-
-  // Build position lists
-  LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
-
-  while ((left_end_row > left_start_row) && (right_end_row > right_start_row)) {
-    expression::ContainerTuple<executor::LogicalTile> left_tuple(
-        left_tile, left_start_row);
-    expression::ContainerTuple<executor::LogicalTile> right_tuple(
-        right_tile, right_start_row);
-    bool not_matching_tuple_pair = false;
-
-    // Evaluate and compare the join clauses
-    for (auto &clause : *join_clauses_) {
-      auto left_value =
-          clause.left_->Evaluate(&left_tuple, &right_tuple, nullptr);
-      auto right_value =
-          clause.right_->Evaluate(&left_tuple, &right_tuple, nullptr);
-
-      // Left key < Right key, advance left
-      if (left_value.CompareLessThan(right_value) == type::CMP_TRUE) {
-        LOG_TRACE("left < right, advance left ");
-        left_start_row = left_end_row;
-        left_end_row = Advance(left_tile, left_start_row, true);
-        not_matching_tuple_pair = true;
-        break;
-      }
-      // Left key > Right key, advance right
-      else if (left_value.CompareGreaterThan(right_value) == type::CMP_TRUE) {
-        LOG_TRACE("left > right, advance right ");
-        right_start_row = right_end_row;
-        right_end_row = Advance(right_tile, right_start_row, false);
-        not_matching_tuple_pair = true;
-        break;
-      }
+  GetKeys(left_cursor_, true, left_keys_);
+  GetKeys(right_cursor_, false, right_keys_);
+  auto cmp = CompareKeys(left_keys_, right_keys_);
 
-      // Left key == Right key, go and check next join clause
+  // Left key < Right key, advance left
+  if (cmp < 0) {
+    if (left_outer == true) {
+      AddOutputRow(left_cursor_.tile, left_cursor_.GetRow(), nullptr,
+                   INVALID_OID);
     }
+    AdvanceCursor(0, left_cursor_);
+    return true;
+  }
 
-    // At least one of the join clauses don't match
-    // One of the tile has been advanced
-    if (not_matching_tuple_pair) {
-      continue;
+  // Left key > Right key, advance right
+  if (cmp > 0) {
+    if (right_outer == true) {
+      AddOutputRow(nullptr, INVALID_OID, right_cursor_.tile,
+                   right_cursor_.GetRow());
     }
+    AdvanceCursor(1, right_cursor_);
+    return true;
+  }
 
-    // Join clauses matched, try to match predicate
-    LOG_TRACE("one pair of tuples matches join clause ");
-
-    // Join predicate exists
-    if (predicate_ != nullptr) {
-      auto eval = predicate_->Evaluate(&left_tuple,
-                                      &right_tuple, executor_context_);
-      if (eval.IsFalse()) {
-      //if (predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
-      //        .IsFalse()) {
-        // Join predicate is false. Advance both.
-        left_start_row = left_end_row;
-        left_end_row = Advance(left_tile, left_start_row, true);
-
-        right_start_row = right_end_row;
-        right_end_row = Advance(right_tile, right_start_row, false);
+  // Buffer the right rows of the key, which may span several tiles
+  right_group_.clear();
+  do {
+    right_group_.push_back({right_cursor_.tile, right_cursor_.GetRow(), false});
+    AdvanceCursor(1, right_cursor_);
+    if (right_cursor_.done == true) break;
+
+    GetKeys(right_cursor_, false, next_keys_);
+  } while (CompareKeys(right_keys_, next_keys_) == 0);
+
+  LOG_TRACE("Joining a key with %lu right rows", right_group_.size());
+
+  // Join each left row of the key with them
+  do {
+    expression::ContainerTuple<LogicalTile> left_tuple(left_cursor_.tile.get(),
+                                                       left_cursor_.GetRow());
+    bool matched = false;
+
+    for (auto &group_row : right_group_) {
+      expression::ContainerTuple<LogicalTile> right_tuple(group_row.tile.get(),
+                                                          group_row.row);
+      if (predicate_ != nullptr &&
+          predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
+                  .IsTrue() == false) {
+        continue;
       }
+
+      AddOutputRow(left_cursor_.tile, left_cursor_.GetRow(), group_row.tile,
+                   group_row.row);
+      matched = true;
+      group_row.matched = true;
     }
 
-    // Sub tile matched, do a Cartesian product
-    // Go over every pair of tuples in left and right logical tiles
-    for (size_t left_tile_row_itr = left_start_row;
-         left_tile_row_itr < left_end_row; left_tile_row_itr++) {
-      for (size_t right_tile_row_itr = right_start_row;
-           right_tile_row_itr < right_end_row; right_tile_row_itr++) {
-        // Insert a tuple into the output logical tile
-        pos_lists_builder.AddRow(left_tile_row_itr, right_tile_row_itr);
-
-        RecordMatchedLeftRow(left_result_tiles_.size() - 1, left_tile_row_itr);
-        RecordMatchedRightRow(right_result_tiles_.size() - 1,
-                              right_tile_row_itr);
-      }
+    if (matched == false && left_outer == true) {
+      AddOutputRow(left_cursor_.tile, left_cursor_.GetRow(), nullptr,
+                   INVALID_OID);
     }
 
-    // Then, advance both if necessary
-    right_start_row = right_end_row;
-    right_end_row = Advance(right_tile, right_start_row, false);
+    AdvanceCursor(0, left_cursor_);
+    if (left_cursor_.done == true) break;
 
-    if (right_start_row != right_end_row) {
-      left_start_row = left_end_row;
-      left_end_row = Advance(left_tile, left_start_row, true);
+    GetKeys(left_cursor_, true, next_keys_);
+  } while (CompareKeys(left_keys_, next_keys_) == 0);
+
+  if (right_outer == true) {
+    for (auto &group_row : right_group_) {
+      if (group_row.matched == false) {
+        AddOutputRow(nullptr, INVALID_OID, group_row.tile, group_row.row);
+      }
     }
   }
+  right_group_.clear();
 
-  // Check if we have any join tuples.
-  if (pos_lists_builder.Size() > 0) {
-    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
-    SetOutput(output_tile.release());
-    return true;
+  return true;
+}
+
+void MergeJoinExecutor::GetKeys(const ChildCursor &cursor, bool is_left,
+                                std::vector<type::Value> &keys) const {
+  expression::ContainerTuple<LogicalTile> tuple(cursor.tile.get(),
+                                                cursor.GetRow());
+  keys.clear();
+  for (auto &clause : *join_clauses_) {
+    auto expr = is_left ? clause.left_.get() : clause.right_.get();
+    keys.push_back(expr->Evaluate(&tuple, &tuple, executor_context_));
+  }
+}
+
+/**
+ * @brief Compare the join keys of a left and a right row.
+ *
+ * A null key matches no key, so it is ordered before the keys of the other
+ * side to skip its row.
+ *
+ * @return a negative number if the left keys come first, a positive number if
+ * the right keys come first, and 0 if they match.
+ */
+int MergeJoinExecutor::CompareKeys(
+    const std::vector<type::Value> &left_keys,
+    const std::vector<type::Value> &right_keys) const {
+  for (auto &key : left_keys) {
+    if (key.IsNull()) return -1;
   }
-  // Try again
-  else {
-    // If we are out of any more pairs of child tiles to examine,
-    // then we will return false earlier in this function
-    // So, no need to return false here
-    DExecute();
+  for (auto &key : right_keys) {
+    if (key.IsNull()) return 1;
   }
 
-  return true;
+  for (size_t key_itr = 0; key_itr < left_keys.size(); key_itr++) {
+    int cmp = 0;
+    if (left_keys[key_itr].CompareLessThan(right_keys[key_itr]) ==
+        type::CMP_TRUE) {
+      cmp = -1;
+    } else if (left_keys[key_itr].CompareGreaterThan(right_keys[key_itr]) ==
+               type::CMP_TRUE) {
+      cmp = 1;
+    }
+
+    // the children are sorted in descending order of the key
+    if ((*join_clauses_)[key_itr].reversed_ == true) {
+      cmp = -cmp;
+    }
+
+    if (cmp != 0) return cmp;
+  }
+  return 0;
 }
 
 /**
- * @brief Advance the row iterator until value changes in terms of the join
- * clauses
- * @return the end row number, [start_row, end_row) are the rows of the same
- * value
- *         if the end_row == start_row, the subset is empty
+ * @brief Add a row to the output tile. A null source tile stands for a row
+ * of nulls, for the outer joins.
+ *
+ * An output tile takes its rows from a single pair of child tiles, so a new
+ * one is started when the sources change.
  */
-size_t MergeJoinExecutor::Advance(LogicalTile *tile, size_t start_row,
-                                  bool is_left) {
-  size_t end_row = start_row + 1;
-  size_t this_row = start_row;
-  size_t tuple_count = tile->GetTupleCount();
-  if (start_row >= tuple_count) return start_row;
-
-  while (end_row < tuple_count) {
-    expression::ContainerTuple<executor::LogicalTile> this_tuple(tile,
-                                                                 this_row);
-    expression::ContainerTuple<executor::LogicalTile> next_tuple(tile, end_row);
-
-    bool diff = false;
-
-    for (auto &clause : *join_clauses_) {
-      // Go through each join clauses
-      auto expr = is_left ? clause.left_.get() : clause.right_.get();
-      auto this_value =
-          expr->Evaluate(&this_tuple, &this_tuple, executor_context_);
-      auto next_value =
-          expr->Evaluate(&next_tuple, &next_tuple, executor_context_);
-
-      if (!(this_value.CompareEquals(next_value) == type::CMP_TRUE)) {
-        diff = true;
-        break;
-      }
+void MergeJoinExecutor::AddOutputRow(
+    const std::shared_ptr<LogicalTile> &left_tile, oid_t left_row,
+    const std::shared_ptr<LogicalTile> &right_tile, oid_t right_row) {
+  bool same_sources =
+      (left_tile == nullptr || left_tile == output_left_source_) &&
+      (right_tile == nullptr || right_tile == output_right_source_);
+
+  if (output_tile_ == nullptr || same_sources == false ||
+      output_builder_.Size() >= MERGE_JOIN_OUTPUT_TILE_SIZE) {
+    FinishOutputTile();
+
+    // Pair a row of nulls with the current tile of the other child, which
+    // the following rows likely join with
+    output_left_source_ =
+        (left_tile != nullptr) ? left_tile : left_cursor_.tile;
+    output_right_source_ =
+        (right_tile != nullptr) ? right_tile : right_cursor_.tile;
+
+    if (output_left_source_ != nullptr && output_right_source_ != nullptr) {
+      output_tile_ = BuildOutputLogicalTile(output_left_source_.get(),
+                                            output_right_source_.get());
+      output_builder_ = LogicalTile::PositionListsBuilder(
+          output_left_source_.get(), output_right_source_.get());
+    } else if (output_left_source_ != nullptr) {
+      output_tile_ = BuildOutputLogicalTile(output_left_source_.get(), nullptr,
+                                            proj_schema_);
+      output_builder_ = LogicalTile::PositionListsBuilder(
+          &output_left_source_->GetPositionLists(), nullptr);
+    } else {
+      output_tile_ = BuildOutputLogicalTile(
+          nullptr, output_right_source_.get(), proj_schema_);
+      output_builder_ = LogicalTile::PositionListsBuilder(
+          nullptr, &output_right_source_->GetPositionLists());
     }
+  }
 
-    if (diff) {
-      break;
-    }
+  if (left_tile == nullptr) {
+    output_builder_.AddLeftNullRow(right_row);
+  } else if (right_tile == nullptr) {
+    output_builder_.AddRightNullRow(left_row);
+  } else {
+    output_builder_.AddRow(left_row, right_row);
+  }
+}
 
-    // the two tuples are the same, we advance by 1
-    this_row = end_row;
-    end_row++;
+void MergeJoinExecutor::FinishOutputTile() {
+  if (output_tile_ != nullptr && output_builder_.Size() > 0) {
+    output_tile_->SetPositionListsAndVisibility(output_builder_.Release());
+    output_tiles_.push_back(std::move(output_tile_));
   }
 
-  LOG_TRACE("Advanced %s with subset size %lu ", is_left ? "left" : "right",
-            end_row - start_row);
-  return end_row;
+  output_tile_.reset();
+  output_left_source_.reset();
+  output_right_source_.reset();
 }
 
 }  // namespace executor
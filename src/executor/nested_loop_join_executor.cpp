@@ -93,6 +93,10 @@ bool NestedLoopJoinExecutor::DExecute() {
   const std::vector<oid_t> &join_column_ids_left = node.GetJoinColumnsLeft();
   const std::vector<oid_t> &join_column_ids_right = node.GetJoinColumnsRight();
 
+  if (join_type_ == JoinType::SEMI || join_type_ == JoinType::ANTI) {
+    return ExecuteSemiJoin(join_column_ids_left, join_column_ids_right);
+  }
+
   // We should first deal with the current result. Otherwise we will cache a lot
   // data which is not good to utilize memory. After that we call child execute.
   // Since is the high level idea, each time we get tile from left, we should
@@ -210,5 +214,61 @@ bool NestedLoopJoinExecutor::DExecute() {
 
   }  // end the very beginning for loop
 }
+
+/**
+ * @brief Semi and anti joins output each left row at most once, with the
+ * columns of the left tile only. The right child is looked up with the join
+ * values of each left row, and only executed until it returns its first row.
+ * @return true on success, false once the left child is exhausted.
+ */
+bool NestedLoopJoinExecutor::ExecuteSemiJoin(
+    const std::vector<oid_t> &join_column_ids_left,
+    const std::vector<oid_t> &join_column_ids_right) {
+  bool output_matched = (join_type_ == JoinType::SEMI);
+
+  for (;;) {
+    if (left_child_done_ == true || children_[0]->Execute() == false) {
+      LOG_TRACE("Left child is exhausted.");
+      left_child_done_ = true;
+      return false;
+    }
+
+    std::unique_ptr<LogicalTile> left_tile(children_[0]->GetOutput());
+    auto output_tile =
+        BuildOutputLogicalTile(left_tile.get(), nullptr, proj_schema_);
+    LogicalTile::PositionListsBuilder pos_lists_builder(
+        &left_tile->GetPositionLists(), nullptr);
+
+    for (auto left_tile_row_itr : *left_tile) {
+      expression::ContainerTuple<executor::LogicalTile> left_tuple(
+          left_tile.get(), left_tile_row_itr);
+
+      std::vector<type::Value> join_values;
+      for (auto column_id : join_column_ids_left) {
+        join_values.push_back(left_tuple.GetValue(column_id));
+      }
+      children_[1]->UpdatePredicate(join_column_ids_right, join_values);
+
+      // One right row is enough to decide
+      bool matched = false;
+      while (matched == false && children_[1]->Execute() == true) {
+        std::unique_ptr<LogicalTile> right_tile(children_[1]->GetOutput());
+        matched = (right_tile->GetTupleCount() > 0);
+      }
+      children_[1]->ResetState();
+
+      if (matched == output_matched) {
+        pos_lists_builder.AddRightNullRow(left_tile_row_itr);
+      }
+    }
+
+    if (pos_lists_builder.Size() > 0) {
+      output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+      SetOutput(output_tile.release());
+      return true;
+    }
+  }
+}
+
 }  // namespace executor
 }  // namespace peloton
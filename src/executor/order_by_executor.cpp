@@ -17,6 +17,8 @@
 #include "executor/logical_tile_factory.h"
 #include "executor/order_by_executor.h"
 #include "executor/executor_context.h"
+#include "common/container_tuple.h"
+#include "executor/spill_file.h"
 
 #include "planner/order_by_plan.h"
 #include "storage/tile.h"
@@ -24,6 +26,36 @@
 namespace peloton {
 namespace executor {
 
+namespace {
+
+// The sort keys of a tuple of a logical tile, read in place: the i-th value
+// is the one of the i-th sort key column, as in the sort key tuples
+class SortKeyTuple : public AbstractTuple {
+ public:
+  SortKeyTuple(LogicalTile *tile, const oid_t &tuple_id,
+               const std::vector<oid_t> &sort_keys)
+      : tile_(tile), tuple_id_(tuple_id), sort_keys_(sort_keys) {}
+
+  type::Value GetValue(oid_t column_id) const override {
+    return tile_->GetValue(tuple_id_, sort_keys_[column_id]);
+  }
+
+  void SetValue(oid_t, const type::Value &) override { PL_ASSERT(false); }
+
+  char *GetData() const override { return nullptr; }
+
+  const std::string GetInfo() const override { return "SortKeyTuple"; }
+
+ private:
+  LogicalTile *tile_;
+
+  const oid_t tuple_id_;
+
+  const std::vector<oid_t> &sort_keys_;
+};
+
+}  // namespace
+
 /**
  * @brief Constructor
  * @param node  OrderByNode plan node corresponding to this executor
@@ -63,6 +95,11 @@ bool OrderByExecutor::DExecute() {
 
   if (!sort_done_) DoSort();
 
+  // Spilled input comes out of the merge of the sorted runs
+  if (merge_runs_.empty() == false) {
+    return ExecuteMerge();
+  }
+
   if (!(num_tuples_returned_ < sort_buffer_.size())) {
     return false;
   }
@@ -108,13 +145,56 @@ bool OrderByExecutor::DExecute() {
   return true;
 }
 
+// Note: This is a less-than comparer, NOT an equality comparer.
+bool OrderByExecutor::TupleComparer::operator()(const AbstractTuple *ta,
+                                                const AbstractTuple *tb) const {
+  for (oid_t id = 0; id < descend_flags.size(); id++) {
+    type::Value va = (ta->GetValue(id));
+    type::Value vb = (tb->GetValue(id));
+    if (!descend_flags[id]) {
+      if (va.CompareLessThan(vb) == type::CMP_TRUE)
+        return true;
+      else {
+        if (va.CompareGreaterThan(vb) == type::CMP_TRUE) return false;
+      }
+    } else {
+      if (vb.CompareLessThan(va) == type::CMP_TRUE)
+        return true;
+      else {
+        if (vb.CompareGreaterThan(va) == type::CMP_TRUE) return false;
+      }
+    }
+  }
+  return false;  // Will return false if all keys equal
+}
+
+bool OrderByExecutor::MergeHeapComparer::operator()(const size_t &a,
+                                                    const size_t &b) const {
+  // The heap keeps the run with the first row on top
+  const expression::ContainerTuple<std::vector<type::Value>> ta(&rows[a]);
+  const expression::ContainerTuple<std::vector<type::Value>> tb(&rows[b]);
+  return comp(&tb, &ta);
+}
+
 bool OrderByExecutor::DoSort() {
   PL_ASSERT(children_.size() == 1);
   PL_ASSERT(children_[0] != nullptr);
   PL_ASSERT(!sort_done_);
   PL_ASSERT(executor_context_ != nullptr);
 
+  // Grab data from plan node
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  descend_flags_ = node.GetDescendFlags();
+  TupleComparer comp(descend_flags_);
+
+  // With a limit over unordered input, only the first offset + limit tuples
+  // are kept while the child is drained
+  if (limit_ && !underling_ordered_) {
+    return DoTopNSort(comp);
+  }
+
   // Extract all data from child
+  size_t memory_budget = executor_context_->GetMemoryBudget();
   while (children_[0]->Execute()) {
     input_tiles_.emplace_back(children_[0]->GetOutput());
 
@@ -130,6 +210,25 @@ bool OrderByExecutor::DoSort() {
         break;
       }
     }
+
+    // Write the buffered tuples out as a sorted run once they exceed the
+    // memory budget
+    if (underling_ordered_ == false) {
+      if (sort_key_tuple_schema_ == nullptr) {
+        InitSchemas();
+      }
+      buffered_size_ += GetBufferedSize(input_tiles_.back().get());
+      if (buffered_size_ > memory_budget) {
+        SpillRun(comp);
+      }
+    }
+  }
+
+  if (sort_runs_.empty() == false) {
+    SpillRun(comp);
+    StartMerge(comp);
+    sort_done_ = true;
+    return true;
   }
 
   /** Number of valid tuples to be sorted. */
@@ -140,42 +239,15 @@ bool OrderByExecutor::DoSort() {
 
   if (count == 0) return true;
 
-  // Grab data from plan node
-  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
-  descend_flags_ = node.GetDescendFlags();
-
-  // Extract the schema for sort keys.
-
-  std::unique_ptr<catalog::Schema> physical_schema;
-  physical_schema.reset(input_tiles_[0]->GetPhysicalSchema());
-  std::vector<catalog::Column> sort_key_columns;
-  std::vector<catalog::Column> output_key_columns;
-  for (auto id : node.GetSortKeys()) {
-    sort_key_columns.push_back(physical_schema->GetColumn(id));
-  }
-  for (auto id : node.GetOutputColumnIds()) {
-    output_key_columns.push_back(physical_schema->GetColumn(id));
-  }
-  output_column_ids_ = node.GetOutputColumnIds();
-  sort_key_tuple_schema_.reset(new catalog::Schema(sort_key_columns));
-  output_schema_.reset(new catalog::Schema(output_key_columns));
-  auto executor_pool = executor_context_->GetPool();
+  InitSchemas();
 
   // Extract all valid tuples into a single std::vector (the sort buffer)
   sort_buffer_.reserve(count);
   for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
     for (oid_t tuple_id : *input_tiles_[tile_id]) {
-      // Extract the sort key tuple
-      std::unique_ptr<storage::Tuple> tuple(
-          new storage::Tuple(sort_key_tuple_schema_.get(), true));
-      for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
-        type::Value val =
-            (input_tiles_[tile_id]->GetValue(tuple_id, node.GetSortKeys()[id]));
-        tuple->SetValue(id, val, executor_pool);
-      }
       // Inert the sort key tuple into sort buffer
       sort_buffer_.emplace_back(sort_buffer_entry_t(
-          ItemPointer(tile_id, tuple_id), std::move(tuple)));
+          ItemPointer(tile_id, tuple_id), GetSortKeyTuple(tile_id, tuple_id)));
     }
   }
 
@@ -190,38 +262,6 @@ bool OrderByExecutor::DoSort() {
     return true;
   }
 
-  // Prepare the compare function
-  // Note: This is a less-than comparer, NOT an equality comparer.
-  struct TupleComparer {
-    TupleComparer(std::vector<bool> &_descend_flags)
-        : descend_flags(_descend_flags) {}
-
-    bool operator()(const storage::Tuple *ta, const storage::Tuple *tb) {
-      for (oid_t id = 0; id < descend_flags.size(); id++) {
-        type::Value va = (ta->GetValue(id));
-        type::Value vb = (tb->GetValue(id));
-        if (!descend_flags[id]) {
-          if (va.CompareLessThan(vb) == type::CMP_TRUE)
-            return true;
-          else {
-            if (va.CompareGreaterThan(vb) == type::CMP_TRUE) return false;
-          }
-        } else {
-          if (vb.CompareLessThan(va) == type::CMP_TRUE)
-            return true;
-          else {
-            if (vb.CompareGreaterThan(va) == type::CMP_TRUE) return false;
-          }
-        }
-      }
-      return false;  // Will return false if all keys equal
-    }
-
-    std::vector<bool> descend_flags;
-  };
-
-  TupleComparer comp(descend_flags_);
-
   // Finally ... sort it !
   std::sort(
       sort_buffer_.begin(), sort_buffer_.end(),
@@ -234,5 +274,281 @@ bool OrderByExecutor::DoSort() {
   return true;
 }
 
+bool OrderByExecutor::DoTopNSort(TupleComparer &comp) {
+  auto entry_comp = [&comp](const sort_buffer_entry_t &a,
+                            const sort_buffer_entry_t &b) {
+    return comp(a.tuple.get(), b.tuple.get());
+  };
+
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  const std::vector<oid_t> &sort_keys = node.GetSortKeys();
+  size_t top_n = limit_offset_ + limit_number_;
+
+  // The sort buffer is a max-heap whose top is the last of the tuples kept
+  // so far. A tile is released as soon as none of its tuples are kept.
+  std::vector<size_t> tile_entry_counts;
+  while (children_[0]->Execute()) {
+    input_tiles_.emplace_back(children_[0]->GetOutput());
+    oid_t tile_id = input_tiles_.size() - 1;
+    LogicalTile *tile = input_tiles_[tile_id].get();
+    num_tuples_get_ += tile->GetTupleCount();
+    tile_entry_counts.push_back(0);
+
+    if (sort_key_tuple_schema_ == nullptr) {
+      InitSchemas();
+    }
+
+    for (oid_t tuple_id : *tile) {
+      if (sort_buffer_.size() < top_n) {
+        sort_buffer_.emplace_back(sort_buffer_entry_t(
+            ItemPointer(tile_id, tuple_id), GetSortKeyTuple(tile_id, tuple_id)));
+        std::push_heap(sort_buffer_.begin(), sort_buffer_.end(), entry_comp);
+        tile_entry_counts[tile_id]++;
+        continue;
+      }
+
+      // Compare against the last kept tuple before extracting the sort key
+      const SortKeyTuple tuple(tile, tuple_id, sort_keys);
+      if (top_n == 0 ||
+          comp(&tuple, sort_buffer_.front().tuple.get()) == false) {
+        continue;
+      }
+
+      std::pop_heap(sort_buffer_.begin(), sort_buffer_.end(), entry_comp);
+      auto &entry = sort_buffer_.back();
+      oid_t evicted_tile_id = entry.item_pointer.block;
+      if (--tile_entry_counts[evicted_tile_id] == 0 &&
+          evicted_tile_id != tile_id) {
+        input_tiles_[evicted_tile_id].reset();
+      }
+      entry.item_pointer = ItemPointer(tile_id, tuple_id);
+      entry.tuple = GetSortKeyTuple(tile_id, tuple_id);
+      std::push_heap(sort_buffer_.begin(), sort_buffer_.end(), entry_comp);
+      tile_entry_counts[tile_id]++;
+    }
+
+    if (tile_entry_counts[tile_id] == 0) {
+      input_tiles_[tile_id].reset();
+    }
+  }
+
+  LOG_TRACE("Kept %lu of %lu tuples for the limit", sort_buffer_.size(),
+            num_tuples_get_);
+
+  std::sort_heap(sort_buffer_.begin(), sort_buffer_.end(), entry_comp);
+  sort_done_ = true;
+
+  return true;
+}
+
+size_t OrderByExecutor::GetBufferedSize(LogicalTile *tile) {
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  size_t tuple_size = sizeof(sort_buffer_entry_t) +
+                      sort_key_tuple_schema_->GetLength() +
+                      output_schema_->GetLength();
+  size_t size = tile->GetTupleCount() * tuple_size;
+
+  // Add the variable length values, which are stored out of line
+  auto add_varlen_size = [&size, tile](const catalog::Schema &schema,
+                                       const std::vector<oid_t> &column_ids) {
+    for (oid_t column_itr = 0; column_itr < column_ids.size(); column_itr++) {
+      if (schema.IsInlined(column_itr) == true) {
+        continue;
+      }
+      for (oid_t tuple_id : *tile) {
+        size += tile->GetValue(tuple_id, column_ids[column_itr]).GetLength();
+      }
+    }
+  };
+  add_varlen_size(*sort_key_tuple_schema_, node.GetSortKeys());
+  add_varlen_size(*output_schema_, output_column_ids_);
+
+  return size;
+}
+
+void OrderByExecutor::SpillRun(TupleComparer &comp) {
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  const std::vector<oid_t> &sort_keys = node.GetSortKeys();
+
+  // Sort the positions of the buffered tuples, comparing them in place
+  std::vector<ItemPointer> positions;
+  for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
+    for (oid_t tuple_id : *input_tiles_[tile_id]) {
+      positions.emplace_back(tile_id, tuple_id);
+    }
+  }
+  if (positions.empty() == true) {
+    input_tiles_.clear();
+    buffered_size_ = 0;
+    return;
+  }
+
+  std::sort(positions.begin(), positions.end(),
+            [this, &comp, &sort_keys](const ItemPointer &a,
+                                      const ItemPointer &b) {
+              const SortKeyTuple ta(input_tiles_[a.block].get(), a.offset,
+                                    sort_keys);
+              const SortKeyTuple tb(input_tiles_[b.block].get(), b.offset,
+                                    sort_keys);
+              return comp(&ta, &tb);
+            });
+
+  // Each row of a run is the sort keys, then the output columns
+  std::unique_ptr<SpillFile> run(new SpillFile());
+  std::vector<type::Value> row;
+  for (auto &position : positions) {
+    auto tile = input_tiles_[position.block].get();
+    row.clear();
+    for (auto column_id : sort_keys) {
+      row.push_back(tile->GetValue(position.offset, column_id));
+    }
+    for (auto column_id : output_column_ids_) {
+      row.push_back(tile->GetValue(position.offset, column_id));
+    }
+    run->Append(row);
+  }
+
+  LOG_TRACE("Spilled a sorted run of %lu tuples (%lu bytes)",
+            run->GetRowCount(), run->GetSize());
+
+  sort_runs_.push_back(std::move(run));
+  input_tiles_.clear();
+  buffered_size_ = 0;
+}
+
+void OrderByExecutor::StartMerge(TupleComparer &comp) {
+  // Merge the oldest runs into one until few enough are left to be merged
+  // at once
+  while (sort_runs_.size() > SORT_MERGE_FAN_IN) {
+    merge_runs_.assign(std::make_move_iterator(sort_runs_.begin()),
+                       std::make_move_iterator(sort_runs_.begin() +
+                                               SORT_MERGE_FAN_IN));
+    sort_runs_.erase(sort_runs_.begin(),
+                     sort_runs_.begin() + SORT_MERGE_FAN_IN);
+    InitMergeHeap(comp);
+
+    std::unique_ptr<SpillFile> run(new SpillFile());
+    std::vector<type::Value> row;
+    while (NextMergedRow(comp, row) == true) {
+      run->Append(row);
+    }
+    sort_runs_.push_back(std::move(run));
+  }
+
+  merge_runs_ = std::move(sort_runs_);
+  sort_runs_.clear();
+  merge_row_count_ = 0;
+  for (auto &run : merge_runs_) {
+    merge_row_count_ += run->GetRowCount();
+  }
+  InitMergeHeap(comp);
+
+  LOG_TRACE("Merging %lu sorted runs of %lu tuples", merge_runs_.size(),
+            merge_row_count_);
+}
+
+void OrderByExecutor::InitMergeHeap(TupleComparer &comp) {
+  merge_rows_.assign(merge_runs_.size(), std::vector<type::Value>());
+  merge_heap_.clear();
+  for (size_t run_itr = 0; run_itr < merge_runs_.size(); run_itr++) {
+    merge_runs_[run_itr]->Rewind();
+    if (merge_runs_[run_itr]->Next(merge_rows_[run_itr]) == true) {
+      merge_heap_.push_back(run_itr);
+    }
+  }
+  std::make_heap(merge_heap_.begin(), merge_heap_.end(),
+                 MergeHeapComparer(comp, merge_rows_));
+}
+
+bool OrderByExecutor::NextMergedRow(TupleComparer &comp,
+                                    std::vector<type::Value> &row) {
+  if (merge_heap_.empty() == true) {
+    return false;
+  }
+
+  // The top of the heap is the run with the first row
+  MergeHeapComparer heap_comp(comp, merge_rows_);
+  std::pop_heap(merge_heap_.begin(), merge_heap_.end(), heap_comp);
+  size_t run_itr = merge_heap_.back();
+  std::swap(row, merge_rows_[run_itr]);
+  if (merge_runs_[run_itr]->Next(merge_rows_[run_itr]) == true) {
+    std::push_heap(merge_heap_.begin(), merge_heap_.end(), heap_comp);
+  } else {
+    merge_heap_.pop_back();
+  }
+  return true;
+}
+
+bool OrderByExecutor::ExecuteMerge() {
+  if (!(num_tuples_returned_ < merge_row_count_)) {
+    return false;
+  }
+
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  size_t sort_key_count = node.GetSortKeys().size();
+  TupleComparer comp(descend_flags_);
+
+  size_t tile_size = std::min(size_t(DEFAULT_TUPLES_PER_TILEGROUP),
+                              merge_row_count_ - num_tuples_returned_);
+
+  std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
+      BackendType::MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
+      nullptr, *output_schema_, nullptr, tile_size));
+
+  std::vector<type::Value> row;
+  for (size_t id = 0; id < tile_size; id++) {
+    UNUSED_ATTRIBUTE bool status = NextMergedRow(comp, row);
+    PL_ASSERT(status == true);
+    for (oid_t i = 0; i < output_schema_->GetColumnCount(); i++) {
+      ptile.get()->SetValue(row[sort_key_count + i], id, i);
+    }
+  }
+
+  // Create an owner wrapper of this physical tile
+  std::vector<std::shared_ptr<storage::Tile>> singleton({ptile});
+  std::unique_ptr<LogicalTile> ltile(LogicalTileFactory::WrapTiles(singleton));
+  PL_ASSERT(ltile->GetTupleCount() == tile_size);
+
+  SetOutput(ltile.release());
+
+  num_tuples_returned_ += tile_size;
+
+  return true;
+}
+
+void OrderByExecutor::InitSchemas() {
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+
+  // Extract the schema for sort keys.
+  std::unique_ptr<catalog::Schema> physical_schema;
+  physical_schema.reset(input_tiles_[0]->GetPhysicalSchema());
+  std::vector<catalog::Column> sort_key_columns;
+  std::vector<catalog::Column> output_key_columns;
+  for (auto id : node.GetSortKeys()) {
+    sort_key_columns.push_back(physical_schema->GetColumn(id));
+  }
+  for (auto id : node.GetOutputColumnIds()) {
+    output_key_columns.push_back(physical_schema->GetColumn(id));
+  }
+  output_column_ids_ = node.GetOutputColumnIds();
+  sort_key_tuple_schema_.reset(new catalog::Schema(sort_key_columns));
+  output_schema_.reset(new catalog::Schema(output_key_columns));
+}
+
+std::unique_ptr<storage::Tuple> OrderByExecutor::GetSortKeyTuple(
+    const oid_t &tile_id, const oid_t &tuple_id) {
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  auto executor_pool = executor_context_->GetPool();
+
+  std::unique_ptr<storage::Tuple> tuple(
+      new storage::Tuple(sort_key_tuple_schema_.get(), true));
+  for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
+    type::Value val =
+        (input_tiles_[tile_id]->GetValue(tuple_id, node.GetSortKeys()[id]));
+    tuple->SetValue(id, val, executor_pool);
+  }
+  return tuple;
+}
+
 } /* namespace executor */
 } /* namespace peloton */
@@ -0,0 +1,325 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_seq_scan_executor.cpp
+//
+// Identification: src/executor/parallel_seq_scan_executor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/parallel_seq_scan_executor.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+#include "common/logger.h"
+#include "common/worker_pool.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "expression/abstract_expression.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Constructor for parallel seqscan executor.
+ * @param node Seqscan node corresponding to this executor.
+ */
+ParallelSeqScanExecutor::ParallelSeqScanExecutor(
+    const planner::AbstractPlan *node, ExecutorContext *executor_context)
+    : AbstractScanExecutor(node, executor_context),
+      next_tile_group_offset_(START_OID) {}
+
+ParallelSeqScanExecutor::~ParallelSeqScanExecutor() { StopWorkers(); }
+
+bool ParallelSeqScanExecutor::IsParallelizable(
+    const planner::SeqScanPlan &node) {
+  auto table = node.GetTable();
+  if (table == nullptr || node.GetChildren().empty() == false) {
+    return false;
+  }
+  if (table->GetVersionStorageType() == VersionStorageType::DELTA) {
+    return false;
+  }
+  size_t tile_group_count = table->GetTileGroupCount();
+  return WorkerPool::GetInstance().GetWorkerCount() > 0 &&
+         tile_group_count >= PARALLEL_SCAN_MIN_TILE_GROUP_COUNT &&
+         tile_group_count * table->GetTuplesPerTileGroup() >=
+             PARALLEL_SCAN_MIN_TUPLE_COUNT;
+}
+
+/**
+ * @brief Let base class DInit() first, then do mine.
+ * @return true on success, false otherwise.
+ */
+bool ParallelSeqScanExecutor::DInit() {
+  auto status = AbstractScanExecutor::DInit();
+
+  if (!status) return false;
+
+  StopWorkers();
+  exhausted_ = false;
+
+  // Grab data from plan node.
+  const planner::SeqScanPlan &node = GetPlanNode<planner::SeqScanPlan>();
+
+  target_table_ = node.GetTable();
+  PL_ASSERT(target_table_ != nullptr);
+
+  table_tile_group_count_ = target_table_->GetTileGroupCount();
+
+  if (column_ids_.empty()) {
+    column_ids_.resize(target_table_->GetSchema()->GetColumnCount());
+    std::iota(column_ids_.begin(), column_ids_.end(), 0);
+  }
+
+  zone_map_predicates_.clear();
+  storage::ZoneMap::GetPredicates(
+      predicate_,
+      executor_context_ != nullptr ? &executor_context_->GetParams() : nullptr,
+      zone_map_predicates_);
+
+  return true;
+}
+
+/**
+ * @brief Gathers the next tile group scanned by the workers.
+ * @return true on success, false otherwise.
+ */
+bool ParallelSeqScanExecutor::DExecute() {
+  if (exhausted_ == true) {
+    return false;
+  }
+
+  if (result_queue_ == nullptr) {
+    StartWorkers();
+  }
+
+  concurrency::TransactionManager &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
+  auto current_txn = executor_context_->GetTransaction();
+
+  ScanResult result;
+  while (true) {
+    if (NextResult(current_txn, result) == false) {
+      exhausted_ = true;
+      StopWorkers();
+      if (error_ != nullptr) {
+        auto error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+      }
+      return false;
+    }
+
+    if (result.owned_position_list.empty() == false) {
+      ResolveOwnedTuples(current_txn, result);
+    }
+    if (result.position_list.empty() == false) {
+      break;
+    }
+    result = ScanResult();
+  }
+
+  for (auto tuple_id : result.position_list) {
+    ItemPointer location(result.tile_group->GetTileGroupId(), tuple_id);
+    auto res =
+        transaction_manager.PerformRead(current_txn, location, acquire_owner);
+    if (!res) {
+      transaction_manager.SetTransactionResult(current_txn,
+                                               ResultType::FAILURE);
+      exhausted_ = true;
+      StopWorkers();
+      return res;
+    }
+  }
+
+  // Construct logical tile.
+  std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+  logical_tile->AddColumns(result.tile_group, column_ids_);
+  logical_tile->AddPositionList(std::move(result.position_list));
+
+  LOG_TRACE("Information %s", logical_tile->GetInfo().c_str());
+  SetOutput(logical_tile.release());
+  return true;
+}
+
+bool ParallelSeqScanExecutor::NextResult(
+    concurrency::Transaction *transaction, ScanResult &result) {
+  while (result_queue_->TryDequeue(result) == false) {
+    // the queue is only closed after an error of a worker
+    if (is_producing_ == false || result_queue_->IsClosed() == true) {
+      return result_queue_->Dequeue(result);
+    }
+
+    // the consumer scans tile groups itself rather than wait for the
+    // workers, which may not get a thread of the pool at all
+    oid_t tile_group_offset = next_tile_group_offset_++;
+    if (tile_group_offset >= table_tile_group_count_) {
+      is_producing_ = false;
+      result_queue_->FinishProducing();
+      continue;
+    }
+    if (ScanTileGroup(tile_group_offset, transaction, result) == true) {
+      return true;
+    }
+    result = ScanResult();
+  }
+  return true;
+}
+
+void ParallelSeqScanExecutor::StartWorkers() {
+  size_t helper_count = std::min<size_t>(
+      WorkerPool::GetInstance().GetWorkerCount(),
+      (table_tile_group_count_ > 0) ? table_tile_group_count_ - 1 : 0);
+  worker_count_ = helper_count + 1;
+  next_tile_group_offset_ = START_OID;
+  error_ = nullptr;
+
+  // the consumer is the first producer, and each worker joins as one once it
+  // gets a thread of the pool
+  result_queue_.reset(new BoundedQueue<ScanResult>(
+      worker_count_ * PARALLEL_SCAN_QUEUE_SIZE_PER_WORKER, 1));
+  is_producing_ = true;
+
+  auto current_txn = executor_context_->GetTransaction();
+  worker_group_.Start(
+      helper_count,
+      [this, current_txn](size_t) { ScanTileGroups(current_txn); },
+      [this]() { result_queue_->AddProducer(); });
+
+  LOG_TRACE("Scanning %u tile groups with up to %lu workers",
+            table_tile_group_count_, worker_count_);
+}
+
+void ParallelSeqScanExecutor::StopWorkers() {
+  if (result_queue_ == nullptr) {
+    return;
+  }
+
+  result_queue_->Close();
+  worker_group_.Join();
+  result_queue_.reset();
+}
+
+void ParallelSeqScanExecutor::ScanTileGroups(
+    concurrency::Transaction *transaction) {
+  try {
+    while (true) {
+      oid_t tile_group_offset = next_tile_group_offset_++;
+      if (tile_group_offset >= table_tile_group_count_) {
+        break;
+      }
+
+      ScanResult result;
+      if (ScanTileGroup(tile_group_offset, transaction, result) == false) {
+        continue;
+      }
+
+      // the queue is closed once the consumer stops
+      if (result_queue_->Enqueue(std::move(result)) == false) {
+        break;
+      }
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(error_mutex_);
+      if (error_ == nullptr) {
+        error_ = std::current_exception();
+      }
+    }
+    result_queue_->Close();
+  }
+
+  result_queue_->FinishProducing();
+}
+
+bool ParallelSeqScanExecutor::ScanTileGroup(
+    const oid_t &tile_group_offset, concurrency::Transaction *transaction,
+    ScanResult &result) const {
+  auto tile_group = target_table_->GetTileGroup(tile_group_offset);
+  if (tile_group == nullptr) {
+    return false;
+  }
+
+  // Skip tile groups whose values cannot satisfy the predicate.
+  if (zone_map_predicates_.empty() == false &&
+      tile_group->GetZoneMap()->MayMatch(zone_map_predicates_) == false) {
+    return false;
+  }
+
+  concurrency::TransactionManager &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto tile_group_header = tile_group->GetHeader();
+
+  oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+  for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+    auto visibility = transaction_manager.IsVisibleUnowned(
+        transaction, tile_group_header, tuple_id);
+    if (visibility == VisibilityType::OK) {
+      result.position_list.push_back(tuple_id);
+    } else if (visibility == VisibilityType::INVALID) {
+      result.owned_position_list.push_back(tuple_id);
+    }
+  }
+
+  FilterPositions(tile_group.get(), result.position_list);
+
+  result.tile_group = tile_group;
+  return result.position_list.empty() == false ||
+         result.owned_position_list.empty() == false;
+}
+
+void ParallelSeqScanExecutor::ResolveOwnedTuples(
+    concurrency::Transaction *transaction, ScanResult &result) const {
+  concurrency::TransactionManager &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto tile_group_header = result.tile_group->GetHeader();
+
+  std::vector<oid_t> owned_position_list;
+  for (auto tuple_id : result.owned_position_list) {
+    if (transaction_manager.IsVisible(transaction, tile_group_header,
+                                      tuple_id) == VisibilityType::OK) {
+      owned_position_list.push_back(tuple_id);
+    }
+  }
+  result.owned_position_list.clear();
+
+  FilterPositions(result.tile_group.get(), owned_position_list);
+  if (owned_position_list.empty() == true) {
+    return;
+  }
+
+  std::vector<oid_t> position_list;
+  position_list.reserve(result.position_list.size() +
+                        owned_position_list.size());
+  std::merge(result.position_list.begin(), result.position_list.end(),
+             owned_position_list.begin(), owned_position_list.end(),
+             std::back_inserter(position_list));
+  result.position_list.swap(position_list);
+}
+
+void ParallelSeqScanExecutor::FilterPositions(
+    storage::TileGroup *tile_group, std::vector<oid_t> &position_list) const {
+  if (predicate_ != nullptr && position_list.empty() == false) {
+    predicate_->EvaluateBatch(tile_group, position_list, executor_context_);
+  }
+
+  if (bloom_filters_.empty() == false && position_list.empty() == false) {
+    ApplyBloomFilters(tile_group, position_list);
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
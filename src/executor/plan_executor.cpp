@@ -300,6 +300,13 @@ executor::AbstractExecutor *BuildExecutorTree(
       break;
 
     case PlanNodeType::SEQSCAN:
+      if (executor::ParallelSeqScanExecutor::IsParallelizable(
+              *static_cast<const planner::SeqScanPlan *>(plan))) {
+        LOG_TRACE("Adding Parallel Sequential Scan Executor");
+        child_executor =
+            new executor::ParallelSeqScanExecutor(plan, executor_context);
+        break;
+      }
       LOG_TRACE("Adding Sequential Scan Executor");
       child_executor = new executor::SeqScanExecutor(plan, executor_context);
       break;
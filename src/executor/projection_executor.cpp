@@ -18,6 +18,8 @@
 #include "type/types.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
+#include "executor/executor_context.h"
+#include "expression/abstract_expression.h"
 #include "common/container_tuple.h"
 #include "storage/tile.h"
 #include "storage/data_table.h"
@@ -50,7 +52,8 @@ bool ProjectionExecutor::DInit() {
 
 /**
  * @brief Create projected tuples based on one or two input.
- * Newly-created physical tiles are needed.
+ * Newly-created physical tiles are needed, unless the projected columns are
+ * left in the tiles of the input (see ProjectLogically()).
  *
  * @return true on success, false otherwise.
  */
@@ -69,6 +72,15 @@ bool ProjectionExecutor::DExecute() {
 
     // Get input from child
     std::unique_ptr<LogicalTile> source_tile(children_[0]->GetOutput());
+
+    if (executor_context_ != nullptr &&
+        executor_context_->IsLateMaterialization() &&
+        CanProjectLogically(source_tile.get())) {
+      ProjectLogically(source_tile.get());
+      SetOutput(source_tile.release());
+      return true;
+    }
+
     auto num_tuples = source_tile->GetTupleCount();
 
     // Create new physical tile where we store projected tuples
@@ -99,5 +111,84 @@ bool ProjectionExecutor::DExecute() {
   return false;
 }
 
+/**
+ * @brief Whether the columns of the source tile can be passed through
+ * without copying them: the direct maps have to read the source tile and
+ * keep the type of their values.
+ */
+bool ProjectionExecutor::CanProjectLogically(LogicalTile *source_tile) const {
+  if (source_tile->GetPositionLists().empty()) return false;
+
+  for (auto &direct_map : project_info_->GetDirectMapList()) {
+    if (direct_map.second.first != 0) return false;
+
+    auto &column_info = source_tile->GetColumnInfo(direct_map.second.second);
+    auto source_type = column_info.base_tile->GetSchema()->GetType(
+        column_info.origin_column_id);
+    if (source_type != schema_->GetType(direct_map.first)) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Turn the source tile into the projected tile.
+ *
+ * The directly mapped columns keep pointing into their base tiles, so they
+ * are only fetched by the operators that read them. Only the computed
+ * columns are evaluated, for the visible tuples, into a new physical tile,
+ * with a position list from the rows of the source tile to its tuples.
+ */
+void ProjectionExecutor::ProjectLogically(LogicalTile *source_tile) {
+  auto &target_list = project_info_->GetTargetList();
+  std::vector<LogicalTile::ColumnInfo> schema(schema_->GetColumnCount());
+
+  for (auto &direct_map : project_info_->GetDirectMapList()) {
+    schema[direct_map.first] =
+        source_tile->GetColumnInfo(direct_map.second.second);
+  }
+
+  if (target_list.empty() == false) {
+    std::vector<catalog::Column> columns;
+    for (auto &target : target_list) {
+      columns.push_back(schema_->GetColumn(target.first));
+    }
+    catalog::Schema target_schema(columns);
+
+    std::shared_ptr<storage::Tile> dest_tile(storage::TileFactory::GetTempTile(
+        target_schema, source_tile->GetTupleCount()));
+    std::unique_ptr<storage::Tuple> buffer(
+        new storage::Tuple(&target_schema, true));
+
+    // rows of the invisible tuples are never read
+    std::vector<oid_t> position_list(
+        source_tile->GetPositionLists()[0].size(), NULL_OID);
+
+    oid_t new_tuple_id = 0;
+    for (oid_t old_tuple_id : *source_tile) {
+      expression::ContainerTuple<LogicalTile> tuple(source_tile, old_tuple_id);
+      for (oid_t target_itr = 0; target_itr < target_list.size();
+           target_itr++) {
+        auto value = target_list[target_itr].second.expr->Evaluate(
+            &tuple, nullptr, executor_context_);
+        buffer->SetValue(target_itr, value, executor_context_->GetPool());
+      }
+
+      dest_tile->InsertTuple(new_tuple_id, buffer.get());
+      position_list[old_tuple_id] = new_tuple_id++;
+    }
+
+    oid_t position_list_idx =
+        source_tile->AddPositionList(std::move(position_list));
+    for (oid_t target_itr = 0; target_itr < target_list.size(); target_itr++) {
+      auto &column_info = schema[target_list[target_itr].first];
+      column_info.position_list_idx = position_list_idx;
+      column_info.base_tile = dest_tile;
+      column_info.origin_column_id = target_itr;
+    }
+  }
+
+  source_tile->SetSchema(std::move(schema));
+}
+
 } /* namespace executor */
 } /* namespace peloton */
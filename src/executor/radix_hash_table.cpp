@@ -0,0 +1,418 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// radix_hash_table.cpp
+//
+// Identification: src/executor/radix_hash_table.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/radix_hash_table.h"
+
+#include <algorithm>
+
+#include "catalog/schema.h"
+#include "common/container_tuple.h"
+#include "common/logger.h"
+#include "common/worker_pool.h"
+#include "executor/aggregate_hash_table.h"
+#include "executor/bloom_filter.h"
+#include "executor/logical_tile.h"
+#include "storage/tile.h"
+
+namespace peloton {
+namespace executor {
+
+static const uint32_t INVALID_ENTRY = UINT32_MAX;
+
+static size_t NextPowerOfTwo(size_t value) {
+  size_t power = 1;
+  while (power < value) {
+    power <<= 1;
+  }
+  return power;
+}
+
+void RadixHashTable::Build(const std::vector<LogicalTile *> &tiles,
+                           const std::vector<oid_t> &column_ids) {
+  tiles_ = tiles;
+  column_ids_ = column_ids;
+
+  size_t tuple_count = 0;
+  for (auto tile : tiles_) {
+    tuple_count += tile->GetTupleCount();
+  }
+  PL_ASSERT(tuple_count < INVALID_ENTRY);
+
+  key_types_.clear();
+  key_width_ = 0;
+  if (GetKeyTypes(tiles_, column_ids_, key_types_) == true) {
+    key_width_ = column_ids_.size() + 1;
+  }
+
+  // Hash the tuples of each tile, and copy their keys
+  std::vector<std::vector<Entry>> tile_entries(tiles_.size());
+  std::vector<std::vector<int64_t>> tile_key_words(tiles_.size());
+  RunTasks(tiles_.size(), tuple_count, [&](size_t tile_offset) {
+    auto tile = tiles_[tile_offset];
+    auto &entries = tile_entries[tile_offset];
+    auto &key_words = tile_key_words[tile_offset];
+    entries.reserve(tile->GetTupleCount());
+    key_words.resize(tile->GetTupleCount() * key_width_);
+    for (oid_t tuple_offset : *tile) {
+      int64_t *tuple_key_words =
+          (key_width_ == 0) ? nullptr
+                            : key_words.data() + entries.size() * key_width_;
+      entries.push_back({HashTuple(tile, tuple_offset, tuple_key_words),
+                         {(uint32_t)tile_offset, tuple_offset}});
+    }
+  });
+
+  // Partition the entries by the low bits of their hash, keeping the build
+  // order within each partition
+  radix_bits_ = 0;
+  while ((tuple_count >> radix_bits_) > RADIX_PARTITION_SIZE) {
+    radix_bits_++;
+  }
+  size_t partition_count = (size_t)1 << radix_bits_;
+  hash_t partition_mask = partition_count - 1;
+
+  partition_offsets_.assign(partition_count + 1, 0);
+  for (auto &entries : tile_entries) {
+    for (auto &entry : entries) {
+      partition_offsets_[(entry.hash & partition_mask) + 1]++;
+    }
+  }
+  for (size_t partition = 0; partition < partition_count; partition++) {
+    partition_offsets_[partition + 1] += partition_offsets_[partition];
+  }
+
+  entries_.resize(tuple_count);
+  key_words_.resize(tuple_count * key_width_);
+  std::vector<size_t> write_offsets(partition_offsets_.begin(),
+                                    partition_offsets_.end() - 1);
+  for (size_t tile_offset = 0; tile_offset < tiles_.size(); tile_offset++) {
+    auto &entries = tile_entries[tile_offset];
+    auto &key_words = tile_key_words[tile_offset];
+    for (size_t entry_itr = 0; entry_itr < entries.size(); entry_itr++) {
+      size_t entry_offset = write_offsets[entries[entry_itr].hash &
+                                          partition_mask]++;
+      entries_[entry_offset] = entries[entry_itr];
+      std::copy(key_words.begin() + entry_itr * key_width_,
+                key_words.begin() + (entry_itr + 1) * key_width_,
+                key_words_.begin() + entry_offset * key_width_);
+    }
+    std::vector<Entry>().swap(entries);
+    std::vector<int64_t>().swap(key_words);
+  }
+
+  // Size the buckets of each partition to its entry count
+  bucket_offsets_.assign(partition_count + 1, 0);
+  for (size_t partition = 0; partition < partition_count; partition++) {
+    size_t entry_count =
+        partition_offsets_[partition + 1] - partition_offsets_[partition];
+    bucket_offsets_[partition + 1] =
+        bucket_offsets_[partition] + NextPowerOfTwo(entry_count);
+  }
+  buckets_.assign(bucket_offsets_.back(), INVALID_ENTRY);
+  next_entries_.assign(tuple_count, INVALID_ENTRY);
+
+  std::vector<std::vector<Location>> duplicates(partition_count);
+  RunTasks(partition_count, tuple_count, [&](size_t partition) {
+    BuildPartition(partition, duplicates[partition]);
+  });
+
+  // Tiles are not safe to modify concurrently
+  for (auto &partition_duplicates : duplicates) {
+    for (auto &location : partition_duplicates) {
+      tiles_[location.tile_offset]->RemoveVisibility(location.tuple_offset);
+    }
+  }
+
+  LOG_TRACE("Built hash table of %lu tuples in %lu partitions", tuple_count,
+            partition_count);
+}
+
+void RadixHashTable::BuildPartition(const size_t &partition,
+                                    std::vector<Location> &duplicates) {
+  size_t bucket_offset = bucket_offsets_[partition];
+  hash_t bucket_mask = bucket_offsets_[partition + 1] - bucket_offset - 1;
+
+  // Entries are pushed at the head of their bucket in reverse order, so the
+  // buckets list them in build order. The nearest later entry with the same
+  // key as the pushed one is a duplicate; the ones after it were found when
+  // it was pushed.
+  for (size_t entry_offset = partition_offsets_[partition + 1];
+       entry_offset-- > partition_offsets_[partition];) {
+    auto &entry = entries_[entry_offset];
+    auto &bucket = buckets_[bucket_offset +
+                            ((entry.hash >> radix_bits_) & bucket_mask)];
+
+    for (uint32_t other_offset = bucket; other_offset != INVALID_ENTRY;
+         other_offset = next_entries_[other_offset]) {
+      auto &other = entries_[other_offset];
+      if (other.hash != entry.hash) {
+        continue;
+      }
+      bool equal =
+          (key_width_ != 0)
+              ? KeyWordsEqual(&key_words_[entry_offset * key_width_],
+                              &key_words_[other_offset * key_width_])
+              : KeyValuesEqual(other.location,
+                               tiles_[entry.location.tile_offset],
+                               entry.location.tuple_offset);
+      if (equal == true) {
+        duplicates.push_back(other.location);
+        break;
+      }
+    }
+
+    next_entries_[entry_offset] = bucket;
+    bucket = entry_offset;
+  }
+}
+
+void RadixHashTable::Probe(const std::vector<LogicalTile *> &probe_tiles,
+                           std::vector<std::vector<Match>> &matches) const {
+  matches.clear();
+  matches.resize(probe_tiles.size());
+  if (entries_.empty() == true) {
+    return;
+  }
+
+  // Number the probe tuples in probe order, from the first one of each tile
+  std::vector<size_t> tile_indexes(probe_tiles.size() + 1, 0);
+  for (size_t tile_offset = 0; tile_offset < probe_tiles.size();
+       tile_offset++) {
+    tile_indexes[tile_offset + 1] =
+        tile_indexes[tile_offset] + probe_tiles[tile_offset]->GetTupleCount();
+  }
+  size_t tuple_count = tile_indexes.back();
+  PL_ASSERT(tuple_count < INVALID_ENTRY);
+
+  // The keys are compared as words if they have the same types on both sides
+  std::vector<type::Type::TypeId> probe_key_types;
+  size_t key_width = 0;
+  if (key_width_ != 0 &&
+      GetKeyTypes(probe_tiles, column_ids_, probe_key_types) == true &&
+      probe_key_types == key_types_) {
+    key_width = key_width_;
+  }
+
+  // Hash the tuples of each tile, and copy their keys
+  std::vector<ProbeEntry> tuple_entries(tuple_count);
+  std::vector<int64_t> tuple_key_words(tuple_count * key_width);
+  RunTasks(probe_tiles.size(), tuple_count, [&](size_t probe_tile_offset) {
+    auto probe_tile = probe_tiles[probe_tile_offset];
+    size_t probe_index = tile_indexes[probe_tile_offset];
+    for (oid_t probe_offset : *probe_tile) {
+      int64_t *key_words =
+          (key_width == 0) ? nullptr
+                           : tuple_key_words.data() + probe_index * key_width;
+      tuple_entries[probe_index] = {
+          HashTuple(probe_tile, probe_offset, key_words),
+          (uint32_t)probe_index,
+          {(uint32_t)probe_tile_offset, probe_offset}};
+      probe_index++;
+    }
+  });
+
+  // Partition the probe tuples on the radix bits of the build side, keeping
+  // the probe order within each partition
+  size_t partition_count = GetPartitionCount();
+  hash_t partition_mask = partition_count - 1;
+
+  std::vector<size_t> probe_partition_offsets(partition_count + 1, 0);
+  for (auto &entry : tuple_entries) {
+    probe_partition_offsets[(entry.hash & partition_mask) + 1]++;
+  }
+  for (size_t partition = 0; partition < partition_count; partition++) {
+    probe_partition_offsets[partition + 1] +=
+        probe_partition_offsets[partition];
+  }
+
+  std::vector<ProbeEntry> probe_entries(tuple_count);
+  std::vector<int64_t> probe_key_words(tuple_count * key_width);
+  std::vector<size_t> write_offsets(probe_partition_offsets.begin(),
+                                    probe_partition_offsets.end() - 1);
+  for (size_t probe_index = 0; probe_index < tuple_count; probe_index++) {
+    auto &entry = tuple_entries[probe_index];
+    size_t entry_offset = write_offsets[entry.hash & partition_mask]++;
+    probe_entries[entry_offset] = entry;
+    std::copy(tuple_key_words.begin() + probe_index * key_width,
+              tuple_key_words.begin() + (probe_index + 1) * key_width,
+              probe_key_words.begin() + entry_offset * key_width);
+  }
+  std::vector<ProbeEntry>().swap(tuple_entries);
+  std::vector<int64_t>().swap(tuple_key_words);
+
+  // Join each probe partition with the build partition of the same bits
+  std::vector<uint32_t> match_counts(tuple_count, 0);
+  std::vector<std::vector<PartitionMatch>> partition_matches(partition_count);
+  RunTasks(partition_count, tuple_count, [&](size_t partition) {
+    ProbePartition(partition, probe_tiles, probe_partition_offsets,
+                   probe_entries, probe_key_words, match_counts,
+                   partition_matches[partition]);
+  });
+
+  // Lay out the matches in probe order. The matches of a probe tuple are in
+  // build order within its partition already.
+  std::vector<size_t> match_offsets(tuple_count);
+  for (size_t tile_offset = 0; tile_offset < probe_tiles.size();
+       tile_offset++) {
+    size_t match_count = 0;
+    for (size_t probe_index = tile_indexes[tile_offset];
+         probe_index < tile_indexes[tile_offset + 1]; probe_index++) {
+      match_offsets[probe_index] = match_count;
+      match_count += match_counts[probe_index];
+    }
+    matches[tile_offset].resize(match_count);
+  }
+
+  RunTasks(partition_count, tuple_count, [&](size_t partition) {
+    for (auto &match : partition_matches[partition]) {
+      auto &tile_matches = matches[match.probe_location.tile_offset];
+      tile_matches[match_offsets[match.probe_index]++] = {
+          match.probe_location.tuple_offset, match.build_location};
+    }
+  });
+}
+
+void RadixHashTable::ProbePartition(
+    const size_t &partition, const std::vector<LogicalTile *> &probe_tiles,
+    const std::vector<size_t> &probe_partition_offsets,
+    const std::vector<ProbeEntry> &probe_entries,
+    const std::vector<int64_t> &probe_key_words,
+    std::vector<uint32_t> &match_counts,
+    std::vector<PartitionMatch> &matches) const {
+  size_t bucket_offset = bucket_offsets_[partition];
+  hash_t bucket_mask = bucket_offsets_[partition + 1] - bucket_offset - 1;
+  bool compare_key_words = (probe_key_words.empty() == false);
+
+  for (size_t probe_entry_offset = probe_partition_offsets[partition];
+       probe_entry_offset < probe_partition_offsets[partition + 1];
+       probe_entry_offset++) {
+    auto &probe_entry = probe_entries[probe_entry_offset];
+    for (uint32_t entry_offset =
+             buckets_[bucket_offset +
+                      ((probe_entry.hash >> radix_bits_) & bucket_mask)];
+         entry_offset != INVALID_ENTRY;
+         entry_offset = next_entries_[entry_offset]) {
+      auto &entry = entries_[entry_offset];
+      if (entry.hash != probe_entry.hash) {
+        continue;
+      }
+      bool equal =
+          (compare_key_words == true)
+              ? KeyWordsEqual(&key_words_[entry_offset * key_width_],
+                              &probe_key_words[probe_entry_offset * key_width_])
+              : KeyValuesEqual(
+                    entry.location,
+                    probe_tiles[probe_entry.location.tile_offset],
+                    probe_entry.location.tuple_offset);
+      if (equal == true) {
+        match_counts[probe_entry.probe_index]++;
+        matches.push_back({probe_entry.probe_index, probe_entry.location,
+                           entry.location});
+      }
+    }
+  }
+}
+
+bool RadixHashTable::GetKeyTypes(const std::vector<LogicalTile *> &tiles,
+                                 const std::vector<oid_t> &column_ids,
+                                 std::vector<type::Type::TypeId> &key_types) {
+  key_types.clear();
+  if (column_ids.size() >= 64) {
+    return false;
+  }
+
+  for (auto tile : tiles) {
+    for (size_t key_itr = 0; key_itr < column_ids.size(); key_itr++) {
+      auto &column_info = tile->GetColumnInfo(column_ids[key_itr]);
+      auto type_id = column_info.base_tile->GetSchema()->GetType(
+          column_info.origin_column_id);
+      if (AggregateHashTable::IsFixedWidthKey(type_id) == false) {
+        return false;
+      }
+      if (key_types.size() < column_ids.size()) {
+        key_types.push_back(type_id);
+      } else if (key_types[key_itr] != type_id) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool RadixHashTable::KeyValuesEqual(const Location &build_location,
+                                    LogicalTile *probe_tile,
+                                    const oid_t &probe_offset) const {
+  const expression::ContainerTuple<LogicalTile> build_tuple(
+      tiles_[build_location.tile_offset], build_location.tuple_offset,
+      &column_ids_);
+  const expression::ContainerTuple<LogicalTile> probe_tuple(
+      probe_tile, probe_offset, &column_ids_);
+  return probe_tuple.EqualsNoSchemaCheck(build_tuple);
+}
+
+hash_t RadixHashTable::HashTuple(LogicalTile *tile, const oid_t &tuple_offset,
+                                 int64_t *key_words) const {
+  if (key_words == nullptr) {
+    const expression::ContainerTuple<LogicalTile> tuple(tile, tuple_offset,
+                                                        &column_ids_);
+    return HashKey(tuple.HashCode());
+  }
+
+  // The hash code is that of the tuple, so that it matches the bloom filter
+  // probes of the scans
+  size_t hash_code = 0;
+  int64_t null_keys = 0;
+  for (size_t key_itr = 0; key_itr < column_ids_.size(); key_itr++) {
+    type::Value value = tile->GetValue(tuple_offset, column_ids_[key_itr]);
+    value.HashCombine(hash_code);
+    if (value.IsNull()) {
+      null_keys |= (int64_t)1 << key_itr;
+      key_words[key_itr] = 0;
+    } else {
+      key_words[key_itr] = AggregateHashTable::GetKeyWord(value);
+    }
+  }
+  key_words[column_ids_.size()] = null_keys;
+  return HashKey(hash_code);
+}
+
+// Spread the bits of a value hash over the whole word, since the hashes of
+// integers are the integers themselves, and their low bits select the
+// partition (the MurmurHash3 finalizer)
+hash_t RadixHashTable::HashKey(const size_t &hash_code) {
+  hash_t hash = hash_code;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+std::shared_ptr<const BloomFilter> RadixHashTable::BuildBloomFilter() const {
+  std::shared_ptr<BloomFilter> filter(new BloomFilter(entries_.size()));
+  for (auto &entry : entries_) {
+    filter->Insert(entry.hash);
+  }
+  return filter;
+}
+
+void RadixHashTable::RunTasks(const size_t &unit_count,
+                              const size_t &tuple_count,
+                              const std::function<void(size_t)> &task) {
+  size_t helper_count =
+      (tuple_count < RADIX_PARALLEL_MIN_TUPLE_COUNT) ? 0 : SIZE_MAX;
+  WorkerPool::GetInstance().RunTasks(unit_count, task, helper_count);
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -12,6 +12,7 @@
 
 #include "executor/seq_scan_executor.h"
 
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -23,8 +24,11 @@
 #include "executor/executor_context.h"
 #include "expression/abstract_expression.h"
 #include "common/container_tuple.h"
+#include "catalog/manager.h"
 #include "planner/create_plan.h"
 #include "storage/data_table.h"
+#include "storage/delta_storage.h"
+#include "storage/delta_tuple.h"
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
 #include "concurrency/transaction_manager_factory.h"
@@ -65,6 +69,13 @@ bool SeqScanExecutor::DInit() {
       column_ids_.resize(target_table_->GetSchema()->GetColumnCount());
       std::iota(column_ids_.begin(), column_ids_.end(), 0);
     }
+
+    zone_map_predicates_.clear();
+    storage::ZoneMap::GetPredicates(
+        predicate_,
+        executor_context_ != nullptr ? &executor_context_->GetParams()
+                                     : nullptr,
+        zone_map_predicates_);
   }
 
   return true;
@@ -149,17 +160,36 @@ bool SeqScanExecutor::DExecute() {
     bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
     auto current_txn = executor_context_->GetTransaction();
 
+    // Return the copies of delta-stored tuples found in the last tile group.
+    if (delta_tiles_.empty() == false) {
+      SetOutput(delta_tiles_.back().release());
+      delta_tiles_.pop_back();
+      return true;
+    }
+
+    auto &delta_storage = storage::DeltaStorage::GetInstance();
+    bool is_delta_table = (target_table_->GetVersionStorageType() ==
+                           VersionStorageType::DELTA);
+
     // Retrieve next tile group.
     while (current_tile_group_offset_ < table_tile_group_count_) {
       auto tile_group =
           target_table_->GetTileGroup(current_tile_group_offset_++);
       auto tile_group_header = tile_group->GetHeader();
 
+      // Skip tile groups whose values cannot satisfy the predicate. Deltas
+      // are not covered by the zone maps.
+      if (zone_map_predicates_.empty() == false && is_delta_table == false &&
+          tile_group->GetZoneMap()->MayMatch(zone_map_predicates_) == false) {
+        continue;
+      }
+
       oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
-      // Construct position list by looping through tile group
-      // and applying the predicate.
+      // Construct position list by looping through tile group, and then
+      // apply the predicate to the whole list.
       std::vector<oid_t> position_list;
+      std::vector<storage::DeltaTuple> delta_tuples;
       for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
         ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
 
@@ -168,41 +198,76 @@ bool SeqScanExecutor::DExecute() {
 
         // check transaction visibility
         if (visibility == VisibilityType::OK) {
-          // if the tuple is visible, then perform predicate evaluation.
-          if (predicate_ == nullptr) {
-            position_list.push_back(tuple_id);
-            auto res = transaction_manager.PerformRead(current_txn, location,
-                                                       acquire_owner);
-            if (!res) {
-              transaction_manager.SetTransactionResult(current_txn,
-                                                       ResultType::FAILURE);
-              return res;
-            }
-          } else {
-            expression::ContainerTuple<storage::TileGroup> tuple(
-                tile_group.get(), tuple_id);
-            LOG_TRACE("Evaluate predicate for a tuple");
-            auto eval =
-                predicate_->Evaluate(&tuple, nullptr, executor_context_);
-            LOG_TRACE("Evaluation result: %s", eval.GetInfo().c_str());
-            if (eval.IsTrue()) {
-              position_list.push_back(tuple_id);
-              auto res = transaction_manager.PerformRead(current_txn, location,
-                                                         acquire_owner);
-              if (!res) {
-                transaction_manager.SetTransactionResult(current_txn,
-                                                         ResultType::FAILURE);
-                return res;
-              } else {
-                LOG_TRACE("Sequential Scan Predicate Satisfied");
+          // a delta-stored tuple with visible deltas cannot be read in place.
+          if (is_delta_table) {
+            storage::DeltaTuple delta_tuple(tile_group.get(), tuple_id);
+            if (delta_storage.GetVisibleDelta(current_txn, tile_group_header,
+                                              tuple_id, &delta_tuple)) {
+              if (predicate_ == nullptr ||
+                  predicate_->Evaluate(&delta_tuple, nullptr,
+                                       executor_context_).IsTrue()) {
+                auto res = transaction_manager.PerformRead(
+                    current_txn, location, acquire_owner);
+                if (!res) {
+                  transaction_manager.SetTransactionResult(
+                      current_txn, ResultType::FAILURE);
+                  return res;
+                }
+                delta_tuples.push_back(delta_tuple);
               }
+              continue;
             }
           }
+
+          position_list.push_back(tuple_id);
+        }
+      }
+
+      if (predicate_ != nullptr && position_list.empty() == false) {
+        LOG_TRACE("Evaluate predicate for %lu tuples", position_list.size());
+        predicate_->EvaluateBatch(tile_group.get(), position_list,
+                                  executor_context_);
+      }
+
+      if (bloom_filters_.empty() == false && position_list.empty() == false) {
+        ApplyBloomFilters(tile_group.get(), position_list);
+      }
+
+      for (auto tuple_id : position_list) {
+        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+        auto res = transaction_manager.PerformRead(current_txn, location,
+                                                   acquire_owner);
+        if (!res) {
+          transaction_manager.SetTransactionResult(current_txn,
+                                                   ResultType::FAILURE);
+          return res;
         }
       }
 
+      // Copy out the tuples read through their deltas.
+      std::map<oid_t, std::vector<oid_t>> delta_position_lists;
+      for (auto &delta_tuple : delta_tuples) {
+        auto copy_location = MaterializeDeltaTuple(
+            target_table_, delta_tuple, delta_tuples.size());
+        delta_position_lists[copy_location.block].push_back(
+            copy_location.offset);
+      }
+      for (auto &entry : delta_position_lists) {
+        auto version_tile_group =
+            catalog::Manager::GetInstance().GetTileGroup(entry.first);
+        std::unique_ptr<LogicalTile> delta_tile(LogicalTileFactory::GetTile());
+        delta_tile->AddColumns(version_tile_group, column_ids_);
+        delta_tile->AddPositionList(std::move(entry.second));
+        delta_tiles_.push_back(std::move(delta_tile));
+      }
+
       // Don't return empty tiles
       if (position_list.size() == 0) {
+        if (delta_tiles_.empty() == false) {
+          SetOutput(delta_tiles_.back().release());
+          delta_tiles_.pop_back();
+          return true;
+        }
         continue;
       }
 
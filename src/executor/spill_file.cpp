@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.cpp
+//
+// Identification: src/executor/spill_file.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/spill_file.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace executor {
+
+SpillFile::SpillFile() {
+  file_ = std::tmpfile();
+  if (file_ == nullptr) {
+    throw ExecutorException("Could not create a spill file: " +
+                            std::string(strerror(errno)));
+  }
+}
+
+SpillFile::~SpillFile() { fclose(file_); }
+
+void SpillFile::Append(const std::vector<type::Value> &values) {
+  // Each row is its length, then the type and the value of each column
+  output_.Reset();
+  output_.WriteInt(0);
+  output_.WriteInt(values.size());
+  for (auto &value : values) {
+    output_.WriteEnumInSingleByte(value.GetTypeId());
+    value.SerializeTo(output_);
+  }
+  output_.WriteIntAt(0, output_.Size() - sizeof(int32_t));
+
+  if (fwrite(output_.Data(), 1, output_.Size(), file_) != output_.Size()) {
+    throw ExecutorException("Could not write to a spill file: " +
+                            std::string(strerror(errno)));
+  }
+  row_count_++;
+  size_ += output_.Size();
+}
+
+void SpillFile::Rewind() {
+  if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0) {
+    throw ExecutorException("Could not rewind a spill file: " +
+                            std::string(strerror(errno)));
+  }
+}
+
+bool SpillFile::Next(std::vector<type::Value> &values) {
+  int32_t length;
+  if (fread(&length, sizeof(length), 1, file_) != 1) {
+    return false;
+  }
+
+  input_.resize(length);
+  if (fread(input_.data(), 1, length, file_) != (size_t)length) {
+    throw ExecutorException("Could not read from a spill file");
+  }
+
+  ReferenceSerializeInput input(input_.data(), length);
+  size_t value_count = input.ReadInt();
+  values.clear();
+  values.reserve(value_count);
+  for (size_t value_itr = 0; value_itr < value_count; value_itr++) {
+    auto type_id = static_cast<type::Type::TypeId>(input.ReadByte());
+    type::Value value = type::Value::DeserializeFrom(input, type_id);
+
+    // Variable length values point into the read buffer, so they are copied
+    if (type_id == type::Type::VARCHAR && value.IsNull() == false) {
+      value = type::ValueFactory::GetVarcharValue(value.GetData(),
+                                                  value.GetLength(), true);
+    } else if (type_id == type::Type::VARBINARY && value.IsNull() == false) {
+      value = type::ValueFactory::GetVarbinaryValue(
+          reinterpret_cast<const unsigned char *>(value.GetData()),
+          value.GetLength(), true);
+    }
+    values.push_back(std::move(value));
+  }
+  return true;
+}
+
+void SpillFile::AppendBytes(const char *data, size_t size) {
+  if (fwrite(data, 1, size, file_) != size) {
+    throw ExecutorException("Could not write to a spill file: " +
+                            std::string(strerror(errno)));
+  }
+  row_count_++;
+  size_ += size;
+}
+
+bool SpillFile::NextBytes(char *data, size_t size) {
+  size_t bytes_read = fread(data, 1, size, file_);
+  if (bytes_read == 0 && feof(file_)) {
+    return false;
+  }
+  if (bytes_read != size) {
+    throw ExecutorException("Could not read from a spill file");
+  }
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
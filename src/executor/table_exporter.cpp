@@ -0,0 +1,286 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_exporter.cpp
+//
+// Identification: src/executor/table_exporter.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/table_exporter.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/worker_pool.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/delta_storage.h"
+#include "storage/delta_tuple.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "type/serializeio.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace executor {
+
+TableExporter::TableExporter(storage::DataTable *table, CopyType copy_type,
+                             char delimiter)
+    : table_(table),
+      copy_type_(copy_type),
+      delimiter_(delimiter),
+      fd_(-1),
+      tile_group_count_(0),
+      next_tile_group_offset_(0),
+      exported_tuple_count_(0),
+      total_bytes_written_(0),
+      has_error_(false) {
+  PL_ASSERT(copy_type == CopyType::EXPORT_CSV ||
+            copy_type == CopyType::EXPORT_BINARY);
+}
+
+size_t TableExporter::Export(const std::string &file_path,
+                             concurrency::Transaction *transaction) {
+  fd_ = open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd_ == -1) {
+    throw ExecutorException("Failed to create file " + file_path +
+                            ". Try absolute path and make sure you have the "
+                            "permission to access this file.");
+  }
+
+  tile_group_count_ = table_->GetTileGroupCount();
+  next_tile_group_offset_ = 0;
+  exported_tuple_count_ = 0;
+  total_bytes_written_ = 0;
+  has_error_ = false;
+  error_ = nullptr;
+
+  try {
+    if (copy_type_ == CopyType::EXPORT_BINARY) {
+      auto schema = table_->GetSchema();
+      oid_t column_count = schema->GetColumnCount();
+
+      CopySerializeOutput output;
+      output.WriteBytes(EXPORT_BINARY_MAGIC, strlen(EXPORT_BINARY_MAGIC));
+      output.WriteInt(column_count);
+      for (oid_t column_id = 0; column_id < column_count; column_id++) {
+        output.WriteEnumInSingleByte(schema->GetType(column_id));
+      }
+      Write(output);
+    }
+  } catch (...) {
+    close(fd_);
+    throw;
+  }
+
+  // the calling thread is one of the workers
+  WorkerGroup worker_group;
+  worker_group.Start(
+      (tile_group_count_ > 0) ? tile_group_count_ - 1 : 0,
+      [this, transaction](size_t) { ExportTileGroups(transaction); });
+  ExportTileGroups(transaction);
+  size_t worker_count = worker_group.Join() + 1;
+
+  if (fsync(fd_) != 0) {
+    LOG_ERROR("Error occurred in fsync(%s)", strerror(errno));
+  }
+  close(fd_);
+  fd_ = -1;
+
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+
+  LOG_DEBUG("Exported %lu tuples of %s with %lu workers",
+            exported_tuple_count_.load(), table_->GetName().c_str(),
+            worker_count);
+  return total_bytes_written_;
+}
+
+void TableExporter::ExportTileGroups(concurrency::Transaction *transaction) {
+  CopySerializeOutput output;
+
+  try {
+    while (has_error_ == false) {
+      size_t tile_group_offset = next_tile_group_offset_++;
+      if (tile_group_offset >= tile_group_count_) {
+        break;
+      }
+
+      ExportTileGroup(tile_group_offset, transaction, output);
+
+      if (output.Size() >= EXPORT_BUFFER_SIZE) {
+        Write(output);
+      }
+    }
+
+    if (output.Size() > 0 && has_error_ == false) {
+      Write(output);
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (error_ == nullptr) {
+      error_ = std::current_exception();
+    }
+    has_error_ = true;
+  }
+}
+
+void TableExporter::ExportTileGroup(const oid_t &tile_group_offset,
+                                    concurrency::Transaction *transaction,
+                                    CopySerializeOutput &output) {
+  auto tile_group = table_->GetTileGroup(tile_group_offset);
+  if (tile_group == nullptr) {
+    return;
+  }
+  auto tile_group_header = tile_group->GetHeader();
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto &delta_storage = storage::DeltaStorage::GetInstance();
+  bool is_delta_table =
+      (table_->GetVersionStorageType() == VersionStorageType::DELTA);
+
+  // the versions in the snapshot of the transaction. the slot of a
+  // delta-stored tuple is read through the deltas the transaction must see.
+  std::vector<oid_t> tuple_ids;
+  std::vector<storage::DeltaTuple> delta_tuples;
+  oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+  for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+    auto visibility = transaction_manager.IsVisibleUnowned(
+        transaction, tile_group_header, tuple_id);
+    // the visibility of a tuple owned by the transaction depends on its
+    // read/write set, which the reads of the other workers update
+    if (visibility == VisibilityType::INVALID) {
+      std::lock_guard<std::mutex> lock(read_mutex_);
+      visibility = transaction_manager.IsVisible(transaction,
+                                                 tile_group_header, tuple_id);
+    }
+    if (visibility == VisibilityType::OK) {
+      tuple_ids.push_back(tuple_id);
+      if (is_delta_table == true) {
+        delta_tuples.emplace_back(tile_group.get(), tuple_id);
+        delta_storage.GetVisibleDelta(transaction, tile_group_header, tuple_id,
+                                      &delta_tuples.back());
+      }
+    }
+  }
+
+  if (tuple_ids.empty() == true) {
+    return;
+  }
+
+  // the reads are recorded as a scan records them, so that the export stays
+  // a serializable snapshot. the read set of the transaction is shared by
+  // the workers.
+  {
+    std::lock_guard<std::mutex> lock(read_mutex_);
+    for (auto tuple_id : tuple_ids) {
+      ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+      if (transaction_manager.PerformRead(transaction, location, false) ==
+          false) {
+        transaction_manager.SetTransactionResult(transaction,
+                                                 ResultType::FAILURE);
+        throw ExecutorException("Failed to read a tuple of " +
+                                table_->GetName() + " for the export");
+      }
+    }
+  }
+
+  auto get_value = [&](const size_t &tuple_itr, const oid_t &column_id) {
+    if (is_delta_table == true) {
+      return delta_tuples[tuple_itr].GetValue(column_id);
+    }
+    return tile_group->GetValue(tuple_ids[tuple_itr], column_id);
+  };
+
+  oid_t column_count = table_->GetSchema()->GetColumnCount();
+
+  if (copy_type_ == CopyType::EXPORT_BINARY) {
+    output.WriteInt(tuple_ids.size());
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      for (size_t tuple_itr = 0; tuple_itr < tuple_ids.size(); tuple_itr++) {
+        get_value(tuple_itr, column_id).SerializeTo(output);
+      }
+    }
+  } else {
+    for (size_t tuple_itr = 0; tuple_itr < tuple_ids.size(); tuple_itr++) {
+      for (oid_t column_id = 0; column_id < column_count; column_id++) {
+        if (column_id != 0) {
+          output.WriteChar(delimiter_);
+        }
+        AppendCsvValue(get_value(tuple_itr, column_id), output);
+      }
+      output.WriteChar('\n');
+    }
+  }
+
+  exported_tuple_count_ += tuple_ids.size();
+}
+
+void TableExporter::AppendCsvValue(const type::Value &value,
+                                   CopySerializeOutput &output) const {
+  // NULL is an empty unquoted field
+  if (value.IsNull() == true) {
+    return;
+  }
+
+  std::string text = value.ToString();
+
+  bool needs_quotes = text.empty();
+  for (auto character : text) {
+    if (character == delimiter_ || character == '"' || character == '\n' ||
+        character == '\r') {
+      needs_quotes = true;
+      break;
+    }
+  }
+
+  if (needs_quotes == false) {
+    output.WriteBytes(text.data(), text.size());
+    return;
+  }
+
+  output.WriteChar('"');
+  for (auto character : text) {
+    if (character == '"') {
+      output.WriteChar('"');
+    }
+    output.WriteChar(character);
+  }
+  output.WriteChar('"');
+}
+
+void TableExporter::Write(CopySerializeOutput &output) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+
+  const char *data = output.Data();
+  size_t size = output.Size();
+  while (size > 0) {
+    ssize_t bytes_written = write(fd_, data, size);
+    if (bytes_written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw ExecutorException(std::string("Failed to write export file (") +
+                              strerror(errno) + ")");
+    }
+    data += bytes_written;
+    size -= bytes_written;
+    total_bytes_written_ += bytes_written;
+  }
+
+  output.Reset();
+}
+
+}  // namespace executor
+}  // namespace peloton
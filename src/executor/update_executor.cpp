@@ -20,6 +20,8 @@
 #include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/data_table.h"
+#include "storage/delta_storage.h"
+#include "storage/delta_tuple.h"
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
 
@@ -98,8 +100,11 @@ bool UpdateExecutor::PerformUpdatePrimaryKey(bool is_owner,
 
   storage::Tuple new_tuple(target_table_schema, true);
 
-  expression::ContainerTuple<storage::TileGroup> old_tuple(tile_group,
-                                                           physical_tuple_id);
+  // a delta-stored tuple has to be looked at through its pending deltas.
+  storage::DeltaTuple old_tuple(tile_group, physical_tuple_id);
+  storage::DeltaStorage::GetInstance().GetVisibleDelta(
+      current_txn, tile_group_header, physical_tuple_id, &old_tuple,
+      VisibilityIdType::COMMIT_ID);
 
   project_info_->Evaluate(&new_tuple, &old_tuple, nullptr, executor_context_);
 
@@ -121,6 +126,83 @@ bool UpdateExecutor::PerformUpdatePrimaryKey(bool is_owner,
   return true;
 }
 
+bool UpdateExecutor::PerformDeltaUpdate(bool is_owner,
+                                        storage::TileGroup *tile_group,
+                                        storage::TileGroupHeader *tile_group_header,
+                                        oid_t physical_tuple_id,
+                                        ItemPointer &old_location) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  auto &delta_storage = storage::DeltaStorage::GetInstance();
+
+  auto current_txn = executor_context_->GetTransaction();
+
+  // a concurrent transaction may have committed a delta that is not visible
+  // to the current transaction. updating the tuple would lose that delta.
+  if (delta_storage.IsLatestVisible(current_txn, tile_group_header,
+                                    physical_tuple_id) == false) {
+    LOG_TRACE("Fail to update the latest version. Set txn failure.");
+    if (is_owner == false) {
+      transaction_manager.YieldOwnership(current_txn, tile_group_header,
+                                         physical_tuple_id);
+    }
+    transaction_manager.SetTransactionResult(current_txn,
+                                             ResultType::FAILURE);
+    return false;
+  }
+
+  storage::DeltaTuple old_tuple(tile_group, physical_tuple_id);
+  delta_storage.GetVisibleDelta(current_txn, tile_group_header,
+                                physical_tuple_id, &old_tuple,
+                                VisibilityIdType::COMMIT_ID);
+
+  // only evaluate the columns that are changed by the projection.
+  std::vector<oid_t> column_ids;
+  std::vector<type::Value> values;
+  for (auto &target : project_info_->GetTargetList()) {
+    column_ids.push_back(target.first);
+    values.push_back(
+        target.second.expr->Evaluate(&old_tuple, nullptr, executor_context_));
+  }
+  for (auto &direct_map : project_info_->GetDirectMapList()) {
+    if (direct_map.first == direct_map.second.second) {
+      continue;
+    }
+    column_ids.push_back(direct_map.first);
+    values.push_back(old_tuple.GetValue(direct_map.second.second));
+  }
+
+  // the secondary indexes see the tuple as it is after the update.
+  storage::DeltaTuple new_tuple(old_tuple);
+  for (size_t i = 0; i < column_ids.size(); ++i) {
+    new_tuple.SetValue(column_ids[i], values[i]);
+  }
+
+  ItemPointer *indirection =
+      tile_group_header->GetIndirection(physical_tuple_id);
+  bool ret = target_table_->InstallVersion(
+      &new_tuple, &(project_info_->GetTargetList()), current_txn, indirection);
+
+  if (ret == false) {
+    LOG_TRACE("Fail to insert new tuple. Set txn failure.");
+    if (is_owner == false) {
+      transaction_manager.YieldOwnership(current_txn, tile_group_header,
+                                         physical_tuple_id);
+    }
+    transaction_manager.SetTransactionResult(current_txn,
+                                             ResultType::FAILURE);
+    return false;
+  }
+
+  LOG_TRACE("perform delta update: %u, %u", old_location.block,
+            old_location.offset);
+  transaction_manager.PerformDeltaUpdate(current_txn, old_location,
+                                         column_ids, values);
+
+  return true;
+}
+
 /**
  * @brief updates a set of columns
  * @return true on success, false otherwise.
@@ -158,6 +240,20 @@ bool UpdateExecutor::DExecute() {
     LOG_TRACE("Visible Tuple id : %u, Physical Tuple id : %u ",
               visible_tuple_id, physical_tuple_id);
 
+    // the scan may have handed over a copy of a delta-stored tuple.
+    // the update has to be applied to the tuple it was copied from.
+    if (storage::DeltaStorage::IsMaterializedVersion(tile_group_header,
+                                                     physical_tuple_id)) {
+      old_location = storage::DeltaStorage::GetOrigin(tile_group_header,
+                                                      physical_tuple_id);
+
+      auto &manager = catalog::Manager::GetInstance();
+      tile_group = manager.GetTileGroup(old_location.block).get();
+      tile_group_header = tile_group->GetHeader();
+
+      physical_tuple_id = old_location.offset;
+    }
+
     ///////////////////////////////////////////////////////////
     // if running at snapshot isolation, 
     // then we need to retrieve the latest version of this tuple.
@@ -263,6 +359,21 @@ bool UpdateExecutor::DExecute() {
           }
         }
 
+        // Normal update of a delta-stored table
+        else if (target_table_->GetVersionStorageType() ==
+                 VersionStorageType::DELTA) {
+          ret = PerformDeltaUpdate(is_owner, tile_group, tile_group_header,
+                                   physical_tuple_id, old_location);
+
+          if (ret == true) {
+            executor_context_->num_processed += 1;  // updated one
+          }
+          // When fail, ownership release is done inside PerformDeltaUpdate
+          else {
+            return false;
+          }
+        }
+
         // Normal update (no primary key)
         else {
           // if it is the latest version and not locked by other threads, then
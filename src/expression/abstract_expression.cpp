@@ -12,11 +12,25 @@
 
 #include <string>
 #include "expression/abstract_expression.h"
+#include "common/container_tuple.h"
 #include "util/hash_util.h"
 
 namespace peloton {
 namespace expression {
 
+void AbstractExpression::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection,
+    executor::ExecutorContext *context) const {
+  size_t selected_count = 0;
+  for (auto tuple_id : selection) {
+    ContainerTuple<storage::TileGroup> tuple(tile_group, tuple_id);
+    if (Evaluate(&tuple, nullptr, context).IsTrue()) {
+      selection[selected_count++] = tuple_id;
+    }
+  }
+  selection.resize(selected_count);
+}
+
 void AbstractExpression::DeduceExpressionName() {
   // If alias exists, it will be used in TrafficCop
   if (!alias.empty()) return;
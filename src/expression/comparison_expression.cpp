@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// comparison_expression.cpp
+//
+// Identification: src/expression/comparison_expression.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "expression/comparison_expression.h"
+
+#include <functional>
+
+#include "expression/numeric_vector.h"
+
+namespace peloton {
+namespace expression {
+
+// Keep the tuples whose values are not NULL and satisfy the comparator. The
+// selection is compacted without branching on the result.
+template <typename ValueType, typename Comparator>
+static void SelectMatches(const std::vector<ValueType> &left,
+                          const std::vector<ValueType> &right,
+                          const NumericVector &left_vector,
+                          const NumericVector &right_vector,
+                          Comparator comparator,
+                          std::vector<oid_t> &selection) {
+  size_t selected_count = 0;
+  for (size_t index = 0; index < selection.size(); index++) {
+    bool is_null = (left_vector.nulls[index] | right_vector.nulls[index]);
+    bool is_match = !is_null && comparator(left[index], right[index]);
+    selection[selected_count] = selection[index];
+    selected_count += is_match;
+  }
+  selection.resize(selected_count);
+}
+
+template <typename ValueType>
+static void SelectMatches(ExpressionType comparison_type,
+                          const std::vector<ValueType> &left,
+                          const std::vector<ValueType> &right,
+                          const NumericVector &left_vector,
+                          const NumericVector &right_vector,
+                          std::vector<oid_t> &selection) {
+  switch (comparison_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      SelectMatches(left, right, left_vector, right_vector,
+                    std::equal_to<ValueType>(), selection);
+      break;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      SelectMatches(left, right, left_vector, right_vector,
+                    std::not_equal_to<ValueType>(), selection);
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+      SelectMatches(left, right, left_vector, right_vector,
+                    std::less<ValueType>(), selection);
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      SelectMatches(left, right, left_vector, right_vector,
+                    std::less_equal<ValueType>(), selection);
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      SelectMatches(left, right, left_vector, right_vector,
+                    std::greater<ValueType>(), selection);
+      break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      SelectMatches(left, right, left_vector, right_vector,
+                    std::greater_equal<ValueType>(), selection);
+      break;
+    default:
+      throw Exception("Invalid comparison expression type.");
+  }
+}
+
+void ComparisonExpression::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection,
+    executor::ExecutorContext *context) const {
+  PL_ASSERT(children_.size() == 2);
+
+  switch (exp_type_) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      AbstractExpression::EvaluateBatch(tile_group, selection, context);
+      return;
+  }
+
+  if (selection.empty() == true) {
+    return;
+  }
+
+  NumericVector left, right;
+  if (children_[0]->EvaluateNumericBatch(tile_group, selection, context,
+                                         left) == false ||
+      children_[1]->EvaluateNumericBatch(tile_group, selection, context,
+                                         right) == false) {
+    AbstractExpression::EvaluateBatch(tile_group, selection, context);
+    return;
+  }
+
+  if (left.IsDecimal() == false && right.IsDecimal() == false) {
+    SelectMatches(exp_type_, left.integers, right.integers, left, right,
+                  selection);
+    return;
+  }
+
+  // integers are compared with decimals as doubles
+  std::vector<double> left_decimals(selection.size());
+  std::vector<double> right_decimals(selection.size());
+  for (size_t index = 0; index < selection.size(); index++) {
+    left_decimals[index] = left.GetDecimal(index);
+    right_decimals[index] = right.GetDecimal(index);
+  }
+  SelectMatches(exp_type_, left_decimals, right_decimals, left, right,
+                selection);
+}
+
+}  // namespace expression
+}  // namespace peloton
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// conjunction_expression.cpp
+//
+// Identification: src/expression/conjunction_expression.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "expression/conjunction_expression.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace peloton {
+namespace expression {
+
+void ConjunctionExpression::EvaluateBatch(
+    storage::TileGroup *tile_group, std::vector<oid_t> &selection,
+    executor::ExecutorContext *context) const {
+  PL_ASSERT(children_.size() == 2);
+
+  switch (exp_type_) {
+    case ExpressionType::CONJUNCTION_AND: {
+      children_[0]->EvaluateBatch(tile_group, selection, context);
+      if (selection.empty() == false) {
+        children_[1]->EvaluateBatch(tile_group, selection, context);
+      }
+      break;
+    }
+    case ExpressionType::CONJUNCTION_OR: {
+      std::vector<oid_t> left_selection(selection);
+      children_[0]->EvaluateBatch(tile_group, left_selection, context);
+
+      std::vector<oid_t> right_selection;
+      std::set_difference(selection.begin(), selection.end(),
+                          left_selection.begin(), left_selection.end(),
+                          std::back_inserter(right_selection));
+      if (right_selection.empty() == false) {
+        children_[1]->EvaluateBatch(tile_group, right_selection, context);
+      }
+
+      selection.clear();
+      std::merge(left_selection.begin(), left_selection.end(),
+                 right_selection.begin(), right_selection.end(),
+                 std::back_inserter(selection));
+      break;
+    }
+    default:
+      throw Exception("Invalid conjunction expression type.");
+  }
+}
+
+}  // namespace expression
+}  // namespace peloton
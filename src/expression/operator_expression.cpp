@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// operator_expression.cpp
+//
+// Identification: src/expression/operator_expression.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "expression/operator_expression.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "expression/numeric_vector.h"
+
+namespace peloton {
+namespace expression {
+
+// The range of the values of an integer type
+static void GetIntegerRange(type::Type::TypeId type_id, int64_t &min,
+                            int64_t &max) {
+  switch (type_id) {
+    case type::Type::TINYINT:
+      min = type::PELOTON_INT8_MIN;
+      max = type::PELOTON_INT8_MAX;
+      break;
+    case type::Type::SMALLINT:
+      min = type::PELOTON_INT16_MIN;
+      max = type::PELOTON_INT16_MAX;
+      break;
+    case type::Type::INTEGER:
+      min = type::PELOTON_INT32_MIN;
+      max = type::PELOTON_INT32_MAX;
+      break;
+    default:
+      min = type::PELOTON_INT64_MIN;
+      max = type::PELOTON_INT64_MAX;
+      break;
+  }
+}
+
+bool OperatorExpression::EvaluateNumericBatch(
+    storage::TileGroup *tile_group, const std::vector<oid_t> &selection,
+    executor::ExecutorContext *context, NumericVector &result) const {
+  switch (exp_type_) {
+    case ExpressionType::OPERATOR_PLUS:
+    case ExpressionType::OPERATOR_MINUS:
+    case ExpressionType::OPERATOR_MULTIPLY:
+    case ExpressionType::OPERATOR_DIVIDE:
+      break;
+    default:
+      return false;
+  }
+  PL_ASSERT(children_.size() == 2);
+
+  NumericVector left, right;
+  if (children_[0]->EvaluateNumericBatch(tile_group, selection, context,
+                                         left) == false ||
+      children_[1]->EvaluateNumericBatch(tile_group, selection, context,
+                                         right) == false) {
+    return false;
+  }
+
+  // the result has the wider type of the operands
+  size_t size = selection.size();
+  result.Reset(std::max(left.type_id, right.type_id), size);
+  for (size_t index = 0; index < size; index++) {
+    result.nulls[index] = (left.nulls[index] | right.nulls[index]);
+  }
+
+  if (result.IsDecimal() == true) {
+    for (size_t index = 0; index < size; index++) {
+      if (result.nulls[index] != 0) {
+        continue;
+      }
+      double x = left.GetDecimal(index);
+      double y = right.GetDecimal(index);
+      switch (exp_type_) {
+        case ExpressionType::OPERATOR_PLUS:
+          result.decimals[index] = x + y;
+          break;
+        case ExpressionType::OPERATOR_MINUS:
+          result.decimals[index] = x - y;
+          break;
+        case ExpressionType::OPERATOR_MULTIPLY:
+          result.decimals[index] = x * y;
+          break;
+        default:
+          if (y == 0) {
+            return false;
+          }
+          result.decimals[index] = x / y;
+          break;
+      }
+    }
+    return true;
+  }
+
+  int64_t min, max;
+  GetIntegerRange(result.type_id, min, max);
+  for (size_t index = 0; index < size; index++) {
+    if (result.nulls[index] != 0) {
+      continue;
+    }
+    int64_t x = left.integers[index];
+    int64_t y = right.integers[index];
+    int64_t value;
+    bool is_overflow;
+    switch (exp_type_) {
+      case ExpressionType::OPERATOR_PLUS:
+        is_overflow = __builtin_add_overflow(x, y, &value);
+        break;
+      case ExpressionType::OPERATOR_MINUS:
+        is_overflow = __builtin_sub_overflow(x, y, &value);
+        break;
+      case ExpressionType::OPERATOR_MULTIPLY:
+        is_overflow = __builtin_mul_overflow(x, y, &value);
+        break;
+      default:
+        if (y == 0) {
+          return false;
+        }
+        // the quotient of the smallest value and -1 overflows, like its
+        // negation
+        if (y == -1) {
+          is_overflow = __builtin_sub_overflow((int64_t)0, x, &value);
+        } else {
+          value = x / y;
+          is_overflow = false;
+        }
+        break;
+    }
+    if (is_overflow == true || value < min || value > max) {
+      throw Exception(EXCEPTION_TYPE_OUT_OF_RANGE,
+                      "Numeric value out of range.");
+    }
+    result.integers[index] = value;
+  }
+  return true;
+}
+
+}  // namespace expression
+}  // namespace peloton
@@ -12,7 +12,10 @@
 
 #include <string>
 #include "common/abstract_tuple.h"
+#include "expression/numeric_vector.h"
 #include "expression/tuple_value_expression.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
 #include "util/hash_util.h"
 
 namespace peloton {
@@ -29,6 +32,77 @@ type::Value TupleValueExpression::Evaluate(
   }
 }
 
+// Copy the column values at the locations into the vector, marking the ones
+// equal to the NULL value of the type
+template <typename ValueType, typename VectorType>
+static void GatherColumn(const std::vector<const char *> &locations,
+                         const ValueType &null_value,
+                         std::vector<VectorType> &values,
+                         std::vector<uint8_t> &nulls) {
+  for (size_t index = 0; index < locations.size(); index++) {
+    auto value = *reinterpret_cast<const ValueType *>(locations[index]);
+    values[index] = value;
+    nulls[index] = (value == null_value);
+  }
+}
+
+bool TupleValueExpression::EvaluateNumericBatch(
+    storage::TileGroup *tile_group, const std::vector<oid_t> &selection,
+    UNUSED_ATTRIBUTE executor::ExecutorContext *context,
+    NumericVector &result) const {
+  if (tuple_idx_ != 0 || value_idx_ < 0) {
+    return false;
+  }
+
+  oid_t tile_offset, tile_column_offset;
+  tile_group->LocateTileAndColumn(value_idx_, tile_offset, tile_column_offset);
+  auto tile = tile_group->GetTile(tile_offset);
+  auto schema = tile->GetSchema();
+  auto column_type = schema->GetType(tile_column_offset);
+  switch (column_type) {
+    case type::Type::TINYINT:
+    case type::Type::SMALLINT:
+    case type::Type::INTEGER:
+    case type::Type::BIGINT:
+    case type::Type::DECIMAL:
+      break;
+    default:
+      return false;
+  }
+
+  size_t column_offset = schema->GetOffset(tile_column_offset);
+  std::vector<const char *> locations(selection.size());
+  for (size_t index = 0; index < selection.size(); index++) {
+    locations[index] =
+        tile->GetTupleLocation(selection[index]) + column_offset;
+  }
+
+  result.Reset(column_type, selection.size());
+  switch (column_type) {
+    case type::Type::TINYINT:
+      GatherColumn(locations, type::PELOTON_INT8_NULL, result.integers,
+                   result.nulls);
+      break;
+    case type::Type::SMALLINT:
+      GatherColumn(locations, type::PELOTON_INT16_NULL, result.integers,
+                   result.nulls);
+      break;
+    case type::Type::INTEGER:
+      GatherColumn(locations, type::PELOTON_INT32_NULL, result.integers,
+                   result.nulls);
+      break;
+    case type::Type::BIGINT:
+      GatherColumn(locations, type::PELOTON_INT64_NULL, result.integers,
+                   result.nulls);
+      break;
+    default:
+      GatherColumn(locations, type::PELOTON_DECIMAL_NULL, result.decimals,
+                   result.nulls);
+      break;
+  }
+  return true;
+}
+
 hash_t TupleValueExpression::Hash() const {
   hash_t hash = HashUtil::Hash(&exp_type_);
   hash = HashUtil::CombineHashes(hash,
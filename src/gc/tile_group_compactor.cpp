@@ -0,0 +1,547 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor.cpp
+//
+// Identification: src/gc/tile_group_compactor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "gc/tile_group_compactor.h"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/container_tuple.h"
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "gc/gc_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile.h"
+#include "storage/tile_group_header.h"
+#include "type/arena_pool.h"
+
+namespace peloton {
+namespace gc {
+
+TileGroupCompactor &TileGroupCompactor::GetInstance() {
+  static TileGroupCompactor tile_group_compactor;
+  return tile_group_compactor;
+}
+
+TileGroupCompactor::TileGroupCompactor() : compaction_stop(true) {}
+
+TileGroupCompactor::~TileGroupCompactor() {}
+
+void TileGroupCompactor::Start() {
+  // Set signal
+  compaction_stop = false;
+
+  // Launch thread
+  compactor_thread = std::thread(&gc::TileGroupCompactor::Compact, this);
+
+  LOG_INFO("Started tile group compactor");
+}
+
+void TileGroupCompactor::Compact() {
+  // Continue till signal is not false
+  while (compaction_stop == false) {
+    CompactTables();
+
+    // Sleep a bit
+    std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
+  }
+}
+
+void TileGroupCompactor::Stop() {
+  // Stop compaction
+  compaction_stop = true;
+
+  // Stop thread
+  compactor_thread.join();
+
+  LOG_INFO("Stopped tile group compactor");
+}
+
+size_t TileGroupCompactor::CompactTables() {
+  std::lock_guard<std::mutex> lock(compactor_mutex);
+
+  size_t dropped_count = 0;
+  for (auto table : tables) {
+    dropped_count += CompactTable(table);
+    FreezeTable(table);
+  }
+
+  ReleasePools();
+
+  if (dropped_count > 0) {
+    ReleaseMemory();
+  }
+
+  return dropped_count;
+}
+
+size_t TileGroupCompactor::CompactTable(storage::DataTable *table) {
+  // without gc, the old versions of the moved tuples are never reclaimed
+  if (GCManagerFactory::GetGCType() == GarbageCollectionType::OFF) {
+    return 0;
+  }
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+
+  auto &compacting = compacting_tile_groups[table->GetOid()];
+
+  size_t dropped_count = 0;
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t offset = 0; offset < tile_group_count; ++offset) {
+    auto tile_group = table->GetTileGroup(offset);
+    auto tile_group_id = tile_group->GetTileGroupId();
+
+    // skip dropped tile groups and the ones that are still being filled
+    if (tile_group_id == INVALID_OID ||
+        table->IsActiveTileGroup(tile_group_id) == true) {
+      continue;
+    }
+
+    auto compacting_itr = compacting.find(tile_group_id);
+    if (compacting_itr == compacting.end()) {
+      if (IsSparse(tile_group.get()) == true) {
+        LOG_TRACE("Compacting tile group : %u ", tile_group_id);
+        tile_group->GetHeader()->SetCompacting(true);
+        compacting[tile_group_id] = epoch_manager.GetCurrentEpochId();
+      }
+      continue;
+    }
+
+    // a transaction that claimed a recycled slot of the tile group before it
+    // was marked may still be running.
+    if (compacting_itr->second > expired_eid) {
+      continue;
+    }
+
+    if (IsEmpty(tile_group.get()) == true) {
+      table->DropTileGroup(offset);
+      compacting.erase(compacting_itr);
+      dropped_count++;
+      continue;
+    }
+
+    MigrateTuples(table, tile_group.get());
+  }
+
+  return dropped_count;
+}
+
+size_t TileGroupCompactor::ReorganizeTable(
+    storage::DataTable *table, const double &theta,
+    const size_t &max_tile_group_count) {
+  std::lock_guard<std::mutex> lock(compactor_mutex);
+
+  // without gc, the old versions of the moved tuples are never reclaimed
+  if (GCManagerFactory::GetGCType() == GarbageCollectionType::OFF) {
+    return 0;
+  }
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto default_layout = table->GetDefaultTileGroupLayout();
+
+  auto &compacting = compacting_tile_groups[table->GetOid()];
+
+  size_t marked_count = 0;
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t offset = 0;
+       offset < tile_group_count && marked_count < max_tile_group_count;
+       ++offset) {
+    auto tile_group = table->GetTileGroup(offset);
+    auto tile_group_id = tile_group->GetTileGroupId();
+
+    if (tile_group_id == INVALID_OID ||
+        table->IsActiveTileGroup(tile_group_id) == true ||
+        compacting.count(tile_group_id) != 0) {
+      continue;
+    }
+
+    if (tile_group->GetSchemaDifference(default_layout) < theta) {
+      continue;
+    }
+
+    LOG_TRACE("Reorganizing tile group : %u ", tile_group_id);
+    tile_group->GetHeader()->SetCompacting(true);
+    compacting[tile_group_id] = epoch_manager.GetCurrentEpochId();
+    marked_count++;
+  }
+
+  CompactTable(table);
+
+  return marked_count;
+}
+
+size_t TileGroupCompactor::FreezeTable(storage::DataTable *table) {
+  // the versions of a delta-stored tuple are not all in its tile group
+  if (table->GetVersionStorageType() == VersionStorageType::DELTA) {
+    return 0;
+  }
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+
+  auto &cold = cold_tile_groups[table->GetOid()];
+
+  size_t frozen_count = 0;
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t offset = 0; offset < tile_group_count; ++offset) {
+    auto tile_group = table->GetTileGroup(offset);
+    auto tile_group_id = tile_group->GetTileGroupId();
+    auto tile_group_header = tile_group->GetHeader();
+
+    if (tile_group_id == INVALID_OID ||
+        table->IsActiveTileGroup(tile_group_id) == true ||
+        tile_group_header->IsCompacting() == true ||
+        tile_group_header->IsUnfrozen() == false) {
+      continue;
+    }
+
+    auto cold_itr = cold.find(tile_group_id);
+    if (cold_itr == cold.end()) {
+      cid_t max_begin_cid;
+      if (IsCold(tile_group.get(), max_begin_cid) == true) {
+        cold[tile_group_id] =
+            std::make_pair(epoch_manager.GetCurrentEpochId(), max_begin_cid);
+      }
+      continue;
+    }
+
+    // a transaction that started before the versions were committed may
+    // still be running.
+    if (cold_itr->second.first > expired_eid) {
+      continue;
+    }
+
+    auto cold_begin_cid = cold_itr->second.second;
+    cold.erase(cold_itr);
+
+    if (FreezeTileGroup(tile_group.get(), cold_begin_cid) == true) {
+      frozen_count++;
+    }
+  }
+
+  return frozen_count;
+}
+
+bool TileGroupCompactor::IsCold(storage::TileGroup *tile_group,
+                                cid_t &max_begin_cid) const {
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t allocated_tuple_count = tile_group->GetAllocatedTupleCount();
+
+  // a free slot may be refilled
+  if (tile_group->GetNextTupleSlot() < allocated_tuple_count) {
+    return false;
+  }
+
+  max_begin_cid = 0;
+  for (oid_t tuple_id = 0; tuple_id < allocated_tuple_count; tuple_id++) {
+    auto begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+    if (tile_group_header->GetTransactionId(tuple_id) != INITIAL_TXN_ID ||
+        begin_cid == MAX_CID ||
+        tile_group_header->GetEndCommitId(tuple_id) != MAX_CID ||
+        tile_group_header->GetDeltaPointer(tuple_id) != nullptr) {
+      return false;
+    }
+    max_begin_cid = std::max(max_begin_cid, begin_cid);
+  }
+
+  return true;
+}
+
+bool TileGroupCompactor::FreezeTileGroup(storage::TileGroup *tile_group,
+                                         const cid_t &cold_begin_cid) {
+  auto tile_group_header = tile_group->GetHeader();
+
+  // a writer unfreezes the tile group after it owns a version, so either the
+  // checks below see the ownership, or the writer undoes the freezing.
+  tile_group_header->StartFreezing();
+
+  if (IsStillCold(tile_group, cold_begin_cid) == false) {
+    tile_group_header->Unfreeze();
+    return false;
+  }
+
+  // the varlen values are moved while no writer owns a version, so the GC
+  // never frees a moved value into the pool it was allocated from.
+  if (EncodeVarlenValues(tile_group, cold_begin_cid) == false ||
+      tile_group_header->FinishFreezing() == false) {
+    tile_group_header->Unfreeze();
+    return false;
+  }
+
+  LOG_TRACE("Froze tile group : %u ", tile_group->GetTileGroupId());
+
+  return true;
+}
+
+bool TileGroupCompactor::IsStillCold(storage::TileGroup *tile_group,
+                                     const cid_t &cold_begin_cid) const {
+  // a writer that owned a version has unfrozen the tile group
+  if (tile_group->GetHeader()->IsUnfrozen() == true) {
+    return false;
+  }
+
+  // a slot may have been refilled with a version that is newer than the
+  // transactions that are still running.
+  cid_t max_begin_cid;
+  return IsCold(tile_group, max_begin_cid) == true &&
+         max_begin_cid <= cold_begin_cid;
+}
+
+bool TileGroupCompactor::EncodeVarlenValues(storage::TileGroup *tile_group,
+                                            const cid_t &cold_begin_cid) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  oid_t allocated_tuple_count = tile_group->GetAllocatedTupleCount();
+
+  // the dictionary of each tile, and the new location of each varlen value
+  std::vector<std::unique_ptr<type::ArenaPool>> dictionary_pools(
+      tile_group->NumTiles());
+  std::vector<std::pair<char **, char *>> moved_values;
+
+  for (oid_t tile_itr = 0; tile_itr < tile_group->NumTiles(); tile_itr++) {
+    auto tile = tile_group->GetTile(tile_itr);
+    auto schema = tile->GetSchema();
+    oid_t uninlined_column_count = schema->GetUninlinedColumnCount();
+    if (uninlined_column_count == 0) {
+      continue;
+    }
+
+    std::unique_ptr<type::ArenaPool> dictionary_pool(new type::ArenaPool());
+    std::unordered_map<std::string, char *> dictionary;
+
+    for (oid_t column_itr = 0; column_itr < uninlined_column_count;
+         column_itr++) {
+      auto column_offset =
+          schema->GetOffset(schema->GetUninlinedColumn(column_itr));
+
+      for (oid_t tuple_id = 0; tuple_id < allocated_tuple_count; tuple_id++) {
+        auto field_location = reinterpret_cast<char **>(
+            tile->GetTupleLocation(tuple_id) + column_offset);
+        char *varlen_ptr = *field_location;
+        if (varlen_ptr == nullptr) {
+          continue;
+        }
+
+        // the value is prefixed with its length
+        uint32_t varlen_length;
+        PL_MEMCPY(&varlen_length, varlen_ptr, sizeof(uint32_t));
+        std::string key(varlen_ptr, varlen_length + sizeof(uint32_t));
+
+        // an entry is shared by all slots holding its value, and is only
+        // released once the GC has freed each of them.
+        auto dictionary_itr = dictionary.find(key);
+        if (dictionary_itr == dictionary.end()) {
+          auto entry_ptr =
+              static_cast<char *>(dictionary_pool->Allocate(key.size()));
+          PL_MEMCPY(entry_ptr, key.data(), key.size());
+          dictionary_itr = dictionary.emplace(key, entry_ptr).first;
+        } else {
+          dictionary_pool->AddReference(dictionary_itr->second);
+        }
+
+        moved_values.emplace_back(field_location, dictionary_itr->second);
+      }
+    }
+
+    dictionary_pools[tile_itr] = std::move(dictionary_pool);
+  }
+
+  // a writer may have owned a version while the dictionaries were built
+  if (IsStillCold(tile_group, cold_begin_cid) == false) {
+    return false;
+  }
+
+  // readers see either the old or the new location, which both stay valid
+  // until the old pool is released.
+  for (auto &moved_value : moved_values) {
+    *moved_value.first = moved_value.second;
+  }
+
+  for (oid_t tile_itr = 0; tile_itr < tile_group->NumTiles(); tile_itr++) {
+    if (dictionary_pools[tile_itr] == nullptr) {
+      continue;
+    }
+    retired_pools.emplace_back(
+        epoch_manager.GetCurrentEpochId(),
+        std::unique_ptr<type::AbstractPool>(
+            tile_group->GetTile(tile_itr)->ReplacePool(
+                dictionary_pools[tile_itr].release())));
+  }
+
+  return true;
+}
+
+bool TileGroupCompactor::IsSparse(storage::TileGroup *tile_group) const {
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t allocated_tuple_count = tile_group->GetAllocatedTupleCount();
+  oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+  oid_t occupied_tuple_count = 0;
+  for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+    if (tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID) {
+      occupied_tuple_count++;
+    }
+  }
+
+  return occupied_tuple_count <= occupancy_threshold * allocated_tuple_count;
+}
+
+bool TileGroupCompactor::IsEmpty(storage::TileGroup *tile_group) const {
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+  for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+    if (tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID ||
+        tile_group_header->GetDeltaPointer(tuple_id) != nullptr) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+size_t TileGroupCompactor::MigrateTuples(storage::DataTable *table,
+                                        storage::TileGroup *tile_group) {
+  auto &manager = catalog::Manager::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+  oid_t column_count = table->GetSchema()->GetColumnCount();
+
+  size_t moved_count = 0;
+
+  auto txn = txn_manager.BeginTransaction();
+
+  for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+    // only the latest version of a tuple is moved.
+    // older versions are left to the gc.
+    if (txn_manager.IsOwnable(txn, tile_group_header, tuple_id) == false ||
+        txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+            VisibilityType::OK) {
+      continue;
+    }
+
+    if (txn_manager.AcquireOwnership(txn, tile_group_header, tuple_id) ==
+        false) {
+      continue;
+    }
+
+    // a delta-stored tuple is moved once its deltas are merged
+    if (tile_group_header->GetDeltaPointer(tuple_id) != nullptr) {
+      txn_manager.YieldOwnership(txn, tile_group_header, tuple_id);
+      continue;
+    }
+
+    // the tuples moved out of a tile group of an older layout must not land
+    // in another one
+    ItemPointer new_location = table->AcquireVersionInDefaultLayout();
+    if (new_location.IsNull() == true) {
+      txn_manager.YieldOwnership(txn, tile_group_header, tuple_id);
+      break;
+    }
+
+    auto new_tile_group = manager.GetTileGroup(new_location.block);
+
+    expression::ContainerTuple<storage::TileGroup> old_tuple(tile_group,
+                                                             tuple_id);
+    expression::ContainerTuple<storage::TileGroup> new_tuple(
+        new_tile_group.get(), new_location.offset);
+
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      new_tuple.SetValue(column_id, old_tuple.GetValue(column_id));
+    }
+
+    // the indexes reach the new version through the indirection
+    txn_manager.PerformUpdate(txn, ItemPointer(tile_group_id, tuple_id),
+                              new_location);
+    moved_count++;
+  }
+
+  // the moved versions are rolled back if the commit fails, and the tile
+  // group is tried again in the next round
+  if (txn_manager.CommitTransaction(txn) != ResultType::SUCCESS) {
+    LOG_TRACE("Failed to move tuples out of tile group : %u ", tile_group_id);
+    return 0;
+  }
+
+  LOG_TRACE("Moved %lu tuples out of tile group : %u ", moved_count,
+            tile_group_id);
+
+  return moved_count;
+}
+
+void TileGroupCompactor::ReleaseMemory() {
+  // the large tiles and headers of the dropped tile groups went back to the
+  // slabs of the storage manager. their small tiles and varlen pools are on
+  // the heap, which is not shrunk on free.
+  malloc_trim(0);
+}
+
+void TileGroupCompactor::ReleasePools() {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+
+  retired_pools.erase(
+      std::remove_if(retired_pools.begin(), retired_pools.end(),
+                     [&expired_eid](
+                         const std::pair<eid_t,
+                                         std::unique_ptr<type::AbstractPool>>
+                             &retired_pool) {
+                       return retired_pool.first <= expired_eid;
+                     }),
+      retired_pools.end());
+}
+
+void TileGroupCompactor::AddTable(storage::DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(compactor_mutex);
+    LOG_TRACE("Tile group compactor adding table : %p", table);
+
+    tables.push_back(table);
+  }
+}
+
+void TileGroupCompactor::DropTable(const oid_t &table_id) {
+  {
+    std::lock_guard<std::mutex> lock(compactor_mutex);
+
+    tables.erase(std::remove_if(tables.begin(), tables.end(),
+                                [&table_id](storage::DataTable *table) {
+                                  return table->GetOid() == table_id;
+                                }),
+                 tables.end());
+
+    compacting_tile_groups.erase(table_id);
+    cold_tile_groups.erase(table_id);
+  }
+}
+
+void TileGroupCompactor::ClearTables() {
+  {
+    std::lock_guard<std::mutex> lock(compactor_mutex);
+    tables.clear();
+    compacting_tile_groups.clear();
+    cold_tile_groups.clear();
+  }
+}
+
+}  // End gc namespace
+}  // End peloton namespace
@@ -12,8 +12,13 @@
 
 #include "gc/transaction_level_gc_manager.h"
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_set>
+
 #include "storage/tuple.h"
 #include "storage/database.h"
+#include "storage/delta_storage.h"
 #include "storage/tile_group.h"
 #include "catalog/manager.h"
 #include "concurrency/transaction_manager_factory.h"
@@ -39,6 +44,10 @@ bool TransactionLevelGCManager::ResetTuple(const ItemPointer &location) {
   PL_MEMSET(tile_group_header->GetReservedFieldRef(location.offset), 0,
             storage::TileGroupHeader::GetReservedSize());
 
+  // Deltas that have not been merged yet belong to the reclaimed tuple
+  storage::DeltaStorage::GetInstance().DiscardDeltas(tile_group_header,
+                                                     location.offset);
+
   // Reclaim the varlen pool
   CheckAndReclaimVarlenColumns(tile_group, location.offset);
 
@@ -64,10 +73,16 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
 
     int unlinked_count = Unlink(thread_id, expired_eid);
 
+    // Merge the deltas that every running transaction can see into the tuples
+    int merged_count =
+        storage::DeltaStorage::GetInstance().Merge(expired_eid);
+
+    DrainIdleSlotCaches(expired_eid);
+
     if (is_running_ == false) {
       return;
     }
-    if (reclaimed_count == 0 && unlinked_count == 0) {
+    if (reclaimed_count == 0 && unlinked_count == 0 && merged_count == 0) {
       // sleep at most 0.8192 s
       if (backoff_shifts < 13) {
         ++backoff_shifts;
@@ -88,33 +103,91 @@ void TransactionLevelGCManager::RecycleTransaction(std::shared_ptr<GCSet> gc_set
   // Add the garbage context to the lock-free queue
   std::shared_ptr<GarbageContext> gc_context(new GarbageContext(gc_set, epoch_id));
   unlink_queues_[HashToThread(thread_id)]->Enqueue(gc_context);
+
+  if (is_cooperative_ == true) {
+    CollectGarbage(thread_id);
+  }
+}
+
+// executed by worker threads in cooperative mode.
+// a worker collects at most a batch of garbage contexts and deltas of the
+// partition it hashes to on every commit, so that no commit stalls on a
+// large backlog, while the backlog is still worked off as fast as the
+// commits add to it. the version chains are therefore kept short without
+// dedicated gc threads.
+int TransactionLevelGCManager::CollectGarbage(const size_t &thread_id) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+
+  if (expired_eid == MAX_EID) {
+    return 0;
+  }
+
+  unsigned int partition_id = HashToThread(thread_id);
+
+  // another worker is collecting the same partition
+  if (partition_locks_[partition_id].TryLock() == false) {
+    return 0;
+  }
+
+  int collected_count =
+      Reclaim(partition_id, expired_eid, COOPERATIVE_ATTEMPT_COUNT);
+
+  collected_count +=
+      Unlink(partition_id, expired_eid, COOPERATIVE_ATTEMPT_COUNT);
+
+  // finding the expired deltas scans all the committed ones, so every commit
+  // merges a batch only until all of them are merged for the expired epoch.
+  if (collected_eids_[partition_id] != expired_eid) {
+    bool is_truncated = false;
+    collected_count += storage::DeltaStorage::GetInstance().Merge(
+        expired_eid, COOPERATIVE_ATTEMPT_COUNT, &is_truncated);
+    if (is_truncated == false) {
+      collected_eids_[partition_id] = expired_eid;
+    }
+  }
+
+  partition_locks_[partition_id].Unlock();
+
+  DrainIdleSlotCaches(expired_eid);
+
+  return collected_count;
 }
 
-int TransactionLevelGCManager::Unlink(const int &thread_id, const eid_t &expired_eid) {
+int TransactionLevelGCManager::Unlink(const int &thread_id, const eid_t &expired_eid,
+                                      const size_t &max_attempt_count) {
   
   int tuple_counter = 0;
 
   // check if any garbage can be unlinked from indexes.
-  // every time we garbage collect at most MAX_ATTEMPT_COUNT tuples.
+  // every time we garbage collect at most max_attempt_count tuples.
   std::vector<std::shared_ptr<GarbageContext>> garbages;
-
-  // First iterate the local unlink queue
-  local_unlink_queues_[thread_id].remove_if(
-    [&garbages, &tuple_counter, expired_eid]
-        (const std::shared_ptr<GarbageContext>& garbage_ctx) -> bool {
-      bool res = garbage_ctx->epoch_id_ <= expired_eid;
-      if (res == true) {
-        // TODO: carefully think about how to delete tuple from indexes!
-        // DeleteFromIndexes(garbage_ctx);
-        // Add to the garbage map
-        garbages.push_back(garbage_ctx);
-        tuple_counter++;
+  size_t attempt_count = 0;
+
+  // First iterate the local unlink queue. the epochs of its garbage are not
+  // in order, so the whole queue is scanned. in cooperative mode, the garbage
+  // taken from it counts towards the batch of the commit.
+  auto &local_unlink_queue = local_unlink_queues_[thread_id];
+  auto garbage_itr = local_unlink_queue.begin();
+  while (garbage_itr != local_unlink_queue.end() &&
+         attempt_count < max_attempt_count) {
+    if ((*garbage_itr)->epoch_id_ <= expired_eid) {
+      // TODO: carefully think about how to delete tuple from indexes!
+      // DeleteFromIndexes(garbage_ctx);
+      // Add to the garbage map
+      garbages.push_back(*garbage_itr);
+      garbage_itr = local_unlink_queue.erase(garbage_itr);
+      tuple_counter++;
+      if (is_cooperative_ == true) {
+        attempt_count++;
       }
-      return res;
+    } else {
+      ++garbage_itr;
     }
-  );
+  }
 
-  for (size_t i = 0; i < MAX_ATTEMPT_COUNT; ++i) {
+  for (; attempt_count < max_attempt_count; ++attempt_count) {
     std::shared_ptr<GarbageContext> garbage_ctx;
     // if there's no more tuples in the queue, then break.
     if (unlink_queues_[thread_id]->Dequeue(garbage_ctx) == false) {
@@ -135,7 +208,7 @@ int TransactionLevelGCManager::Unlink(const int &thread_id, const eid_t &expired
 
     } else {
       // if a tuple cannot be reclaimed, then add it back to the list.
-      local_unlink_queues_[thread_id].push_back(garbage_ctx);
+      local_unlink_queue.push_back(garbage_ctx);
     }
   }  // end for
 
@@ -152,12 +225,14 @@ int TransactionLevelGCManager::Unlink(const int &thread_id, const eid_t &expired
 }
 
 // executed by a single thread. so no synchronization is required.
-int TransactionLevelGCManager::Reclaim(const int &thread_id, const eid_t &expired_eid) {
+int TransactionLevelGCManager::Reclaim(const int &thread_id, const eid_t &expired_eid,
+                                       const size_t &max_attempt_count) {
   int gc_counter = 0;
 
   // we delete garbage in the free list
   auto garbage_ctx_entry = reclaim_maps_[thread_id].begin();
-  while (garbage_ctx_entry != reclaim_maps_[thread_id].end()) {
+  while (garbage_ctx_entry != reclaim_maps_[thread_id].end() &&
+         (size_t)gc_counter < max_attempt_count) {
     const eid_t garbage_eid = garbage_ctx_entry->first;
     auto garbage_ctx = garbage_ctx_entry->second;
 
@@ -186,9 +261,9 @@ void TransactionLevelGCManager::AddToRecycleMap(
     auto tile_group = manager.GetTileGroup(entry.first);
 
     // During the resetting, a table may be deconstructed because of the DROP
-    // TABLE request
+    // TABLE request, or the tile group may have been dropped by the compactor
     if (tile_group == nullptr) {
-      return;
+      continue;
     }
 
     PL_ASSERT(tile_group != nullptr);
@@ -199,6 +274,9 @@ void TransactionLevelGCManager::AddToRecycleMap(
 
     oid_t table_id = table->GetOid();
 
+    std::vector<ItemPointer> free_slots;
+    free_slots.reserve(entry.second.size());
+
     for (auto &element : entry.second) {
       // as this transaction has been committed, we should reclaim older
       // versions.
@@ -208,31 +286,202 @@ void TransactionLevelGCManager::AddToRecycleMap(
       if (ResetTuple(location) == false) {
         continue;
       }
-      // if the entry for table_id exists.
-      if (recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
-        recycle_queue_map_[table_id]->Enqueue(location);
-      }
+      free_slots.push_back(location);
     }
+
+    // recycle the slots of the tile group as a single batch
+    AddToRecycleQueue(table_id, free_slots);
+  }
+}
+
+void TransactionLevelGCManager::AddToRecycleQueue(
+    const oid_t &table_id, std::vector<ItemPointer> &free_slots) {
+  if (free_slots.empty() == true) {
+    return;
   }
+
+  // the slots are handed out from the back of the batch.
+  // hand them out in the order of their offsets.
+  std::sort(free_slots.begin(), free_slots.end(),
+            [](const ItemPointer &lhs, const ItemPointer &rhs) {
+              return lhs.offset > rhs.offset;
+            });
+
+  recycle_queue_map_lock_.ReadLock();
+  auto recycle_queue_itr = recycle_queue_map_.find(table_id);
+  // if the entry for table_id exists.
+  if (recycle_queue_itr != recycle_queue_map_.end()) {
+    recycle_queue_itr->second->Enqueue(free_slots);
+  }
+  recycle_queue_map_lock_.Unlock();
 }
 
+namespace {
+
+// free slots taken from the recycle queue of a table by the current thread.
+struct FreeSlotCache {
+  // recycle queue of the table, null if the table is not registered
+  std::shared_ptr<LockFreeQueue<std::vector<ItemPointer>>> recycle_queue;
+
+  // free slots of one tile group
+  std::vector<ItemPointer> free_slots;
+
+  // epoch in which the free slots were taken from the recycle queue
+  eid_t cached_eid = INVALID_EID;
+};
+
+// the free slot caches of one thread. they are given back to the recycle
+// queues instead of being dropped, so that no free slot is lost.
+struct ThreadSlotCaches {
+  ThreadSlotCaches();
+
+  ~ThreadSlotCaches();
+
+  // give the cached slots back to the recycle queues of their tables
+  void Flush();
+
+  // taken by the owning thread while it uses the caches, and by the gc while
+  // it drains them
+  Spinlock lock;
+
+  // recycle generation the cached entries belong to
+  uint64_t generation = 0;
+
+  // epoch in which the owning thread last took a slot
+  eid_t last_used_eid = 0;
+
+  // table id -> cached entry
+  std::unordered_map<oid_t, FreeSlotCache> caches;
+};
+
+// the slot caches of all running threads
+struct SlotCacheRegistry {
+  std::mutex mutex;
+
+  std::unordered_set<ThreadSlotCaches *> thread_caches;
+};
+
+// never destroyed, as threads may still exit after the static destructors
+SlotCacheRegistry &GetSlotCacheRegistry() {
+  static SlotCacheRegistry *registry = new SlotCacheRegistry();
+  return *registry;
+}
+
+ThreadSlotCaches::ThreadSlotCaches() {
+  auto &registry = GetSlotCacheRegistry();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+  registry.thread_caches.insert(this);
+}
+
+ThreadSlotCaches::~ThreadSlotCaches() {
+  {
+    auto &registry = GetSlotCacheRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    registry.thread_caches.erase(this);
+  }
+  Flush();
+}
+
+void ThreadSlotCaches::Flush() {
+  for (auto &entry : caches) {
+    auto &cache = entry.second;
+    // the queue of a dropped table is only held by the cache, and the slots
+    // are released with it
+    if (cache.recycle_queue != nullptr && cache.free_slots.empty() == false) {
+      cache.recycle_queue->Enqueue(cache.free_slots);
+      cache.free_slots.clear();
+    }
+  }
+}
+
+thread_local ThreadSlotCaches thread_slot_caches;
+
+}  // namespace
+
 // this function returns a free tuple slot, if one exists
 // called by data_table.
 ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id) {
+  auto &thread_caches = thread_slot_caches;
+  thread_caches.lock.Lock();
+
+  auto current_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  thread_caches.last_used_eid = current_eid;
+
+  // refresh the cached queues if any table has been (de)registered since
+  auto generation = recycle_generation_.load();
+  if (thread_caches.generation != generation) {
+    thread_caches.Flush();
+    thread_caches.caches.clear();
+    thread_caches.generation = generation;
+  }
+
+  auto cache_itr = thread_caches.caches.find(table_id);
+  if (cache_itr == thread_caches.caches.end()) {
+    FreeSlotCache cache;
+    recycle_queue_map_lock_.ReadLock();
+    auto recycle_queue_itr = recycle_queue_map_.find(table_id);
+    if (recycle_queue_itr != recycle_queue_map_.end()) {
+      cache.recycle_queue = recycle_queue_itr->second;
+    }
+    recycle_queue_map_lock_.Unlock();
+    cache_itr = thread_caches.caches.emplace(table_id, std::move(cache)).first;
+  }
+
+  auto &cache = cache_itr->second;
+
+  // cached slots are only handed out in the epoch in which they were taken
+  // from the queue, as uncached ones would be. the compactor waits for the
+  // epoch in which it marks a tile group, which then also covers the slots
+  // of the tile group that were cached before. older slots go back.
+  if (cache.free_slots.empty() == false && cache.cached_eid != current_eid) {
+    cache.recycle_queue->Enqueue(cache.free_slots);
+    cache.free_slots.clear();
+  }
+
   // for catalog tables, we directly return invalid item pointer.
-  if (recycle_queue_map_.find(table_id) == recycle_queue_map_.end()) {
-    return INVALID_ITEMPOINTER;
+  // otherwise take the next batch of free slots once the cached one is used.
+  ItemPointer location = INVALID_ITEMPOINTER;
+  if (cache.recycle_queue != nullptr && cache.free_slots.empty() == true &&
+      cache.recycle_queue->Dequeue(cache.free_slots) == true) {
+    cache.cached_eid = current_eid;
   }
-  ItemPointer location;
-  PL_ASSERT(recycle_queue_map_.find(table_id) != recycle_queue_map_.end());
-  auto recycle_queue = recycle_queue_map_[table_id];
 
-  if (recycle_queue->Dequeue(location) == true) {
+  if (cache.free_slots.empty() == false) {
+    location = cache.free_slots.back();
+    cache.free_slots.pop_back();
+
     LOG_TRACE("Reuse tuple(%u, %u) in table %u", location.block,
               location.offset, table_id);
-    return location;
   }
-  return INVALID_ITEMPOINTER;
+
+  thread_caches.lock.Unlock();
+  return location;
+}
+
+// the slots cached by a thread that stopped inserting would otherwise never
+// be reused by the other threads.
+void TransactionLevelGCManager::DrainIdleSlotCaches(const eid_t &expired_eid) {
+  // drain once per expired epoch
+  auto drained_eid = drained_eid_.load();
+  if (drained_eid == expired_eid ||
+      drained_eid_.compare_exchange_strong(drained_eid, expired_eid) ==
+          false) {
+    return;
+  }
+
+  auto &registry = GetSlotCacheRegistry();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+  for (auto thread_caches : registry.thread_caches) {
+    // a thread holding its lock is not idle
+    if (thread_caches->lock.TryLock() == false) {
+      continue;
+    }
+    if (thread_caches->last_used_eid < expired_eid) {
+      thread_caches->Flush();
+    }
+    thread_caches->lock.Unlock();
+  }
 }
 
 void TransactionLevelGCManager::ClearGarbage(int thread_id) {
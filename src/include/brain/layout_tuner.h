@@ -15,6 +15,7 @@
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "brain/clusterer.h"
@@ -64,10 +65,22 @@ class LayoutTuner {
 
   std::string GetColumnMapInfo(const column_map_type &column_map);
 
+  void SetReorganizationBatchSize(const oid_t &batch_size) {
+    reorganization_batch_size = batch_size;
+  }
+
+  // Number of tile groups handed to the compactor for rewriting so far
+  size_t GetReorganizedTileGroupCount() const {
+    return reorganized_tile_group_count.load();
+  }
+
  protected:
   // Update layout of table
   void UpdateDefaultPartition(storage::DataTable *table);
 
+  // Rewrite some existing tile groups of the table into its default layout
+  void ReorganizeTable(storage::DataTable *table);
+
  private:
   // Tables whose layout must be tuned
   std::vector<storage::DataTable *> tables;
@@ -80,6 +93,11 @@ class LayoutTuner {
   // Tuner thread
   std::thread layout_tuner_thread;
 
+  // Tuning rounds since the last reorganization of each table
+  std::unordered_map<oid_t, oid_t> rounds_since_reorganization;
+
+  std::atomic<size_t> reorganized_tile_group_count;
+
   //===--------------------------------------------------------------------===//
   // Tuner Parameters
   //===--------------------------------------------------------------------===//
@@ -89,8 +107,8 @@ class LayoutTuner {
   // This is a critical parameter. It measures the difference between the schema
   // of a existing tilegroup and the desired schema, and normalizes this difference
   // with respect to the column count, so that it falls within [0, 1]
-  // Theta should not be set to zero, otherwise it will always trigger
-  // DataTable::TransformTileGroup, even if the schema is the same.
+  // Theta should not be set to zero, otherwise it will always pick tile
+  // groups for reorganization, even if the schema is the same.
   double theta = 0.0001;
 
   // Sleeping period (in us)
@@ -105,6 +123,13 @@ class LayoutTuner {
   // Desired layout tile count
   oid_t tile_count = 2;
 
+  // Tile groups rewritten into the default layout are picked every this many
+  // tuning rounds
+  oid_t reorganization_period = 1000;
+
+  // Maximum number of tile groups picked at a time
+  oid_t reorganization_batch_size = 1;
+
 };
 
 }  // End brain namespace
@@ -18,6 +18,10 @@
 
 namespace peloton {
 
+namespace planner {
+class SeqScanPlan;
+}  // namespace planner
+
 namespace storage {
 class DataTable;
 class TileGroup;
@@ -42,6 +46,11 @@ class RuntimeFunctions {
   static storage::TileGroup *GetTileGroup(storage::DataTable *table,
                                           oid_t tile_group_index);
 
+  // Check the zone map of the tile group against the predicate of the scan.
+  // Returns false if no tuple of the tile group can satisfy the predicate.
+  static bool TileGroupMayMatch(storage::TileGroup *tile_group,
+                                const planner::SeqScanPlan *scan_plan);
+
   // This struct represents the layout (or configuration) of a column in a
   // tile group. A configuration is characterized by two properties: its
   // starting address and its stride.  The former indicates where in memory
@@ -35,6 +35,12 @@ class RuntimeFunctionsProxy {
     static llvm::Function *GetFunction(CodeGen &codegen);
   };
 
+  struct _TileGroupMayMatch {
+    // Get the LLVM function definition/wrapper to
+    // RuntimeFunctions::TileGroupMayMatch(TileGroup*, SeqScanPlan*)
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
   struct _ColumnLayoutInfo {
     static llvm::Type *GetType(CodeGen &codegen);
   };
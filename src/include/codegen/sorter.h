@@ -15,6 +15,7 @@
 #include <unordered_map>
 
 #include "codegen/updateable_storage.h"
+#include "codegen/utils/sorter.h"
 
 namespace peloton {
 namespace codegen {
@@ -91,13 +92,17 @@ class Sorter {
                                 SorterAccess &access) const = 0;
   };
 
-  // Constructor
+  // Constructor. A sorter with a bound only keeps the first top_k tuples in
+  // the sort order.
   Sorter();
-  Sorter(CodeGen &codegen, const std::vector<type::Type::TypeId> &row_desc);
+  Sorter(CodeGen &codegen, const std::vector<type::Type::TypeId> &row_desc,
+         uint64_t top_k = utils::Sorter::kNoLimit);
 
-  // Initialize the given sorter instance with the comparison function
+  // Initialize the given sorter instance with the comparison function. The
+  // sorter spills past the memory budget of the executor context.
   void Init(CodeGen &codegen, llvm::Value *sorter_ptr,
-            llvm::Value *comparison_func) const;
+            llvm::Value *comparison_func,
+            llvm::Value *executor_context) const;
 
   // Append the given tuple into the sorter instance
   void Append(CodeGen &codegen, llvm::Value *sorter_ptr,
@@ -113,6 +118,10 @@ class Sorter {
                          uint32_t vector_size,
                          VectorizedIterateCallback &callback) const;
 
+  // Refill the sorter instance with the next batch of sorted tuples. Returns
+  // false if no batches are left.
+  llvm::Value *NextBatch(CodeGen &codegen, llvm::Value *sorter_ptr) const;
+
   void Destroy(CodeGen &codegen, llvm::Value *sorter_ptr) const;
 
   const UpdateableStorage &GetStorageFormat() const { return storage_format_; }
@@ -141,6 +150,9 @@ class Sorter {
   // Compact storage to materialize things
   // TODO: Change to CompactStorage?
   UpdateableStorage storage_format_;
+
+  // The number of tuples kept
+  uint64_t top_k_;
 };
 
 }  // namespace codegen
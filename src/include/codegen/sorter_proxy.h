@@ -38,6 +38,14 @@ class SorterProxy {
     static llvm::Function *GetFunction(CodeGen &codegen);
   };
 
+  //===--------------------------------------------------------------------===//
+  // The proxy for codegen::utils::Sorter::KeepTopK()
+  //===--------------------------------------------------------------------===//
+  struct _KeepTopK {
+    static const std::string &GetFunctionName();
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
   //===--------------------------------------------------------------------===//
   // The proxy for codegen::utils::Sorter::Sort()
   //===--------------------------------------------------------------------===//
@@ -46,6 +54,14 @@ class SorterProxy {
     static llvm::Function *GetFunction(CodeGen &codegen);
   };
 
+  //===--------------------------------------------------------------------===//
+  // The proxy for codegen::utils::Sorter::NextBatch()
+  //===--------------------------------------------------------------------===//
+  struct _NextBatch {
+    static const std::string &GetFunctionName();
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
   //===--------------------------------------------------------------------===//
   // The proxy for codegen::utils::Sorter::Destroy()
   //===--------------------------------------------------------------------===//
@@ -42,9 +42,11 @@ class Table {
   void GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
                     ScanConsumer &consumer) const;
 
+  // If a pointer to the scan plan is provided, tile groups whose zone maps
+  // rule out the scan's predicate are skipped.
   void GenerateVectorizedScan(CodeGen &codegen, llvm::Value *table_ptr,
-                              uint32_t vector_size,
-                              ScanConsumer &consumer) const;
+                              uint32_t vector_size, ScanConsumer &consumer,
+                              llvm::Value *scan_plan_ptr = nullptr) const;
 
   // Given a table instance, return the number of tile groups in the table.
   llvm::Value *GetTileGroupCount(CodeGen &codegen,
@@ -57,7 +59,14 @@ class Table {
 
  private:
   void DoGenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
-                      uint32_t vector_size, ScanConsumer &consumer) const;
+                      uint32_t vector_size, llvm::Value *scan_plan_ptr,
+                      ScanConsumer &consumer) const;
+
+  // Generate the scan over a single tile group
+  void GenerateTileGroupScan(CodeGen &codegen, llvm::Value *tile_group_idx,
+                             llvm::Value *tile_group_ptr,
+                             llvm::Value *column_layouts, uint32_t vector_size,
+                             ScanConsumer &consumer) const;
 
  private:
   // The table associated with this generator
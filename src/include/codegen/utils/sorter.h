@@ -13,9 +13,17 @@
 #pragma once
 
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <vector>
 
 namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+class SpillFile;
+}  // namespace executor
+
 namespace codegen {
 namespace utils {
 
@@ -36,31 +44,61 @@ namespace utils {
 //    tuples and let clients worry about serializing types into the allocated
 //    space. We would accept a Serializer type as part of the Init(..) function,
 //    but we don't need it at this moment.
+//
+// When initialized with a bound K, the sorter only keeps the first K tuples in
+// the sort order (e.g., for ORDER BY ... LIMIT). The kept tuples form a binary
+// max-heap in the buffer, and every stored tuple either replaces the top of the
+// heap or is dropped, so the buffer never holds more than K + 1 tuples.
+//
+// An unbounded sorter keeps its buffer within the memory budget of the query.
+// Once the buffer would have to grow past the budget, its tuples are sorted
+// and written to a spill file as a run, and the buffer is reused. Sort() then
+// merges the runs, and the sorted tuples are handed out a buffer at a time:
+// the buffer holds the first batch after Sort(), and NextBatch() refills it.
 //===----------------------------------------------------------------------===//
 class Sorter {
  private:
   // We (arbitrarily) allocate 4MB of buffer space upon initialization
   static constexpr uint64_t kInitialBufferSize = 1 * 1024 * 1024 * 4;
 
+  // A smaller memory budget shrinks the initial buffer down to 4KB
+  static constexpr uint64_t kMinBufferSize = 4 * 1024;
+
  public:
   typedef int (*ComparisonFunction)(const void *left_tuple,
                                     const void *right_tuple);
 
+  // The bound of a sorter that keeps all tuples
+  static constexpr uint64_t kNoLimit = std::numeric_limits<uint64_t>::max();
+
   // Constructor
   Sorter();
   // Destructor
   ~Sorter();
 
-  // Initialize this sorter with the given comparison function
-  void Init(ComparisonFunction func, uint32_t tuple_size);
+  // Initialize this sorter with the given comparison function, keeping the
+  // first top_k tuples in the sort order. The memory budget is the one of the
+  // executor context, or the work_mem setting without one.
+  void Init(ComparisonFunction func, uint32_t tuple_size,
+            uint64_t top_k = kNoLimit,
+            executor::ExecutorContext *executor_context = nullptr);
 
   // StoreValue an input tuple whose size is _equivalent_ to the size of tuple
   // provided at initialization time.
   char *StoreInputTuple();
 
-  // Perform the sort
+  // With a bound, add the tuple stored last to the heap of kept tuples, or
+  // drop it. Must be called after each StoreInputTuple() of a bounded sorter.
+  void KeepTopK();
+
+  // Perform the sort. If runs were spilled, the buffer holds the first batch
+  // of the sorted tuples afterwards.
   void Sort();
 
+  // Refill the buffer with the next batch of sorted tuples. Returns false once
+  // all tuples have been handed out, or if the whole input fit in the buffer.
+  bool NextBatch();
+
   // Cleanup all the resources this sorter maintains
   void Destroy();
 
@@ -86,7 +124,7 @@ class Sorter {
     uint32_t tuple_size_;
   };
 
-  // Iterators
+  // Iterators over the tuples in the buffer
   Iterator begin();
   Iterator end();
 
@@ -104,6 +142,53 @@ class Sorter {
   // Resize the given array to a larger size
   void Resize();
 
+  char *GetTuple(uint64_t idx) const {
+    return buffer_start_ + idx * tuple_size_;
+  }
+
+  // Restore the heap order of the kept tuples after a change at the index
+  void SiftUp(uint64_t idx);
+  void SiftDown(uint64_t idx, uint64_t num_tuples);
+
+  void SwapTuples(char *left_tuple, char *right_tuple);
+
+  // Sort the tuples in the buffer, write them to a new run and empty the
+  // buffer
+  void SpillRun();
+
+  // Merge the runs down to at most SORT_MERGE_FAN_IN, and start merging them
+  void StartMerge();
+
+  // Read the first tuple of each merged run
+  void InitMergeHeap();
+
+  // Copy the next merged tuple into the given space. Returns false once all
+  // merged runs are read.
+  bool NextMergedTuple(char *tuple);
+
+  // Fill the buffer with merged tuples. Returns false if none were left.
+  bool FillBuffer();
+
+  // Orders the runs being merged by their next tuples
+  struct MergeHeapComparer {
+    MergeHeapComparer(const Sorter &_sorter) : sorter(_sorter) {}
+
+    bool operator()(const size_t &a, const size_t &b) const;
+
+    const Sorter &sorter;
+  };
+
+  // The sorted runs, and the state of their merge
+  struct SpillState {
+    // Runs written while the tuples are stored
+    std::vector<std::unique_ptr<executor::SpillFile>> runs;
+
+    // Runs being merged, the next tuple of each, and the heap of their ids
+    std::vector<std::unique_ptr<executor::SpillFile>> merge_runs;
+    std::vector<char> merge_tuples;
+    std::vector<size_t> merge_heap;
+  };
+
  private:
   // The contiguous buffer space where tuples are stored.
   //
@@ -122,6 +207,15 @@ class Sorter {
 
   // The comparison function
   ComparisonFunction cmp_func_;
+
+  // The number of tuples kept
+  uint64_t top_k_;
+
+  // The memory the buffer may take before its tuples are spilled
+  uint64_t memory_budget_;
+
+  // The spilled runs, if any
+  SpillState *spill_state_;
 };
 
 }  // namespace utils
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// worker_pool.h
+//
+// Identification: src/include/common/worker_pool.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Worker Pool
+//===--------------------------------------------------------------------===//
+
+/**
+ * Threads that help the executors with the parts of a query that run in
+ * parallel, e.g. hash join builds and probes, parallel scans, aggregations,
+ * loads and exports. They are started once and shared by all queries, so
+ * that concurrent queries do not start threads of their own and oversubscribe
+ * the cores.
+ *
+ * The pool has one thread less than the hardware, as the thread that asks for
+ * help always works on its task as well. A task must make progress without
+ * any of the pool threads, since they may all be busy with other queries.
+ */
+class WorkerPool {
+ public:
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  // global singleton
+  static WorkerPool &GetInstance();
+
+  size_t GetWorkerCount() const { return workers_.size(); }
+
+  // Queue a job for the next idle thread
+  void Submit(std::function<void()> &&job);
+
+  // Run the task for every unit of work, on the calling thread and on up to
+  // helper_count pool threads. Rethrows the first exception of the task,
+  // after which the units not yet started are skipped.
+  void RunTasks(const size_t &unit_count,
+                const std::function<void(size_t)> &task,
+                size_t helper_count = SIZE_MAX);
+
+ private:
+  WorkerPool();
+
+  ~WorkerPool();
+
+  void Run();
+
+  std::mutex mutex_;
+
+  std::condition_variable job_added_;
+
+  std::deque<std::function<void()>> jobs_;
+
+  bool stopped_ = false;
+
+  std::vector<std::thread> workers_;
+};
+
+/**
+ * Pool threads that help the calling thread with one task. Each of them runs
+ * the job of the group once, with its own helper id. A helper that only gets
+ * a pool thread after the group is joined does not run the job at all, so
+ * that the state of the task may go away with the group.
+ */
+class WorkerGroup {
+ public:
+  WorkerGroup(const WorkerGroup &) = delete;
+  WorkerGroup &operator=(const WorkerGroup &) = delete;
+
+  WorkerGroup();
+
+  // Joins the helpers
+  ~WorkerGroup();
+
+  // Ask the pool for up to helper_count helpers. on_start is called, under
+  // the lock of the group, by each helper that starts before the job.
+  // Returns the number of asked helpers.
+  size_t Start(size_t helper_count, std::function<void(size_t)> job,
+               std::function<void()> on_start = nullptr);
+
+  // Keep the helpers that have not started from running the job, and wait
+  // for the others to return. Returns the number of helpers that ran.
+  size_t Join();
+
+ private:
+  struct State;
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace peloton
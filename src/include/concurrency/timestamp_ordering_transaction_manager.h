@@ -96,6 +96,11 @@ class TimestampOrderingTransactionManager : public TransactionManager {
   virtual void PerformDelete(Transaction *const current_txn,
                              const ItemPointer &location);
 
+  virtual void PerformDeltaUpdate(Transaction *const current_txn,
+                                  const ItemPointer &location,
+                                  const std::vector<oid_t> &column_ids,
+                                  const std::vector<type::Value> &values);
+
   virtual ResultType CommitTransaction(Transaction *const current_txn);
 
   virtual ResultType AbortTransaction(Transaction *const current_txn);
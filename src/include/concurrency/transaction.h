@@ -20,6 +20,7 @@
 
 #include "common/exception.h"
 #include "common/item_pointer.h"
+#include "common/platform.h"
 #include "common/printable.h"
 #include "type/types.h"
 
@@ -113,6 +114,10 @@ class Transaction : public Printable {
 
   RWType GetRWType(const ItemPointer &);
 
+  // Record a tile group filled by a bulk load of the transaction. Its tuples
+  // are owned by the transaction without being in the read/write set.
+  void RecordBulkLoad(const oid_t &tile_group_id);
+
   bool IsInRWSet(const ItemPointer &location) {
 
     oid_t tile_group_id = location.block;
@@ -129,6 +134,8 @@ class Transaction : public Printable {
 
   inline const ReadWriteSet &GetReadWriteSet() { return rw_set_; }
 
+  inline const std::vector<oid_t> &GetBulkLoadSet() { return bulk_load_set_; }
+
   inline std::shared_ptr<GCSet> GetGCSetPtr() {
     return gc_set_;
   }
@@ -177,6 +184,11 @@ class Transaction : public Printable {
 
   ReadWriteSet rw_set_;
 
+  // the tile groups filled by bulk loads, which may run in parallel
+  std::vector<oid_t> bulk_load_set_;
+
+  Spinlock bulk_load_lock_;
+
   // this set contains data location that needs to be gc'd in the transaction.
   std::shared_ptr<GCSet> gc_set_;
 
@@ -17,11 +17,13 @@
 #include <unordered_map>
 #include <list>
 #include <utility>
+#include <vector>
 
 #include "storage/tile_group_header.h"
 #include "concurrency/transaction.h"
 #include "concurrency/epoch_manager_factory.h"
 #include "common/logger.h"
+#include "type/value.h"
 
 namespace peloton {
 
@@ -65,6 +67,15 @@ class TransactionManager {
       const oid_t &tuple_id,
       const VisibilityIdType type = VisibilityIdType::READ_ID);
 
+  // Same as IsVisible, for threads that run beside the thread of the
+  // transaction and so must not read its read/write set. Returns
+  // VisibilityType::INVALID for the versions owned by the transaction, whose
+  // visibility is left to its own thread.
+  VisibilityType IsVisibleUnowned(
+      Transaction *const current_txn,
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id);
+
   // This method test whether the current transaction is the owner of this version.
   virtual bool IsOwner(
       Transaction *const current_txn, 
@@ -126,6 +137,13 @@ class TransactionManager {
   virtual void PerformDelete(Transaction *const current_txn, 
                              const ItemPointer &location) = 0;
 
+  // Record an update of a tuple in a delta-stored table. Only the new values
+  // of the updated columns are kept, and the tuple stays where it is.
+  virtual void PerformDeltaUpdate(Transaction *const current_txn,
+                                  const ItemPointer &location,
+                                  const std::vector<oid_t> &column_ids,
+                                  const std::vector<type::Value> &values) = 0;
+
   void SetTransactionResult(Transaction *const current_txn, const ResultType result) {
     current_txn->SetResult(result);
   }
@@ -159,6 +177,12 @@ class TransactionManager {
   }
 
  protected:
+  VisibilityType CheckVisibility(
+      Transaction *const current_txn,
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id, const VisibilityIdType type,
+      const bool resolve_owned);
+
   inline bool CidIsInDirtyRange(cid_t cid) {
     return ((cid > dirty_range_.first) & (cid <= dirty_range_.second));
   }
@@ -35,6 +35,12 @@ DECLARE_string(socket_family);
 // RESOURCE USAGE
 //===----------------------------------------------------------------------===//
 
+// Memory budget of each sort and hash aggregation
+DECLARE_uint64(work_mem);
+
+// Enable or disable late materialization of the projected columns
+DECLARE_bool(late_materialization);
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
@@ -67,6 +73,9 @@ DECLARE_bool(index_tuner);
 // Enable or disable layout tuner
 DECLARE_bool(layout_tuner);
 
+// Enable or disable tile group compaction
+DECLARE_bool(tile_group_compaction);
+
 //===----------------------------------------------------------------------===//
 // CODEGEN
 //===----------------------------------------------------------------------===//
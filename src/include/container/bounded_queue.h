@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bounded_queue.h
+//
+// Identification: src/include/container/bounded_queue.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Bounded Queue -- Blocking queue of a fixed capacity, between a known number
+// of producers and one or more consumers.
+//===--------------------------------------------------------------------===//
+
+template <typename T>
+class BoundedQueue {
+ public:
+  BoundedQueue(const size_t &capacity, const size_t &producer_count)
+      : capacity_(capacity),
+        producer_count_(producer_count),
+        is_closed_(false) {}
+
+  BoundedQueue(const BoundedQueue &) = delete;             // disable copying
+  BoundedQueue &operator=(const BoundedQueue &) = delete;  // disable assignment
+
+  // Enqueues one item, waiting while the queue is full. Returns false if the
+  // queue has been closed, in which case the item is dropped.
+  bool Enqueue(T &&item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock,
+                   [this] { return is_closed_ || queue_.size() < capacity_; });
+    if (is_closed_ == true) {
+      return false;
+    }
+    queue_.push_back(std::move(item));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // Enqueues one item if the queue has room. Returns false if it is full or
+  // has been closed, in which case the item is left to the caller.
+  bool TryEnqueue(T &item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_closed_ == true || queue_.size() >= capacity_) {
+      return false;
+    }
+    queue_.push_back(std::move(item));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // Dequeues one item, waiting while the queue is empty. Returns false once
+  // all producers are done and the queue is drained, or it has been closed.
+  bool Dequeue(T &item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] {
+      return is_closed_ || queue_.empty() == false || producer_count_ == 0;
+    });
+    if (is_closed_ == true || queue_.empty() == true) {
+      return false;
+    }
+    item = std::move(queue_.front());
+    queue_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  // Dequeues one item if there is one. Returns false if the queue is empty or
+  // has been closed.
+  bool TryDequeue(T &item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_closed_ == true || queue_.empty() == true) {
+      return false;
+    }
+    item = std::move(queue_.front());
+    queue_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  // Called by each producer that joins after the queue is created
+  void AddProducer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    producer_count_++;
+  }
+
+  // Called by each producer once it has enqueued all of its items
+  void FinishProducing() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    producer_count_--;
+    if (producer_count_ == 0) {
+      not_empty_.notify_all();
+    }
+  }
+
+  bool IsClosed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return is_closed_;
+  }
+
+  // Drops the queued items, and wakes up all producers and consumers
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_closed_ = true;
+    queue_.clear();
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  const size_t capacity_;
+
+  size_t producer_count_;
+
+  bool is_closed_;
+
+  std::deque<T> queue_;
+
+  std::mutex mutex_;
+
+  std::condition_variable not_full_;
+
+  std::condition_variable not_empty_;
+};
+
+}  // namespace peloton
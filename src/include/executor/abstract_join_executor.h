@@ -42,6 +42,10 @@ class AbstractJoinExecutor : public AbstractExecutor {
         return "JoinType::INNER";
       case JoinType::OUTER:
         return "JoinType::OUTER";
+      case JoinType::SEMI:
+        return "JoinType::SEMI";
+      case JoinType::ANTI:
+        return "JoinType::ANTI";
       case JoinType::INVALID:
       default:
         return "JoinType::INVALID";
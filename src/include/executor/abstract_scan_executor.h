@@ -12,13 +12,25 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "planner/abstract_scan_plan.h"
 #include "type/types.h"
 #include "executor/abstract_executor.h"
 
 namespace peloton {
+
+namespace storage {
+class DataTable;
+class DeltaTuple;
+class TileGroup;
+}
+
 namespace executor {
 
+class BloomFilter;
+
 /**
  * Super class for different kinds of scan executor.
  * It provides common codes for all kinds of scan:
@@ -34,6 +46,8 @@ class AbstractScanExecutor : public AbstractExecutor {
   explicit AbstractScanExecutor(const planner::AbstractPlan *node,
                                 ExecutorContext *executor_context);
 
+  virtual ~AbstractScanExecutor();
+
   virtual void UpdatePredicate(const std::vector<oid_t> &column_ids
                                    UNUSED_ATTRIBUTE,
                                const std::vector<type::Value> &values
@@ -41,11 +55,29 @@ class AbstractScanExecutor : public AbstractExecutor {
 
   virtual void ResetState() {}
 
+  // Drop the tuples of the table whose key, in the given output columns, is
+  // not in the bloom filter. Set by the joins that only output the tuples
+  // of this scan with a match, before they start reading it.
+  void AddBloomFilter(const std::shared_ptr<const BloomFilter> &filter,
+                      const std::vector<oid_t> &key_column_offsets);
+
  protected:
   bool DInit();
 
   virtual bool DExecute() = 0;
 
+  // Copy a tuple of a delta-stored table, as seen through its deltas, into a
+  // tile group private to this scan. A new tile group with the given number
+  // of slots is created when the current one is full.
+  ItemPointer MaterializeDeltaTuple(storage::DataTable *table,
+                                    const storage::DeltaTuple &tuple,
+                                    const size_t &capacity);
+
+  // Remove the tuples of the tile group whose keys are not in the bloom
+  // filters from the position list
+  void ApplyBloomFilters(storage::TileGroup *tile_group,
+                         std::vector<oid_t> &position_list) const;
+
  protected:
   //===--------------------------------------------------------------------===//
   // Plan Info
@@ -56,6 +88,15 @@ class AbstractScanExecutor : public AbstractExecutor {
 
   /** @brief Columns from tile group to be added to logical tile output. */
   std::vector<oid_t> column_ids_;
+
+  /** @brief Bloom filters of the joins over this scan, with the tile group
+   * columns of their keys. */
+  std::vector<std::pair<std::shared_ptr<const BloomFilter>, std::vector<oid_t>>>
+      bloom_filters_;
+
+ private:
+  /** @brief Private tile groups holding copies of delta-stored tuples. */
+  std::vector<std::shared_ptr<storage::TileGroup>> version_tile_groups_;
 };
 
 }  // namespace executor
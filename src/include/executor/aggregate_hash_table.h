@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// aggregate_hash_table.h
+//
+// Identification: src/include/executor/aggregate_hash_table.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+// number of buckets of an empty table
+#define AGGREGATE_HASH_TABLE_INITIAL_SIZE 256
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace executor {
+
+class SpillFile;
+
+/**
+ * Hash table of groups for the hash aggregation of fixed width group-by keys
+ * with simple aggregates (COUNT, SUM, AVG, MIN and MAX).
+ *
+ * The keys and the aggregate states of each group are 64-bit words, stored
+ * one group after the other in contiguous arrays. A power-of-two array of
+ * buckets holds the group offsets, probed linearly from the MurmurHash3
+ * finalizer of the key words.
+ *
+ * The states of the groups are partial aggregates, so tables filled by
+ * different threads can be merged. Once the groups exceed the memory budget,
+ * their states are written to spill partitions, and merged again by
+ * partition when the table is finalized.
+ */
+class AggregateHashTable {
+ public:
+  // An aggregate of the groups
+  struct Aggregate {
+    ExpressionType aggregate_type;
+
+    // input column of the argument, or INVALID_OID if every input tuple
+    // is counted
+    oid_t column_id;
+
+    // type of the argument
+    type::Type::TypeId value_type;
+  };
+
+  // Called with the group-by key values and the aggregate values of each
+  // group. Returns false to stop.
+  typedef std::function<bool(const std::vector<type::Value> &,
+                             const std::vector<type::Value> &)> GroupCallback;
+
+  AggregateHashTable(const AggregateHashTable &) = delete;
+  AggregateHashTable &operator=(const AggregateHashTable &) = delete;
+
+  AggregateHashTable(const std::vector<oid_t> &key_column_ids,
+                     const std::vector<type::Type::TypeId> &key_types,
+                     const std::vector<Aggregate> &aggregates,
+                     size_t memory_budget, size_t spill_level = 0);
+
+  ~AggregateHashTable();
+
+  // Whether values of the type fit in a key word
+  static bool IsFixedWidthKey(type::Type::TypeId type_id);
+
+  // Word holding a non-null value of a fixed width key type
+  static int64_t GetKeyWord(const type::Value &value);
+
+  // Whether values of the type can be summed up in a state word
+  static bool IsIntegerArgument(type::Type::TypeId type_id);
+
+  // Add the tuple to the aggregates of its group
+  void Advance(const AbstractTuple *tuple);
+
+  // Add the groups of the other table to the groups of this one, and take
+  // over its spill partitions. The other table is left empty.
+  void Merge(AggregateHashTable &other);
+
+  // Call the callback for each group, including the spilled ones, and
+  // empty the table
+  bool Finalize(const GroupCallback &callback);
+
+  size_t GetGroupCount() const { return hashes_.size(); }
+
+  // Bytes used by the groups and the buckets
+  size_t GetMemoryUsage() const;
+
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
+ private:
+  // Find the group of the key words with the hash, or add it with empty
+  // aggregates. Returns the offset of the group.
+  uint32_t FindOrInsertGroup(const int64_t *key_words, const hash_t &hash);
+
+  // Double the number of buckets
+  void Grow();
+
+  // Add the partial aggregates of a group to the group with the same key,
+  // added if there is none
+  void MergeGroup(const int64_t *key_words, const hash_t &hash,
+                  const int64_t *states);
+
+  // Add the partial aggregates of a group to the aggregates of another group
+  void MergeStates(int64_t *states, const int64_t *other_states) const;
+
+  // Write all groups to the spill partitions and empty the table
+  void SpillGroups();
+
+  // Forget all groups
+  void Clear();
+
+  hash_t HashKey(const int64_t *key_words) const;
+
+  std::vector<oid_t> key_column_ids_;
+
+  std::vector<type::Type::TypeId> key_types_;
+
+  std::vector<Aggregate> aggregates_;
+
+  // number of words of a key: the key values, then a bitmap of the null ones
+  size_t key_width_;
+
+  // number of words of the aggregate states of a group: two per aggregate
+  size_t state_width_;
+
+  size_t memory_budget_;
+
+  // number of times the input of the table has been partitioned
+  size_t spill_level_;
+
+  // key words of each group
+  std::vector<int64_t> keys_;
+
+  // aggregate states of each group
+  std::vector<int64_t> states_;
+
+  // hash of the key of each group
+  std::vector<hash_t> hashes_;
+
+  // offset of the group in each bucket
+  std::vector<uint32_t> buckets_;
+
+  // files of groups written out in each spill partition, empty until the
+  // groups exceed the memory budget
+  std::vector<std::vector<std::unique_ptr<SpillFile>>> spill_partitions_;
+
+  // key words of the tuple being added
+  std::vector<int64_t> key_words_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -12,14 +12,39 @@
 
 #pragma once
 
+#include <exception>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "common/container_tuple.h"
+#include "common/worker_pool.h"
+#include "container/bounded_queue.h"
 #include "executor/abstract_executor.h"
 #include "planner/aggregate_plan.h"
 #include "type/value_factory.h"
 
+// number of hash bits that select the spill partition of a group, each time
+// the tuples of groups that do not fit in memory are partitioned
+#define HASH_AGGREGATE_SPILL_PARTITION_BITS 4
+
+// spilled partitions whose groups still do not fit are partitioned again, at
+// most this many times
+#define HASH_AGGREGATE_MAX_SPILL_LEVEL 4
+
+// the flat hash aggregator pre-aggregates the tiles in the worker pool once
+// it has aggregated this many tiles and tuples by itself, so that small
+// inputs do not pay for handing tiles over
+#define HASH_AGGREGATE_PARALLEL_MIN_TILE_COUNT 4
+#define HASH_AGGREGATE_PARALLEL_MIN_TUPLE_COUNT 16384
+
+// one worker is asked for each this many tuples aggregated by the calling
+// thread, up to the threads of the worker pool
+#define HASH_AGGREGATE_TUPLE_COUNT_PER_WORKER 16384
+
+// number of input tiles queued for each worker
+#define HASH_AGGREGATE_QUEUE_SIZE_PER_WORKER 2
+
 //===--------------------------------------------------------------------===//
 // Aggregate
 //===--------------------------------------------------------------------===//
@@ -32,6 +57,9 @@ class AbstractTable;
 
 namespace executor {
 
+class AggregateHashTable;
+class SpillFile;
+
 /*
  * Base class for an individual aggregate that aggregates a specific
  * column for a group
@@ -244,6 +272,9 @@ class AbstractAggregator {
 
   virtual bool Advance(AbstractTuple *next_tuple) = 0;
 
+  // Advance the visible tuples of the tile, one at a time
+  virtual bool AdvanceTile(std::unique_ptr<LogicalTile> tile);
+
   virtual bool Finalize() = 0;
 
   virtual ~AbstractAggregator() {}
@@ -316,11 +347,105 @@ class HashAggregator : public AbstractAggregator {
                              ValueVectorHasher, ValueVectorCmp>
       HashAggregateMapType;
 
+  // Estimated memory used by a group
+  size_t GetGroupSize(const AggregateList *aggregate_list) const;
+
+  // Set the tuple aside in the spill partition of its group key
+  void SpillTuple(AbstractTuple *tuple);
+
+  // Free the aggregates of all groups
+  void ClearGroups();
+
   /** @brief Group by key values used */
   std::vector<type::Value> group_by_key_values;
 
   /** @brief Hash table */
   HashAggregateMapType aggregates_map;
+
+  /** @brief Estimated memory used by the groups in the hash table */
+  size_t memory_usage_ = 0;
+
+  /**
+   * @brief Input tuples of the groups that did not fit in the memory budget,
+   * partitioned by their group keys. Empty until the budget is exceeded.
+   */
+  std::vector<std::unique_ptr<SpillFile>> spill_partitions_;
+
+  /** @brief Number of times the current input has been partitioned */
+  size_t spill_level_ = 0;
+};
+
+/**
+ * @brief Used when input is NOT sorted, and the group-by keys are fixed width
+ * and the aggregates simple, see IsSupported().
+ * Will maintain flat hash tables of partial aggregates, one per thread.
+ */
+class FlatHashAggregator : public AbstractAggregator {
+ public:
+  FlatHashAggregator(const planner::AggregatePlan *node,
+                     storage::AbstractTable *output_table,
+                     executor::ExecutorContext *econtext, LogicalTile *tile);
+
+  // Whether the groups of the plan over tiles like this one fit in a flat
+  // hash table: the group-by columns are fixed width, the aggregates are
+  // COUNT, SUM, AVG, MIN or MAX of integer columns without DISTINCT, and
+  // the output only uses the group-by columns of the input
+  static bool IsSupported(const planner::AggregatePlan *node,
+                          LogicalTile *tile);
+
+  bool Advance(AbstractTuple *next_tuple) override;
+
+  bool AdvanceTile(std::unique_ptr<LogicalTile> tile) override;
+
+  bool Finalize() override;
+
+  ~FlatHashAggregator();
+
+ private:
+  // Create an empty hash table for the groups of the plan
+  AggregateHashTable *CreateTable(size_t memory_budget) const;
+
+  // Ask the worker pool for workers, each with its own hash table, as many
+  // as the tuples aggregated so far call for
+  void StartWorkers();
+
+  // Aggregate the queued tiles along with the workers, wait for them, and
+  // rethrow their error if any
+  void StopWorkers();
+
+  // Body of a worker
+  void AggregateTiles(AggregateHashTable *table);
+
+  static void AggregateTile(AggregateHashTable *table, LogicalTile *tile);
+
+  size_t GetMemoryBudget() const;
+
+  const size_t num_input_columns_;
+
+  /** @brief Types of the group-by columns */
+  std::vector<type::Type::TypeId> key_types_;
+
+  /** @brief Types of the argument columns of the aggregates */
+  std::vector<type::Type::TypeId> argument_types_;
+
+  /** @brief Hash tables of the calling thread and of each worker */
+  std::vector<std::unique_ptr<AggregateHashTable>> tables_;
+
+  /** @brief Number of tiles aggregated by the calling thread */
+  size_t tile_count_ = 0;
+
+  /** @brief Number of tuples aggregated by the calling thread */
+  size_t tuple_count_ = 0;
+
+  /** @brief Tiles for the workers, once they are started */
+  std::unique_ptr<BoundedQueue<std::unique_ptr<LogicalTile>>> tile_queue_;
+
+  WorkerGroup worker_group_;
+
+  /** @brief First error of a worker */
+  std::exception_ptr error_;
+
+  std::mutex error_mutex_;
 };
 
 /**
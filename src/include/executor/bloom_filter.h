@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bloom_filter.h
+//
+// Identification: src/include/executor/bloom_filter.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "type/types.h"
+
+// bits of the filter per inserted key, for a false positive rate of about
+// one percent
+#define BLOOM_FILTER_BITS_PER_KEY 16
+
+namespace peloton {
+namespace executor {
+
+/**
+ * Bloom filter over the hashes of a set of keys, to drop the tuples whose key
+ * is not in the set before they are materialized, such as the probe tuples
+ * of a hash join without a match in its build side.
+ *
+ * The filter is split in 64-bit blocks: the high bits of a hash select the
+ * block, and four slices of its low bits the bits set in the block, so a key
+ * is tested with a single memory access. The hashes have to be well mixed,
+ * like the ones of RadixHashTable::HashKey().
+ */
+class BloomFilter {
+ public:
+  BloomFilter(const BloomFilter &) = delete;
+  BloomFilter &operator=(const BloomFilter &) = delete;
+
+  // Size the filter for the number of keys
+  explicit BloomFilter(const size_t &key_count) {
+    size_t block_count = 1;
+    while (block_count * 64 < key_count * BLOOM_FILTER_BITS_PER_KEY) {
+      block_count <<= 1;
+    }
+    blocks_.assign(block_count, 0);
+  }
+
+  void Insert(const hash_t &hash) { blocks_[GetBlock(hash)] |= GetMask(hash); }
+
+  // False if the key of the hash was not inserted
+  bool MayContain(const hash_t &hash) const {
+    uint64_t mask = GetMask(hash);
+    return (blocks_[GetBlock(hash)] & mask) == mask;
+  }
+
+  // Size of the filter in bytes
+  size_t GetSize() const { return blocks_.size() * sizeof(uint64_t); }
+
+ private:
+  size_t GetBlock(const hash_t &hash) const {
+    return (hash >> 32) & (blocks_.size() - 1);
+  }
+
+  static uint64_t GetMask(const hash_t &hash) {
+    return ((uint64_t)1 << (hash & 63)) | ((uint64_t)1 << ((hash >> 6) & 63)) |
+           ((uint64_t)1 << ((hash >> 12) & 63)) |
+           ((uint64_t)1 << ((hash >> 18) & 63));
+  }
+
+  // a power-of-two number of blocks
+  std::vector<uint64_t> blocks_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -38,6 +38,8 @@ class CopyExecutor : public AbstractExecutor {
 
   inline size_t GetTotalBytesWritten() { return total_bytes_written; }
 
+  inline size_t GetTotalTuplesLoaded() { return total_tuples_loaded; }
+
  protected:
   bool DInit();
 
@@ -84,6 +86,9 @@ class CopyExecutor : public AbstractExecutor {
   // Total number of bytes written
   size_t total_bytes_written = 0;
 
+  // Total number of tuples loaded by COPY FROM
+  size_t total_tuples_loaded = 0;
+
   // The special column ids in query_metric table
   unsigned int num_param_col_id =
       catalog::QueryMetricsCatalog::ColumnId::NUM_PARAMS;
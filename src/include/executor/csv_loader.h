@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// csv_loader.h
+//
+// Identification: src/include/executor/csv_loader.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+// size of the chunks that the input of COPY FROM is split into
+#define COPY_CHUNK_SIZE (16 * 1024 * 1024)
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+class DataTable;
+class Tuple;
+}
+
+namespace type {
+class AbstractPool;
+}
+
+namespace executor {
+
+/**
+ * Loads a CSV file into a table, for COPY FROM.
+ *
+ * The file is mapped and split into chunks of equal size. The calling thread
+ * and the worker pool first count the quotes of the chunks, which tells
+ * whether a chunk starts inside a quoted part. Each of them then loads the
+ * rows that start within a chunk, from the first row boundary in it, and
+ * hands the tuples to the bulk-load path of the table, a tile group at a
+ * time. Fields follow the PostgreSQL CSV format: double quotes enclose a
+ * part of a field holding the delimiter, quotes or line breaks, a doubled
+ * quote within them stands for one quote, and an empty unquoted field is
+ * NULL.
+ */
+class CsvLoader {
+ public:
+  CsvLoader(const CsvLoader &) = delete;
+  CsvLoader &operator=(const CsvLoader &) = delete;
+
+  CsvLoader(storage::DataTable *table, char delimiter,
+            size_t chunk_size = COPY_CHUNK_SIZE);
+
+  // Load all rows of the file as inserts of the transaction. Throws an
+  // ExecutorException if the file cannot be read or a row is malformed, and a
+  // ConstraintException if a row violates a foreign key or a unique index.
+  // The rows loaded up to then are left to the transaction, which has to
+  // abort. Returns the number of loaded tuples.
+  size_t Load(const std::string &file_path,
+              concurrency::Transaction *transaction);
+
+  // Load all rows of a buffer, as above
+  size_t Load(const char *data, size_t size,
+              concurrency::Transaction *transaction);
+
+  size_t GetChunkCount() const { return chunks_.size(); }
+
+ private:
+  struct Chunk {
+    const char *begin;
+    const char *end;
+
+    // whether the chunk starts inside a quoted part
+    bool in_quotes;
+  };
+
+  // Split the input into chunks of the chunk size, at any byte, and find
+  // whether each of them starts inside a quoted part
+  void SplitChunks(const char *data, size_t size);
+
+  // Find the first row that starts at or after the position of the chunk, with
+  // the same quote rules as ParseRow
+  const char *FindRowStart(const Chunk &chunk) const;
+
+  void LoadChunk(const Chunk &chunk, concurrency::Transaction *transaction);
+
+  // Parse the row starting at the position into the tuple, and return the
+  // position of the next row
+  const char *ParseRow(const char *position, const char *end,
+                       storage::Tuple *tuple, type::AbstractPool *pool);
+
+  // Convert the text of a field to a value of the column
+  type::Value ParseValue(const oid_t &column_id, const std::string &field,
+                         bool is_null) const;
+
+  // Find the next delimiter, quote or line break character
+  const char *FindSpecialCharacter(const char *position,
+                                   const char *end) const;
+
+  // Count the quote characters
+  size_t CountQuotes(const char *position, const char *end) const;
+
+  bool IsSpecialCharacter(const char &character) const {
+    return character == delimiter_ || character == '"' || character == '\n' ||
+           character == '\r';
+  }
+
+  storage::DataTable *table_;
+
+  const char delimiter_;
+
+  const size_t chunk_size_;
+
+  // the input being loaded
+  const char *data_begin_ = nullptr;
+
+  const char *data_end_ = nullptr;
+
+  std::vector<Chunk> chunks_;
+
+  std::atomic<size_t> loaded_tuple_count_;
+
+  // set by the first error of a worker, which stops all workers
+  std::atomic<bool> has_error_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -55,6 +55,20 @@ class ExecutorContext {
   // Get a pool
   type::EphemeralPool *GetPool();
 
+  // Memory, in bytes, each sort or hash aggregation of the query may use
+  // before it spills to temporary files
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
+  // Whether the executors leave the columns they pass through in their base
+  // tiles, for the operators that read them, instead of copying them
+  bool IsLateMaterialization() const { return late_materialization_; }
+
+  void SetLateMaterialization(bool late_materialization) {
+    late_materialization_ = late_materialization;
+  }
+
   // num of tuple processed
   uint32_t num_processed = 0;
 
@@ -72,6 +86,11 @@ class ExecutorContext {
   // pool
   std::unique_ptr<type::EphemeralPool> pool_;
 
+  // memory budget of sorts and hash aggregations
+  size_t memory_budget_;
+
+  bool late_materialization_;
+
 };
 
 }  // namespace executor
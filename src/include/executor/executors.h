@@ -20,6 +20,7 @@
 #include "executor/limit_executor.h"
 #include "executor/materialization_executor.h"
 #include "executor/seq_scan_executor.h"
+#include "executor/parallel_seq_scan_executor.h"
 #include "executor/index_scan_executor.h"
 #include "executor/insert_executor.h"
 #include "executor/delete_executor.h"
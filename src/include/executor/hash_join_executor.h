@@ -20,6 +20,9 @@
 #include "planner/hash_join_plan.h"
 #include "executor/hash_executor.h"
 
+// number of left tuples probed together, across threads if there are enough
+#define HASH_JOIN_PROBE_BATCH_SIZE 65536
+
 namespace peloton {
 namespace executor {
 
@@ -37,6 +40,14 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   bool DExecute();
 
  private:
+  void PushDownBloomFilter();
+
+  void BuildJoinTiles(LogicalTile *left_tile, size_t left_tile_itr,
+                      const std::vector<RadixHashTable::Match> &matches);
+
+  void BuildSemiJoinTile(LogicalTile *left_tile,
+                         const std::vector<RadixHashTable::Match> &matches);
+
   HashExecutor *hash_executor_ = nullptr;
 
   bool hashed_ = false;
@@ -12,19 +12,29 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "executor/abstract_scan_executor.h"
 #include "index/scan_optimizer.h"
 
+// Number of index entries read at a time by a key ordered scan
+#define KEY_ORDERED_TILE_SIZE 1024
+
+// Runs of tuples in the same block that are shorter than this are copied
+// into the tiles of a key ordered scan instead of being wrapped in place
+#define KEY_ORDERED_MIN_RUN_LENGTH 64
+
 namespace peloton {
 
 namespace index {
 class Index;
+class IndexScanCursor;
 }
 
 namespace storage {
 class AbstractTable;
+class TileGroup;
 }
 
 namespace executor {
@@ -56,6 +66,33 @@ class IndexScanExecutor : public AbstractScanExecutor {
   bool ExecPrimaryIndexLookup();
   bool ExecSecondaryIndexLookup();
 
+  // Read the next batch of a key ordered scan into the result tiles
+  bool ExecKeyOrderedLookup();
+
+  // Find the entries of the scan range in the primary index
+  void ScanPrimaryIndex(std::vector<ItemPointer *> &tuple_location_ptrs);
+
+  // Append the visible versions of the tuples of the primary index entries
+  // that satisfy the predicate. Returns false if the transaction fails.
+  bool ReadPrimaryIndexTuples(
+      const std::vector<ItemPointer *> &tuple_location_ptrs,
+      std::vector<ItemPointer> &visible_tuple_locations);
+
+  // Wrap the visible tuples into the result tiles
+  void BuildResultTiles(const std::vector<ItemPointer> &tuple_locations);
+
+  // Wrap the visible tuples into result tiles that keep their order
+  void BuildKeyOrderedTiles(const std::vector<ItemPointer> &tuple_locations);
+
+  // Copy the tuples into a new block, and wrap them in a tile in their order.
+  // The block is released once no tile reads from it anymore.
+  LogicalTile *CopyKeyOrderedTuples(
+      const std::vector<ItemPointer> &tuple_locations);
+
+  LogicalTile *BuildLogicalTile(
+      const std::shared_ptr<storage::TileGroup> &tile_group,
+      std::vector<oid_t> &&positions);
+
   // When the required scan range has open boundaries, the tuples found by the
   // index might not be exact since the index can only give back tuples in a
   // close range. This function prune the head and the tail of the returned
@@ -63,6 +100,10 @@ class IndexScanExecutor : public AbstractScanExecutor {
   void CheckOpenRangeWithReturnedTuples(
       std::vector<ItemPointer> &tuple_locations);
 
+  // Same, but for the primary index entries of a key ordered scan
+  void CheckOpenRangeWithIndexEntries(
+      std::vector<ItemPointer *> &tuple_location_ptrs);
+
   // Check whether the tuple at a given location satisfies the required
   // conditions on key columns
   bool CheckKeyConditions(const ItemPointer &tuple_location);
@@ -80,6 +121,9 @@ class IndexScanExecutor : public AbstractScanExecutor {
   /** @brief Computed the result */
   bool done_ = false;
 
+  /** @brief Position of a key ordered scan in the index */
+  std::unique_ptr<index::IndexScanCursor> scan_cursor_;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
@@ -129,6 +173,9 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   // whether order by is descending
   bool descend_ = false;
+
+  // whether the result tiles have to keep the tuples in key order
+  bool key_ordered_ = false;
 };
 
 }  // namespace executor
@@ -54,8 +54,64 @@ class LogicalTile : public Printable {
  public:
   struct ColumnInfo;
 
-  /* A vector of position to represent a column */
-  typedef std::vector<oid_t> PositionList;
+  /**
+   * @brief Positions of the rows of a column in its base tile.
+   *
+   * A dense run of consecutive positions, such as the tuples a scan keeps
+   * from a tile group, is stored as its first position and its size rather
+   * than one entry per row. The list falls back to explicit positions once
+   * a position breaks the run.
+   */
+  class PositionList {
+   public:
+    PositionList() {}
+
+    // Take over the positions, stored as a range if they are consecutive
+    PositionList(std::vector<oid_t> &&positions);
+
+    // Positions first, first + 1, ..., first + size - 1
+    static PositionList Range(oid_t first, size_t size);
+
+    inline oid_t operator[](size_t offset) const {
+      if (is_range_ == true) return range_first_ + offset;
+      return positions_[offset];
+    }
+
+    inline size_t size() const {
+      if (is_range_ == true) return range_size_;
+      return positions_.size();
+    }
+
+    inline bool empty() const { return size() == 0; }
+
+    inline void push_back(oid_t position) {
+      if (is_range_ == true) {
+        if (position != NULL_OID &&
+            (range_size_ == 0 || position == range_first_ + range_size_)) {
+          if (range_size_ == 0) range_first_ = position;
+          range_size_++;
+          return;
+        }
+        Expand();
+      }
+      positions_.push_back(position);
+    }
+
+    inline bool IsRange() const { return is_range_; }
+
+   private:
+    // Store the range as explicit positions
+    void Expand();
+
+    bool is_range_ = true;
+
+    oid_t range_first_ = 0;
+
+    size_t range_size_ = 0;
+
+    // positions of the rows, empty while the list is a range
+    std::vector<oid_t> positions_;
+  };
 
   /* A vector of column to represent a tile */
   typedef std::vector<PositionList> PositionLists;
@@ -13,14 +13,27 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include "executor/abstract_join_executor.h"
 #include "planner/merge_join_plan.h"
 
+// maximum number of rows of an output tile
+#define MERGE_JOIN_OUTPUT_TILE_SIZE 1000
+
 namespace peloton {
 namespace executor {
 
+/**
+ * Merge join of two children whose tiles come in the order of the join
+ * keys, such as key ordered index scans.
+ *
+ * Both children are read a row at a time. Only the right rows of the
+ * current key are buffered, so the join needs memory for the largest group
+ * of duplicate keys rather than for a whole child.
+ */
 class MergeJoinExecutor : public AbstractJoinExecutor {
   MergeJoinExecutor(const MergeJoinExecutor &) = delete;
   MergeJoinExecutor &operator=(const MergeJoinExecutor &) = delete;
@@ -35,17 +48,78 @@ class MergeJoinExecutor : public AbstractJoinExecutor {
   bool DExecute();
 
  private:
-  size_t Advance(LogicalTile *tile, size_t start_row, bool is_left);
+  /** @brief Current row of a child */
+  struct ChildCursor {
+    std::shared_ptr<LogicalTile> tile;
+
+    /** @brief Visible rows of the tile */
+    std::vector<oid_t> rows;
+
+    size_t offset = 0;
+
+    /** @brief Whether the child has returned all its tiles */
+    bool done = false;
+
+    /** @brief Whether the child has returned any row */
+    bool has_rows = false;
+
+    inline oid_t GetRow() const { return rows[offset]; }
+  };
+
+  /** @brief Buffered right row of the current key */
+  struct GroupRow {
+    std::shared_ptr<LogicalTile> tile;
+    oid_t row;
+    bool matched;
+  };
+
+  // Move the cursor to the next row of the child
+  void AdvanceCursor(oid_t child_idx, ChildCursor &cursor);
+
+  // Join the next key of the children, or the next row without a match.
+  // Returns false once the join is done.
+  bool MergeNext();
+
+  void GetKeys(const ChildCursor &cursor, bool is_left,
+               std::vector<type::Value> &keys) const;
+
+  // Compare the keys of the left and right rows
+  int CompareKeys(const std::vector<type::Value> &left_keys,
+                  const std::vector<type::Value> &right_keys) const;
+
+  // Add a row to the output, with nulls for the missing side
+  void AddOutputRow(const std::shared_ptr<LogicalTile> &left_tile,
+                    oid_t left_row,
+                    const std::shared_ptr<LogicalTile> &right_tile,
+                    oid_t right_row);
+
+  // Move the output tile being built to the finished ones
+  void FinishOutputTile();
 
   /** @brief a vector of join clauses
    * Get this from plan node during initialization */
   const std::vector<planner::MergeJoinPlan::JoinClause> *join_clauses_;
 
-  size_t left_start_row = 0;
-  size_t right_start_row = 0;
+  bool started_ = false;
+
+  ChildCursor left_cursor_;
+  ChildCursor right_cursor_;
+
+  /** @brief Right rows with the key of the current left rows */
+  std::vector<GroupRow> right_group_;
+
+  /** @brief Output tile being built, from the rows of the output sources */
+  std::unique_ptr<LogicalTile> output_tile_;
+  LogicalTile::PositionListsBuilder output_builder_;
+  std::shared_ptr<LogicalTile> output_left_source_;
+  std::shared_ptr<LogicalTile> output_right_source_;
+
+  /** @brief Output tiles ready to be returned */
+  std::deque<std::unique_ptr<LogicalTile>> output_tiles_;
 
-  size_t left_end_row = 0;
-  size_t right_end_row = 0;
+  std::vector<type::Value> left_keys_;
+  std::vector<type::Value> right_keys_;
+  std::vector<type::Value> next_keys_;
 };
 
 }  // namespace executor
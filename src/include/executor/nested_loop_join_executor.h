@@ -32,6 +32,11 @@ class NestedLoopJoinExecutor : public AbstractJoinExecutor {
   bool DExecute();
 
  private:
+  // Output the left rows that the right child does (semi join) or does not
+  // (anti join) return rows for
+  bool ExecuteSemiJoin(const std::vector<oid_t> &join_column_ids_left,
+                       const std::vector<oid_t> &join_column_ids_right);
+
   // Right child's result tiles iterator
   size_t right_result_itr_ = 0;
 
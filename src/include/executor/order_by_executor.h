@@ -16,9 +16,15 @@
 #include "executor/abstract_executor.h"
 #include "storage/tuple.h"
 
+// largest number of sorted runs merged at once; more runs are first merged
+// into fewer, longer ones
+#define SORT_MERGE_FAN_IN 64
+
 namespace peloton {
 namespace executor {
 
+class SpillFile;
+
 /**
  * @warning This is a pipeline breaker and a materialization point.
  *
@@ -45,8 +51,58 @@ class OrderByExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  // Less-than comparer over the sort keys of two tuples
+  struct TupleComparer {
+    TupleComparer(const std::vector<bool> &_descend_flags)
+        : descend_flags(_descend_flags) {}
+
+    bool operator()(const AbstractTuple *ta, const AbstractTuple *tb) const;
+
+    const std::vector<bool> &descend_flags;
+  };
+
+  // Orders the runs being merged by their next rows
+  struct MergeHeapComparer {
+    MergeHeapComparer(TupleComparer &_comp,
+                      std::vector<std::vector<type::Value>> &_rows)
+        : comp(_comp), rows(_rows) {}
+
+    bool operator()(const size_t &a, const size_t &b) const;
+
+    TupleComparer &comp;
+    std::vector<std::vector<type::Value>> &rows;
+  };
+
   bool DoSort();
 
+  // Keep the first limit_offset_ + limit_number_ tuples of the child in a
+  // bounded heap, instead of materializing and sorting all of them
+  bool DoTopNSort(TupleComparer &comp);
+
+  // Build the sort key and output schemas from the first input tile
+  void InitSchemas();
+
+  std::unique_ptr<storage::Tuple> GetSortKeyTuple(const oid_t &tile_id,
+                                                  const oid_t &tuple_id);
+
+  // Estimated memory used to sort the tuples of the tile
+  size_t GetBufferedSize(LogicalTile *tile);
+
+  // Sort the buffered tuples, write them to a new run and drop the tiles
+  void SpillRun(TupleComparer &comp);
+
+  // Merge the runs down to at most SORT_MERGE_FAN_IN, and start merging them
+  void StartMerge(TupleComparer &comp);
+
+  // Read the first row of each merged run
+  void InitMergeHeap(TupleComparer &comp);
+
+  // Returns false once all merged runs are read
+  bool NextMergedRow(TupleComparer &comp, std::vector<type::Value> &row);
+
+  // Return the next tile of merged rows
+  bool ExecuteMerge();
+
   bool sort_done_ = false;
 
   /**
@@ -75,7 +131,7 @@ class OrderByExecutor : public AbstractExecutor {
     sort_buffer_entry_t &operator=(const sort_buffer_entry_t &) = delete;
   };
 
-  /** All tiles returned by child. */
+  /** All tiles returned by child (null once a top-N sort drops them). */
   std::vector<std::unique_ptr<LogicalTile>> input_tiles_;
 
   /** Physical (not logical) schema of output tiles */
@@ -92,6 +148,22 @@ class OrderByExecutor : public AbstractExecutor {
 
   std::vector<bool> descend_flags_;
 
+  /** Estimated memory used by the buffered input tiles */
+  size_t buffered_size_ = 0;
+
+  /** Sorted runs of the input that did not fit in the memory budget */
+  std::vector<std::unique_ptr<SpillFile>> sort_runs_;
+
+  /** Runs being merged, the next row of each, and the heap of their ids */
+  std::vector<std::unique_ptr<SpillFile>> merge_runs_;
+
+  std::vector<std::vector<type::Value>> merge_rows_;
+
+  std::vector<size_t> merge_heap_;
+
+  /** Number of tuples in the merged runs */
+  size_t merge_row_count_ = 0;
+
   /** How many tuples have been returned to parent */
   size_t num_tuples_returned_ = 0;
 
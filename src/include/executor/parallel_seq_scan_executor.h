@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_seq_scan_executor.h
+//
+// Identification: src/include/executor/parallel_seq_scan_executor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/worker_pool.h"
+#include "container/bounded_queue.h"
+#include "executor/abstract_scan_executor.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/zone_map.h"
+
+// smallest table, in tile groups, whose scans are split across workers
+#define PARALLEL_SCAN_MIN_TILE_GROUP_COUNT 4
+
+// smallest table, in tuple slots, whose scans are split across workers; the
+// workers are asked for on every scan, so short scans stay serial
+#define PARALLEL_SCAN_MIN_TUPLE_COUNT 65536
+
+// number of scanned tile groups each worker may run ahead of the consumer
+#define PARALLEL_SCAN_QUEUE_SIZE_PER_WORKER 2
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace executor {
+
+/**
+ * Sequential scan of a table by a group of workers, exchange style.
+ *
+ * The workers, which run on the shared worker pool, claim tile groups, check
+ * the visibility of their tuples and apply the predicate, and push the
+ * matching positions into a bounded queue. Each call of DExecute gathers one
+ * of them into a logical tile, and scans a tile group itself while the queue
+ * is empty. Tiles come out in no particular order.
+ *
+ * Transactions are not shared between threads, so the gathering thread
+ * records the reads with the transaction, and checks the visibility of the
+ * tuples the transaction owns, which depends on its read/write set.
+ */
+class ParallelSeqScanExecutor : public AbstractScanExecutor {
+ public:
+  ParallelSeqScanExecutor(const ParallelSeqScanExecutor &) = delete;
+  ParallelSeqScanExecutor &operator=(const ParallelSeqScanExecutor &) = delete;
+  ParallelSeqScanExecutor(ParallelSeqScanExecutor &&) = delete;
+  ParallelSeqScanExecutor &operator=(ParallelSeqScanExecutor &&) = delete;
+
+  explicit ParallelSeqScanExecutor(const planner::AbstractPlan *node,
+                                   ExecutorContext *executor_context);
+
+  ~ParallelSeqScanExecutor();
+
+  // Whether the scan of the plan should be split across workers. Scans over
+  // child executors, of delta-stored tables and of small tables stay serial.
+  static bool IsParallelizable(const planner::SeqScanPlan &node);
+
+  void ResetState() {
+    StopWorkers();
+    exhausted_ = false;
+  }
+
+  size_t GetWorkerCount() const { return worker_count_; }
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  // The visible tuples of a tile group that satisfy the predicate
+  struct ScanResult {
+    std::shared_ptr<storage::TileGroup> tile_group;
+    std::vector<oid_t> position_list;
+    // tuples owned by the transaction, whose visibility is checked by the
+    // consumer
+    std::vector<oid_t> owned_position_list;
+  };
+
+  // Gather the next scanned tile group, scanning one on the calling thread
+  // while there are none queued. Returns false once all are gathered.
+  bool NextResult(concurrency::Transaction *transaction, ScanResult &result);
+
+  void StartWorkers();
+
+  // Close the queue and wait for the workers to exit
+  void StopWorkers();
+
+  // Claim and scan tile groups until there are none left
+  void ScanTileGroups(concurrency::Transaction *transaction);
+
+  // Returns false if no tuple of the tile group matches
+  bool ScanTileGroup(const oid_t &tile_group_offset,
+                     concurrency::Transaction *transaction,
+                     ScanResult &result) const;
+
+  // Check the visibility of the tuples owned by the transaction, which the
+  // workers leave to the consumer, and merge the matching ones into the
+  // position list
+  void ResolveOwnedTuples(concurrency::Transaction *transaction,
+                          ScanResult &result) const;
+
+  // Apply the predicate and the bloom filters to the positions
+  void FilterPositions(storage::TileGroup *tile_group,
+                       std::vector<oid_t> &position_list) const;
+
+  //===--------------------------------------------------------------------===//
+  // Executor State
+  //===--------------------------------------------------------------------===//
+
+  /** @brief Number of tile groups when the scan started. */
+  oid_t table_tile_group_count_ = INVALID_OID;
+
+  /** @brief Next tile group to be claimed by a worker. */
+  std::atomic<oid_t> next_tile_group_offset_;
+
+  size_t worker_count_ = 0;
+
+  /** @brief Set once the scan is done, until the executor is reset. */
+  bool exhausted_ = false;
+
+  /** @brief Whether the consumer still claims tile groups itself. */
+  bool is_producing_ = false;
+
+  WorkerGroup worker_group_;
+
+  /** @brief Scanned tile groups waiting to be gathered. */
+  std::unique_ptr<BoundedQueue<ScanResult>> result_queue_;
+
+  /** @brief The first error of a worker. */
+  std::exception_ptr error_;
+
+  std::mutex error_mutex_;
+
+  //===--------------------------------------------------------------------===//
+  // Plan Info
+  //===--------------------------------------------------------------------===//
+
+  /** @brief Predicate terms used to skip tile groups via their zone maps. */
+  std::vector<storage::ZoneMapPredicate> zone_map_predicates_;
+
+  /** @brief Pointer to table to scan from. */
+  storage::DataTable *target_table_ = nullptr;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -35,6 +35,14 @@ class ProjectionExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  //===--------------------------------------------------------------------===//
+  // Helper
+  //===--------------------------------------------------------------------===//
+
+  bool CanProjectLogically(LogicalTile *source_tile) const;
+
+  void ProjectLogically(LogicalTile *source_tile);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// radix_hash_table.h
+//
+// Identification: src/include/executor/radix_hash_table.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "type/type.h"
+#include "type/types.h"
+
+// largest number of entries per partition, so that the buckets and entries
+// of a partition stay in the L2 cache while it is built or probed
+#define RADIX_PARTITION_SIZE 4096
+
+// inputs with fewer tuples are built and probed by the calling thread alone
+#define RADIX_PARALLEL_MIN_TUPLE_COUNT 16384
+
+namespace peloton {
+namespace executor {
+
+class BloomFilter;
+class LogicalTile;
+
+/**
+ * Hash table over the tuples of a set of logical tiles, for hash joins.
+ *
+ * The tuples are hashed on their key columns and partitioned by the low bits
+ * of the hash into partitions of at most RADIX_PARTITION_SIZE entries. Each
+ * partition gets a flat table: a power-of-two array of bucket heads and a
+ * chain of entry offsets, both indexing one contiguous array of entries.
+ * The probe tuples are partitioned on the same bits, and each pair of
+ * partitions is joined on its own. Fixed width keys are copied into the
+ * table as 64-bit words and compared without building values. Large inputs
+ * are hashed, built and probed by a pool of threads shared by all tables.
+ *
+ * The table keeps pointers to the tiles, which have to outlive it.
+ */
+class RadixHashTable {
+ public:
+  // A tuple of the build side: the logical tile and the tuple offset in it
+  struct Location {
+    uint32_t tile_offset;
+    oid_t tuple_offset;
+  };
+
+  // A build tuple with the same key as a probe tuple
+  struct Match {
+    oid_t probe_offset;
+    Location location;
+  };
+
+  RadixHashTable(const RadixHashTable &) = delete;
+  RadixHashTable &operator=(const RadixHashTable &) = delete;
+
+  RadixHashTable() {}
+
+  // Build the table over the visible tuples of the tiles, keyed by the
+  // columns. A tuple whose key already occurs in an earlier tuple is removed
+  // from the visible tuples of its tile, but still stays in the table.
+  void Build(const std::vector<LogicalTile *> &tiles,
+             const std::vector<oid_t> &column_ids);
+
+  // Find the build tuples with the same key as each visible tuple of the
+  // probe tiles, whose key columns have the same ids. The matches of each
+  // probe tile are in probe order, and then in build order.
+  void Probe(const std::vector<LogicalTile *> &probe_tiles,
+             std::vector<std::vector<Match>> &matches) const;
+
+  // Bloom filter over the keys of the table, for the hashes of HashKey()
+  std::shared_ptr<const BloomFilter> BuildBloomFilter() const;
+
+  // Hash of a key, from the hash code of its values
+  static hash_t HashKey(const size_t &hash_code);
+
+  size_t GetSize() const { return entries_.size(); }
+
+  size_t GetPartitionCount() const { return partition_offsets_.size() - 1; }
+
+ private:
+  struct Entry {
+    hash_t hash;
+    Location location;
+  };
+
+  // A tuple of the probe side, and its number in probe order
+  struct ProbeEntry {
+    hash_t hash;
+    uint32_t probe_index;
+    Location location;
+  };
+
+  // A build tuple with the same key as a probe tuple, by partition
+  struct PartitionMatch {
+    uint32_t probe_index;
+    Location probe_location;
+    Location build_location;
+  };
+
+  // Collect the key types of the tiles, if every key column is fixed width
+  // and has the same type in every tile
+  static bool GetKeyTypes(const std::vector<LogicalTile *> &tiles,
+                          const std::vector<oid_t> &column_ids,
+                          std::vector<type::Type::TypeId> &key_types);
+
+  // Hash the key of a visible tuple of the tile, and copy it into the key
+  // words unless they are null
+  hash_t HashTuple(LogicalTile *tile, const oid_t &tuple_offset,
+                   int64_t *key_words) const;
+
+  inline bool KeyWordsEqual(const int64_t *lhs, const int64_t *rhs) const {
+    for (size_t word_itr = 0; word_itr < key_width_; word_itr++) {
+      if (lhs[word_itr] != rhs[word_itr]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Whether the build and the probe tuple have the same key values
+  bool KeyValuesEqual(const Location &build_location, LogicalTile *probe_tile,
+                      const oid_t &probe_offset) const;
+
+  // Link the entries of the partition into its buckets, in build order, and
+  // collect the tuples whose key occurs in an earlier tuple
+  void BuildPartition(const size_t &partition,
+                      std::vector<Location> &duplicates);
+
+  // Find the build tuples with the same key as each probe tuple of the
+  // partition, whose key words are set if the keys are compared as words
+  void ProbePartition(const size_t &partition,
+                      const std::vector<LogicalTile *> &probe_tiles,
+                      const std::vector<size_t> &probe_partition_offsets,
+                      const std::vector<ProbeEntry> &probe_entries,
+                      const std::vector<int64_t> &probe_key_words,
+                      std::vector<uint32_t> &match_counts,
+                      std::vector<PartitionMatch> &matches) const;
+
+  // Run the task for every unit of work, with the help of the worker pool if
+  // there is enough work in total
+  static void RunTasks(const size_t &unit_count, const size_t &tuple_count,
+                       const std::function<void(size_t)> &task);
+
+  std::vector<LogicalTile *> tiles_;
+
+  std::vector<oid_t> column_ids_;
+
+  // types of the key columns, if the keys are compared as words
+  std::vector<type::Type::TypeId> key_types_;
+
+  // number of words of a key: the key values, then a bitmap of the null
+  // ones. 0 if the keys are compared as values.
+  size_t key_width_ = 0;
+
+  // number of low hash bits that select the partition
+  size_t radix_bits_ = 0;
+
+  // entries, grouped by partition
+  std::vector<Entry> entries_;
+
+  // key words of the entries, in entry order
+  std::vector<int64_t> key_words_;
+
+  // offset of the first entry of each partition, and the entry count
+  std::vector<size_t> partition_offsets_ = {0};
+
+  // offset of the first bucket of each partition, and the bucket count
+  std::vector<size_t> bucket_offsets_ = {0};
+
+  // first entry of each bucket
+  std::vector<uint32_t> buckets_;
+
+  // next entry in the bucket of each entry
+  std::vector<uint32_t> next_entries_;
+};
+
+}  // namespace executor
+}  // namespace peloton
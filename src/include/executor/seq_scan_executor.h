@@ -12,8 +12,12 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "planner/seq_scan_plan.h"
 #include "executor/abstract_scan_executor.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace executor {
@@ -28,7 +32,10 @@ class SeqScanExecutor : public AbstractScanExecutor {
   explicit SeqScanExecutor(const planner::AbstractPlan *node,
                            ExecutorContext *executor_context);
 
-  void ResetState() { current_tile_group_offset_ = START_OID; }
+  void ResetState() {
+    current_tile_group_offset_ = START_OID;
+    delta_tiles_.clear();
+  }
 
  protected:
   bool DInit();
@@ -52,6 +59,12 @@ class SeqScanExecutor : public AbstractScanExecutor {
 
   bool index_done_ = false;
 
+  /** @brief Predicate terms used to skip tile groups via their zone maps. */
+  std::vector<storage::ZoneMapPredicate> zone_map_predicates_;
+
+  /** @brief Copies of delta-stored tuples waiting to be returned. */
+  std::vector<std::unique_ptr<LogicalTile>> delta_tiles_;
+
   /** @brief Pointer to table to scan from. */
   storage::DataTable *target_table_ = nullptr;
 };
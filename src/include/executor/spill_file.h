@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.h
+//
+// Identification: src/include/executor/spill_file.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+#include "type/serializeio.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * Temporary file of rows of values, for operators that run out of their
+ * memory budget. The rows are appended, then read back in the same order.
+ *
+ * Each row records the types of its values, so rows of different shapes can
+ * share a file. Callers that keep their rows in their own fixed size format
+ * append and read them as bytes instead; a file holds rows of one kind only.
+ * The file is removed once it is closed.
+ */
+class SpillFile {
+ public:
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  SpillFile();
+
+  ~SpillFile();
+
+  // Append a row at the end of the file
+  void Append(const std::vector<type::Value> &values);
+
+  // Go back to the first row, to read the file
+  void Rewind();
+
+  // Read the next row into the values. Returns false after the last row.
+  bool Next(std::vector<type::Value> &values);
+
+  // Append a row of the given number of bytes at the end of the file
+  void AppendBytes(const char *data, size_t size);
+
+  // Read the next row of bytes, of the size it was appended with. Returns
+  // false after the last row.
+  bool NextBytes(char *data, size_t size);
+
+  size_t GetRowCount() const { return row_count_; }
+
+  size_t GetSize() const { return size_; }
+
+ private:
+  FILE *file_;
+
+  size_t row_count_ = 0;
+
+  /** @brief Bytes written to the file. */
+  size_t size_ = 0;
+
+  /** @brief Serialized row being written. */
+  CopySerializeOutput output_;
+
+  /** @brief Serialized row being read. */
+  std::vector<char> input_;
+};
+
+}  // namespace executor
+}  // namespace peloton
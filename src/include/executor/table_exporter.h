@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_exporter.h
+//
+// Identification: src/include/executor/table_exporter.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <string>
+
+#include "type/types.h"
+
+// size of the buffers that the workers of an export fill before writing
+#define EXPORT_BUFFER_SIZE (4 * 1024 * 1024)
+
+// leading bytes of a columnar binary export
+#define EXPORT_BINARY_MAGIC "PLTNCOL1"
+
+namespace peloton {
+
+class CopySerializeOutput;
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+class DataTable;
+}
+
+namespace type {
+class Value;
+}
+
+namespace executor {
+
+/**
+ * Exports a table, for COPY TO in CSV or binary format.
+ *
+ * The calling thread and the worker pool claim tile groups and format the
+ * tuples visible to the transaction into private buffers, which are appended
+ * to the file once they grow large. The rows of a tile group stay together, but tile groups may
+ * appear in any order.
+ *
+ * CSV fields are quoted as COPY FROM expects them. A binary export holds the
+ * magic bytes, the column count and the column types, followed by one block
+ * per tile group: the row count, and then the values of each column in turn,
+ * serialized as type::Value::SerializeTo writes them.
+ */
+class TableExporter {
+ public:
+  TableExporter(const TableExporter &) = delete;
+  TableExporter &operator=(const TableExporter &) = delete;
+
+  TableExporter(storage::DataTable *table, CopyType copy_type,
+                char delimiter);
+
+  // Write the tuples visible to the transaction to the file, reading them
+  // as a scan does. Throws an ExecutorException if the file cannot be
+  // written, or if a read fails, which also sets the transaction result to
+  // FAILURE. Returns the number of bytes written.
+  size_t Export(const std::string &file_path,
+                concurrency::Transaction *transaction);
+
+  size_t GetExportedTupleCount() const { return exported_tuple_count_; }
+
+ private:
+  // Claim and export tile groups until there are none left
+  void ExportTileGroups(concurrency::Transaction *transaction);
+
+  // Append the visible tuples of a tile group to the buffer
+  void ExportTileGroup(const oid_t &tile_group_offset,
+                       concurrency::Transaction *transaction,
+                       CopySerializeOutput &output);
+
+  void AppendCsvValue(const type::Value &value,
+                      CopySerializeOutput &output) const;
+
+  // Append the buffer to the file, and empty it
+  void Write(CopySerializeOutput &output);
+
+  storage::DataTable *table_;
+
+  const CopyType copy_type_;
+
+  const char delimiter_;
+
+  int fd_;
+
+  // number of tile groups when the export started
+  size_t tile_group_count_;
+
+  // next tile group to be claimed by a worker
+  std::atomic<size_t> next_tile_group_offset_;
+
+  std::atomic<size_t> exported_tuple_count_;
+
+  size_t total_bytes_written_;
+
+  // the first error of a worker, which stops all workers
+  std::exception_ptr error_;
+
+  std::atomic<bool> has_error_;
+
+  // Protects the file and the error
+  std::mutex write_mutex_;
+
+  // Serializes the accesses of the workers to the read/write set of the
+  // transaction
+  std::mutex read_mutex_;
+};
+
+}  // namespace executor
+}  // namespace peloton
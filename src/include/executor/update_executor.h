@@ -42,6 +42,14 @@ class UpdateExecutor : public AbstractExecutor {
                                oid_t physical_tuple_id,
                                ItemPointer &old_location);
 
+  // update a tuple of a delta-stored table by recording a delta of the
+  // updated columns instead of copying the tuple.
+  bool PerformDeltaUpdate(bool is_owner,
+                          storage::TileGroup *tile_group,
+                          storage::TileGroupHeader *tile_group_header,
+                          oid_t physical_tuple_id,
+                          ItemPointer &old_location);
+
   bool DInit();
 
   bool DExecute();
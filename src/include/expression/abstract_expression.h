@@ -35,12 +35,18 @@ namespace planner {
 class BindingContext;
 }
 
+namespace storage {
+class TileGroup;
+}
+
 namespace type {
 class Value;
 }
 
 namespace expression {
 
+struct NumericVector;
+
 //===----------------------------------------------------------------------===//
 // AbstractExpression
 //
@@ -61,6 +67,29 @@ class AbstractExpression : public Printable {
                                const AbstractTuple *tuple2,
                                executor::ExecutorContext *context) const = 0;
 
+  /**
+   * Evaluate the predicate for the tuples of a tile group in the selection
+   * vector, and keep only those it is true for. The selection vector is in
+   * ascending order. By default each tuple is evaluated on its own.
+   */
+  virtual void EvaluateBatch(storage::TileGroup *tile_group,
+                             std::vector<oid_t> &selection,
+                             executor::ExecutorContext *context) const;
+
+  /**
+   * Compute the numeric values of this expression for the tuples of a tile
+   * group in the selection vector. Returns false if the expression has no
+   * batch kernel for them, or the values would raise an error, in which case
+   * the caller has to evaluate the tuples one by one.
+   */
+  virtual bool EvaluateNumericBatch(
+      UNUSED_ATTRIBUTE storage::TileGroup *tile_group,
+      UNUSED_ATTRIBUTE const std::vector<oid_t> &selection,
+      UNUSED_ATTRIBUTE executor::ExecutorContext *context,
+      UNUSED_ATTRIBUTE NumericVector &result) const {
+    return false;
+  }
+
   /**
    * Return true if this expression or any descendent has a value that should be
    * substituted with a parameter.
@@ -71,6 +71,12 @@ class ComparisonExpression : public AbstractExpression {
     }
   }
 
+  // Compares numeric operands with typed kernels, and falls back to the
+  // evaluation of each tuple otherwise
+  void EvaluateBatch(storage::TileGroup *tile_group,
+                     std::vector<oid_t> &selection,
+                     executor::ExecutorContext *context) const override;
+
   AbstractExpression *Copy() const override {
     return new ComparisonExpression(*this);
   }
@@ -57,6 +57,12 @@ class ConjunctionExpression : public AbstractExpression {
     }
   }
 
+  // AND narrows the selection with each child in turn, and OR evaluates the
+  // right child only on the tuples the left one rejects
+  void EvaluateBatch(storage::TileGroup *tile_group,
+                     std::vector<oid_t> &selection,
+                     executor::ExecutorContext *context) const override;
+
   AbstractExpression *Copy() const override {
     return new ConjunctionExpression(*this);
   }
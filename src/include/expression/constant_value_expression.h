@@ -14,6 +14,7 @@
 
 #include "common/sql_node_visitor.h"
 #include "expression/abstract_expression.h"
+#include "expression/numeric_vector.h"
 #include "util/hash_util.h"
 
 namespace peloton {
@@ -37,6 +38,14 @@ class ConstantValueExpression : public AbstractExpression {
     return value_;
   }
 
+  bool EvaluateNumericBatch(
+      UNUSED_ATTRIBUTE storage::TileGroup *tile_group,
+      const std::vector<oid_t> &selection,
+      UNUSED_ATTRIBUTE executor::ExecutorContext *context,
+      NumericVector &result) const override {
+    return result.Broadcast(value_, selection.size());
+  }
+
   virtual void DeduceExpressionName() override {
     if (!alias.empty())
       return;
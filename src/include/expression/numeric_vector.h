@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// numeric_vector.h
+//
+// Identification: src/include/expression/numeric_vector.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "type/type.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace expression {
+
+//===----------------------------------------------------------------------===//
+// NumericVector
+//
+// The values of a numeric expression for the tuples of a selection vector,
+// one entry per selected tuple. Integer types are widened to 64 bits; only
+// one of the two value arrays is filled, depending on the type.
+//===----------------------------------------------------------------------===//
+
+struct NumericVector {
+  void Reset(type::Type::TypeId value_type, size_t size) {
+    type_id = value_type;
+    if (IsDecimal() == true) {
+      integers.clear();
+      decimals.resize(size);
+    } else {
+      decimals.clear();
+      integers.resize(size);
+    }
+    nulls.assign(size, 0);
+  }
+
+  // Repeat a numeric value, and return false for other types
+  bool Broadcast(const type::Value &value, size_t size) {
+    auto value_type = value.GetTypeId();
+    switch (value_type) {
+      case type::Type::TINYINT:
+      case type::Type::SMALLINT:
+      case type::Type::INTEGER:
+      case type::Type::BIGINT:
+      case type::Type::DECIMAL:
+        break;
+      default:
+        return false;
+    }
+
+    Reset(value_type, size);
+    if (value.IsNull() == true) {
+      nulls.assign(size, 1);
+    } else if (IsDecimal() == true) {
+      decimals.assign(size, value.GetAs<double>());
+    } else if (value_type == type::Type::TINYINT) {
+      integers.assign(size, value.GetAs<int8_t>());
+    } else if (value_type == type::Type::SMALLINT) {
+      integers.assign(size, value.GetAs<int16_t>());
+    } else if (value_type == type::Type::INTEGER) {
+      integers.assign(size, value.GetAs<int32_t>());
+    } else {
+      integers.assign(size, value.GetAs<int64_t>());
+    }
+    return true;
+  }
+
+  inline bool IsDecimal() const { return type_id == type::Type::DECIMAL; }
+
+  inline size_t GetSize() const { return nulls.size(); }
+
+  // The value at the index, as a double
+  inline double GetDecimal(size_t index) const {
+    return IsDecimal() ? decimals[index] : (double)integers[index];
+  }
+
+  // TINYINT, SMALLINT, INTEGER, BIGINT or DECIMAL
+  type::Type::TypeId type_id = type::Type::INVALID;
+
+  std::vector<int64_t> integers;
+
+  std::vector<double> decimals;
+
+  // non-zero for the NULL entries
+  std::vector<uint8_t> nulls;
+};
+
+}  // namespace expression
+}  // namespace peloton
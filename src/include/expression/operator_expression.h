@@ -68,6 +68,13 @@ class OperatorExpression : public AbstractExpression {
     }
   }
 
+  // Computes +, -, * and / on numeric operands. Overflows and divisions by
+  // zero are left to the evaluation of each tuple, which raises the error.
+  bool EvaluateNumericBatch(storage::TileGroup *tile_group,
+                            const std::vector<oid_t> &selection,
+                            executor::ExecutorContext *context,
+                            NumericVector &result) const override;
+
   void DeduceExpressionType() {
     // if we are a decimal or int we should take the highest type id of both
     // children
@@ -13,6 +13,7 @@
 #pragma once
 
 #include "expression/abstract_expression.h"
+#include "expression/numeric_vector.h"
 #include "executor/executor_context.h"
 #include "common/sql_node_visitor.h"
 
@@ -38,6 +39,14 @@ class ParameterValueExpression : public AbstractExpression {
     return context->GetParams().at(value_idx_);
   }
 
+  bool EvaluateNumericBatch(
+      UNUSED_ATTRIBUTE storage::TileGroup *tile_group,
+      const std::vector<oid_t> &selection, executor::ExecutorContext *context,
+      NumericVector &result) const override {
+    return result.Broadcast(context->GetParams().at(value_idx_),
+                            selection.size());
+  }
+
   AbstractExpression *Copy() const override {
     return new ParameterValueExpression(value_idx_);
   }
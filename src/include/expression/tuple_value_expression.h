@@ -55,6 +55,12 @@ class TupleValueExpression : public AbstractExpression {
       const AbstractTuple *tuple1, const AbstractTuple *tuple2,
       executor::ExecutorContext *context) const override;
 
+  // Reads numeric columns of the first tuple straight from the tiles
+  virtual bool EvaluateNumericBatch(storage::TileGroup *tile_group,
+                                    const std::vector<oid_t> &selection,
+                                    executor::ExecutorContext *context,
+                                    NumericVector &result) const override;
+
   virtual void DeduceExpressionName() override {
     if (!alias.empty())
       return;
@@ -26,6 +26,7 @@ class GCManagerFactory {
     switch (gc_type_) {
 
       case GarbageCollectionType::ON:
+      case GarbageCollectionType::COOPERATIVE:
         return TransactionLevelGCManager::GetInstance(gc_thread_count_);
 
       default:
@@ -33,12 +34,23 @@ class GCManagerFactory {
     }
   }
 
-  static void Configure(const int thread_count = 1) { 
+  // in cooperative mode, thread_count is the number of garbage partitions
+  // that the worker threads hash into.
+  static void Configure(const int thread_count = 1,
+                        const bool is_cooperative = false) {
     if (thread_count == 0) {
+      // worker threads must not keep collecting once gc is off
+      if (gc_type_ == GarbageCollectionType::COOPERATIVE) {
+        TransactionLevelGCManager::GetInstance(gc_thread_count_)
+            .SetCooperative(false);
+      }
       gc_type_ = GarbageCollectionType::OFF;
     } else {
-      gc_type_ = GarbageCollectionType::ON;
+      gc_type_ = (is_cooperative == true) ? GarbageCollectionType::COOPERATIVE
+                                          : GarbageCollectionType::ON;
       gc_thread_count_ = thread_count;
+      TransactionLevelGCManager::GetInstance(gc_thread_count_)
+          .SetCooperative(is_cooperative);
     }
   }
 
@@ -0,0 +1,192 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor.h
+//
+// Identification: src/include/gc/tile_group_compactor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+class TileGroup;
+}
+
+namespace type {
+class AbstractPool;
+}
+
+namespace gc {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Compactor
+//===--------------------------------------------------------------------===//
+
+/**
+ * Empties sparse tile groups and returns their memory.
+ *
+ * A tile group whose occupancy drops below a threshold is marked as
+ * compacting, after which its recycled slots are no longer reused. Once every
+ * transaction that may have claimed one of its slots has finished, the latest
+ * versions of the tuples it holds are moved into other tile groups by regular
+ * updates, which redirect the indirections that the indexes point to. The GC
+ * then reclaims the old versions, and the tile group is dropped once all of
+ * its slots are free.
+ *
+ * Tile groups whose layout no longer matches the default layout of their
+ * table are compacted the same way, so that their tuples are rewritten into
+ * tile groups of the tuned layout.
+ *
+ * A full tile group whose tuples all hold a single committed version, that
+ * every running transaction can see, is frozen instead: visibility checks of
+ * its tuples are skipped, and each distinct varlen value of its tiles is
+ * stored only once. The first write to a frozen tile group unfreezes it.
+ */
+class TileGroupCompactor {
+ public:
+  TileGroupCompactor(const TileGroupCompactor &) = delete;
+  TileGroupCompactor &operator=(const TileGroupCompactor &) = delete;
+  TileGroupCompactor(TileGroupCompactor &&) = delete;
+  TileGroupCompactor &operator=(TileGroupCompactor &&) = delete;
+
+  TileGroupCompactor();
+
+  ~TileGroupCompactor();
+
+  // Singleton
+  static TileGroupCompactor &GetInstance();
+
+  // Start compaction
+  void Start();
+
+  // Compact tables until stopped
+  void Compact();
+
+  // Stop compaction
+  void Stop();
+
+  // Make a single compaction pass over all tables.
+  // Returns the number of dropped tile groups.
+  size_t CompactTables();
+
+  // Make a single compaction pass over a table.
+  // Returns the number of dropped tile groups.
+  size_t CompactTable(storage::DataTable *table);
+
+  // Mark up to max_tile_group_count tile groups of the table whose layout
+  // differs from the layout of its new tile groups by at least theta, and
+  // advance the compaction of the table. Their tuples are only moved into
+  // tile groups of the new layout. Returns the number of marked tile groups.
+  size_t ReorganizeTable(storage::DataTable *table, const double &theta,
+                         const size_t &max_tile_group_count);
+
+  // Make a single freezing pass over a table.
+  // Returns the number of frozen tile groups.
+  size_t FreezeTable(storage::DataTable *table);
+
+  // Add table to list of tables that must be compacted
+  void AddTable(storage::DataTable *table);
+
+  // Remove table from list, e.g. when the table is dropped
+  void DropTable(const oid_t &table_id);
+
+  // Clear list
+  void ClearTables();
+
+  void SetOccupancyThreshold(const double &threshold) {
+    occupancy_threshold = threshold;
+  }
+
+ protected:
+  // Whether the share of occupied slots is below the threshold
+  bool IsSparse(storage::TileGroup *tile_group) const;
+
+  // Whether all slots of the tile group are free
+  bool IsEmpty(storage::TileGroup *tile_group) const;
+
+  // Move the latest versions out of the tile group.
+  // Returns the number of moved tuples, which is zero if the moving
+  // transaction fails to commit.
+  size_t MigrateTuples(storage::DataTable *table,
+                       storage::TileGroup *tile_group);
+
+  // Whether every slot holds a committed version that is not being replaced.
+  // Sets the latest commit id of the versions.
+  bool IsCold(storage::TileGroup *tile_group, cid_t &max_begin_cid) const;
+
+  // Freeze the tile group, unless a version was written since it was found
+  // cold. Returns whether the tile group was frozen.
+  bool FreezeTileGroup(storage::TileGroup *tile_group,
+                       const cid_t &cold_begin_cid);
+
+  // Whether no writer unfroze the freezing tile group, and no version was
+  // written since it was found cold
+  bool IsStillCold(storage::TileGroup *tile_group,
+                   const cid_t &cold_begin_cid) const;
+
+  // Store each distinct varlen value of the tile group only once, unless a
+  // writer owned a version in the meantime. Returns whether the values were
+  // moved into the dictionaries.
+  bool EncodeVarlenValues(storage::TileGroup *tile_group,
+                          const cid_t &cold_begin_cid);
+
+  // Give the heap memory freed by dropped tile groups back to the OS
+  void ReleaseMemory();
+
+  // Free the retired pools that no transaction can read from anymore
+  void ReleasePools();
+
+ private:
+  // Tables that must be compacted
+  std::vector<storage::DataTable *> tables;
+
+  // table id -> (compacting tile group id -> epoch at which it was marked)
+  std::unordered_map<oid_t, std::map<oid_t, eid_t>> compacting_tile_groups;
+
+  // table id -> (cold tile group id -> (epoch at which it was found cold,
+  // latest commit id of its versions))
+  std::unordered_map<oid_t, std::map<oid_t, std::pair<eid_t, cid_t>>>
+      cold_tile_groups;
+
+  // pools replaced while freezing, with the epoch at which they were retired
+  std::vector<std::pair<eid_t, std::unique_ptr<type::AbstractPool>>>
+      retired_pools;
+
+  std::mutex compactor_mutex;
+
+  // Stop signal
+  std::atomic<bool> compaction_stop;
+
+  // Compactor thread
+  std::thread compactor_thread;
+
+  //===--------------------------------------------------------------------===//
+  // Compactor Parameters
+  //===--------------------------------------------------------------------===//
+
+  // A tile group is compacted if at most this share of its slots is occupied
+  double occupancy_threshold = 0.25;
+
+  // Sleeping period (in us)
+  oid_t sleep_duration = 100000;
+};
+
+}  // End gc namespace
+}  // End peloton namespace
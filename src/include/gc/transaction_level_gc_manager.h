@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <thread>
 #include <unordered_map>
 #include <map>
@@ -21,6 +22,7 @@
 #include "type/types.h"
 #include "common/logger.h"
 #include "common/init.h"
+#include "common/platform.h"
 #include "common/thread_pool.h"
 #include "gc/gc_manager.h"
 
@@ -31,6 +33,7 @@ namespace gc {
 
 #define MAX_QUEUE_LENGTH 100000
 #define MAX_ATTEMPT_COUNT 100000
+#define COOPERATIVE_ATTEMPT_COUNT 1000
 
 
 struct GarbageContext {
@@ -49,7 +52,12 @@ class TransactionLevelGCManager : public GCManager {
 public:
   TransactionLevelGCManager(const int thread_count) 
     : gc_thread_count_(thread_count),
-      reclaim_maps_(thread_count) {
+      is_cooperative_(false),
+      reclaim_maps_(thread_count),
+      partition_locks_(thread_count),
+      collected_eids_(thread_count, INVALID_EID),
+      recycle_generation_(0),
+      drained_eid_(0) {
 
     unlink_queues_.reserve(thread_count);
     for (int i = 0; i < gc_thread_count_; ++i) {
@@ -71,6 +79,10 @@ public:
   virtual void StartGC(std::vector<std::unique_ptr<std::thread>> &gc_threads) override {
     LOG_TRACE("Starting GC");
     this->is_running_ = true;
+    // worker threads collect the garbage themselves
+    if (is_cooperative_ == true) {
+      return;
+    }
     gc_threads.resize(gc_thread_count_);
     for (int i = 0; i < gc_thread_count_; ++i) {
       gc_threads[i].reset(new std::thread(&TransactionLevelGCManager::Running, this, i));
@@ -81,6 +93,10 @@ public:
   virtual void StartGC() override {
     LOG_TRACE("Starting GC");
     this->is_running_ = true;
+    // worker threads collect the garbage themselves
+    if (is_cooperative_ == true) {
+      return;
+    }
     for (int i = 0; i < gc_thread_count_; ++i) {
       thread_pool.SubmitDedicatedTask(&TransactionLevelGCManager::Running, this, std::move(i));
     }
@@ -96,27 +112,52 @@ public:
   virtual ItemPointer ReturnFreeSlot(const oid_t &table_id) override;
 
   virtual void RegisterTable(const oid_t &table_id) override {
+    recycle_queue_map_lock_.WriteLock();
     // Insert a new entry for the table
     if (recycle_queue_map_.find(table_id) == recycle_queue_map_.end()) {
-      std::shared_ptr<LockFreeQueue<ItemPointer>> recycle_queue(new LockFreeQueue<ItemPointer>(MAX_QUEUE_LENGTH));
+      std::shared_ptr<LockFreeQueue<std::vector<ItemPointer>>> recycle_queue(
+          new LockFreeQueue<std::vector<ItemPointer>>(MAX_QUEUE_LENGTH));
       recycle_queue_map_[table_id] = recycle_queue;
+      // worker threads may have cached the table as unregistered
+      recycle_generation_++;
     }
+    recycle_queue_map_lock_.Unlock();
   }
 
   virtual void DeregisterTable(const oid_t &table_id) override {
+    recycle_queue_map_lock_.WriteLock();
     // Remove dropped tables
     if (recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
       recycle_queue_map_.erase(table_id);
+      // slots cached by worker threads may belong to the dropped table
+      recycle_generation_++;
     }
+    recycle_queue_map_lock_.Unlock();
   }
 
   virtual size_t GetTableCount() override {
-    return recycle_queue_map_.size();
+    recycle_queue_map_lock_.ReadLock();
+    size_t table_count = recycle_queue_map_.size();
+    recycle_queue_map_lock_.Unlock();
+    return table_count;
+  }
+
+  // in cooperative mode, no gc thread is started. instead, every worker
+  // thread collects a batch of the garbage partition it hashes to when it
+  // recycles a transaction.
+  void SetCooperative(const bool is_cooperative) {
+    is_cooperative_ = is_cooperative;
   }
 
-  int Unlink(const int &thread_id, const eid_t &expired_eid);
+  bool IsCooperative() const { return is_cooperative_.load(); }
 
-  int Reclaim(const int &thread_id, const eid_t &expired_eid);
+  int Unlink(const int &thread_id, const eid_t &expired_eid,
+             const size_t &max_attempt_count = MAX_ATTEMPT_COUNT);
+
+  int Reclaim(const int &thread_id, const eid_t &expired_eid,
+              const size_t &max_attempt_count = MAX_ATTEMPT_COUNT);
+
+  int CollectGarbage(const size_t &thread_id);
 
 private:
 
@@ -130,6 +171,13 @@ private:
 
   void AddToRecycleMap(std::shared_ptr<GarbageContext> gc_ctx);
 
+  void AddToRecycleQueue(const oid_t &table_id,
+                         std::vector<ItemPointer> &free_slots);
+
+  // give the free slots cached by threads that have not taken a slot since
+  // the expired epoch back to the recycle queues
+  void DrainIdleSlotCaches(const eid_t &expired_eid);
+
   bool ResetTuple(const ItemPointer &);
 
   void DeleteFromIndexes(const std::shared_ptr<GarbageContext>& garbage_ctx);
@@ -143,6 +191,9 @@ private:
 
   int gc_thread_count_;
 
+  // read by the worker threads on every commit
+  std::atomic<bool> is_cooperative_;
+
   // queues for to-be-unlinked tuples.
   // # unlink_queues == # gc_threads
   std::vector<std::shared_ptr<peloton::LockFreeQueue<std::shared_ptr<GarbageContext>>>> unlink_queues_;
@@ -157,9 +208,32 @@ private:
   // # reclaim_maps == # gc_threads
   std::vector<std::multimap<cid_t, std::shared_ptr<GarbageContext>>> reclaim_maps_;
 
+  // in cooperative mode, a partition of the queues and maps above is
+  // collected by one worker at a time.
+  // # partition_locks == # gc_threads
+  std::vector<Spinlock> partition_locks_;
+
+  // the expired epoch at which all the expired deltas were merged for each
+  // partition.
+  // # collected_eids == # gc_threads
+  std::vector<eid_t> collected_eids_;
+
   // queues for to-be-reused tuples.
+  // every element is a batch of free slots of the same tile group. a worker
+  // thread takes a whole batch into its local cache and reuses the slots
+  // one by one, so that consecutive inserts of a thread hit the same tile
+  // group and the shared queue is touched once per batch.
   // # recycle_queue_maps == # tables
-  std::unordered_map<oid_t, std::shared_ptr<peloton::LockFreeQueue<ItemPointer>>> recycle_queue_map_;
+  std::unordered_map<oid_t, std::shared_ptr<peloton::LockFreeQueue<std::vector<ItemPointer>>>> recycle_queue_map_;
+
+  RWLock recycle_queue_map_lock_;
+
+  // bumped whenever a table is registered or deregistered, upon which worker
+  // threads give their cached free slots back and refresh their queues.
+  std::atomic<uint64_t> recycle_generation_;
+
+  // the expired epoch at which the idle slot caches were last drained
+  std::atomic<eid_t> drained_eid_;
 
 };
 }
@@ -93,6 +93,8 @@ class BWTreeIndex : public Index {
 
   void ScanAllKeys(std::vector<ValueType> &result);
 
+  std::unique_ptr<IndexScanCursor> ScanAllKeysInBatches();
+
   void ScanKey(const storage::Tuple *key,
                std::vector<ValueType> &result);
 
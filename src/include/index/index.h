@@ -192,6 +192,41 @@ class IndexMetadata : public Printable {
   static bool index_default_visibility;
 };
 
+/////////////////////////////////////////////////////////////////////
+// IndexScanCursor class definition
+/////////////////////////////////////////////////////////////////////
+
+/*
+ * class IndexScanCursor - The position of a forward scan over the entries of
+ *                         an index, which is resumed to read the entries in
+ *                         bounded batches
+ */
+class IndexScanCursor {
+ public:
+  virtual ~IndexScanCursor() {}
+
+  // Append up to max_count of the entries that follow the ones returned so
+  // far. Returns false once there is no entry left.
+  virtual bool Next(size_t max_count, std::vector<ItemPointer *> &result) = 0;
+};
+
+/*
+ * class BufferedIndexScanCursor - Hands out the entries of a scan that has
+ *                                 already been run in batches
+ */
+class BufferedIndexScanCursor : public IndexScanCursor {
+ public:
+  BufferedIndexScanCursor(std::vector<ItemPointer *> &&entries)
+      : entries_(std::move(entries)) {}
+
+  bool Next(size_t max_count, std::vector<ItemPointer *> &result);
+
+ private:
+  std::vector<ItemPointer *> entries_;
+
+  size_t next_entry_ = 0;
+};
+
 /////////////////////////////////////////////////////////////////////
 // Index class definition
 /////////////////////////////////////////////////////////////////////
@@ -281,6 +316,10 @@ class Index : public Printable {
 
   virtual void ScanAllKeys(std::vector<ItemPointer *> &result) = 0;
 
+  // Scan all entries in key order, a batch at a time. By default the entries
+  // are all collected first.
+  virtual std::unique_ptr<IndexScanCursor> ScanAllKeysInBatches();
+
   virtual void ScanKey(const storage::Tuple *key,
                        std::vector<ItemPointer *> &result) = 0;
 
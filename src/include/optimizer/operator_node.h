@@ -34,6 +34,7 @@ enum class OpType {
   RightJoin,
   OuterJoin,
   SemiJoin,
+  AntiJoin,
   LogicalAggregate,
   LogicalGroupBy,
   LogicalHash,
@@ -119,6 +119,16 @@ class LogicalSemiJoin : public OperatorNode<LogicalSemiJoin> {
   expression::AbstractExpression *condition;
 };
 
+//===--------------------------------------------------------------------===//
+// AntiJoin
+//===--------------------------------------------------------------------===//
+class LogicalAntiJoin : public OperatorNode<LogicalAntiJoin> {
+ public:
+  static Operator make(expression::AbstractExpression *condition = nullptr);
+
+  expression::AbstractExpression *condition;
+};
+
 //===--------------------------------------------------------------------===//
 // Aggregate
 //===--------------------------------------------------------------------===//
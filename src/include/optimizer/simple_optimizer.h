@@ -40,6 +40,10 @@ namespace expression {
 class AbstractExpression;
 }
 
+namespace index {
+class Index;
+}
+
 namespace planner {
 class AbstractScan;
 }
@@ -97,6 +101,11 @@ class SimpleOptimizer : public AbstractOptimizer {
   static std::unique_ptr<planner::AbstractPlan> CreateJoinPlan(
       parser::SelectStatement *select_stmt);
 
+  // find the primary index if it returns the tuples of the table in the order
+  // of the column, for a merge join. Returns nullptr if there is none.
+  static std::shared_ptr<index::Index> GetOrderedIndex(
+      storage::DataTable *target_table, oid_t column_id);
+
   // This is used for order_by + limit optimization. Let the index scan executor
   // know order_by flags when create an order_by
   // plan. This is used when we create a order_by plan and the underlying
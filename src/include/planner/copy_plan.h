@@ -37,6 +37,19 @@ class CopyPlan : public AbstractPlan {
     LOG_DEBUG("Creating a Copy Plan");
   }
 
+  // COPY FROM the file into the table, or COPY TO the file by scanning the
+  // table in parallel
+  explicit CopyPlan(storage::DataTable *target_table, char *file_path,
+                    char delimiter, CopyType copy_type)
+      : file_path(file_path),
+        is_from(copy_type == CopyType::IMPORT_CSV ||
+                copy_type == CopyType::IMPORT_TSV),
+        target_table(target_table),
+        delimiter(delimiter),
+        copy_type(copy_type) {
+    LOG_DEBUG("Creating a Copy Plan for table");
+  }
+
   inline PlanNodeType GetPlanNodeType() const { return PlanNodeType::COPY; }
 
   const std::string GetInfo() const { return "CopyPlan"; }
@@ -50,6 +63,16 @@ class CopyPlan : public AbstractPlan {
   // Whether the copying requires deserialization of parameters
   bool deserialize_parameters = false;
 
+  // Whether the rows are copied from the file into the target table
+  bool is_from = false;
+
+  storage::DataTable *target_table = nullptr;
+
+  // Field delimiter of the file
+  char delimiter = ',';
+
+  CopyType copy_type = CopyType::EXPORT_OTHER;
+
  private:
   DISALLOW_COPY_AND_MOVE(CopyPlan);
 };
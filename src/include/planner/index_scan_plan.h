@@ -149,6 +149,8 @@ class IndexScanPlan : public AbstractScan {
 
   inline bool GetDescend() const { return descend_; }
 
+  inline bool GetKeyOrdered() const { return key_ordered_; }
+
   const std::string GetInfo() const { return "IndexScan"; }
 
   void SetLimit(bool limit) { limit_ = limit; }
@@ -159,6 +161,8 @@ class IndexScanPlan : public AbstractScan {
 
   void SetDescend(bool descend) { descend_ = descend; }
 
+  void SetKeyOrdered(bool key_ordered) { key_ordered_ = key_ordered; }
+
   void SetParameterValues(std::vector<type::Value> *values);
 
   std::unique_ptr<AbstractPlan> Copy() const {
@@ -169,8 +173,12 @@ class IndexScanPlan : public AbstractScan {
 
     IndexScanDesc desc(index_, key_column_ids_, expr_types_, values_,
                        new_runtime_keys);
+    // full index scans, such as the ones of a merge join, have no predicate
+    auto predicate_copy =
+        (GetPredicate() == nullptr) ? nullptr : GetPredicate()->Copy();
     IndexScanPlan *new_plan = new IndexScanPlan(
-        GetTable(), GetPredicate()->Copy(), GetColumnIds(), desc, false);
+        GetTable(), predicate_copy, GetColumnIds(), desc, false);
+    new_plan->SetKeyOrdered(key_ordered_);
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
@@ -228,6 +236,10 @@ class IndexScanPlan : public AbstractScan {
   // whether order by is descending
   bool descend_ = false;
 
+  // whether the output has to stay in the order of the index keys, for a
+  // merge join. Only scans of the primary index keep the key order.
+  bool key_ordered_ = false;
+
  private:
   DISALLOW_COPY_AND_MOVE(IndexScanPlan);
 };
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -21,6 +22,7 @@
 #include "type/serializer.h"
 #include "type/types.h"
 #include "expression/abstract_expression.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 
@@ -52,6 +54,10 @@ class SeqScanPlan : public AbstractScan {
 
   void SetParameterValues(std::vector<type::Value> *values);
 
+  // Terms of the predicate that can be checked against the zone maps of the
+  // tile groups. Parameters are left unresolved.
+  const std::vector<storage::ZoneMapPredicate> &GetZoneMapPredicates() const;
+
   //===--------------------------------------------------------------------===//
   // Serialization/Deserialization
   //===--------------------------------------------------------------------===//
@@ -71,6 +77,10 @@ class SeqScanPlan : public AbstractScan {
 
  private:
   DISALLOW_COPY_AND_MOVE(SeqScanPlan);
+
+  mutable std::once_flag zone_map_predicates_flag_;
+
+  mutable std::vector<storage::ZoneMapPredicate> zone_map_predicates_;
 };
 
 }  // namespace planner
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "common/item_pointer.h"
+#include "common/platform.h"
 #include "common/printable.h"
 #include "type/types.h"
 
@@ -46,6 +47,7 @@ namespace storage {
 
 class Tuple;
 class TileGroup;
+class TileGroupLayout;
 
 /**
  * Base class for all tables
@@ -136,6 +138,10 @@ class AbstractTable : public Printable {
 
   column_map_type GetTileGroupLayout(LayoutType layout_type) const;
 
+  // Layout shared by the tile groups of the table with the given column map
+  std::shared_ptr<const TileGroupLayout> GetLayout(
+      const column_map_type &column_map);
+
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
@@ -152,6 +158,11 @@ class AbstractTable : public Printable {
    * where the scheme may live longer.
    */
   bool own_schema_;
+
+  // column map -> layout of tile groups
+  std::map<column_map_type, std::shared_ptr<const TileGroupLayout>> layouts_;
+
+  Spinlock layout_lock_;
 };
 
 }  // End storage namespace
@@ -105,6 +105,13 @@ class DataTable : public AbstractTable {
   // into all the corresponding indexes.
   ItemPointer AcquireVersion();
 
+  // acquire a version slot for a tuple moved into the default tile group
+  // layout. the slot is never a recycled one, and is only taken from an
+  // active tile group of that layout; an active tile group created before
+  // the layout changed is replaced first. returns INVALID_ITEMPOINTER if no
+  // slot could be acquired.
+  ItemPointer AcquireVersionInDefaultLayout();
+
   // install an version in table. designed for update operation.
   // as we implement logical-pointer indexing mechanism, targets_ptr is
   // required.
@@ -121,6 +128,20 @@ class DataTable : public AbstractTable {
   // aggregate_executor.
   ItemPointer InsertTuple(const Tuple *tuple);
 
+  //===--------------------------------------------------------------------===//
+  // BULK LOAD
+  //===--------------------------------------------------------------------===//
+
+  // Load tuples into new tile groups as inserts of the transaction, which
+  // become visible to others when it commits. The tuples stay out of the
+  // read/write set; the transaction stamps the tile groups as a whole. The
+  // index entries are built once the tile groups are filled, and scans see
+  // the tile groups after that. Concurrent loads within one transaction are
+  // allowed. Throws a ConstraintException if a tuple violates a foreign key
+  // or a unique index; the caller must then abort the transaction.
+  void BulkLoadTuples(const std::vector<std::unique_ptr<Tuple>> &tuples,
+                        concurrency::Transaction *transaction);
+
   //===--------------------------------------------------------------------===//
   // TILE GROUP
   //===--------------------------------------------------------------------===//
@@ -143,6 +164,15 @@ class DataTable : public AbstractTable {
   // Get a tile group with given layout
   TileGroup *GetTileGroupWithLayout(const column_map_type &partitioning);
 
+  // Whether new tuples are currently placed into the tile group
+  bool IsActiveTileGroup(const oid_t &tile_group_id) const;
+
+  // Drop the tile group at the given offset once it no longer holds any
+  // version. The offset is kept and marked as dropped, and maps to an empty
+  // tile group, so that the offsets of the other tile groups do not shift
+  // under running scans.
+  void DropTileGroup(const std::size_t &tile_group_offset);
+
   //===--------------------------------------------------------------------===//
   // INDEX
   //===--------------------------------------------------------------------===//
@@ -180,6 +210,20 @@ class DataTable : public AbstractTable {
 
   oid_t GetForeignKeyCount() const;
 
+  //===--------------------------------------------------------------------===//
+  // VERSION STORAGE
+  //===--------------------------------------------------------------------===//
+
+  // switch between full-tuple versions and column deltas for updates.
+  // must be set before the table receives any update.
+  void SetVersionStorageType(const VersionStorageType &version_storage_type) {
+    version_storage_type_ = version_storage_type;
+  }
+
+  VersionStorageType GetVersionStorageType() const {
+    return version_storage_type_;
+  }
+
   //===--------------------------------------------------------------------===//
   // TRANSFORMERS
   //===--------------------------------------------------------------------===//
@@ -217,6 +261,10 @@ class DataTable : public AbstractTable {
 
   column_map_type GetDefaultLayout() const;
 
+  // layout of the tile groups created for inserts. in hybrid layout mode, it
+  // is the default layout tuned by the layout tuner.
+  column_map_type GetDefaultTileGroupLayout() const;
+
   //===--------------------------------------------------------------------===//
   // INDEX TUNER
   //===--------------------------------------------------------------------===//
@@ -237,6 +285,8 @@ class DataTable : public AbstractTable {
   // deprecated, use catalog::TableCatalog::GetInstance()->GetDatabaseOid()
   inline oid_t GetDatabaseOid() const { return (database_oid); }
 
+  inline size_t GetTuplesPerTileGroup() const { return tuples_per_tilegroup_; }
+
   bool HasPrimaryKey() const { return (has_primary_key_); }
 
   bool HasUniqueConstraints() const { return (unique_constraint_count_ > 0); }
@@ -273,12 +323,30 @@ class DataTable : public AbstractTable {
   // Claim a tuple slot in a tile group
   ItemPointer GetEmptyTupleSlot(const storage::Tuple *tuple);
 
+  // prepare or swap in the next tile group of the active_tile_group_id-th
+  // active tile group, once the given slot of it has been claimed
+  void AdvanceActiveTileGroup(const size_t &active_tile_group_id,
+                              TileGroup *tile_group, const oid_t &tuple_slot);
+
   // add a tile group to the table
   oid_t AddDefaultTileGroup();
   // add a tile group to the table. replace the active_tile_group_id-th active
-  // tile group.
+  // tile group, with the standby tile group if one has been prepared.
   oid_t AddDefaultTileGroup(const size_t &active_tile_group_id);
 
+  // create the tile group that will replace the active_tile_group_id-th
+  // active tile group once it fills up
+  void PrepareStandbyTileGroup(const size_t &active_tile_group_id);
+
+  // make the tile group the active_tile_group_id-th active tile group, and
+  // retire the one it replaces
+  void SetActiveTileGroup(const size_t &active_tile_group_id,
+                          const std::shared_ptr<TileGroup> &tile_group);
+
+  // keep a tile group that is no longer active or standby alive until the
+  // current epoch expires, and release the ones retired before
+  void RetireTileGroup(const std::shared_ptr<TileGroup> &tile_group);
+
   oid_t AddDefaultIndirectionArray(const size_t &active_indirection_array_id);
 
   // Drop all tile groups of the table. Used by recovery
@@ -296,6 +364,16 @@ class DataTable : public AbstractTable {
   // check the foreign key constraints
   bool CheckForeignKeyConstraints(const storage::Tuple *tuple);
 
+  // Claim an indirection for the index entries of a new tuple
+  ItemPointer *AllocateIndirection();
+
+  // Insert the entries of bulk loaded tuples into all indexes, one index at
+  // a time. Returns false at the first key that a unique index already holds.
+  bool InsertInIndexesForBulkLoad(
+      const std::vector<std::unique_ptr<Tuple>> &tuples,
+      const std::vector<ItemPointer *> &index_entry_ptrs,
+      concurrency::Transaction *transaction);
+
  public:
   static size_t default_active_tilegroup_count_;
 
@@ -320,10 +398,31 @@ class DataTable : public AbstractTable {
   // TILE GROUPS
   LockFreeArray<oid_t> tile_groups_;
 
+  // the tile groups that inserts claim slots in. inserts read the plain
+  // pointers, while the shared pointers keep the tile groups alive.
   std::vector<std::shared_ptr<storage::TileGroup>> active_tile_groups_;
 
+  std::unique_ptr<std::atomic<storage::TileGroup *>[]> active_tile_group_ptrs_;
+
+  // the tile groups created ahead of time to replace the active ones. they
+  // are owned by the catalog until they become active.
+  std::unique_ptr<std::atomic<storage::TileGroup *>[]>
+      standby_tile_group_ptrs_;
+
+  // guards the shared pointers of the active tile groups and the retired ones
+  std::mutex active_tile_group_mutex_;
+
+  // the tile groups that stopped being active or standby, with the epoch in
+  // which they did. an insert that read the plain pointer of one before then
+  // may still use it, even once the compactor dropped it from the catalog.
+  std::vector<std::pair<eid_t, std::shared_ptr<storage::TileGroup>>>
+      retired_tile_groups_;
+
   std::atomic<size_t> tile_group_count_ = ATOMIC_VAR_INIT(0);
 
+  // stands in for the tile groups at the offsets marked as dropped
+  std::shared_ptr<storage::TileGroup> dropped_tile_group_;
+
   // INDIRECTIONS
   std::vector<std::shared_ptr<storage::IndirectionArray>>
       active_indirection_arrays_;
@@ -353,6 +452,9 @@ class DataTable : public AbstractTable {
   // dirty flag. for detecting whether the tile group has been used.
   bool dirty_ = false;
 
+  // how updates store the new version of a tuple
+  VersionStorageType version_storage_type_ = VersionStorageType::TUPLE;
+
   //===--------------------------------------------------------------------===//
   // TUNING MEMBERS
   //===--------------------------------------------------------------------===//
@@ -363,6 +465,9 @@ class DataTable : public AbstractTable {
   // default partition map for table
   column_map_type default_partition_;
 
+  // the default partition is read by inserters while the tuner sets it
+  mutable std::mutex default_partition_mutex_;
+
   // samples for layout tuning
   std::vector<brain::Sample> layout_samples_;
 
@@ -376,6 +481,9 @@ class DataTable : public AbstractTable {
   std::mutex index_samples_mutex_;
 
   static oid_t invalid_tile_group_id;
+
+  // marks the offsets of the tile groups dropped by the compactor
+  static oid_t dropped_tile_group_id;
 };
 
 }  // End storage namespace
@@ -0,0 +1,243 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// delta_storage.h
+//
+// Identification: src/include/storage/delta_storage.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/item_pointer.h"
+#include "common/macros.h"
+#include "common/platform.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+
+// A writer that finds this many older deltas on a tuple merges the ones that
+// no running transaction can miss into the tuple slot, so that the chains
+// readers walk stay short when the gc is disabled or falls behind
+#define DELTA_CHAIN_MERGE_LENGTH 8
+
+class DataTable;
+class DeltaTuple;
+class TileGroup;
+class TileGroupHeader;
+
+//===--------------------------------------------------------------------===//
+// Delta Record
+//===--------------------------------------------------------------------===//
+
+/**
+ * The after-image of the columns changed by a single update of a tuple that
+ * belongs to a table with VersionStorageType::DELTA.
+ *
+ * The deltas of a tuple form a newest-to-oldest chain that hangs off the
+ * delta pointer of the tuple header. The tuple slot keeps the oldest
+ * version that may still be read, and the garbage collector merges a
+ * committed delta into the slot once no transaction can observe the slot
+ * without it. A writer that finds a long chain merges its expired tail the
+ * same way. A slot is therefore never overwritten under a running reader.
+ */
+class DeltaRecord {
+ public:
+  DeltaRecord(const ItemPointer &location, const txn_id_t &txn_id)
+      : location(location),
+        txn_id(txn_id),
+        commit_id(MAX_CID),
+        epoch_id(MAX_EID),
+        next(nullptr),
+        discarded(false) {}
+
+  // the tuple slot this delta applies to
+  ItemPointer location;
+
+  // the transaction that wrote this delta
+  txn_id_t txn_id;
+
+  // MAX_CID until the writer commits
+  std::atomic<cid_t> commit_id;
+
+  // the delta can be merged into the tuple slot once this epoch expires
+  eid_t epoch_id;
+
+  // changed columns and their new values
+  std::vector<oid_t> column_ids;
+
+  std::vector<type::Value> values;
+
+  // the next (older) delta of the same tuple
+  std::atomic<DeltaRecord *> next;
+
+  // set when the delta leaves its chain before the gc merges it, because
+  // the tuple slot is recycled or a writer merged it
+  std::atomic<bool> discarded;
+};
+
+//===--------------------------------------------------------------------===//
+// Delta Storage
+//===--------------------------------------------------------------------===//
+
+/**
+ * Keeps the delta records of all delta-stored tables.
+ *
+ * Committed and retired records are buffered per worker thread so that
+ * committing transactions do not contend with each other. Modifications of a
+ * delta chain are serialized by a striped latch keyed on the tuple location;
+ * readers traverse chains without latching.
+ */
+class DeltaStorage {
+ public:
+  DeltaStorage(const DeltaStorage &) = delete;
+  DeltaStorage &operator=(const DeltaStorage &) = delete;
+
+  DeltaStorage() {}
+
+  ~DeltaStorage();
+
+  static DeltaStorage &GetInstance();
+
+  //===--------------------------------------------------------------------===//
+  // Writers
+  //===--------------------------------------------------------------------===//
+
+  // check that no committed delta is hidden from the transaction, i.e. the
+  // transaction is about to modify the latest version of the tuple.
+  bool IsLatestVisible(const concurrency::Transaction *current_txn,
+                       const TileGroupHeader *tile_group_header,
+                       const oid_t &tuple_id) const;
+
+  // publish the new values of an update as the newest delta of the tuple.
+  // the transaction must own the tuple. a repeated update of the same tuple
+  // by the same transaction is folded into its pending delta.
+  void InstallDelta(concurrency::Transaction *current_txn,
+                    TileGroupHeader *tile_group_header,
+                    const ItemPointer &location,
+                    const std::vector<oid_t> &column_ids,
+                    const std::vector<type::Value> &values);
+
+  // make the pending delta of the transaction visible at its commit id.
+  // returns false if the transaction has no pending delta on the tuple.
+  bool CommitDelta(concurrency::Transaction *current_txn,
+                   TileGroupHeader *tile_group_header, const oid_t &tuple_id);
+
+  // drop the pending delta of the transaction.
+  // returns false if the transaction has no pending delta on the tuple.
+  bool AbortDelta(concurrency::Transaction *current_txn,
+                  TileGroupHeader *tile_group_header, const oid_t &tuple_id);
+
+  // whether the newest delta of the tuple is pending for the transaction.
+  static bool HasPendingDelta(const TileGroupHeader *tile_group_header,
+                              const oid_t &tuple_id, const txn_id_t &txn_id);
+
+  //===--------------------------------------------------------------------===//
+  // Readers
+  //===--------------------------------------------------------------------===//
+
+  // lay the deltas that the transaction must see over the tuple slot.
+  // returns false if the tuple slot can be read in place.
+  bool GetVisibleDelta(const concurrency::Transaction *current_txn,
+                       const TileGroupHeader *tile_group_header,
+                       const oid_t &tuple_id, DeltaTuple *tuple,
+                       const VisibilityIdType type =
+                           VisibilityIdType::READ_ID) const;
+
+  // create a tile group, private to a scan, into which versions with visible
+  // deltas are copied. it is registered in the catalog so that downstream
+  // executors can locate it, and must be released by the creator.
+  static std::shared_ptr<TileGroup> CreateVersionTileGroup(
+      DataTable *table, const size_t &tuple_count);
+
+  static void ReleaseVersionTileGroup(const oid_t &tile_group_id);
+
+  // copy the version into the next free slot of a version tile group.
+  // returns the position of the copy.
+  static oid_t MaterializeVersion(const DeltaTuple &tuple,
+                                  TileGroup *version_tile_group);
+
+  // whether the slot holds a copy made by MaterializeVersion().
+  static bool IsMaterializedVersion(const TileGroupHeader *tile_group_header,
+                                    const oid_t &tuple_id);
+
+  // the tuple a materialized version was copied from.
+  static ItemPointer GetOrigin(const TileGroupHeader *tile_group_header,
+                               const oid_t &tuple_id);
+
+  //===--------------------------------------------------------------------===//
+  // Garbage collection
+  //===--------------------------------------------------------------------===//
+
+  // merge committed deltas that no running transaction can miss into their
+  // tuple slots and free the records retired before the expired epoch.
+  // at most max_count deltas are merged, an equal share from each partition.
+  // is_truncated is set if expired deltas were left for a later merge.
+  // returns the number of merged deltas.
+  size_t Merge(const eid_t &expired_eid, const size_t &max_count = SIZE_MAX,
+               bool *is_truncated = nullptr);
+
+  // detach all deltas of a tuple slot that is about to be recycled.
+  void DiscardDeltas(TileGroupHeader *tile_group_header,
+                     const oid_t &tuple_id);
+
+  // number of committed deltas waiting to be merged.
+  size_t GetPendingDeltaCount();
+
+  // free all buffered records. only safe when no transaction is running.
+  void Clear();
+
+ private:
+  enum class MergeResult { MERGED, DISCARDED, BLOCKED };
+
+  MergeResult MergeDelta(DeltaRecord *delta);
+
+  // merge the expired tail of the chain of a tuple into the tuple slot.
+  // the caller holds the chain lock. returns the number of merged deltas.
+  size_t MergeChain(TileGroupHeader *tile_group_header,
+                    const ItemPointer &location);
+
+  void Retire(DeltaRecord *delta, const size_t &partition_id);
+
+  size_t FreeRetired(const eid_t &expired_eid);
+
+  inline Spinlock &GetChainLock(const ItemPointer &location) {
+    return chain_locks_[(location.block * 31 + location.offset) %
+                        chain_lock_count];
+  }
+
+  static const size_t partition_count = 32;
+
+  static const size_t chain_lock_count = 1024;
+
+  struct Partition {
+    Spinlock lock;
+
+    // committed deltas waiting to be merged
+    std::vector<DeltaRecord *> committed;
+
+    // unlinked deltas waiting for readers to drain
+    std::vector<std::pair<eid_t, DeltaRecord *>> retired;
+  };
+
+  Partition partitions_[partition_count];
+
+  Spinlock chain_locks_[chain_lock_count];
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// delta_tuple.h
+//
+// Identification: src/include/storage/delta_tuple.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sstream>
+#include <vector>
+
+#include "common/abstract_tuple.h"
+#include "common/container_tuple.h"
+#include "storage/tile_group.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// DeltaTuple class
+//===--------------------------------------------------------------------===//
+
+/**
+ * A 'DeltaTuple' is a view of a tuple slot with a set of column values laid
+ * over it. It is used to look at a tuple of a delta-stored table as of a
+ * given transaction without copying the unchanged columns.
+ */
+class DeltaTuple : public AbstractTuple {
+ public:
+  inline DeltaTuple(TileGroup *tile_group, oid_t tuple_id)
+      : base_(tile_group, tuple_id) {}
+
+  inline type::Value GetValue(oid_t column_id) const {
+    for (size_t i = 0; i < column_ids_.size(); ++i) {
+      if (column_ids_[i] == column_id) {
+        return values_[i];
+      }
+    }
+    return base_.GetValue(column_id);
+  }
+
+  // overwrite the value of the column, whether or not it is laid over.
+  inline void SetValue(oid_t column_id, const type::Value &value) {
+    for (size_t i = 0; i < column_ids_.size(); ++i) {
+      if (column_ids_[i] == column_id) {
+        values_[i] = value.Copy();
+        return;
+      }
+    }
+    column_ids_.push_back(column_id);
+    values_.push_back(value.Copy());
+  }
+
+  // lay the value over the column only if no newer value has been laid yet.
+  // delta chains are traversed from newest to oldest.
+  inline void AddDeltaValue(oid_t column_id, const type::Value &value) {
+    for (auto existing_column_id : column_ids_) {
+      if (existing_column_id == column_id) {
+        return;
+      }
+    }
+    column_ids_.push_back(column_id);
+    values_.push_back(value.Copy());
+  }
+
+  inline bool HasDelta() const { return (column_ids_.empty() == false); }
+
+  inline const std::vector<oid_t> &GetDeltaColumnIds() const {
+    return column_ids_;
+  }
+
+  inline TileGroup *GetTileGroup() const { return base_.GetContainer(); }
+
+  inline oid_t GetTupleId() const { return base_.GetTupleId(); }
+
+  inline char *GetData() const { return (base_.GetData()); }
+
+  const std::string GetInfo() const {
+    std::stringstream os;
+    os << "***DeltaTuple*** ";
+    for (size_t i = 0; i < column_ids_.size(); ++i) {
+      os << "(" << column_ids_[i] << ": " << values_[i].ToString() << ") ";
+    }
+    return os.str();
+  }
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // Data members
+  //===--------------------------------------------------------------------===//
+
+  // The tuple slot that is looked through
+  expression::ContainerTuple<TileGroup> base_;
+
+  // Columns laid over the tuple slot and their values
+  std::vector<oid_t> column_ids_;
+
+  std::vector<type::Value> values_;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
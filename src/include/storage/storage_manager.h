@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "common/platform.h"
 #include "type/types.h"
@@ -31,11 +34,37 @@ namespace storage {
 
 #define TMP_DIR "/tmp/"
 
+//===--------------------------------------------------------------------===//
+// Memory backends
+//===--------------------------------------------------------------------===//
+
+// size of a huge page, and of the slabs that tile memory is carved from
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// smaller allocations are served by the heap
+#define MIN_SLAB_ALLOCATION_SIZE (16 * 1024)
+
+// numa nodes beyond this count share slabs
+#define MAX_NUMA_NODE_COUNT 8
+
 //===--------------------------------------------------------------------===//
 // Storage Manager
 //===--------------------------------------------------------------------===//
 
 /// Stores data on different backends
+///
+/// In memory, large allocations (e.g. tiles and tile group headers) are carved
+/// from 2MB slabs that are backed by huge pages when the OS provides them, to
+/// cut the TLB misses of scans. Every NUMA node has its own slab, so that the
+/// memory of a tile group is first touched, and hence placed, on the node of
+/// the worker that creates it. A released range goes on a free list of its
+/// node and is reused by the next allocation of the same size, a slab is
+/// unmapped once all of its ranges are released, and the current slab is
+/// rewound.
+///
+/// SSD and HDD allocations are kept in memory as well. Recovery rebuilds the
+/// tables from the log and checkpoints, so a data file would never be mapped
+/// back after a restart.
 class StorageManager {
  public:
   // global singleton
@@ -54,27 +83,60 @@ class StorageManager {
 
   size_t GetClflushCount() const { return clflush_count; }
 
-  size_t GetAllocationCount() const { return allocation_count; }
+  size_t GetAllocationCount() const { return allocation_count.load(); }
+
+  // number of huge page slabs in use
+  size_t GetSlabCount() const { return slab_count.load(); }
+
+  // bytes mapped for slabs and for allocations larger than a slab
+  size_t GetMappedSize() const { return mapped_size.load(); }
 
  private:
-  // data file address
-  void *data_file_address;
+  struct Slab;
+
+  void *AllocateMemory(size_t size);
+
+  void ReleaseMemory(void *address);
 
-  // data file lock
-  Spinlock data_file_spinlock;
+  // map a 2MB-aligned region, backed by huge pages if possible
+  void *MapHugePages(size_t size);
 
-  // data file len
-  size_t data_file_len;
+  void UnmapHugePages(void *address, size_t size);
 
-  // data offset
-  size_t data_file_offset;
+  // drop a reference to the slab, and unmap it once it is unreferenced.
+  // the caller holds the lock of the arena of the slab.
+  void ReleaseSlab(Slab *slab);
+
+  // take the released ranges of the slab off the free list of its arena
+  void RemoveFreeRanges(Slab *slab);
+
+  static size_t GetCurrentNumaNode();
+
+  // the slab that allocations of a numa node are carved from, and the ranges
+  // released on the slabs of the node, by size
+  struct NumaNodeArena {
+    Spinlock lock;
+
+    Slab *slab = nullptr;
+
+    std::unordered_map<size_t, std::vector<char *>> free_ranges;
+  };
+
+  NumaNodeArena numa_node_arenas[MAX_NUMA_NODE_COUNT];
+
+  // whether explicit huge pages could be mapped so far
+  std::atomic<bool> huge_page_available;
 
   // stats
   size_t msync_count = 0;
 
   size_t clflush_count = 0;
 
-  size_t allocation_count = 0;
+  std::atomic<size_t> allocation_count;
+
+  std::atomic<size_t> slab_count;
+
+  std::atomic<size_t> mapped_size;
 };
 
 }  // End storage namespace
@@ -172,6 +172,14 @@ class Tile : public Printable {
 
   type::AbstractPool *GetPool() { return (pool); }
 
+  // Install another pool for the uninlined data, and return the old one.
+  // The caller must have moved the uninlined values to the new pool.
+  type::AbstractPool *ReplacePool(type::AbstractPool *new_pool) {
+    auto old_pool = pool;
+    pool = new_pool;
+    return old_pool;
+  }
+
   char *GetTupleLocation(const oid_t tuple_offset) const;
 
   // Sync the contents
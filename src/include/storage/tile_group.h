@@ -21,6 +21,7 @@
 #include "common/item_pointer.h"
 #include "common/printable.h"
 #include "planner/project_info.h"
+#include "storage/tile_group_layout.h"
 #include "type/abstract_pool.h"
 #include "type/types.h"
 #include "type/value.h"
@@ -52,8 +53,7 @@ class TileGroupHeader;
 class AbstractTable;
 class TileGroupIterator;
 class RollbackSegment;
-
-typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
+class ZoneMap;
 
 /**
  * Represents a group of tiles logically horizontally contiguous.
@@ -76,7 +76,8 @@ class TileGroup : public Printable {
   // Tile group constructor
   TileGroup(BackendType backend_type, TileGroupHeader *tile_group_header,
             AbstractTable *table, const std::vector<catalog::Schema> &schemas,
-            const column_map_type &column_map, int tuple_count);
+            const std::shared_ptr<const TileGroupLayout> &layout,
+            int tuple_count);
 
   ~TileGroup();
 
@@ -143,8 +144,12 @@ class TileGroup : public Printable {
 
   peloton::type::AbstractPool *GetTilePool(const oid_t tile_id) const;
 
-  const std::map<oid_t, std::pair<oid_t, oid_t>> &GetColumnMap() const {
-    return column_map;
+  const column_map_type &GetColumnMap() const {
+    return layout->GetColumnMap();
+  }
+
+  const std::shared_ptr<const TileGroupLayout> &GetLayout() const {
+    return layout;
   }
 
   oid_t GetTileGroupId() const { return tile_group_id; }
@@ -165,11 +170,8 @@ class TileGroup : public Printable {
   // the specified tile group column id.
   inline void LocateTileAndColumn(oid_t column_offset, oid_t &tile_offset,
                                   oid_t &tile_column_offset) const {
-    PL_ASSERT(column_map.count(column_offset) != 0);
-    // get the entry in the column map
-    auto entry = column_map.at(column_offset);
-    tile_offset = entry.first;
-    tile_column_offset = entry.second;
+    layout->LocateTileAndColumn(column_offset, tile_offset,
+                                tile_column_offset);
   }
 
   oid_t GetTileIdFromColumnId(oid_t column_id);
@@ -185,6 +187,9 @@ class TileGroup : public Printable {
   // Sync the contents
   void Sync();
 
+  // Min/max synopses of the columns, used to skip the tile group in scans
+  ZoneMap *GetZoneMap() const { return zone_map.get(); }
+
  protected:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -218,9 +223,10 @@ class TileGroup : public Printable {
 
   std::mutex tile_group_mutex;
 
-  // column to tile mapping :
-  // <column offset> to <tile offset, tile column offset>
-  column_map_type column_map;
+  // column to tile mapping, shared with the tile groups of the same layout
+  std::shared_ptr<const TileGroupLayout> layout;
+
+  std::unique_ptr<ZoneMap> zone_map;
 };
 
 }  // End storage namespace
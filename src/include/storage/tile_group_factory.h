@@ -34,6 +34,12 @@ class TileGroupFactory {
                                  const std::vector<catalog::Schema> &schemas,
                                  const column_map_type &column_map,
                                  int tuple_count);
+
+  // Tile group sharing the given layout
+  static TileGroup *GetTileGroup(
+      oid_t database_id, oid_t table_id, oid_t tile_group_id,
+      AbstractTable *table, const std::vector<catalog::Schema> &schemas,
+      const std::shared_ptr<const TileGroupLayout> &layout, int tuple_count);
 };
 
 }  // End storage namespace
@@ -28,6 +28,7 @@ namespace peloton {
 namespace storage {
 
 class TileGroup;
+class DeltaRecord;
 
 //===--------------------------------------------------------------------===//
 // Tile Group Header
@@ -59,6 +60,11 @@ class TileGroup;
  * of the version chain header.
  *  ReservedField: unused space for future usage.
  *
+ *  The newest pending delta record of each tuple whose table stores its
+ * versions as deltas (see VersionStorageType::DELTA) is kept in a separate
+ * array, which is allocated by the first delta installed in the tile group.
+ * Tile groups of other tables never pay for it.
+ *
  *  STATUS:
  *  ===================
  *  TxnID == INITIAL_TXN_ID, BeginTS == MAX_CID, EndTS == MAX_CID --> empty version
@@ -139,6 +145,34 @@ class TileGroupHeader : public Printable {
 
   oid_t GetActiveTupleCount() const;
 
+  // the slots of a compacting tile group are being emptied by the
+  // compactor and must not be reused.
+  inline void SetCompacting(const bool is_compacting) {
+    compacting.store(is_compacting);
+  }
+
+  inline bool IsCompacting() const { return compacting.load(); }
+
+  // every tuple slot of a frozen tile group holds a committed version that is
+  // visible to all transactions. the first write to the tile group, i.e. the
+  // first ownership acquired on one of its versions, unfreezes it.
+  enum FreezeState { NOT_FROZEN = 0, FREEZING = 1, FROZEN = 2 };
+
+  // the tile group is frozen by FinishFreezing(), unless it is unfrozen by a
+  // writer in between.
+  inline void StartFreezing() { freeze_state.store(FREEZING); }
+
+  inline bool FinishFreezing() {
+    int expected_state = FREEZING;
+    return freeze_state.compare_exchange_strong(expected_state, FROZEN);
+  }
+
+  inline void Unfreeze() { freeze_state.store(NOT_FROZEN); }
+
+  inline bool IsFrozen() const { return freeze_state.load() == FROZEN; }
+
+  inline bool IsUnfrozen() const { return freeze_state.load() == NOT_FROZEN; }
+
   //===--------------------------------------------------------------------===//
   // MVCC utilities
   //===--------------------------------------------------------------------===//
@@ -176,6 +210,14 @@ class TileGroupHeader : public Printable {
     return *(ItemPointer **)(TUPLE_HEADER_LOCATION + indirection_offset);
   }
 
+  inline DeltaRecord *GetDeltaPointer(const oid_t &tuple_slot_id) const {
+    DeltaRecord **delta_pointers = delta_pointer_array.load();
+    if (delta_pointers == nullptr) {
+      return nullptr;
+    }
+    return __atomic_load_n(delta_pointers + tuple_slot_id, __ATOMIC_ACQUIRE);
+  }
+
   // constraint: at most 16 bytes.
   inline char *GetReservedFieldRef(const oid_t &tuple_slot_id) const {
     return (char *)(TUPLE_HEADER_LOCATION + reserved_field_offset);
@@ -217,6 +259,20 @@ class TileGroupHeader : public Printable {
         indirection;
   }
 
+  // readers traverse the delta chain without latching, so the head must be
+  // published only after the delta record is fully built.
+  inline void SetDeltaPointer(const oid_t &tuple_slot_id,
+                              DeltaRecord *delta) {
+    DeltaRecord **delta_pointers = delta_pointer_array.load();
+    if (delta_pointers == nullptr) {
+      if (delta == nullptr) {
+        return;
+      }
+      delta_pointers = AllocateDeltaPointers();
+    }
+    __atomic_store_n(delta_pointers + tuple_slot_id, delta, __ATOMIC_RELEASE);
+  }
+
   inline txn_id_t SetAtomicTransactionId(const oid_t &tuple_slot_id,
                                          const txn_id_t &old_txn_id,
                                          const txn_id_t &new_txn_id) const {
@@ -265,6 +321,10 @@ class TileGroupHeader : public Printable {
       indirection_offset + sizeof(ItemPointer);
 
  private:
+  // allocate the delta pointers of the tuple slots, unless another writer
+  // allocated them first
+  DeltaRecord **AllocateDeltaPointers();
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -289,6 +349,16 @@ class TileGroupHeader : public Printable {
   std::atomic<oid_t> next_tuple_slot;
 
   Spinlock tile_header_lock;
+
+  // whether the tile group is being compacted
+  std::atomic<bool> compacting;
+
+  // freeze state of the tile group
+  std::atomic<int> freeze_state;
+
+  // newest pending delta record of each tuple slot, or nullptr until the
+  // first delta is installed
+  std::atomic<DeltaRecord **> delta_pointer_array;
 };
 
 }  // End storage namespace
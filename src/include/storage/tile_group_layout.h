@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_layout.h
+//
+// Identification: src/include/storage/tile_group_layout.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "common/macros.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace storage {
+
+typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
+
+//===--------------------------------------------------------------------===//
+// Tile Group Layout
+//===--------------------------------------------------------------------===//
+
+/**
+ * Immutable mapping of the columns of a tile group to its tiles.
+ *
+ * Besides the column map, the layout keeps the tile and tile column of each
+ * column in a flat array indexed by the column offset, so locating a value
+ * does not walk the map. Tile groups of a table with the same column map share
+ * a single layout (see AbstractTable::GetLayout).
+ */
+class TileGroupLayout {
+ public:
+  TileGroupLayout(const TileGroupLayout &) = delete;
+  TileGroupLayout &operator=(const TileGroupLayout &) = delete;
+
+  TileGroupLayout(const column_map_type &column_map);
+
+  // column to tile mapping :
+  // <column offset> to <tile offset, tile column offset>
+  const column_map_type &GetColumnMap() const { return column_map_; }
+
+  oid_t GetColumnCount() const { return column_map_.size(); }
+
+  // Sets the tile id and column id w.r.t that tile corresponding to
+  // the specified tile group column id.
+  inline void LocateTileAndColumn(oid_t column_offset, oid_t &tile_offset,
+                                  oid_t &tile_column_offset) const {
+    PL_ASSERT(column_offset < column_locations_.size());
+    auto &location = column_locations_[column_offset];
+    PL_ASSERT(location.tile_offset != INVALID_OID);
+    tile_offset = location.tile_offset;
+    tile_column_offset = location.tile_column_offset;
+  }
+
+ private:
+  struct ColumnLocation {
+    oid_t tile_offset;
+    oid_t tile_column_offset;
+  };
+
+  const column_map_type column_map_;
+
+  // column offset -> location, INVALID_OID for offsets missing from the map
+  std::vector<ColumnLocation> column_locations_;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,187 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.h
+//
+// Identification: src/include/storage/zone_map.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/platform.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace storage {
+
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Zone Map
+//===--------------------------------------------------------------------===//
+
+// A term of a scan predicate of the form <column> <comparison> <value>, or
+// <column> IS NULL, that can be checked against a zone map
+struct ZoneMapPredicate {
+  oid_t column_id;
+
+  ExpressionType comparison_type;
+
+  type::Value value;
+};
+
+/**
+ * Min/max and null count synopses of the columns of a tile group.
+ *
+ * The synopses are widened whenever a value is written into a tuple slot, so
+ * they cover every version that a transaction may see, and never shrink while
+ * the tile group is mutable. The bounds of fixed width columns are kept as
+ * ordered words that writers widen atomically, without the lock of the zone
+ * map. The bounds of varlen columns are widened under the lock with owned
+ * copies of the written values, and are never recomputed from the tuple
+ * slots, whose varlen values the GC frees once the slots are reclaimed.
+ * Writers that bypass the tile group (e.g. a layout transformation) merge
+ * the zone map of the source tile group instead.
+ */
+class ZoneMap {
+ public:
+  ZoneMap(const ZoneMap &) = delete;
+  ZoneMap &operator=(const ZoneMap &) = delete;
+
+  ZoneMap(TileGroup *tile_group);
+
+  // Widen the synopsis of a column to cover a value written into it
+  void UpdateValue(const oid_t &column_id, const type::Value &value);
+
+  // Widen the synopses to cover a tuple written into a slot
+  void UpdateTuple(const AbstractTuple *tuple);
+
+  // The synopses of the fixed width columns no longer cover all values,
+  // rebuild them before next use
+  void Invalidate() { is_invalid_ = true; }
+
+  // Widen the synopses to cover those of another zone map over the same
+  // columns
+  void Merge(ZoneMap *other);
+
+  // Whether some tuple of the tile group may satisfy all the predicates
+  bool MayMatch(const std::vector<ZoneMapPredicate> &predicates);
+
+  // Collect the terms of a conjunctive predicate that zone maps can check.
+  // Parameters are resolved with the given values, if any.
+  static void GetPredicates(const expression::AbstractExpression *predicate,
+                            const std::vector<type::Value> *params,
+                            std::vector<ZoneMapPredicate> &predicates);
+
+  //===--------------------------------------------------------------------===//
+  // Accessors
+  //===--------------------------------------------------------------------===//
+
+  // Whether the column has a non-null value
+  bool HasValues(const oid_t &column_id);
+
+  type::Value GetMinValue(const oid_t &column_id);
+
+  type::Value GetMaxValue(const oid_t &column_id);
+
+  size_t GetNullCount(const oid_t &column_id);
+
+ private:
+  struct ColumnSynopsis {
+    type::Type::TypeId type_id = type::Type::INVALID;
+
+    // whether the type of the column is ordered
+    bool is_tracked = false;
+
+    bool is_varlen = false;
+
+    // ordered words of the bounds of a fixed width column, min above max
+    // while the column has no values
+    std::atomic<int64_t> min_word;
+
+    std::atomic<int64_t> max_word;
+
+    // bounds of a varlen column, widened under the lock
+    bool has_values = false;
+
+    // whether a varlen value could not be compared with the bounds, under the
+    // lock
+    bool is_unbounded = false;
+
+    type::Value min_value;
+
+    type::Value max_value;
+
+    std::atomic<size_t> null_count;
+  };
+
+  // Widen a synopsis to cover a value
+  void Widen(ColumnSynopsis &synopsis, const type::Value &value);
+
+  // Widen the bounds of a varlen column to cover a value, under the lock
+  void WidenVarlenBounds(ColumnSynopsis &synopsis, const type::Value &value);
+
+  // Copy of a varlen value that owns its bytes
+  static type::Value GetOwnedValue(const type::Value &value);
+
+  // Recompute the synopses of the fixed width columns from the tuple slots,
+  // under the lock
+  void Rebuild();
+
+  // Bring the synopses up to date, under the lock
+  void RebuildIfStale();
+
+  bool HasValues(const ColumnSynopsis &synopsis) const;
+
+  type::Value GetMinValue(const ColumnSynopsis &synopsis) const;
+
+  type::Value GetMaxValue(const ColumnSynopsis &synopsis) const;
+
+  bool MayMatch(const ColumnSynopsis &synopsis,
+                const ZoneMapPredicate &predicate) const;
+
+  static bool IsTracked(const type::Type::TypeId &type_id);
+
+  // Word of a non-null fixed width value, ordered like the values
+  static int64_t GetOrderedWord(const type::Type::TypeId &type_id,
+                                const type::Value &value);
+
+  // Value of a fixed width type with the ordered word
+  static type::Value GetOrderedValue(const type::Type::TypeId &type_id,
+                                     const int64_t &word);
+
+  // Whether a predicate value can be compared with the values of a column
+  static bool IsComparable(const type::Type::TypeId &column_type_id,
+                           const type::Type::TypeId &value_type_id);
+
+  TileGroup *tile_group_;
+
+  const oid_t column_count_;
+
+  std::unique_ptr<ColumnSynopsis[]> synopses_;
+
+  bool has_tracked_columns_;
+
+  std::atomic<bool> is_invalid_;
+
+  Spinlock zone_map_lock_;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena_pool.h
+//
+// Identification: src/include/type/arena_pool.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "common/platform.h"
+#include "type/abstract_pool.h"
+
+namespace peloton {
+namespace type {
+
+// size of the chunks that the arena carves allocations from
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+// A memory pool that bump-allocates varlen values out of large chunks.
+//
+// Allocating is a single atomic add on the current chunk, and only taking a
+// new chunk is done under the lock. Each value is prefixed with its size and
+// its number of owners, so the pool knows how many bytes of a chunk have been
+// freed. The chunks are aligned to their size and end with a pointer to their
+// bookkeeping, so freeing a value finds its chunk without the lock, which is
+// only taken once the last value of a chunk is freed. A chunk whose
+// values have all been freed is reused for new values. Values are only freed
+// by the GC once no transaction can read them anymore, so a chunk is reused
+// once its epoch is safe. The memory of all chunks is returned when the pool
+// is destroyed, i.e. when the tile owning it is dropped or compacted away.
+class ArenaPool : public AbstractPool {
+ public:
+  ArenaPool(const size_t &chunk_size = ARENA_CHUNK_SIZE);
+
+  // Destroy this pool, and all memory it owns.
+  ~ArenaPool();
+
+  // Allocate a contiguous block of memory of the given size. If the allocation
+  // is successful a non-null pointer is returned. If the allocation fails, a
+  // null pointer will be returned.
+  void *Allocate(size_t size);
+
+  // Returns the provided chunk of memory back into the pool
+  void Free(void *ptr);
+
+  // Let one more owner share the value at the given location. A shared value
+  // is only returned to the pool once each of its owners has freed it.
+  void AddReference(void *ptr);
+
+  // Number of chunks taken so far
+  size_t GetChunkCount() const;
+
+  // Number of chunks whose values have all been freed
+  size_t GetFreeChunkCount() const;
+
+  // Bytes allocated by the pool so far
+  size_t GetAllocatedSize() const { return allocated_size_.load(); }
+
+ private:
+  struct Chunk {
+    Chunk(char *data)
+        : data(data), offset(0), used_size(0), freed_size(0), is_free(false) {}
+
+    ~Chunk() { std::free(data); }
+
+    // aligned to the chunk alignment of the pool, followed by a pointer to
+    // this chunk
+    char *data;
+
+    // offset of the next allocation, may grow past the end of the chunk
+    std::atomic<size_t> offset;
+
+    // bytes ever handed out from and given back to the chunk. Both only
+    // grow, so they match exactly when all of its values have been freed.
+    std::atomic<size_t> used_size;
+    std::atomic<size_t> freed_size;
+
+    // whether the chunk waits in the free list
+    bool is_free;
+  };
+
+  // Take a new chunk, unless another thread already replaced the full one.
+  // Free chunks are reused before new ones are allocated.
+  void AddChunk(Chunk *full_chunk);
+
+  // Move the chunk to the free list if all of its values have been freed.
+  // The pool lock must be held.
+  void RecycleChunk(Chunk *chunk);
+
+  // The chunk holding a small value
+  Chunk *GetChunk(const char *location) const;
+
+  const size_t chunk_size_;
+
+  // smallest power of two that is at least the chunk size
+  size_t chunk_alignment_;
+
+  // Chunk that allocations are currently carved from
+  std::atomic<Chunk *> current_chunk_;
+
+  // All chunks of the pool
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+
+  // Chunks whose values have all been freed
+  std::vector<Chunk *> free_chunks_;
+
+  // Allocations too large for a chunk
+  std::unordered_set<char *> large_locations_;
+
+  std::atomic<size_t> allocated_size_;
+
+  // Spin lock protecting the chunk and location lists
+  mutable Spinlock pool_lock_;
+};
+
+}  // namespace type
+}  // namespace peloton
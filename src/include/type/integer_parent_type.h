@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <limits>
+
 #include "type/numeric_type.h"
 #include "common/exception.h"
 #include "type/value_factory.h"
@@ -171,6 +173,12 @@ Value IntegerParentType::DivideValue(const Value& left, const Value &right) cons
     throw Exception(EXCEPTION_TYPE_DIVIDE_BY_ZERO,
                     "Division by zero.");
   }
+  // The smallest value divided by -1 does not fit
+  if (sizeof(x) >= sizeof(y) && y == -1 &&
+      x == std::numeric_limits<T1>::min()) {
+    throw Exception(EXCEPTION_TYPE_OUT_OF_RANGE,
+                    "Numeric value out of range.");
+  }
   T1 quot1 = (T1)(x / y);
   T2 quot2 = (T2)(x / y);
   if (sizeof(x) >= sizeof(y)) {
@@ -187,6 +195,10 @@ Value IntegerParentType::ModuloValue(const Value& left, const Value &right) cons
     throw Exception(EXCEPTION_TYPE_DIVIDE_BY_ZERO,
                     "Division by zero.");
   }
+  // x % -1 is 0, but overflows for the smallest value
+  if (y == -1) {
+    y = 1;
+  }
   T1 quot1 = (T1)(x % y);
   T2 quot2 = (T2)(x % y);
   if (sizeof(x) >= sizeof(y)) {
@@ -470,13 +470,27 @@ std::ostream &operator<<(std::ostream &os, const ConflictAvoidanceType &type);
 
 enum class GarbageCollectionType {
   INVALID = INVALID_TYPE_ID,
-  OFF = 1,  // turn off GC
-  ON = 2    // turn on GC
+  OFF = 1,         // turn off GC
+  ON = 2,          // turn on GC
+  COOPERATIVE = 3  // worker threads collect their own garbage
 };
 std::string GarbageCollectionTypeToString(GarbageCollectionType type);
 GarbageCollectionType StringToGarbageCollectionType(const std::string &str);
 std::ostream &operator<<(std::ostream &os, const GarbageCollectionType &type);
 
+//===--------------------------------------------------------------------===//
+// Version Storage Types
+//===--------------------------------------------------------------------===//
+
+enum class VersionStorageType {
+  INVALID = INVALID_TYPE_ID,
+  TUPLE = 1,  // every update copies the whole tuple into a new slot
+  DELTA = 2   // updates only record the changed columns as deltas
+};
+std::string VersionStorageTypeToString(VersionStorageType type);
+VersionStorageType StringToVersionStorageType(const std::string &str);
+std::ostream &operator<<(std::ostream &os, const VersionStorageType &type);
+
 //===--------------------------------------------------------------------===//
 // Backend Types
 //===--------------------------------------------------------------------===//
@@ -681,7 +695,8 @@ enum class JoinType {
   RIGHT = 2,                  // right
   INNER = 3,                  // inner
   OUTER = 4,                  // outer
-  SEMI = 5                    // IN+Subquery is SEMI
+  SEMI = 5,                   // IN+Subquery is SEMI
+  ANTI = 6                    // NOT EXISTS+Subquery is ANTI
 };
 std::string JoinTypeToString(JoinType type);
 JoinType StringToJoinType(const std::string &str);
@@ -749,6 +764,7 @@ enum class CopyType {
   IMPORT_CSV,     // Import csv data to database
   IMPORT_TSV,     // Import tsv data to database
   EXPORT_CSV,     // Export data to csv file
+  EXPORT_BINARY,  // Export data to columnar binary file
   EXPORT_STDOUT,  // Export data to std out
   EXPORT_OTHER,   // Export data to other file format
 };
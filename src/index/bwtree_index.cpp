@@ -256,6 +256,47 @@ void BWTREE_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
   return;
 }
 
+/*
+ * class BWTreeScanCursor - Resumes a full scan from the iterator, which keeps
+ *                          a snapshot of the current leaf between batches
+ */
+template <typename MapType>
+class BWTreeScanCursor : public IndexScanCursor {
+ public:
+  BWTreeScanCursor(MapType &container, IndexMetadata *metadata)
+      : scan_itr_(container.Begin()), metadata_(metadata) {}
+
+  bool Next(size_t max_count, std::vector<ItemPointer *> &result) {
+    size_t count = 0;
+    for (; (count < max_count) && (scan_itr_.IsEnd() == false);
+         count++, scan_itr_++) {
+      result.push_back(scan_itr_->second);
+    }
+
+    if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+      stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+          count, metadata_);
+    }
+
+    return scan_itr_.IsEnd() == false;
+  }
+
+ private:
+  typename MapType::ForwardIterator scan_itr_;
+
+  IndexMetadata *metadata_;
+};
+
+/*
+ * ScanAllKeysInBatches() - Scan the leaves one batch at a time, instead of
+ *                          collecting all entries up front
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+std::unique_ptr<IndexScanCursor> BWTREE_INDEX_TYPE::ScanAllKeysInBatches() {
+  return std::unique_ptr<IndexScanCursor>(
+      new BWTreeScanCursor<MapType>(container, metadata));
+}
+
 BWTREE_TEMPLATE_ARGUMENTS
 void BWTREE_INDEX_TYPE::ScanKey(const storage::Tuple *key,
                                 std::vector<ValueType> &result) {
@@ -205,6 +205,27 @@ void Index::ScanTest(const std::vector<type::Value> &value_list,
   return;
 }
 
+/*
+ * ScanAllKeysInBatches() - Run a full scan, and hand out its entries in batches
+ */
+std::unique_ptr<IndexScanCursor> Index::ScanAllKeysInBatches() {
+  std::vector<ItemPointer *> entries;
+  ScanAllKeys(entries);
+
+  return std::unique_ptr<IndexScanCursor>(
+      new BufferedIndexScanCursor(std::move(entries)));
+}
+
+bool BufferedIndexScanCursor::Next(size_t max_count,
+                                   std::vector<ItemPointer *> &result) {
+  size_t count = std::min(max_count, entries_.size() - next_entry_);
+  result.insert(result.end(), entries_.begin() + next_entry_,
+                entries_.begin() + next_entry_ + count);
+  next_entry_ += count;
+
+  return next_entry_ < entries_.size();
+}
+
 /*
  * Compare() - Check whether a given index key satisfies a predicate
  *
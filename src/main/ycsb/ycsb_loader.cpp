@@ -139,8 +139,9 @@ void LoadYCSBRows(const int begin_rowid, const int end_rowid) {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   const bool allocate = true;
   auto txn = txn_manager.BeginTransaction();
-  std::unique_ptr<executor::ExecutorContext> context(
-      new executor::ExecutorContext(txn));
+
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  tuples.reserve(end_rowid - begin_rowid);
 
   for (int rowid = begin_rowid; rowid < end_rowid; rowid++) {
     std::unique_ptr<storage::Tuple> tuple(
@@ -162,11 +163,12 @@ void LoadYCSBRows(const int begin_rowid, const int end_rowid) {
       }
     }
 
-    planner::InsertPlan node(user_table, std::move(tuple));
-    executor::InsertExecutor executor(&node, context.get());
-    executor.Execute();
+    tuples.push_back(std::move(tuple));
   }
 
+  // the rows of the range fill whole tile groups
+  user_table->BulkLoadTuples(tuples, txn);
+
   txn_manager.CommitTransaction(txn);
 }
 
@@ -161,6 +161,16 @@ void OperatorToPlanTransformer::Visit(const PhysicalLimit *op) {
   // Limit Operator does not change the column mapping
   *output_expr_map_ = children_expr_map_[0];
 
+  // A sort under the limit only has to keep the top offset + limit tuples
+  if (children_plans_[0]->GetPlanNodeType() == PlanNodeType::ORDERBY &&
+      op->limit >= 0) {
+    auto order_by_plan =
+        static_cast<planner::OrderByPlan *>(children_plans_[0].get());
+    order_by_plan->SetLimit(true);
+    order_by_plan->SetLimitNumber(op->limit);
+    order_by_plan->SetLimitOffset(std::max<int64_t>(op->offset, 0));
+  }
+
   unique_ptr<planner::AbstractPlan> limit_plan(
       new planner::LimitPlan(op->limit, op->offset));
   limit_plan->AddChild(move(children_plans_[0]));
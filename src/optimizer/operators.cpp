@@ -105,6 +105,15 @@ Operator LogicalSemiJoin::make(expression::AbstractExpression *condition) {
   return Operator(join);
 }
 
+//===--------------------------------------------------------------------===//
+// AntiJoin
+//===--------------------------------------------------------------------===//
+Operator LogicalAntiJoin::make(expression::AbstractExpression *condition) {
+  LogicalAntiJoin *join = new LogicalAntiJoin;
+  join->condition = condition;
+  return Operator(join);
+}
+
 //===--------------------------------------------------------------------===//
 // Aggregate
 //===--------------------------------------------------------------------===//
@@ -409,6 +418,9 @@ template <>
 void OperatorNode<LogicalSemiJoin>::Accept(
     UNUSED_ATTRIBUTE OperatorVisitor *v) const {}
 template <>
+void OperatorNode<LogicalAntiJoin>::Accept(
+    UNUSED_ATTRIBUTE OperatorVisitor *v) const {}
+template <>
 void OperatorNode<LogicalInsert>::Accept(
     UNUSED_ATTRIBUTE OperatorVisitor *v) const {}
 template <>
@@ -436,6 +448,8 @@ std::string OperatorNode<LogicalOuterJoin>::name_ = "LogicalOuterJoin";
 template <>
 std::string OperatorNode<LogicalSemiJoin>::name_ = "LogicalSemiJoin";
 template <>
+std::string OperatorNode<LogicalAntiJoin>::name_ = "LogicalAntiJoin";
+template <>
 std::string OperatorNode<LogicalAggregate>::name_ = "LogicalAggregate";
 template <>
 std::string OperatorNode<LogicalGroupBy>::name_ = "LogicalGroupBy";
@@ -509,6 +523,8 @@ OpType OperatorNode<LogicalOuterJoin>::type_ = OpType::OuterJoin;
 template <>
 OpType OperatorNode<LogicalSemiJoin>::type_ = OpType::SemiJoin;
 template <>
+OpType OperatorNode<LogicalAntiJoin>::type_ = OpType::AntiJoin;
+template <>
 OpType OperatorNode<LogicalAggregate>::type_ = OpType::LogicalAggregate;
 template <>
 OpType OperatorNode<LogicalGroupBy>::type_ = OpType::LogicalGroupBy;
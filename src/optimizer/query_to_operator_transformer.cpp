@@ -134,6 +134,11 @@ void QueryToOperatorTransformer::Visit(const parser::JoinDefinition *node) {
           LogicalSemiJoin::make(node->condition));
       break;
     }
+    case JoinType::ANTI: {
+      join_expr = std::make_shared<OperatorExpression>(
+          LogicalAntiJoin::make(node->condition));
+      break;
+    }
     default:
       throw Exception("Join type invalid");
   }
@@ -33,6 +33,7 @@
 #include "planner/index_scan_plan.h"
 #include "planner/insert_plan.h"
 #include "planner/limit_plan.h"
+#include "planner/merge_join_plan.h"
 #include "planner/nested_loop_join_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/populate_index_plan.h"
@@ -40,6 +41,7 @@
 #include "planner/seq_scan_plan.h"
 #include "planner/update_plan.h"
 #include "storage/data_table.h"
+#include "index/index.h"
 #include "catalog/query_metrics_catalog.h"
 
 #include "common/logger.h"
@@ -712,6 +714,21 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateCopyPlan(
     deserialize_parameters = true;
   }
 
+  // COPY FROM loads the file straight into the table, and COPY TO in CSV or
+  // binary format scans the table itself
+  if (copy_stmt->type == CopyType::IMPORT_CSV ||
+      copy_stmt->type == CopyType::IMPORT_TSV ||
+      ((copy_stmt->type == CopyType::EXPORT_CSV ||
+        copy_stmt->type == CopyType::EXPORT_BINARY) &&
+       deserialize_parameters == false)) {
+    auto target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+        copy_stmt->cpy_table->GetDatabaseName(), table_name);
+    std::unique_ptr<planner::AbstractPlan> copy_plan(
+        new planner::CopyPlan(target_table, copy_stmt->file_path,
+                              copy_stmt->delimiter, copy_stmt->type));
+    return std::move(copy_plan);
+  }
+
   std::unique_ptr<planner::AbstractPlan> copy_plan(
       new planner::CopyPlan(copy_stmt->file_path, deserialize_parameters));
 
@@ -1198,10 +1215,10 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateJoinPlan(
       select_stmt->from_table->join->condition->Copy());
   auto join_for_update = select_stmt->is_for_update;
 
-  std::unique_ptr<planner::SeqScanPlan> left_SelectPlan(
-      new planner::SeqScanPlan(left_table, nullptr, {}, join_for_update));
-  std::unique_ptr<planner::SeqScanPlan> right_SelectPlan(
-      new planner::SeqScanPlan(right_table, nullptr, {}, join_for_update));
+  // Semi and anti joins only output the columns of the left table
+  bool left_columns_only =
+      (join_type == JoinType::SEMI || join_type == JoinType::ANTI);
+  int output_schema_count = left_columns_only ? 1 : 2;
 
   auto left_schema = left_table->GetSchema();
   auto right_schema = right_table->GetSchema();
@@ -1213,17 +1230,6 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateJoinPlan(
   auto right_key_col_name =
       static_cast<expression::TupleValueExpression*>(
           join_condition->GetModifiableChild(1))->GetColumnName();
-  // Generate hash for right table
-  auto right_key = expression::ExpressionUtil::ConvertToTupleValueExpression(
-      right_schema, right_key_col_name);
-  std::vector<std::unique_ptr<const expression::AbstractExpression>> hash_keys;
-  hash_keys.emplace_back(right_key);
-
-  // Create hash plan node
-  std::unique_ptr<planner::HashPlan> hash_plan_node(
-      new planner::HashPlan(hash_keys));
-  hash_plan_node->AddChild(std::move(right_SelectPlan));
-
   std::vector<catalog::Column> output_table_columns = {};
   // expressions to evaluate
   TargetList tl = TargetList();
@@ -1240,17 +1246,19 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateJoinPlan(
   // SELECT * FROM A JOIN B
   if (select_list[0]->GetExpressionType() == ExpressionType::STAR) {
     auto& left_cols = left_schema->GetColumns();
-    auto& right_cols = right_schema->GetColumns();
     output_table_columns = left_cols;
-    output_table_columns.insert(output_table_columns.end(), right_cols.begin(),
-                                right_cols.end());
     int left_col_cnt = left_cols.size();
-    int right_col_cnt = right_cols.size();
     for (int j = 0; j < left_col_cnt; j++) {
       dml.push_back(DirectMap(i++, std::make_pair(0, j)));
     }
-    for (int j = 0; j < right_col_cnt; j++) {
-      dml.push_back(DirectMap(i++, std::make_pair(1, j)));
+    if (left_columns_only == false) {
+      auto& right_cols = right_schema->GetColumns();
+      output_table_columns.insert(output_table_columns.end(),
+                                  right_cols.begin(), right_cols.end());
+      int right_col_cnt = right_cols.size();
+      for (int j = 0; j < right_col_cnt; j++) {
+        dml.push_back(DirectMap(i++, std::make_pair(1, j)));
+      }
     }
   }
 
@@ -1266,7 +1274,8 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateJoinPlan(
         oid_t old_col_id = -1;
         catalog::Column column;
 
-        for (int schema_index = 0; schema_index < 2; schema_index++) {
+        for (int schema_index = 0; schema_index < output_schema_count;
+             schema_index++) {
           auto& schema = schemas_ps[schema_index];
           old_col_id = schema.second->GetColumnID(tup_expr->GetColumnName());
           if (old_col_id != (oid_t)-1 &&
@@ -1279,7 +1288,8 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateJoinPlan(
           }
         }
       } else if (expr_type == ExpressionType::STAR) {
-        for (int schema_index = 0; schema_index < 2; schema_index++) {
+        for (int schema_index = 0; schema_index < output_schema_count;
+             schema_index++) {
           auto& schema = schemas[schema_index];
           auto& cols = schema->GetColumns();
           output_table_columns.insert(output_table_columns.end(), cols.begin(),
@@ -1316,6 +1326,71 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateJoinPlan(
     predicates = std::unique_ptr<const peloton::expression::AbstractExpression>(
         select_stmt->where_clause->Copy());
 
+  // If both tables have an index ordered on their join key, merge their
+  // tuples in key order instead of building a hash table of the right one
+  std::shared_ptr<index::Index> left_index;
+  std::shared_ptr<index::Index> right_index;
+  if (join_condition->GetExpressionType() == ExpressionType::COMPARE_EQUAL &&
+      left_columns_only == false) {
+    left_index = GetOrderedIndex(left_table,
+                                 left_schema->GetColumnID(left_key_col_name));
+    right_index = GetOrderedIndex(
+        right_table, right_schema->GetColumnID(right_key_col_name));
+  }
+
+  if (left_index != nullptr && right_index != nullptr) {
+    LOG_DEBUG("Create Merge Join Plan on indexes %s and %s",
+              left_index->GetName().c_str(), right_index->GetName().c_str());
+    std::vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+    join_clauses.emplace_back(
+        expression::ExpressionUtil::ConvertToTupleValueExpression(
+            left_schema, left_key_col_name),
+        expression::ExpressionUtil::ConvertToTupleValueExpression(
+            right_schema, right_key_col_name),
+        false);
+
+    std::unique_ptr<planner::MergeJoinPlan> merge_join_plan_node(
+        new planner::MergeJoinPlan(join_type, std::move(predicates),
+                                   std::move(proj_info), schema,
+                                   join_clauses));
+
+    // scan all keys of the indexes, keeping the tuples in key order
+    std::vector<expression::AbstractExpression*> runtime_keys;
+    planner::IndexScanPlan::IndexScanDesc left_index_scan_desc(
+        left_index, {}, {}, {}, runtime_keys);
+    std::unique_ptr<planner::IndexScanPlan> left_index_scan_node(
+        new planner::IndexScanPlan(left_table, nullptr, {},
+                                   left_index_scan_desc, join_for_update));
+    left_index_scan_node->SetKeyOrdered(true);
+
+    planner::IndexScanPlan::IndexScanDesc right_index_scan_desc(
+        right_index, {}, {}, {}, runtime_keys);
+    std::unique_ptr<planner::IndexScanPlan> right_index_scan_node(
+        new planner::IndexScanPlan(right_table, nullptr, {},
+                                   right_index_scan_desc, join_for_update));
+    right_index_scan_node->SetKeyOrdered(true);
+
+    merge_join_plan_node->AddChild(std::move(left_index_scan_node));
+    merge_join_plan_node->AddChild(std::move(right_index_scan_node));
+    return std::move(merge_join_plan_node);
+  }
+
+  std::unique_ptr<planner::SeqScanPlan> left_SelectPlan(
+      new planner::SeqScanPlan(left_table, nullptr, {}, join_for_update));
+  std::unique_ptr<planner::SeqScanPlan> right_SelectPlan(
+      new planner::SeqScanPlan(right_table, nullptr, {}, join_for_update));
+
+  // Generate hash for right table
+  auto right_key = expression::ExpressionUtil::ConvertToTupleValueExpression(
+      right_schema, right_key_col_name);
+  std::vector<std::unique_ptr<const expression::AbstractExpression>> hash_keys;
+  hash_keys.emplace_back(right_key);
+
+  // Create hash plan node
+  std::unique_ptr<planner::HashPlan> hash_plan_node(
+      new planner::HashPlan(hash_keys));
+  hash_plan_node->AddChild(std::move(right_SelectPlan));
+
   auto left_hash_key = peloton::expression::ExpressionUtil::
       ConvertToTupleValueExpression(left_schema, left_key_col_name);
   std::vector<std::unique_ptr<const expression::AbstractExpression>> lhash_keys;
@@ -1337,6 +1412,33 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateJoinPlan(
   return std::move(hash_join_plan_node);
 }
 
+std::shared_ptr<index::Index> SimpleOptimizer::GetOrderedIndex(
+    storage::DataTable* target_table, oid_t column_id) {
+  std::shared_ptr<index::Index> ordered_index;
+  if (column_id == INVALID_OID) return ordered_index;
+
+  for (oid_t index_itr = 0; index_itr < target_table->GetIndexCount();
+       index_itr++) {
+    auto index = target_table->GetIndex(index_itr);
+    // only the bwtree scans its keys in order
+    if (index == nullptr || index->GetIndexMethodType() != IndexType::BWTREE) {
+      continue;
+    }
+
+    // a secondary index keeps the entries of old keys after an update, and a
+    // full scan would emit the visible version again at its old key. updates
+    // of the primary key insert a new tuple instead.
+    if (index->GetIndexType() != IndexConstraintType::PRIMARY_KEY) continue;
+
+    auto& key_attrs = index->GetMetadata()->GetKeyAttrs();
+    if (key_attrs.empty() || key_attrs[0] != column_id) continue;
+
+    ordered_index = index;
+    break;
+  }
+  return ordered_index;
+}
+
 void SimpleOptimizer::SetIndexScanFlag(planner::AbstractPlan* select_plan,
                                        uint64_t limit, uint64_t offset,
                                        bool descent) {
@@ -1545,6 +1647,11 @@ std::unique_ptr<planner::AbstractPlan> SimpleOptimizer::CreateOrderByLimitPlan(
         "Underlying plan has the same ordering output with"
         "order_by plan with limit");
     order_by_plan->SetUnderlyingOrder(true);
+  }
+
+  // Either the order by stops reading once it has enough ordered tuples, or
+  // it keeps only the top offset + limit ones while sorting
+  if (select_stmt->limit->limit >= 0) {
     order_by_plan->SetLimit(true);
     order_by_plan->SetLimitNumber(select_stmt->limit->limit);
     order_by_plan->SetLimitOffset(offset);
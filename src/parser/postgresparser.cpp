@@ -55,7 +55,7 @@ parser::JoinDefinition* PostgresParser::JoinTransform(JoinExpr* root) {
   parser::JoinDefinition* result = nullptr;
 
   // Natrual join is not supported
-  if ((root->jointype > 4) || (root->isNatural)) {
+  if ((root->jointype > 5) || (root->isNatural)) {
     return nullptr;
   }
   LOG_TRACE("Join type is %d\n", root->jointype);
@@ -81,6 +81,10 @@ parser::JoinDefinition* PostgresParser::JoinTransform(JoinExpr* root) {
       result->type = StringToJoinType("semi");
       break;
     }
+    case JOIN_ANTI: {
+      result->type = StringToJoinType("anti");
+      break;
+    }
     default: {
       delete result;
       throw NotImplementedException(StringUtil::Format(
@@ -954,17 +958,35 @@ parser::PrepareStatement* PostgresParser::PrepareTransform(PrepareStmt* root) {
   return res;
 }
 
-// TODO: Only support COPY TABLE TO FILE and DELIMITER option
+// TODO: Only support COPY TABLE TO/FROM FILE, DELIMITER and FORMAT options
 parser::CopyStatement* PostgresParser::CopyTransform(CopyStmt* root) {
-  auto res = new CopyStatement(peloton::CopyType::EXPORT_OTHER);
+  auto res = new CopyStatement(root->is_from ? peloton::CopyType::IMPORT_CSV
+                                             : peloton::CopyType::EXPORT_OTHER);
   res->cpy_table = RangeVarTransform(root->relation);
   res->file_path = cstrdup(root->filename);
+  if (root->options == nullptr) return res;
   for (auto cell = root->options->head; cell != NULL; cell = cell->next) {
     auto def_elem = reinterpret_cast<DefElem*>(cell->data.ptr_value);
     if (strcmp(def_elem->defname, "delimiter") == 0) {
       auto delimiter = reinterpret_cast<value*>(def_elem->arg)->val.str;
       res->delimiter = *delimiter;
-      break;
+    } else if (strcmp(def_elem->defname, "format") == 0 &&
+               root->is_from == true) {
+      // the loader only parses csv
+      auto format = reinterpret_cast<value*>(def_elem->arg)->val.str;
+      if (strcmp(format, "csv") != 0) {
+        delete res;
+        throw NotImplementedException(StringUtil::Format(
+            "COPY FROM format %s not supported yet...\n", format));
+      }
+    } else if (strcmp(def_elem->defname, "format") == 0) {
+      // an explicit format selects the parallel export
+      auto format = reinterpret_cast<value*>(def_elem->arg)->val.str;
+      if (strcmp(format, "csv") == 0) {
+        res->type = peloton::CopyType::EXPORT_CSV;
+      } else if (strcmp(format, "binary") == 0) {
+        res->type = peloton::CopyType::EXPORT_BINARY;
+      }
     }
   }
   return res;
@@ -251,6 +251,15 @@ oid_t SeqScanPlan::GetColumnID(std::string col_name) {
   return index;
 }
 
+const std::vector<storage::ZoneMapPredicate> &
+SeqScanPlan::GetZoneMapPredicates() const {
+  std::call_once(zone_map_predicates_flag_, [this]() {
+    storage::ZoneMap::GetPredicates(GetPredicate(), nullptr,
+                                    zone_map_predicates_);
+  });
+  return zone_map_predicates_;
+}
+
 void SeqScanPlan::SetParameterValues(std::vector<type::Value> *values) {
   LOG_TRACE("Setting parameter values in Sequential Scan");
 
@@ -85,13 +85,28 @@ TileGroup *AbstractTable::GetTileGroupWithLayout(
     schemas.push_back(tile_schema);
   }
 
-  TileGroup *tile_group =
-      TileGroupFactory::GetTileGroup(database_id, GetOid(), tile_group_id, this,
-                                     schemas, partitioning, num_tuples);
+  TileGroup *tile_group = TileGroupFactory::GetTileGroup(
+      database_id, GetOid(), tile_group_id, this, schemas,
+      GetLayout(partitioning), num_tuples);
 
   return tile_group;
 }
 
+std::shared_ptr<const TileGroupLayout> AbstractTable::GetLayout(
+    const column_map_type &column_map) {
+  layout_lock_.Lock();
+
+  auto &layout = layouts_[column_map];
+  if (layout == nullptr) {
+    layout.reset(new TileGroupLayout(column_map));
+  }
+  auto shared_layout = layout;
+
+  layout_lock_.Unlock();
+
+  return shared_layout;
+}
+
 const std::string AbstractTable::GetInfo() const {
   std::ostringstream inner;
   oid_t tile_group_count = this->GetTileGroupCount();
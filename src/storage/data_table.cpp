@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <mutex>
 #include <utility>
 
@@ -20,6 +21,7 @@
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/platform.h"
+#include "concurrency/epoch_manager_factory.h"
 #include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager_factory.h"
@@ -33,6 +35,7 @@
 #include "storage/tile_group_factory.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 
 //===--------------------------------------------------------------------===//
 // Configuration Variables
@@ -49,6 +52,8 @@ namespace storage {
 
 oid_t DataTable::invalid_tile_group_id = -1;
 
+oid_t DataTable::dropped_tile_group_id = -2;
+
 size_t DataTable::default_active_tilegroup_count_ = 1;
 size_t DataTable::default_active_indirection_array_count_ = 1;
 
@@ -76,6 +81,14 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
   }
 
   active_tile_groups_.resize(active_tilegroup_count_);
+  active_tile_group_ptrs_.reset(
+      new std::atomic<TileGroup *>[active_tilegroup_count_]);
+  standby_tile_group_ptrs_.reset(
+      new std::atomic<TileGroup *>[active_tilegroup_count_]);
+  for (size_t i = 0; i < active_tilegroup_count_; ++i) {
+    active_tile_group_ptrs_[i] = nullptr;
+    standby_tile_group_ptrs_[i] = nullptr;
+  }
 
   active_indirection_arrays_.resize(active_indirection_array_count_);
   // Create tile groups.
@@ -99,13 +112,22 @@ DataTable::~DataTable() {
        tile_groups_itr++) {
     auto tile_group_id = tile_groups_.Find(tile_groups_itr);
 
-    if (tile_group_id != invalid_tile_group_id) {
+    if (tile_group_id != invalid_tile_group_id &&
+        tile_group_id != dropped_tile_group_id) {
       LOG_TRACE("Dropping tile group : %u ", tile_group_id);
       // drop tile group in catalog
       catalog_manager.DropTileGroup(tile_group_id);
     }
   }
 
+  // the standby tile groups are not in the tile group list yet
+  for (size_t i = 0; i < active_tilegroup_count_; ++i) {
+    auto standby_tile_group = standby_tile_group_ptrs_[i].load();
+    if (standby_tile_group != nullptr) {
+      catalog_manager.DropTileGroup(standby_tile_group->GetTileGroupId());
+    }
+  }
+
   // clean up foreign keys
   for (auto foreign_key : foreign_keys_) {
     delete foreign_key;
@@ -171,26 +193,31 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   // check if there are recycled tuple slots
   auto &gc_manager = gc::GCManagerFactory::GetInstance();
   auto free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
-  if (free_item_pointer.IsNull() == false) {
-    // when inserting a tuple
-    if (tuple != nullptr) {
-      auto tile_group =
-          catalog::Manager::GetInstance().GetTileGroup(free_item_pointer.block);
-      tile_group->CopyTuple(tuple, free_item_pointer.offset);
+  while (free_item_pointer.IsNull() == false) {
+    auto tile_group =
+        catalog::Manager::GetInstance().GetTileGroup(free_item_pointer.block);
+    // skip the slots of tile groups that are compacted or already dropped
+    if (tile_group != nullptr &&
+        tile_group->GetHeader()->IsCompacting() == false) {
+      // when inserting a tuple
+      if (tuple != nullptr) {
+        tile_group->CopyTuple(tuple, free_item_pointer.offset);
+      }
+      return free_item_pointer;
     }
-    return free_item_pointer;
+    free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
   }
   //====================================================
 
   size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
-  std::shared_ptr<storage::TileGroup> tile_group;
+  storage::TileGroup *tile_group = nullptr;
   oid_t tuple_slot = INVALID_OID;
   oid_t tile_group_id = INVALID_OID;
 
   // get valid tuple.
   while (true) {
     // get the last tile group.
-    tile_group = active_tile_groups_[active_tile_group_id];
+    tile_group = active_tile_group_ptrs_[active_tile_group_id].load();
 
     tuple_slot = tile_group->InsertTuple(tuple);
 
@@ -199,17 +226,17 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
       tile_group_id = tile_group->GetTileGroupId();
       break;
     }
-  }
 
-  // if this is the last tuple slot we can get
-  // then create a new tile group
-  if (tuple_slot == tile_group->GetAllocatedTupleCount() - 1) {
-    AddDefaultTileGroup(active_tile_group_id);
+    // the tile group is full, and the inserter of its last tuple is about to
+    // swap in the next one
+    _mm_pause();
   }
 
+  AdvanceActiveTileGroup(active_tile_group_id, tile_group, tuple_slot);
+
   LOG_TRACE("tile group count: %lu, tile group id: %u, address: %p",
             tile_group_count_.load(), tile_group->GetTileGroupId(),
-            tile_group.get());
+            tile_group);
 
   // Set tuple location
   ItemPointer location(tile_group_id, tuple_slot);
@@ -217,6 +244,23 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   return location;
 }
 
+void DataTable::AdvanceActiveTileGroup(const size_t &active_tile_group_id,
+                                       TileGroup *tile_group,
+                                       const oid_t &tuple_slot) {
+  // halfway through the tile group, prepare the next one, so that it is
+  // ready by the time this one fills up
+  auto allocated_tuple_count = tile_group->GetAllocatedTupleCount();
+  if (tuple_slot == allocated_tuple_count / 2) {
+    PrepareStandbyTileGroup(active_tile_group_id);
+  }
+
+  // if this is the last tuple slot we can get
+  // then switch to a new tile group
+  if (tuple_slot == allocated_tuple_count - 1) {
+    AddDefaultTileGroup(active_tile_group_id);
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // INSERT
 //===--------------------------------------------------------------------===//
@@ -248,6 +292,47 @@ ItemPointer DataTable::AcquireVersion() {
   return location;
 }
 
+ItemPointer DataTable::AcquireVersionInDefaultLayout() {
+  auto column_map = GetDefaultTileGroupLayout();
+  size_t first_active_tile_group_id =
+      number_of_tuples_ % active_tilegroup_count_;
+
+  for (size_t itr = 0; itr < active_tilegroup_count_; itr++) {
+    size_t active_tile_group_id =
+        (first_active_tile_group_id + itr) % active_tilegroup_count_;
+    auto tile_group = active_tile_group_ptrs_[active_tile_group_id].load();
+    if (tile_group->GetColumnMap() != column_map) {
+      continue;
+    }
+
+    // a full tile group is swapped out by the inserter of its last tuple
+    oid_t tuple_slot = tile_group->InsertTuple(nullptr);
+    if (tuple_slot == INVALID_OID) {
+      continue;
+    }
+
+    AdvanceActiveTileGroup(active_tile_group_id, tile_group, tuple_slot);
+    IncreaseTupleCount(1);
+    return ItemPointer(tile_group->GetTileGroupId(), tuple_slot);
+  }
+
+  // none of the active tile groups has the layout yet. the replaced one
+  // keeps its tuples, and is reorganized once it is no longer active.
+  AddDefaultTileGroup(first_active_tile_group_id);
+  auto tile_group = active_tile_group_ptrs_[first_active_tile_group_id].load();
+  if (tile_group->GetColumnMap() != column_map) {
+    return INVALID_ITEMPOINTER;
+  }
+  oid_t tuple_slot = tile_group->InsertTuple(nullptr);
+  if (tuple_slot == INVALID_OID) {
+    return INVALID_ITEMPOINTER;
+  }
+
+  AdvanceActiveTileGroup(first_active_tile_group_id, tile_group, tuple_slot);
+  IncreaseTupleCount(1);
+  return ItemPointer(tile_group->GetTileGroupId(), tuple_slot);
+}
+
 bool DataTable::InstallVersion(const AbstractTuple *tuple,
                                const TargetList *targets_ptr,
                                concurrency::Transaction *transaction,
@@ -340,30 +425,11 @@ bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
                                 ItemPointer **index_entry_ptr) {
   int index_count = GetIndexCount();
 
-  size_t active_indirection_array_id =
-      number_of_tuples_ % active_indirection_array_count_;
-
-  size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
-
-  while (true) {
-    auto active_indirection_array =
-        active_indirection_arrays_[active_indirection_array_id];
-    indirection_offset = active_indirection_array->AllocateIndirection();
-
-    if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
-      *index_entry_ptr =
-          active_indirection_array->GetIndirectionByOffset(indirection_offset);
-      break;
-    }
-  }
+  *index_entry_ptr = AllocateIndirection();
 
   (*index_entry_ptr)->block = location.block;
   (*index_entry_ptr)->offset = location.offset;
 
-  if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
-    AddDefaultIndirectionArray(active_indirection_array_id);
-  }
-
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
 
@@ -414,6 +480,32 @@ bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
   return true;
 }
 
+ItemPointer *DataTable::AllocateIndirection() {
+  size_t active_indirection_array_id =
+      number_of_tuples_ % active_indirection_array_count_;
+
+  size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
+  ItemPointer *indirection = nullptr;
+
+  while (true) {
+    auto active_indirection_array =
+        active_indirection_arrays_[active_indirection_array_id];
+    indirection_offset = active_indirection_array->AllocateIndirection();
+
+    if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
+      indirection =
+          active_indirection_array->GetIndirectionByOffset(indirection_offset);
+      break;
+    }
+  }
+
+  if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
+    AddDefaultIndirectionArray(active_indirection_array_id);
+  }
+
+  return indirection;
+}
+
 bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                          const TargetList *targets_ptr,
                                          concurrency::Transaction *transaction,
@@ -483,6 +575,153 @@ bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
   return res;
 }
 
+//===--------------------------------------------------------------------===//
+// BULK LOAD
+//===--------------------------------------------------------------------===//
+
+void DataTable::BulkLoadTuples(
+    const std::vector<std::unique_ptr<storage::Tuple>> &tuples,
+    concurrency::Transaction *transaction) {
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  auto column_map = GetDefaultTileGroupLayout();
+  auto transaction_id = transaction->GetTransactionId();
+
+  // ForeignKey checks, before any tuple is copied
+  for (auto &tuple : tuples) {
+    if (CheckForeignKeyConstraints(tuple.get()) == false) {
+      LOG_TRACE("ForeignKey constraint violated");
+      throw ConstraintException("ForeignKey constraint violated : " +
+                                std::string(tuple->GetInfo()));
+    }
+  }
+
+  std::vector<std::shared_ptr<TileGroup>> tile_groups;
+  std::vector<ItemPointer *> index_entry_ptrs;
+  index_entry_ptrs.reserve(tuples.size());
+
+  // no other writer can reach the new tile groups, so the tuples are copied
+  // without going through the free slots of the table, and are owned by the
+  // transaction without entering its read/write set. the transaction stamps
+  // the whole tile groups when it ends.
+  std::shared_ptr<TileGroup> tile_group;
+  TileGroupHeader *tile_group_header = nullptr;
+  for (auto &tuple : tuples) {
+    if (tile_group == nullptr ||
+        tile_group->GetNextTupleSlot() == tuples_per_tilegroup_) {
+      tile_group.reset(GetTileGroupWithLayout(column_map));
+      tile_group_header = tile_group->GetHeader();
+      tile_groups.push_back(tile_group);
+
+      // index entries find the tile group through the locator
+      catalog_manager.AddTileGroup(tile_group->GetTileGroupId(), tile_group);
+      transaction->RecordBulkLoad(tile_group->GetTileGroupId());
+    }
+
+    auto tuple_slot = tile_group->InsertTuple(tuple.get());
+    PL_ASSERT(tuple_slot != INVALID_OID);
+
+    auto index_entry_ptr = AllocateIndirection();
+    *index_entry_ptr = ItemPointer(tile_group->GetTileGroupId(), tuple_slot);
+    tile_group_header->SetIndirection(tuple_slot, index_entry_ptr);
+    tile_group_header->SetTransactionId(tuple_slot, transaction_id);
+    index_entry_ptrs.push_back(index_entry_ptr);
+  }
+
+  // the index entries are built once all tuples are in place
+  auto index_result =
+      InsertInIndexesForBulkLoad(tuples, index_entry_ptrs, transaction);
+
+  // publish the tile groups to scans. this is also done when an index
+  // constraint is violated, so that the slots the abort recycles belong to
+  // the table.
+  for (auto &loaded_tile_group : tile_groups) {
+    tile_groups_.Append(loaded_tile_group->GetTileGroupId());
+
+    COMPILER_MEMORY_FENCE;
+
+    tile_group_count_++;
+  }
+
+  // Increase the table's number of tuples, as for inserts
+  IncreaseTupleCount(tuples.size());
+
+  if (index_result == false) {
+    LOG_TRACE("Index constraint violated");
+    throw ConstraintException("Index constraint violated in bulk load");
+  }
+
+  LOG_TRACE("Bulk loaded %lu tuples into %lu tile groups", tuples.size(),
+            tile_groups.size());
+}
+
+bool DataTable::InsertInIndexesForBulkLoad(
+    const std::vector<std::unique_ptr<storage::Tuple>> &tuples,
+    const std::vector<ItemPointer *> &index_entry_ptrs,
+    concurrency::Transaction *transaction) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  // the loaded tuples are occupied for the transaction, as they are owned by
+  // it and have no commit id yet
+  std::function<bool(const void *)> fn =
+      std::bind(&concurrency::TransactionManager::IsOccupied,
+                &transaction_manager, transaction, std::placeholders::_1);
+
+  // the unique indexes are built first, so that a violation stops the load
+  // before the other indexes are touched
+  std::vector<std::shared_ptr<index::Index>> unique_indexes;
+  std::vector<std::shared_ptr<index::Index>> other_indexes;
+  int index_count = GetIndexCount();
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    if (index == nullptr) continue;
+    switch (index->GetIndexType()) {
+      case IndexConstraintType::PRIMARY_KEY:
+      case IndexConstraintType::UNIQUE:
+        unique_indexes.push_back(index);
+        break;
+      case IndexConstraintType::DEFAULT:
+      default:
+        other_indexes.push_back(index);
+        break;
+    }
+  }
+
+  auto build_key = [&tuples](index::Index *index, size_t tuple_itr) {
+    auto index_schema = index->GetKeySchema();
+    std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
+    key->SetFromTuple(tuples[tuple_itr].get(),
+                      index_schema->GetIndexedColumns(), index->GetPool());
+    return key;
+  };
+
+  // each index is built in one pass over the tuples. the entries built
+  // before a violation are deleted by the gc once the transaction aborts,
+  // like those of aborted inserts.
+  for (auto &unique_index : unique_indexes) {
+    auto index = unique_index.get();
+    for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+      auto key = build_key(index, tuple_itr);
+      if (index->CondInsertEntry(key.get(), index_entry_ptrs[tuple_itr], fn) ==
+          false) {
+        LOG_TRACE("Index constraint violated on %s",
+                  index->GetName().c_str());
+        return false;
+      }
+    }
+  }
+
+  for (auto &other_index : other_indexes) {
+    auto index = other_index.get();
+    for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+      index->InsertEntry(build_key(index, tuple_itr).get(),
+                         index_entry_ptrs[tuple_itr]);
+    }
+  }
+
+  return true;
+}
+
 /**
  * @brief Check if all the foreign key constraints on this table
  * is satisfied by checking whether the key exist in the referred table
@@ -622,27 +861,45 @@ oid_t DataTable::AddDefaultTileGroup() {
 }
 
 oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
-  column_map_type column_map;
-  oid_t tile_group_id = INVALID_OID;
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  std::shared_ptr<TileGroup> tile_group;
 
   // Figure out the partitioning for given tilegroup layout
-  column_map = GetTileGroupLayout((LayoutType)peloton_layout_mode);
+  column_map_type column_map = GetDefaultTileGroupLayout();
+
+  // take the standby tile group, if it is ready, unless it was prepared
+  // before the layout changed
+  auto standby_tile_group =
+      standby_tile_group_ptrs_[active_tile_group_id].exchange(nullptr);
+  if (standby_tile_group != nullptr) {
+    tile_group =
+        catalog_manager.GetTileGroup(standby_tile_group->GetTileGroupId());
+    if (tile_group != nullptr &&
+        standby_tile_group->GetColumnMap() != column_map) {
+      catalog_manager.DropTileGroup(tile_group->GetTileGroupId());
+      RetireTileGroup(tile_group);
+      tile_group.reset();
+    }
+  }
 
-  // Create a tile group with that partitioning
-  std::shared_ptr<TileGroup> tile_group(GetTileGroupWithLayout(column_map));
-  PL_ASSERT(tile_group.get());
+  if (tile_group == nullptr) {
+
+    // Create a tile group with that partitioning
+    tile_group.reset(GetTileGroupWithLayout(column_map));
+    PL_ASSERT(tile_group.get());
 
-  tile_group_id = tile_group->GetTileGroupId();
+    // add tile group metadata in locator
+    catalog_manager.AddTileGroup(tile_group->GetTileGroupId(), tile_group);
+  }
+
+  oid_t tile_group_id = tile_group->GetTileGroupId();
 
   LOG_TRACE("Added a tile group ");
   tile_groups_.Append(tile_group_id);
 
-  // add tile group metadata in locator
-  catalog::Manager::GetInstance().AddTileGroup(tile_group_id, tile_group);
-
   COMPILER_MEMORY_FENCE;
 
-  active_tile_groups_[active_tile_group_id] = tile_group;
+  SetActiveTileGroup(active_tile_group_id, tile_group);
 
   // we must guarantee that the compiler always add tile group before adding
   // tile_group_count_.
@@ -655,6 +912,66 @@ oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
   return tile_group_id;
 }
 
+void DataTable::SetActiveTileGroup(
+    const size_t &active_tile_group_id,
+    const std::shared_ptr<TileGroup> &tile_group) {
+  std::shared_ptr<TileGroup> replaced_tile_group;
+  {
+    std::lock_guard<std::mutex> lock(active_tile_group_mutex_);
+    replaced_tile_group = std::move(active_tile_groups_[active_tile_group_id]);
+    active_tile_groups_[active_tile_group_id] = tile_group;
+    active_tile_group_ptrs_[active_tile_group_id] = tile_group.get();
+  }
+
+  if (replaced_tile_group != nullptr) {
+    RetireTileGroup(replaced_tile_group);
+  }
+}
+
+void DataTable::RetireTileGroup(const std::shared_ptr<TileGroup> &tile_group) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+
+  std::lock_guard<std::mutex> lock(active_tile_group_mutex_);
+
+  // no transaction is left from the epochs at or before the expired one
+  if (expired_eid != MAX_EID) {
+    retired_tile_groups_.erase(
+        std::remove_if(
+            retired_tile_groups_.begin(), retired_tile_groups_.end(),
+            [&expired_eid](
+                const std::pair<eid_t, std::shared_ptr<TileGroup>> &retired) {
+              return retired.first <= expired_eid;
+            }),
+        retired_tile_groups_.end());
+  }
+
+  retired_tile_groups_.emplace_back(epoch_manager.GetCurrentEpochId(),
+                                    tile_group);
+}
+
+void DataTable::PrepareStandbyTileGroup(const size_t &active_tile_group_id) {
+  if (standby_tile_group_ptrs_[active_tile_group_id].load() != nullptr) {
+    return;
+  }
+
+  column_map_type column_map = GetDefaultTileGroupLayout();
+  std::shared_ptr<TileGroup> tile_group(GetTileGroupWithLayout(column_map));
+  PL_ASSERT(tile_group.get());
+
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  catalog_manager.AddTileGroup(tile_group->GetTileGroupId(), tile_group);
+
+  // a standby tile group left over from a previous round wins
+  TileGroup *expected = nullptr;
+  if (standby_tile_group_ptrs_[active_tile_group_id].compare_exchange_strong(
+          expected, tile_group.get()) == false) {
+    catalog_manager.DropTileGroup(tile_group->GetTileGroupId());
+  }
+
+  LOG_TRACE("Prepared standby tile group : %u ", tile_group->GetTileGroupId());
+}
+
 void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
   PL_ASSERT(tile_group_id);
 
@@ -696,7 +1013,7 @@ void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
 void DataTable::AddTileGroup(const std::shared_ptr<TileGroup> &tile_group) {
   size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
 
-  active_tile_groups_[active_tile_group_id] = tile_group;
+  SetActiveTileGroup(active_tile_group_id, tile_group);
 
   oid_t tile_group_id = tile_group->GetTileGroupId();
 
@@ -723,7 +1040,17 @@ std::shared_ptr<storage::TileGroup> DataTable::GetTileGroup(
   auto tile_group_id =
       tile_groups_.FindValid(tile_group_offset, invalid_tile_group_id);
 
-  return GetTileGroupById(tile_group_id);
+  auto tile_group = GetTileGroupById(tile_group_id);
+
+  // the offset is marked before the tile group leaves the catalog, so a
+  // failed lookup of a tile group dropped by the compactor finds the mark
+  if (tile_group == nullptr &&
+      tile_groups_.FindValid(tile_group_offset, invalid_tile_group_id) ==
+          dropped_tile_group_id) {
+    return std::atomic_load(&dropped_tile_group_);
+  }
+
+  return tile_group;
 }
 
 std::shared_ptr<storage::TileGroup> DataTable::GetTileGroupById(
@@ -732,6 +1059,45 @@ std::shared_ptr<storage::TileGroup> DataTable::GetTileGroupById(
   return manager.GetTileGroup(tile_group_id);
 }
 
+bool DataTable::IsActiveTileGroup(const oid_t &tile_group_id) const {
+  for (size_t i = 0; i < active_tilegroup_count_; ++i) {
+    auto tile_group = active_tile_group_ptrs_[i].load();
+    if (tile_group != nullptr && tile_group->GetTileGroupId() == tile_group_id) {
+      return true;
+    }
+    auto standby_tile_group = standby_tile_group_ptrs_[i].load();
+    if (standby_tile_group != nullptr &&
+        standby_tile_group->GetTileGroupId() == tile_group_id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void DataTable::DropTileGroup(const std::size_t &tile_group_offset) {
+  auto tile_group_id =
+      tile_groups_.FindValid(tile_group_offset, invalid_tile_group_id);
+  PL_ASSERT(tile_group_id != dropped_tile_group_id);
+  PL_ASSERT(IsActiveTileGroup(tile_group_id) == false);
+
+  // the empty tile group must be in place before the dropped one disappears
+  if (std::atomic_load(&dropped_tile_group_) == nullptr) {
+    std::shared_ptr<TileGroup> dropped_tile_group(
+        AbstractTable::GetTileGroupWithLayout(
+            database_oid, INVALID_OID,
+            GetTileGroupLayout((LayoutType)peloton_layout_mode), 1));
+    std::atomic_store(&dropped_tile_group_, dropped_tile_group);
+  }
+
+  // only the offsets marked here map to the empty tile group
+  tile_groups_.Update(tile_group_offset, dropped_tile_group_id);
+
+  // drop tile group in catalog
+  catalog::Manager::GetInstance().DropTileGroup(tile_group_id);
+
+  LOG_TRACE("Dropped tile group : %u ", tile_group_id);
+}
+
 void DataTable::DropTileGroups() {
   auto &catalog_manager = catalog::Manager::GetInstance();
   auto tile_groups_size = tile_groups_.GetSize();
@@ -741,7 +1107,8 @@ void DataTable::DropTileGroups() {
        tile_groups_itr++) {
     auto tile_group_id = tile_groups_.Find(tile_groups_itr);
 
-    if (tile_group_id != invalid_tile_group_id) {
+    if (tile_group_id != invalid_tile_group_id &&
+        tile_group_id != dropped_tile_group_id) {
       // drop tile group in catalog
       catalog_manager.DropTileGroup(tile_group_id);
     }
@@ -976,6 +1343,9 @@ void SetTransformedTileGroup(storage::TileGroup *orig_tile_group,
   auto header = orig_tile_group->GetHeader();
   auto new_header = new_tile_group->GetHeader();
   *new_header = *header;
+
+  // The values were copied tile by tile
+  new_tile_group->GetZoneMap()->Merge(orig_tile_group->GetZoneMap());
 }
 
 storage::TileGroup *DataTable::TransformTileGroup(
@@ -989,6 +1359,11 @@ storage::TileGroup *DataTable::TransformTileGroup(
   auto tile_group_id =
       tile_groups_.FindValid(tile_group_offset, invalid_tile_group_id);
 
+  // Nothing to transform in a dropped tile group
+  if (tile_group_id == dropped_tile_group_id) {
+    return nullptr;
+  }
+
   // Get orig tile group from catalog
   auto &catalog_manager = catalog::Manager::GetInstance();
   auto tile_group = catalog_manager.GetTileGroup(tile_group_id);
@@ -1086,12 +1461,21 @@ std::map<oid_t, oid_t> DataTable::GetColumnMapStats() {
 }
 
 void DataTable::SetDefaultLayout(const column_map_type &layout) {
+  std::lock_guard<std::mutex> lock(default_partition_mutex_);
   default_partition_ = layout;
 }
 
 column_map_type DataTable::GetDefaultLayout() const {
+  std::lock_guard<std::mutex> lock(default_partition_mutex_);
   return default_partition_;
 }
 
+column_map_type DataTable::GetDefaultTileGroupLayout() const {
+  if (peloton_layout_mode == LAYOUT_TYPE_HYBRID) {
+    return GetDefaultLayout();
+  }
+  return GetTileGroupLayout((LayoutType)peloton_layout_mode);
+}
+
 }  // End storage namespace
 }  // End peloton namespace
@@ -16,6 +16,7 @@
 #include "common/exception.h"
 #include "common/logger.h"
 #include "gc/gc_manager_factory.h"
+#include "gc/tile_group_compactor.h"
 #include "index/index.h"
 #include "storage/database.h"
 #include "storage/table_factory.h"
@@ -29,7 +30,10 @@ Database::~Database() {
   // Clean up all the tables
   LOG_TRACE("Deleting tables from database");
   for (auto table : tables) {
-    if (table != nullptr) delete table;
+    if (table != nullptr) {
+      gc::TileGroupCompactor::GetInstance().DropTable(table->GetOid());
+      delete table;
+    }
   }
 
   LOG_TRACE("Finish deleting tables from database");
@@ -49,6 +53,9 @@ void Database::AddTable(storage::DataTable *table, bool is_catalog) {
       auto *gc_manager = &gc::GCManagerFactory::GetInstance();
       assert(gc_manager != nullptr);
       gc_manager->RegisterTable(table->GetOid());
+
+      // Register table to tile group compactor.
+      gc::TileGroupCompactor::GetInstance().AddTable(table);
     }
   }
 }
@@ -83,6 +90,9 @@ void Database::DropTableWithOid(const oid_t table_oid) {
     assert(gc_manager != nullptr);
     gc_manager->DeregisterTable(table_oid);
 
+    // Deregister table from tile group compactor.
+    gc::TileGroupCompactor::GetInstance().DropTable(table_oid);
+
     oid_t table_offset = 0;
     for (auto table : tables) {
       if (table->GetOid() == table_oid) {
@@ -0,0 +1,565 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// delta_storage.cpp
+//
+// Identification: src/storage/delta_storage.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/delta_storage.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction.h"
+#include "storage/data_table.h"
+#include "storage/delta_tuple.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_factory.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+// overwrite a column of a tuple slot and give the replaced variable-length
+// value back to the tile pool.
+void MergeValue(TileGroup *tile_group, const oid_t &tuple_id,
+                const oid_t &column_id, const type::Value &value) {
+  oid_t tile_offset, tile_column_id;
+  tile_group->LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+  Tile *tile = tile_group->GetTile(tile_offset);
+  const catalog::Schema *schema = tile->GetSchema();
+
+  char *varlen_ptr = nullptr;
+  auto type_id = schema->GetType(tile_column_id);
+  if ((type_id == type::Type::TypeId::VARCHAR ||
+       type_id == type::Type::TypeId::VARBINARY) &&
+      schema->IsInlined(tile_column_id) == false) {
+    char *field_location = tile->GetTupleLocation(tuple_id) +
+                           schema->GetOffset(tile_column_id);
+    varlen_ptr = type::Value::GetDataFromStorage(type_id, field_location);
+  }
+
+  tile->SetValue(value, tuple_id, tile_column_id);
+
+  if (varlen_ptr != nullptr) {
+    tile->GetPool()->Free(varlen_ptr);
+  }
+}
+
+}  // namespace
+
+DeltaStorage &DeltaStorage::GetInstance() {
+  static DeltaStorage delta_storage;
+  return delta_storage;
+}
+
+DeltaStorage::~DeltaStorage() {
+  // the catalog may already be gone, so do not touch any tuple slot here.
+  for (auto &partition : partitions_) {
+    for (auto &entry : partition.retired) {
+      delete entry.second;
+    }
+    partition.retired.clear();
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Writers
+//===--------------------------------------------------------------------===//
+
+bool DeltaStorage::IsLatestVisible(
+    const concurrency::Transaction *current_txn,
+    const TileGroupHeader *tile_group_header, const oid_t &tuple_id) const {
+  txn_id_t txn_id = current_txn->GetTransactionId();
+
+  DeltaRecord *delta = tile_group_header->GetDeltaPointer(tuple_id);
+  while (delta != nullptr) {
+    cid_t delta_cid = delta->commit_id.load();
+    if (delta_cid != MAX_CID) {
+      // the newest committed delta decides.
+      return delta_cid <= current_txn->GetCommitId();
+    }
+    if (delta->txn_id != txn_id) {
+      return false;
+    }
+    delta = delta->next.load();
+  }
+  return true;
+}
+
+void DeltaStorage::InstallDelta(concurrency::Transaction *current_txn,
+                                TileGroupHeader *tile_group_header,
+                                const ItemPointer &location,
+                                const std::vector<oid_t> &column_ids,
+                                const std::vector<type::Value> &values) {
+  PL_ASSERT(column_ids.size() == values.size());
+  txn_id_t txn_id = current_txn->GetTransactionId();
+  PL_ASSERT(tile_group_header->GetTransactionId(location.offset) == txn_id);
+
+  DeltaRecord *delta = new DeltaRecord(location, txn_id);
+  for (size_t i = 0; i < column_ids.size(); ++i) {
+    delta->column_ids.push_back(column_ids[i]);
+    delta->values.push_back(values[i].Copy());
+  }
+
+  auto &chain_lock = GetChainLock(location);
+  chain_lock.Lock();
+
+  DeltaRecord *head = tile_group_header->GetDeltaPointer(location.offset);
+
+  if (head != nullptr && head->txn_id == txn_id &&
+      head->commit_id.load() == MAX_CID) {
+    // fold the pending delta of this transaction into the new one.
+    for (size_t i = 0; i < head->column_ids.size(); ++i) {
+      if (std::find(column_ids.begin(), column_ids.end(),
+                    head->column_ids[i]) == column_ids.end()) {
+        delta->column_ids.push_back(head->column_ids[i]);
+        delta->values.push_back(head->values[i]);
+      }
+    }
+    delta->next.store(head->next.load());
+    tile_group_header->SetDeltaPointer(location.offset, delta);
+
+    chain_lock.Unlock();
+
+    Retire(head, current_txn->GetThreadId() % partition_count);
+    return;
+  }
+
+  delta->next.store(head);
+  tile_group_header->SetDeltaPointer(location.offset, delta);
+
+  // readers walk the whole chain, so do not let it wait for the gc, which
+  // may be disabled or behind.
+  size_t chain_length = 0;
+  for (; head != nullptr && chain_length < DELTA_CHAIN_MERGE_LENGTH;
+       head = head->next.load()) {
+    ++chain_length;
+  }
+  if (chain_length == DELTA_CHAIN_MERGE_LENGTH) {
+    MergeChain(tile_group_header, location);
+  }
+
+  chain_lock.Unlock();
+}
+
+bool DeltaStorage::CommitDelta(concurrency::Transaction *current_txn,
+                               TileGroupHeader *tile_group_header,
+                               const oid_t &tuple_id) {
+  txn_id_t txn_id = current_txn->GetTransactionId();
+  if (HasPendingDelta(tile_group_header, tuple_id, txn_id) == false) {
+    return false;
+  }
+
+  DeltaRecord *delta = tile_group_header->GetDeltaPointer(tuple_id);
+
+  // transactions that start from now on observe the committed delta, so it
+  // can be merged once the next epoch expires.
+  delta->epoch_id =
+      concurrency::EpochManagerFactory::GetInstance().GetNextEpochId();
+  delta->commit_id.store(current_txn->GetCommitId());
+
+  auto &partition =
+      partitions_[current_txn->GetThreadId() % partition_count];
+  partition.lock.Lock();
+  partition.committed.push_back(delta);
+  partition.lock.Unlock();
+
+  return true;
+}
+
+bool DeltaStorage::AbortDelta(concurrency::Transaction *current_txn,
+                              TileGroupHeader *tile_group_header,
+                              const oid_t &tuple_id) {
+  txn_id_t txn_id = current_txn->GetTransactionId();
+  if (HasPendingDelta(tile_group_header, tuple_id, txn_id) == false) {
+    return false;
+  }
+
+  DeltaRecord *delta = tile_group_header->GetDeltaPointer(tuple_id);
+
+  auto &chain_lock = GetChainLock(delta->location);
+  chain_lock.Lock();
+  tile_group_header->SetDeltaPointer(tuple_id, delta->next.load());
+  chain_lock.Unlock();
+
+  Retire(delta, current_txn->GetThreadId() % partition_count);
+
+  return true;
+}
+
+bool DeltaStorage::HasPendingDelta(const TileGroupHeader *tile_group_header,
+                                   const oid_t &tuple_id,
+                                   const txn_id_t &txn_id) {
+  DeltaRecord *delta = tile_group_header->GetDeltaPointer(tuple_id);
+  return (delta != nullptr && delta->txn_id == txn_id &&
+          delta->commit_id.load() == MAX_CID);
+}
+
+//===--------------------------------------------------------------------===//
+// Readers
+//===--------------------------------------------------------------------===//
+
+bool DeltaStorage::GetVisibleDelta(const concurrency::Transaction *current_txn,
+                                   const TileGroupHeader *tile_group_header,
+                                   const oid_t &tuple_id, DeltaTuple *tuple,
+                                   const VisibilityIdType type) const {
+  DeltaRecord *delta = tile_group_header->GetDeltaPointer(tuple_id);
+  if (delta == nullptr) {
+    return false;
+  }
+
+  txn_id_t txn_id = current_txn->GetTransactionId();
+
+  cid_t txn_vis_id;
+  if (type == VisibilityIdType::READ_ID) {
+    txn_vis_id = current_txn->GetReadId();
+  } else {
+    PL_ASSERT(type == VisibilityIdType::COMMIT_ID);
+    txn_vis_id = current_txn->GetCommitId();
+  }
+
+  for (; delta != nullptr; delta = delta->next.load()) {
+    cid_t delta_cid = delta->commit_id.load();
+    if (delta_cid == MAX_CID) {
+      // only the writer itself may see an uncommitted delta.
+      if (delta->txn_id != txn_id) {
+        continue;
+      }
+    } else if (delta_cid > txn_vis_id) {
+      continue;
+    }
+
+    for (size_t i = 0; i < delta->column_ids.size(); ++i) {
+      tuple->AddDeltaValue(delta->column_ids[i], delta->values[i]);
+    }
+  }
+
+  return tuple->HasDelta();
+}
+
+std::shared_ptr<TileGroup> DeltaStorage::CreateVersionTileGroup(
+    DataTable *table, const size_t &tuple_count) {
+  auto &manager = catalog::Manager::GetInstance();
+  oid_t tile_group_id = manager.GetNextTileGroupId();
+
+  // store the copies in a single row-oriented tile.
+  auto schema = table->GetSchema();
+  std::vector<catalog::Schema> schemas = {*schema};
+  column_map_type column_map;
+  for (oid_t column_id = 0; column_id < schema->GetColumnCount();
+       ++column_id) {
+    column_map[column_id] = std::make_pair(0, column_id);
+  }
+
+  std::shared_ptr<TileGroup> tile_group(TileGroupFactory::GetTileGroup(
+      table->GetDatabaseOid(), table->GetOid(), tile_group_id, table, schemas,
+      column_map, tuple_count));
+
+  manager.AddTileGroup(tile_group_id, tile_group);
+
+  return tile_group;
+}
+
+void DeltaStorage::ReleaseVersionTileGroup(const oid_t &tile_group_id) {
+  catalog::Manager::GetInstance().DropTileGroup(tile_group_id);
+}
+
+oid_t DeltaStorage::MaterializeVersion(const DeltaTuple &tuple,
+                                       TileGroup *version_tile_group) {
+  auto version_header = version_tile_group->GetHeader();
+  oid_t version_slot = version_header->GetNextEmptyTupleSlot();
+  PL_ASSERT(version_slot != INVALID_OID);
+
+  auto origin_tile_group = tuple.GetTileGroup();
+  auto origin_header = origin_tile_group->GetHeader();
+  oid_t origin_slot = tuple.GetTupleId();
+
+  oid_t column_count =
+      version_tile_group->GetAbstractTable()->GetSchema()->GetColumnCount();
+  for (oid_t column_id = 0; column_id < column_count; ++column_id) {
+    type::Value value = tuple.GetValue(column_id);
+    version_tile_group->SetValue(value, version_slot, column_id);
+  }
+
+  // the copy is never owned by any transaction, and points back to the tuple
+  // that writers must operate on, past any copy it was made from.
+  ItemPointer origin(origin_tile_group->GetTileGroupId(), origin_slot);
+  if (IsMaterializedVersion(origin_header, origin_slot) == true) {
+    origin = GetOrigin(origin_header, origin_slot);
+  }
+  version_header->SetBeginCommitId(version_slot,
+                                   origin_header->GetBeginCommitId(origin_slot));
+  version_header->SetEndCommitId(version_slot, MAX_CID);
+  version_header->SetNextItemPointer(version_slot, origin);
+  version_header->SetIndirection(version_slot,
+                                 origin_header->GetIndirection(origin_slot));
+
+  return version_slot;
+}
+
+bool DeltaStorage::IsMaterializedVersion(
+    const TileGroupHeader *tile_group_header, const oid_t &tuple_id) {
+  return (tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID &&
+          tile_group_header->GetNextItemPointer(tuple_id).IsNull() == false);
+}
+
+ItemPointer DeltaStorage::GetOrigin(const TileGroupHeader *tile_group_header,
+                                    const oid_t &tuple_id) {
+  PL_ASSERT(IsMaterializedVersion(tile_group_header, tuple_id));
+  return tile_group_header->GetNextItemPointer(tuple_id);
+}
+
+//===--------------------------------------------------------------------===//
+// Garbage collection
+//===--------------------------------------------------------------------===//
+
+size_t DeltaStorage::Merge(const eid_t &expired_eid, const size_t &max_count,
+                           bool *is_truncated) {
+  std::vector<DeltaRecord *> expired_deltas;
+  size_t partition_max_count =
+      max_count / partition_count + (max_count % partition_count != 0);
+
+  for (auto &partition : partitions_) {
+    // another gc thread is working on this partition.
+    if (partition.lock.TryLock() == false) {
+      if (is_truncated != nullptr) {
+        *is_truncated = true;
+      }
+      continue;
+    }
+    auto &committed = partition.committed;
+    auto itr = std::partition(committed.begin(), committed.end(),
+                              [expired_eid](const DeltaRecord *delta) {
+                                return delta->epoch_id > expired_eid;
+                              });
+    size_t expired_count = std::min<size_t>(committed.end() - itr,
+                                            partition_max_count);
+    if (is_truncated != nullptr &&
+        expired_count < (size_t)(committed.end() - itr)) {
+      *is_truncated = true;
+    }
+    expired_deltas.insert(expired_deltas.end(),
+                          committed.end() - expired_count, committed.end());
+    committed.erase(committed.end() - expired_count, committed.end());
+    partition.lock.Unlock();
+  }
+
+  // deltas of the same tuple must be merged from oldest to newest.
+  std::sort(expired_deltas.begin(), expired_deltas.end(),
+            [](const DeltaRecord *lhs, const DeltaRecord *rhs) {
+              return lhs->commit_id.load() < rhs->commit_id.load();
+            });
+
+  size_t merged_count = 0;
+  for (auto delta : expired_deltas) {
+    size_t partition_id =
+        (delta->location.block * 31 + delta->location.offset) %
+        partition_count;
+
+    auto result = MergeDelta(delta);
+    if (result == MergeResult::BLOCKED) {
+      // an older delta of the tuple is not mergeable yet.
+      auto &partition = partitions_[partition_id];
+      partition.lock.Lock();
+      partition.committed.push_back(delta);
+      partition.lock.Unlock();
+      continue;
+    }
+
+    if (result == MergeResult::MERGED) {
+      ++merged_count;
+    }
+    Retire(delta, partition_id);
+  }
+
+  FreeRetired(expired_eid);
+
+  LOG_TRACE("Merged %lu deltas", merged_count);
+  return merged_count;
+}
+
+DeltaStorage::MergeResult DeltaStorage::MergeDelta(DeltaRecord *delta) {
+  ItemPointer location = delta->location;
+
+  // the table may have been dropped.
+  auto tile_group = catalog::Manager::GetInstance().GetTileGroup(location.block);
+  if (tile_group == nullptr) {
+    return MergeResult::DISCARDED;
+  }
+  auto tile_group_header = tile_group->GetHeader();
+
+  auto &chain_lock = GetChainLock(location);
+  chain_lock.Lock();
+
+  if (delta->discarded.load() == true) {
+    chain_lock.Unlock();
+    return MergeResult::DISCARDED;
+  }
+
+  DeltaRecord *prev = nullptr;
+  DeltaRecord *curr = tile_group_header->GetDeltaPointer(location.offset);
+  while (curr != nullptr && curr != delta) {
+    prev = curr;
+    curr = curr->next.load();
+  }
+  PL_ASSERT(curr == delta);
+
+  if (delta->next.load() != nullptr) {
+    chain_lock.Unlock();
+    return MergeResult::BLOCKED;
+  }
+
+  for (size_t i = 0; i < delta->column_ids.size(); ++i) {
+    MergeValue(tile_group.get(), location.offset, delta->column_ids[i],
+               delta->values[i]);
+  }
+  tile_group_header->SetBeginCommitId(location.offset,
+                                      delta->commit_id.load());
+
+  // the slot must hold the new values before the delta disappears.
+  COMPILER_MEMORY_FENCE;
+
+  if (prev == nullptr) {
+    tile_group_header->SetDeltaPointer(location.offset, nullptr);
+  } else {
+    prev->next.store(nullptr);
+  }
+
+  chain_lock.Unlock();
+
+  return MergeResult::MERGED;
+}
+
+size_t DeltaStorage::MergeChain(TileGroupHeader *tile_group_header,
+                                const ItemPointer &location) {
+  eid_t expired_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetExpiredEpochId();
+  if (expired_eid == MAX_EID) {
+    return 0;
+  }
+
+  auto tile_group = catalog::Manager::GetInstance().GetTileGroup(location.block);
+  oid_t tuple_id = location.offset;
+
+  std::vector<DeltaRecord *> chain;
+  for (DeltaRecord *delta = tile_group_header->GetDeltaPointer(tuple_id);
+       delta != nullptr; delta = delta->next.load()) {
+    chain.push_back(delta);
+  }
+
+  // merge from the oldest delta until one is still visible to some reader.
+  // the records stay queued for merging and get retired from there.
+  size_t merged_count = 0;
+  for (auto itr = chain.rbegin(); itr != chain.rend(); ++itr) {
+    DeltaRecord *delta = *itr;
+    if (delta->commit_id.load() == MAX_CID || delta->epoch_id > expired_eid) {
+      break;
+    }
+
+    for (size_t i = 0; i < delta->column_ids.size(); ++i) {
+      MergeValue(tile_group.get(), tuple_id, delta->column_ids[i],
+                 delta->values[i]);
+    }
+    tile_group_header->SetBeginCommitId(tuple_id, delta->commit_id.load());
+
+    // the slot must hold the new values before the delta disappears.
+    COMPILER_MEMORY_FENCE;
+
+    if (std::next(itr) == chain.rend()) {
+      tile_group_header->SetDeltaPointer(tuple_id, nullptr);
+    } else {
+      (*std::next(itr))->next.store(nullptr);
+    }
+    delta->discarded.store(true);
+    ++merged_count;
+  }
+
+  return merged_count;
+}
+
+void DeltaStorage::DiscardDeltas(TileGroupHeader *tile_group_header,
+                                 const oid_t &tuple_id) {
+  if (tile_group_header->GetDeltaPointer(tuple_id) == nullptr) {
+    return;
+  }
+
+  ItemPointer location(tile_group_header->GetTileGroup()->GetTileGroupId(),
+                       tuple_id);
+  auto &chain_lock = GetChainLock(location);
+  chain_lock.Lock();
+
+  DeltaRecord *delta = tile_group_header->GetDeltaPointer(tuple_id);
+  tile_group_header->SetDeltaPointer(tuple_id, nullptr);
+
+  // the records are still queued for merging and get retired from there.
+  for (; delta != nullptr; delta = delta->next.load()) {
+    PL_ASSERT(delta->commit_id.load() != MAX_CID);
+    delta->discarded.store(true);
+  }
+
+  chain_lock.Unlock();
+}
+
+size_t DeltaStorage::GetPendingDeltaCount() {
+  size_t count = 0;
+  for (auto &partition : partitions_) {
+    partition.lock.Lock();
+    count += partition.committed.size();
+    partition.lock.Unlock();
+  }
+  return count;
+}
+
+void DeltaStorage::Clear() {
+  while (Merge(MAX_EID) != 0) {
+  }
+}
+
+void DeltaStorage::Retire(DeltaRecord *delta, const size_t &partition_id) {
+  // readers may still be traversing the record.
+  eid_t epoch_id =
+      concurrency::EpochManagerFactory::GetInstance().GetNextEpochId();
+
+  auto &partition = partitions_[partition_id];
+  partition.lock.Lock();
+  partition.retired.emplace_back(epoch_id, delta);
+  partition.lock.Unlock();
+}
+
+size_t DeltaStorage::FreeRetired(const eid_t &expired_eid) {
+  size_t freed_count = 0;
+  for (auto &partition : partitions_) {
+    if (partition.lock.TryLock() == false) {
+      continue;
+    }
+    auto &retired = partition.retired;
+    auto itr = std::partition(
+        retired.begin(), retired.end(),
+        [expired_eid](const std::pair<eid_t, DeltaRecord *> &entry) {
+          return entry.first > expired_eid;
+        });
+    for (auto free_itr = itr; free_itr != retired.end(); ++free_itr) {
+      delete free_itr->second;
+      ++freed_count;
+    }
+    retired.erase(itr, retired.end());
+    partition.lock.Unlock();
+  }
+  return freed_count;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
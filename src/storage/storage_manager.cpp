@@ -18,9 +18,11 @@
 #include <string.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -312,7 +314,10 @@ StorageManager &StorageManager::GetInstance(void) {
 }
 
 StorageManager::StorageManager()
-    : data_file_address(nullptr), data_file_len(0), data_file_offset(0) {
+    : huge_page_available(true),
+      allocation_count(0),
+      slab_count(0),
+      mapped_size(0) {
   // // Check if we need a data pool
   // if (logging::LoggingUtil::IsBasedOnWriteAheadLogging(peloton_logging_mode) ==
   //         true ||
@@ -421,7 +426,18 @@ StorageManager::StorageManager()
 }
 
 StorageManager::~StorageManager() {
-  LOG_TRACE("Allocation count : %ld \n", allocation_count);
+  LOG_TRACE("Allocation count : %ld \n", allocation_count.load());
+
+  // slabs that still hold allocations are unmapped by their last release
+  for (auto &arena : numa_node_arenas) {
+    arena.lock.Lock();
+    if (arena.slab != nullptr) {
+      auto slab = arena.slab;
+      arena.slab = nullptr;
+      ReleaseSlab(slab);
+    }
+    arena.lock.Unlock();
+  }
 
   // // Check if we need a PMEM pool
   // if (peloton_logging_mode != LoggingType::NVM_WBL) return;
@@ -447,46 +463,18 @@ void *StorageManager::Allocate(BackendType type, size_t size) {
   allocation_count++;
 
   switch (type) {
+    // ssd and hdd are kept in memory as well, since nothing maps a data file
+    // back after a restart
     case BackendType::MM:
-    case BackendType::NVM: {
-      return ::operator new(size);
-    } break;
-
+    case BackendType::NVM:
     case BackendType::SSD:
     case BackendType::HDD: {
-      {
-        size_t cache_data_file_offset = 0;
-
-        // Lock the file
-        data_file_spinlock.Lock();
-
-        // Check if within bounds
-        if (data_file_offset < data_file_len) {
-          cache_data_file_offset = data_file_offset;
-
-          // Offset by the requested size
-          data_file_offset += size;
-
-          // Unlock the file
-          data_file_spinlock.Unlock();
-
-          void *address = reinterpret_cast<char *>(data_file_address) +
-                          cache_data_file_offset;
-          return address;
-        }
-
-        data_file_spinlock.Unlock();
-        throw Exception("no more memory available: offset : " +
-                        std::to_string(data_file_offset) + " length : " +
-                        std::to_string(data_file_len));
-
-        return nullptr;
-      }
+      return AllocateMemory(size);
     } break;
 
     case BackendType::INVALID:
     default: {
-      throw Exception("invalid backend: " + std::to_string(data_file_len));
+      throw Exception("invalid backend: " + BackendTypeToString(type));
       return nullptr;
     }
   }
@@ -495,13 +483,10 @@ void *StorageManager::Allocate(BackendType type, size_t size) {
 void StorageManager::Release(BackendType type, void *address) {
   switch (type) {
     case BackendType::MM:
-    case BackendType::NVM: {
-      ::operator delete(address);
-    } break;
-
+    case BackendType::NVM:
     case BackendType::SSD:
     case BackendType::HDD: {
-      // Nothing to do here
+      ReleaseMemory(address);
     } break;
 
     case BackendType::INVALID:
@@ -512,9 +497,265 @@ void StorageManager::Release(BackendType type, void *address) {
   }
 }
 
+//===--------------------------------------------------------------------===//
+// HUGE PAGE SLABS
+//===--------------------------------------------------------------------===//
+
+// A huge page aligned region that allocations are carved from
+struct StorageManager::Slab {
+  char *base;
+
+  // bump offset of the next allocation
+  size_t offset;
+
+  // numa node of the arena that owns the slab
+  size_t numa_node;
+
+  // live allocations, plus one while the slab is the arena's current slab.
+  // guarded by the lock of the arena, like the counter below.
+  size_t reference_count;
+
+  // released ranges of the slab on the free list of the arena
+  size_t free_range_count;
+};
+
+// Precedes every allocation of the memory backends
+struct AllocationHeader {
+  // slab the allocation was carved from, or nullptr
+  void *slab;
+
+  // size of the dedicated mapping, or 0 if the allocation is on the heap
+  size_t mapped_size;
+
+  // size of the range carved from the slab, including this header
+  size_t range_size;
+};
+
+// keeps the allocations cache line aligned
+#define ALLOCATION_HEADER_SIZE 64
+
+static_assert(sizeof(AllocationHeader) <= ALLOCATION_HEADER_SIZE,
+              "allocation header does not fit");
+
+static inline size_t AlignUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+void *StorageManager::AllocateMemory(size_t size) {
+  size_t total_size = AlignUp(size + ALLOCATION_HEADER_SIZE, FLUSH_ALIGN);
+  char *address = nullptr;
+  AllocationHeader header = {nullptr, 0, 0};
+
+  if (size < MIN_SLAB_ALLOCATION_SIZE) {
+    // small allocations gain nothing from huge pages
+    address = reinterpret_cast<char *>(::operator new(total_size));
+  } else if (total_size > HUGE_PAGE_SIZE) {
+    // too large for a slab, so it gets huge pages of its own
+    header.mapped_size = AlignUp(total_size, HUGE_PAGE_SIZE);
+    address = reinterpret_cast<char *>(MapHugePages(header.mapped_size));
+  } else {
+    size_t numa_node = GetCurrentNumaNode();
+    auto &arena = numa_node_arenas[numa_node];
+    header.range_size = total_size;
+
+    arena.lock.Lock();
+
+    // reuse a released range of the same size, e.g. the tile of a tile
+    // group that was dropped by compaction
+    auto free_range_itr = arena.free_ranges.find(total_size);
+    if (free_range_itr != arena.free_ranges.end()) {
+      address = free_range_itr->second.back();
+      free_range_itr->second.pop_back();
+      if (free_range_itr->second.empty() == true) {
+        arena.free_ranges.erase(free_range_itr);
+      }
+
+      // the header of a released range still points to its slab
+      auto slab = reinterpret_cast<Slab *>(
+          reinterpret_cast<AllocationHeader *>(address)->slab);
+      slab->free_range_count--;
+      slab->reference_count++;
+      header.slab = slab;
+
+      arena.lock.Unlock();
+
+      *reinterpret_cast<AllocationHeader *>(address) = header;
+      return address + ALLOCATION_HEADER_SIZE;
+    }
+
+    if (arena.slab == nullptr ||
+        arena.slab->offset + total_size > HUGE_PAGE_SIZE) {
+      Slab *slab = nullptr;
+      try {
+        slab = new Slab();
+        slab->base = reinterpret_cast<char *>(MapHugePages(HUGE_PAGE_SIZE));
+      } catch (...) {
+        arena.lock.Unlock();
+        delete slab;
+        throw;
+      }
+      slab->offset = 0;
+      slab->numa_node = numa_node;
+      slab->reference_count = 1;
+      slab->free_range_count = 0;
+      slab_count++;
+
+      // the old slab is unmapped once its allocations are released
+      auto retired_slab = arena.slab;
+      arena.slab = slab;
+      if (retired_slab != nullptr) {
+        ReleaseSlab(retired_slab);
+      }
+    }
+
+    address = arena.slab->base + arena.slab->offset;
+    arena.slab->offset += total_size;
+    arena.slab->reference_count++;
+    header.slab = arena.slab;
+
+    arena.lock.Unlock();
+  }
+
+  *reinterpret_cast<AllocationHeader *>(address) = header;
+  return address + ALLOCATION_HEADER_SIZE;
+}
+
+void StorageManager::ReleaseMemory(void *address) {
+  if (address == nullptr) {
+    return;
+  }
+
+  char *allocation = reinterpret_cast<char *>(address) - ALLOCATION_HEADER_SIZE;
+  auto header = *reinterpret_cast<AllocationHeader *>(allocation);
+
+  if (header.slab != nullptr) {
+    auto slab = reinterpret_cast<Slab *>(header.slab);
+    auto &arena = numa_node_arenas[slab->numa_node];
+
+    arena.lock.Lock();
+    arena.free_ranges[header.range_size].push_back(allocation);
+    slab->free_range_count++;
+    ReleaseSlab(slab);
+    arena.lock.Unlock();
+  } else if (header.mapped_size != 0) {
+    UnmapHugePages(allocation, header.mapped_size);
+  } else {
+    ::operator delete(allocation);
+  }
+}
+
+void StorageManager::ReleaseSlab(Slab *slab) {
+  if (--slab->reference_count != 0) {
+    // the current slab is rewound once it holds no allocation
+    auto &arena = numa_node_arenas[slab->numa_node];
+    if (slab->reference_count == 1 && arena.slab == slab) {
+      RemoveFreeRanges(slab);
+      slab->offset = 0;
+    }
+    return;
+  }
+
+  RemoveFreeRanges(slab);
+  UnmapHugePages(slab->base, HUGE_PAGE_SIZE);
+  delete slab;
+  slab_count--;
+}
+
+void StorageManager::RemoveFreeRanges(Slab *slab) {
+  if (slab->free_range_count == 0) {
+    return;
+  }
+
+  auto &free_ranges = numa_node_arenas[slab->numa_node].free_ranges;
+  for (auto free_range_itr = free_ranges.begin();
+       free_range_itr != free_ranges.end();) {
+    auto &ranges = free_range_itr->second;
+    ranges.erase(std::remove_if(ranges.begin(), ranges.end(),
+                                [slab](char *range) {
+                                  return range >= slab->base &&
+                                         range < slab->base + HUGE_PAGE_SIZE;
+                                }),
+                 ranges.end());
+    if (ranges.empty() == true) {
+      free_range_itr = free_ranges.erase(free_range_itr);
+    } else {
+      ++free_range_itr;
+    }
+  }
+  slab->free_range_count = 0;
+}
+
+void *StorageManager::MapHugePages(size_t size) {
+  PL_ASSERT(size % HUGE_PAGE_SIZE == 0);
+
+#ifdef MAP_HUGETLB
+  // explicit huge pages are only available if the OS reserved some
+  if (huge_page_available == true) {
+    void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (address != MAP_FAILED) {
+      mapped_size += size;
+      return address;
+    }
+    LOG_TRACE("Could not map huge pages, falling back to transparent ones");
+    huge_page_available = false;
+  }
+#endif
+
+  // over-map, so that the region can be aligned to a huge page
+  size_t padded_size = size + HUGE_PAGE_SIZE;
+  void *padded_address = mmap(nullptr, padded_size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (padded_address == MAP_FAILED) {
+    throw Exception("could not map memory of size : " + std::to_string(size));
+  }
+
+  uintptr_t begin = reinterpret_cast<uintptr_t>(padded_address);
+  uintptr_t aligned_begin = AlignUp(begin, HUGE_PAGE_SIZE);
+  uintptr_t end = begin + padded_size;
+  uintptr_t aligned_end = aligned_begin + size;
+
+  if (aligned_begin != begin) {
+    munmap(padded_address, aligned_begin - begin);
+  }
+  if (end != aligned_end) {
+    munmap(reinterpret_cast<void *>(aligned_end), end - aligned_end);
+  }
+
+  void *address = reinterpret_cast<void *>(aligned_begin);
+
+#ifdef MADV_HUGEPAGE
+  // let the kernel back the region with transparent huge pages
+  madvise(address, size, MADV_HUGEPAGE);
+#endif
+
+  mapped_size += size;
+  return address;
+}
+
+void StorageManager::UnmapHugePages(void *address, size_t size) {
+  munmap(address, size);
+  mapped_size -= size;
+}
+
+size_t StorageManager::GetCurrentNumaNode() {
+  unsigned cpu = 0;
+  unsigned node = 0;
+
+#ifdef SYS_getcpu
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    node = 0;
+  }
+#endif
+
+  return node % MAX_NUMA_NODE_COUNT;
+}
+
 void StorageManager::Sync(BackendType type, void *address, size_t length) {
   switch (type) {
-    case BackendType::MM: {
+    case BackendType::MM:
+    case BackendType::SSD:
+    case BackendType::HDD: {
       // Nothing to do here
     } break;
 
@@ -525,18 +766,6 @@ void StorageManager::Sync(BackendType type, void *address, size_t length) {
       clflush_count++;
     } break;
 
-    case BackendType::SSD:
-    case BackendType::HDD: {
-      // sync the mmap'ed file to SSD or HDD
-      int status = msync(data_file_address, data_file_len, MS_SYNC);
-      if (status != 0) {
-        perror("msync");
-        exit(EXIT_FAILURE);
-      }
-
-      msync_count++;
-    } break;
-
     case BackendType::INVALID:
     default: {
       // Nothing to do here
@@ -18,7 +18,7 @@
 #include "common/macros.h"
 #include "type/serializer.h"
 #include "type/types.h"
-#include "type/ephemeral_pool.h"
+#include "type/arena_pool.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/storage_manager.h"
 #include "storage/tile.h"
@@ -53,28 +53,25 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
   tile_size = tuple_count * tuple_length;
 
   // allocate tuple storage space for inlined data
-  // auto &storage_manager = storage::StorageManager::GetInstance();
-  // data = reinterpret_cast<char *>(
-      // storage_manager.Allocate(backend_type, tile_size));
-
-  data = new char[tile_size];
+  auto &storage_manager = storage::StorageManager::GetInstance();
+  data = reinterpret_cast<char *>(
+      storage_manager.Allocate(backend_type, tile_size));
   PL_ASSERT(data != NULL);
 
-  // zero out the data
+  // zero out the data, which also places it on the numa node of this thread
   PL_MEMSET(data, 0, tile_size);
 
-  // allocate pool for blob storage if schema not inlined
+  // allocate pool for blob storage if schema not inlined.
+  // its chunks are only taken once a varlen value is stored.
   // if (schema.IsInlined() == false) {
-  pool = new type::EphemeralPool();
+  pool = new type::ArenaPool();
   //}
 }
 
 Tile::~Tile() {
   // reclaim the tile memory (INLINED data)
-  // auto &storage_manager = storage::StorageManager::GetInstance();
-  // storage_manager.Release(backend_type, data);
-
-  delete[] data;
+  auto &storage_manager = storage::StorageManager::GetInstance();
+  storage_manager.Release(backend_type, data);
   data = NULL;
 
   // reclaim the tile memory (UNINLINED data)
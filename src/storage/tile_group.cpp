@@ -23,6 +23,7 @@
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace storage {
@@ -30,7 +31,8 @@ namespace storage {
 TileGroup::TileGroup(BackendType backend_type,
                      TileGroupHeader *tile_group_header, AbstractTable *table,
                      const std::vector<catalog::Schema> &schemas,
-                     const column_map_type &column_map, int tuple_count)
+                     const std::shared_ptr<const TileGroupLayout> &layout,
+                     int tuple_count)
     : database_id(INVALID_OID),
       table_id(INVALID_OID),
       tile_group_id(INVALID_OID),
@@ -39,7 +41,7 @@ TileGroup::TileGroup(BackendType backend_type,
       tile_group_header(tile_group_header),
       table(table),
       num_tuple_slots(tuple_count),
-      column_map(column_map) {
+      layout(layout) {
   tile_count = tile_schemas.size();
 
   for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
@@ -53,6 +55,8 @@ TileGroup::TileGroup(BackendType backend_type,
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
   }
+
+  zone_map.reset(new ZoneMap(this));
 }
 
 TileGroup::~TileGroup() {
@@ -121,6 +125,8 @@ void TileGroup::CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id) {
       column_itr++;
     }
   }
+
+  zone_map->UpdateTuple(tuple);
 }
 
 /**
@@ -205,6 +211,8 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
     }
   }
 
+  zone_map->UpdateTuple(tuple);
+
   // Set MVCC info
   tile_group_header->SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
   tile_group_header->SetBeginCommitId(tuple_slot_id, commit_id);
@@ -305,6 +313,8 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
     }
   }
 
+  zone_map->UpdateTuple(tuple);
+
   // Set MVCC info
   tile_group_header->SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
   tile_group_header->SetBeginCommitId(tuple_slot_id, commit_id);
@@ -339,6 +349,7 @@ void TileGroup::SetValue(type::Value &value, oid_t tuple_id,
   oid_t tile_column_id, tile_offset;
   LocateTileAndColumn(column_id, tile_offset, tile_column_id);
   GetTile(tile_offset)->SetValue(value, tuple_id, tile_column_id);
+  zone_map->UpdateValue(column_id, value);
 }
 
 
@@ -351,6 +362,7 @@ std::shared_ptr<Tile> TileGroup::GetTileReference(
 double TileGroup::GetSchemaDifference(
     const storage::column_map_type &new_column_map) {
   double theta = 0;
+  auto &column_map = layout->GetColumnMap();
   size_t capacity = column_map.size();
   double diff = 0;
 
@@ -28,13 +28,23 @@ TileGroup *TileGroupFactory::GetTileGroup(
     oid_t database_id, oid_t table_id, oid_t tile_group_id,
     AbstractTable *table, const std::vector<catalog::Schema> &schemas,
     const column_map_type &column_map, int tuple_count) {
+  std::shared_ptr<const TileGroupLayout> layout(
+      new TileGroupLayout(column_map));
+  return GetTileGroup(database_id, table_id, tile_group_id, table, schemas,
+                      layout, tuple_count);
+}
+
+TileGroup *TileGroupFactory::GetTileGroup(
+    oid_t database_id, oid_t table_id, oid_t tile_group_id,
+    AbstractTable *table, const std::vector<catalog::Schema> &schemas,
+    const std::shared_ptr<const TileGroupLayout> &layout, int tuple_count) {
   // Allocate the data on appropriate backend
   BackendType backend_type = BackendType::MM;
       // logging::LoggingUtil::GetBackendType(peloton_logging_mode);
 
   TileGroupHeader *tile_header = new TileGroupHeader(backend_type, tuple_count);
   TileGroup *tile_group = new TileGroup(backend_type, tile_header, table,
-                                        schemas, column_map, tuple_count);
+                                        schemas, layout, tuple_count);
 
   tile_header->SetTileGroup(tile_group);
 
@@ -35,17 +35,19 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
       data(nullptr),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0),
-      tile_header_lock() {
+      tile_header_lock(),
+      compacting(false),
+      freeze_state(NOT_FROZEN),
+      delta_pointer_array(nullptr) {
   header_size = num_tuple_slots * header_entry_size;
 
   // allocate storage space for header
-  // auto &storage_manager = storage::StorageManager::GetInstance();
-  // data = reinterpret_cast<char *>(
-      // storage_manager.Allocate(backend_type, header_size));
-  data = new char[header_size];
+  auto &storage_manager = storage::StorageManager::GetInstance();
+  data = reinterpret_cast<char *>(
+      storage_manager.Allocate(backend_type, header_size));
   PL_ASSERT(data != nullptr);
 
-  // zero out the data
+  // zero out the data, which also places it on the numa node of this thread
   PL_MEMSET(data, 0, header_size);
 
   // Set MVCC Initial Value
@@ -61,10 +63,23 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
 
 TileGroupHeader::~TileGroupHeader() {
   // reclaim the space
-  // auto &storage_manager = storage::StorageManager::GetInstance();
-  // storage_manager.Release(backend_type, data);
-  delete[] data;
+  auto &storage_manager = storage::StorageManager::GetInstance();
+  storage_manager.Release(backend_type, data);
   data = nullptr;
+
+  delete[] delta_pointer_array.load();
+}
+
+DeltaRecord **TileGroupHeader::AllocateDeltaPointers() {
+  DeltaRecord **delta_pointers = new DeltaRecord *[num_tuple_slots]();
+
+  DeltaRecord **expected = nullptr;
+  if (delta_pointer_array.compare_exchange_strong(expected, delta_pointers) ==
+      false) {
+    delete[] delta_pointers;
+    return expected;
+  }
+  return delta_pointers;
 }
 
 //===--------------------------------------------------------------------===//
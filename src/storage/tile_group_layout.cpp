@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_layout.cpp
+//
+// Identification: src/storage/tile_group_layout.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tile_group_layout.h"
+
+namespace peloton {
+namespace storage {
+
+TileGroupLayout::TileGroupLayout(const column_map_type &column_map)
+    : column_map_(column_map) {
+  if (column_map_.empty() == true) {
+    return;
+  }
+
+  // the map is ordered, so its last entry has the largest column offset
+  oid_t column_offset_count = column_map_.rbegin()->first + 1;
+  column_locations_.resize(column_offset_count, {INVALID_OID, INVALID_OID});
+
+  for (auto &entry : column_map_) {
+    column_locations_[entry.first] = {entry.second.first, entry.second.second};
+  }
+}
+
+}  // End storage namespace
+}  // End peloton namespace
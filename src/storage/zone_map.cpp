@@ -0,0 +1,538 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.cpp
+//
+// Identification: src/storage/zone_map.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/zone_map.h"
+
+#include "common/abstract_tuple.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+ZoneMap::ZoneMap(TileGroup *tile_group)
+    : tile_group_(tile_group),
+      column_count_(tile_group->GetColumnMap().size()),
+      synopses_(new ColumnSynopsis[column_count_]),
+      has_tracked_columns_(false),
+      is_invalid_(false) {
+  for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+    oid_t tile_offset, tile_column_id;
+    tile_group->LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+    auto type_id =
+        tile_group->GetTile(tile_offset)->GetSchema()->GetType(tile_column_id);
+    auto &synopsis = synopses_[column_id];
+    synopsis.type_id = type_id;
+    synopsis.is_tracked = IsTracked(type_id);
+    synopsis.is_varlen = (type_id == type::Type::VARCHAR);
+    synopsis.min_word = INT64_MAX;
+    synopsis.max_word = INT64_MIN;
+    synopsis.null_count = 0;
+    has_tracked_columns_ |= synopsis.is_tracked;
+  }
+}
+
+void ZoneMap::UpdateValue(const oid_t &column_id, const type::Value &value) {
+  PL_ASSERT(column_id < column_count_);
+  auto &synopsis = synopses_[column_id];
+  if (synopsis.is_tracked == false) {
+    return;
+  }
+
+  Widen(synopsis, value);
+}
+
+void ZoneMap::UpdateTuple(const AbstractTuple *tuple) {
+  if (has_tracked_columns_ == false) {
+    return;
+  }
+
+  for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+    auto &synopsis = synopses_[column_id];
+    if (synopsis.is_tracked == true) {
+      Widen(synopsis, tuple->GetValue(column_id));
+    }
+  }
+}
+
+void ZoneMap::Widen(ColumnSynopsis &synopsis, const type::Value &value) {
+  if (value.IsNull() == true) {
+    synopsis.null_count++;
+    return;
+  }
+
+  if (synopsis.is_varlen == true) {
+    zone_map_lock_.Lock();
+    try {
+      if (value.GetTypeId() != synopsis.type_id) {
+        WidenVarlenBounds(synopsis, value.CastAs(synopsis.type_id));
+      } else {
+        WidenVarlenBounds(synopsis, value);
+      }
+    } catch (Exception &) {
+      // the varlen slots are never read back, so the column can no longer
+      // be bounded
+      synopsis.is_unbounded = true;
+    }
+    zone_map_lock_.Unlock();
+    return;
+  }
+
+  int64_t word;
+  try {
+    word = GetOrderedWord(synopsis.type_id, value);
+  } catch (Exception &) {
+    // a value that does not cast to the type of the column is covered once
+    // the synopses are rebuilt from the slots
+    Invalidate();
+    return;
+  }
+
+  int64_t min_word = synopsis.min_word.load();
+  while (word < min_word &&
+         synopsis.min_word.compare_exchange_weak(min_word, word) == false) {
+  }
+  int64_t max_word = synopsis.max_word.load();
+  while (word > max_word &&
+         synopsis.max_word.compare_exchange_weak(max_word, word) == false) {
+  }
+}
+
+void ZoneMap::WidenVarlenBounds(ColumnSynopsis &synopsis,
+                                const type::Value &value) {
+  // the bounds own their bytes, as the slot of the value may be reclaimed
+  // and its varlen storage freed by the GC
+  if (synopsis.has_values == false) {
+    synopsis.min_value = GetOwnedValue(value);
+    synopsis.max_value = GetOwnedValue(value);
+    synopsis.has_values = true;
+  } else if (value.CompareLessThan(synopsis.min_value) == type::CMP_TRUE) {
+    synopsis.min_value = GetOwnedValue(value);
+  } else if (value.CompareGreaterThan(synopsis.max_value) == type::CMP_TRUE) {
+    synopsis.max_value = GetOwnedValue(value);
+  }
+}
+
+type::Value ZoneMap::GetOwnedValue(const type::Value &value) {
+  return type::ValueFactory::GetVarcharValue(value.GetData(),
+                                             value.GetLength(), true);
+}
+
+void ZoneMap::Merge(ZoneMap *other) {
+  PL_ASSERT(other->column_count_ == column_count_);
+
+  // take a copy of the synopses of the other zone map before widening ours,
+  // so that the two locks are never held together
+  std::vector<type::Value> min_values(column_count_), max_values(column_count_);
+  std::vector<size_t> null_counts(column_count_, 0);
+  other->zone_map_lock_.Lock();
+  other->RebuildIfStale();
+  for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+    auto &synopsis = other->synopses_[column_id];
+    if (synopsis.is_tracked == false) {
+      continue;
+    }
+    null_counts[column_id] = synopsis.null_count;
+    if (other->HasValues(synopsis) == true) {
+      min_values[column_id] = other->GetMinValue(synopsis).Copy();
+      max_values[column_id] = other->GetMaxValue(synopsis).Copy();
+    }
+  }
+  other->zone_map_lock_.Unlock();
+
+  for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+    auto &synopsis = synopses_[column_id];
+    if (synopsis.is_tracked == false) {
+      continue;
+    }
+    synopsis.null_count += null_counts[column_id];
+    if (min_values[column_id].IsNull() == false) {
+      Widen(synopsis, min_values[column_id]);
+      Widen(synopsis, max_values[column_id]);
+    }
+  }
+}
+
+void ZoneMap::Rebuild() {
+  for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+    auto &synopsis = synopses_[column_id];
+    if (synopsis.is_varlen == false) {
+      synopsis.min_word = INT64_MAX;
+      synopsis.max_word = INT64_MIN;
+      synopsis.null_count = 0;
+    }
+  }
+
+  // every claimed slot is covered, as a transaction may be about to write it.
+  // the slots of the varlen columns are never read back, since the GC frees
+  // the values of reclaimed slots and leaves their pointers behind. their
+  // bounds were widened with owned copies on the write path instead.
+  oid_t tuple_count = tile_group_->GetNextTupleSlot();
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+      auto &synopsis = synopses_[column_id];
+      if (synopsis.is_tracked == true && synopsis.is_varlen == false) {
+        Widen(synopsis, tile_group_->GetValue(tuple_id, column_id));
+      }
+    }
+  }
+
+  LOG_TRACE("Rebuilt zone map of tile group : %u ",
+            tile_group_->GetTileGroupId());
+}
+
+void ZoneMap::RebuildIfStale() {
+  if (is_invalid_ == true) {
+    is_invalid_ = false;
+    Rebuild();
+  }
+}
+
+bool ZoneMap::MayMatch(const std::vector<ZoneMapPredicate> &predicates) {
+  bool may_match = true;
+
+  zone_map_lock_.Lock();
+
+  RebuildIfStale();
+
+  for (auto &predicate : predicates) {
+    if (predicate.column_id >= column_count_) {
+      continue;
+    }
+    auto &synopsis = synopses_[predicate.column_id];
+    if (synopsis.is_tracked == true && MayMatch(synopsis, predicate) == false) {
+      may_match = false;
+      break;
+    }
+  }
+
+  zone_map_lock_.Unlock();
+
+  return may_match;
+}
+
+bool ZoneMap::MayMatch(const ColumnSynopsis &synopsis,
+                       const ZoneMapPredicate &predicate) const {
+  if (predicate.comparison_type == ExpressionType::OPERATOR_IS_NULL) {
+    return synopsis.null_count > 0;
+  }
+
+  if (synopsis.is_unbounded == true) {
+    return true;
+  }
+
+  // a comparison with null is never true
+  if (HasValues(synopsis) == false || predicate.value.IsNull() == true) {
+    return false;
+  }
+
+  if (IsComparable(synopsis.type_id, predicate.value.GetTypeId()) == false) {
+    return true;
+  }
+
+  // the bounds of fixed width columns are decoded from their words
+  type::Value fixed_min_value, fixed_max_value;
+  if (synopsis.is_varlen == false) {
+    fixed_min_value = GetMinValue(synopsis);
+    fixed_max_value = GetMaxValue(synopsis);
+  }
+
+  auto &value = predicate.value;
+  auto &min_value =
+      (synopsis.is_varlen == true) ? synopsis.min_value : fixed_min_value;
+  auto &max_value =
+      (synopsis.is_varlen == true) ? synopsis.max_value : fixed_max_value;
+
+  switch (predicate.comparison_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return min_value.CompareLessThanEquals(value) == type::CMP_TRUE &&
+             max_value.CompareGreaterThanEquals(value) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_LESSTHAN:
+      return min_value.CompareLessThan(value) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return min_value.CompareLessThanEquals(value) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return max_value.CompareGreaterThan(value) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return max_value.CompareGreaterThanEquals(value) == type::CMP_TRUE;
+    default:
+      return true;
+  }
+}
+
+void ZoneMap::GetPredicates(const expression::AbstractExpression *predicate,
+                            const std::vector<type::Value> *params,
+                            std::vector<ZoneMapPredicate> &predicates) {
+  if (predicate == nullptr) {
+    return;
+  }
+
+  auto expression_type = predicate->GetExpressionType();
+
+  if (expression_type == ExpressionType::CONJUNCTION_AND) {
+    for (size_t child_itr = 0; child_itr < predicate->GetChildrenSize();
+         child_itr++) {
+      GetPredicates(predicate->GetChild(child_itr), params, predicates);
+    }
+    return;
+  }
+
+  if (expression_type == ExpressionType::OPERATOR_IS_NULL) {
+    auto child = predicate->GetChild(0);
+    if (child != nullptr &&
+        child->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto tuple_value =
+          static_cast<const expression::TupleValueExpression *>(child);
+      if (tuple_value->GetTupleId() == 0 && tuple_value->GetColumnId() >= 0) {
+        predicates.push_back({static_cast<oid_t>(tuple_value->GetColumnId()),
+                              expression_type, type::Value()});
+      }
+    }
+    return;
+  }
+
+  switch (expression_type) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return;
+  }
+
+  if (predicate->GetChildrenSize() != 2) {
+    return;
+  }
+
+  auto left = predicate->GetChild(0);
+  auto right = predicate->GetChild(1);
+
+  // normalize to <column> <comparison> <value>
+  if (right->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    std::swap(left, right);
+    switch (expression_type) {
+      case ExpressionType::COMPARE_LESSTHAN:
+        expression_type = ExpressionType::COMPARE_GREATERTHAN;
+        break;
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        expression_type = ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+        break;
+      case ExpressionType::COMPARE_GREATERTHAN:
+        expression_type = ExpressionType::COMPARE_LESSTHAN;
+        break;
+      case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        expression_type = ExpressionType::COMPARE_LESSTHANOREQUALTO;
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (left->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    return;
+  }
+
+  auto tuple_value = static_cast<const expression::TupleValueExpression *>(left);
+  if (tuple_value->GetTupleId() != 0 || tuple_value->GetColumnId() < 0) {
+    return;
+  }
+
+  type::Value value;
+  if (right->GetExpressionType() == ExpressionType::VALUE_CONSTANT) {
+    value = static_cast<const expression::ConstantValueExpression *>(right)
+                ->GetValue();
+  } else if (right->GetExpressionType() == ExpressionType::VALUE_PARAMETER &&
+             params != nullptr) {
+    auto value_idx =
+        static_cast<const expression::ParameterValueExpression *>(right)
+            ->GetValueIdx();
+    if (value_idx < 0 || static_cast<size_t>(value_idx) >= params->size()) {
+      return;
+    }
+    value = params->at(value_idx);
+  } else {
+    return;
+  }
+
+  predicates.push_back({static_cast<oid_t>(tuple_value->GetColumnId()),
+                        expression_type, value.Copy()});
+}
+
+bool ZoneMap::HasValues(const oid_t &column_id) {
+  zone_map_lock_.Lock();
+  RebuildIfStale();
+  bool has_values = HasValues(synopses_[column_id]);
+  zone_map_lock_.Unlock();
+  return has_values;
+}
+
+type::Value ZoneMap::GetMinValue(const oid_t &column_id) {
+  zone_map_lock_.Lock();
+  RebuildIfStale();
+  auto min_value = GetMinValue(synopses_[column_id]);
+  zone_map_lock_.Unlock();
+  return min_value;
+}
+
+type::Value ZoneMap::GetMaxValue(const oid_t &column_id) {
+  zone_map_lock_.Lock();
+  RebuildIfStale();
+  auto max_value = GetMaxValue(synopses_[column_id]);
+  zone_map_lock_.Unlock();
+  return max_value;
+}
+
+size_t ZoneMap::GetNullCount(const oid_t &column_id) {
+  zone_map_lock_.Lock();
+  RebuildIfStale();
+  size_t null_count = synopses_[column_id].null_count;
+  zone_map_lock_.Unlock();
+  return null_count;
+}
+
+bool ZoneMap::HasValues(const ColumnSynopsis &synopsis) const {
+  if (synopsis.is_varlen == true) {
+    return synopsis.has_values;
+  }
+  return synopsis.min_word.load() <= synopsis.max_word.load();
+}
+
+type::Value ZoneMap::GetMinValue(const ColumnSynopsis &synopsis) const {
+  if (synopsis.is_varlen == true) {
+    return synopsis.min_value;
+  }
+  if (HasValues(synopsis) == false) {
+    return type::Value();
+  }
+  return GetOrderedValue(synopsis.type_id, synopsis.min_word.load());
+}
+
+type::Value ZoneMap::GetMaxValue(const ColumnSynopsis &synopsis) const {
+  if (synopsis.is_varlen == true) {
+    return synopsis.max_value;
+  }
+  if (HasValues(synopsis) == false) {
+    return type::Value();
+  }
+  return GetOrderedValue(synopsis.type_id, synopsis.max_word.load());
+}
+
+bool ZoneMap::IsTracked(const type::Type::TypeId &type_id) {
+  switch (type_id) {
+    case type::Type::TINYINT:
+    case type::Type::SMALLINT:
+    case type::Type::INTEGER:
+    case type::Type::BIGINT:
+    case type::Type::DECIMAL:
+    case type::Type::TIMESTAMP:
+    case type::Type::DATE:
+    case type::Type::VARCHAR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int64_t ZoneMap::GetOrderedWord(const type::Type::TypeId &type_id,
+                                const type::Value &value) {
+  if (value.GetTypeId() != type_id) {
+    return GetOrderedWord(type_id, value.CastAs(type_id));
+  }
+
+  switch (type_id) {
+    case type::Type::TINYINT:
+      return value.GetAs<int8_t>();
+    case type::Type::SMALLINT:
+      return value.GetAs<int16_t>();
+    case type::Type::INTEGER:
+      return value.GetAs<int32_t>();
+    case type::Type::BIGINT:
+      return value.GetAs<int64_t>();
+    case type::Type::DATE:
+      return value.GetAs<uint32_t>();
+    case type::Type::TIMESTAMP:
+      return static_cast<int64_t>(value.GetAs<uint64_t>());
+    case type::Type::DECIMAL: {
+      // the bits of doubles order like signed integers once the ones below
+      // the sign bit of negative doubles are flipped
+      double number = value.GetAs<double>();
+      int64_t word;
+      PL_MEMCPY(&word, &number, sizeof(word));
+      return (word < 0) ? (word ^ INT64_MAX) : word;
+    }
+    default:
+      throw UnknownTypeException(static_cast<int>(type_id),
+                                 "Value has no fixed width bounds");
+  }
+}
+
+type::Value ZoneMap::GetOrderedValue(const type::Type::TypeId &type_id,
+                                     const int64_t &word) {
+  switch (type_id) {
+    case type::Type::TINYINT:
+      return type::ValueFactory::GetTinyIntValue(static_cast<int8_t>(word));
+    case type::Type::SMALLINT:
+      return type::ValueFactory::GetSmallIntValue(static_cast<int16_t>(word));
+    case type::Type::INTEGER:
+      return type::ValueFactory::GetIntegerValue(static_cast<int32_t>(word));
+    case type::Type::BIGINT:
+      return type::ValueFactory::GetBigIntValue(word);
+    case type::Type::DATE:
+      return type::ValueFactory::GetDateValue(static_cast<uint32_t>(word));
+    case type::Type::TIMESTAMP:
+      return type::ValueFactory::GetTimestampValue(
+          static_cast<uint64_t>(word));
+    case type::Type::DECIMAL: {
+      int64_t bits = (word < 0) ? (word ^ INT64_MAX) : word;
+      double number;
+      PL_MEMCPY(&number, &bits, sizeof(number));
+      return type::ValueFactory::GetDecimalValue(number);
+    }
+    default:
+      throw UnknownTypeException(static_cast<int>(type_id),
+                                 "Value has no fixed width bounds");
+  }
+}
+
+bool ZoneMap::IsComparable(const type::Type::TypeId &column_type_id,
+                           const type::Type::TypeId &value_type_id) {
+  if (column_type_id == value_type_id) {
+    return IsTracked(column_type_id);
+  }
+
+  auto is_numeric = [](const type::Type::TypeId &type_id) {
+    switch (type_id) {
+      case type::Type::TINYINT:
+      case type::Type::SMALLINT:
+      case type::Type::INTEGER:
+      case type::Type::BIGINT:
+      case type::Type::DECIMAL:
+        return true;
+      default:
+        return false;
+    }
+  };
+
+  return is_numeric(column_type_id) && is_numeric(value_type_id);
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,214 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena_pool.cpp
+//
+// Identification: src/type/arena_pool.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/arena_pool.h"
+
+#include <cstdint>
+#include <new>
+
+#include "common/macros.h"
+
+namespace peloton {
+namespace type {
+
+// keeps the length prefix of varlen values aligned
+#define ARENA_ALIGNMENT 8
+
+// every value is prefixed with its size, including the prefix
+#define ARENA_HEADER_SIZE ARENA_ALIGNMENT
+
+namespace {
+
+struct ArenaHeader {
+  uint32_t size;
+
+  // slots sharing the value, e.g. the entries of a frozen tile dictionary
+  std::atomic<uint32_t> ref_count;
+};
+
+static_assert(sizeof(ArenaHeader) <= ARENA_HEADER_SIZE,
+              "arena header does not fit in its prefix");
+
+ArenaHeader *GetHeader(void *ptr) {
+  return reinterpret_cast<ArenaHeader *>(static_cast<char *>(ptr) -
+                                         ARENA_HEADER_SIZE);
+}
+
+char *InitHeader(char *location, const size_t &size) {
+  PL_ASSERT(size <= UINT32_MAX);
+  auto header = new (location) ArenaHeader();
+  header->size = static_cast<uint32_t>(size);
+  header->ref_count = 1;
+  return location + ARENA_HEADER_SIZE;
+}
+
+}  // namespace
+
+ArenaPool::ArenaPool(const size_t &chunk_size)
+    : chunk_size_(chunk_size),
+      chunk_alignment_(sizeof(Chunk *)),
+      current_chunk_(nullptr),
+      allocated_size_(0) {
+  while (chunk_alignment_ < chunk_size_) {
+    chunk_alignment_ <<= 1;
+  }
+}
+
+ArenaPool::~ArenaPool() {
+  pool_lock_.Lock();
+  for (auto location : large_locations_) {
+    delete[] location;
+  }
+  large_locations_.clear();
+  free_chunks_.clear();
+  chunks_.clear();
+  pool_lock_.Unlock();
+}
+
+void *ArenaPool::Allocate(size_t size) {
+  size = (size + ARENA_HEADER_SIZE + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT *
+         ARENA_ALIGNMENT;
+
+  // large values would waste most of a chunk
+  if (size > chunk_size_ / 4) {
+    auto location = new char[size];
+
+    pool_lock_.Lock();
+    large_locations_.insert(location);
+    pool_lock_.Unlock();
+
+    allocated_size_ += size;
+    return InitHeader(location, size);
+  }
+
+  while (true) {
+    Chunk *chunk = current_chunk_.load();
+    if (chunk != nullptr) {
+      // counted before the space is claimed, so that a chunk is never
+      // recycled while a value is being carved from it
+      chunk->used_size += size;
+      size_t offset = chunk->offset.fetch_add(size);
+      if (offset + size <= chunk_size_) {
+        return InitHeader(chunk->data + offset, size);
+      }
+      chunk->used_size -= size;
+    }
+
+    AddChunk(chunk);
+  }
+}
+
+void ArenaPool::Free(void *ptr) {
+  auto header = GetHeader(ptr);
+
+  // other owners still use the value
+  if (header->ref_count.fetch_sub(1) != 1) {
+    return;
+  }
+
+  char *location = reinterpret_cast<char *>(header);
+  size_t size = header->size;
+
+  if (size > chunk_size_ / 4) {
+    pool_lock_.Lock();
+    auto erased_count = large_locations_.erase(location);
+    pool_lock_.Unlock();
+
+    if (erased_count != 0) {
+      delete[] location;
+    }
+    return;
+  }
+
+  // a chunk can only be recycled by the free of its last value. an
+  // allocation that raced with it recycles the chunk once it is replaced.
+  Chunk *chunk = GetChunk(location);
+  if (chunk->freed_size.fetch_add(size) + size != chunk->used_size.load()) {
+    return;
+  }
+
+  pool_lock_.Lock();
+  RecycleChunk(chunk);
+  pool_lock_.Unlock();
+}
+
+void ArenaPool::AddReference(void *ptr) { GetHeader(ptr)->ref_count++; }
+
+size_t ArenaPool::GetChunkCount() const {
+  pool_lock_.Lock();
+  size_t chunk_count = chunks_.size();
+  pool_lock_.Unlock();
+  return chunk_count;
+}
+
+size_t ArenaPool::GetFreeChunkCount() const {
+  pool_lock_.Lock();
+  size_t chunk_count = free_chunks_.size();
+  pool_lock_.Unlock();
+  return chunk_count;
+}
+
+void ArenaPool::AddChunk(Chunk *full_chunk) {
+  pool_lock_.Lock();
+
+  if (current_chunk_.load() == full_chunk) {
+    Chunk *chunk;
+    if (free_chunks_.empty() == false) {
+      chunk = free_chunks_.back();
+      free_chunks_.pop_back();
+      chunk->is_free = false;
+      chunk->offset = 0;
+    } else {
+      void *data = nullptr;
+      if (posix_memalign(&data, chunk_alignment_,
+                         chunk_size_ + sizeof(Chunk *)) != 0) {
+        pool_lock_.Unlock();
+        throw std::bad_alloc();
+      }
+      chunks_.emplace_back(new Chunk(static_cast<char *>(data)));
+      chunk = chunks_.back().get();
+      *reinterpret_cast<Chunk **>(chunk->data + chunk_size_) = chunk;
+      allocated_size_ += chunk_size_;
+    }
+    current_chunk_ = chunk;
+  }
+
+  // the values of the full chunk may all have been freed in the meantime
+  if (full_chunk != nullptr) {
+    RecycleChunk(full_chunk);
+  }
+
+  pool_lock_.Unlock();
+}
+
+ArenaPool::Chunk *ArenaPool::GetChunk(const char *location) const {
+  // a value lies in the first chunk size bytes of its chunk, which starts at
+  // the alignment boundary below it
+  auto data = reinterpret_cast<const char *>(
+      reinterpret_cast<uintptr_t>(location) & ~(chunk_alignment_ - 1));
+  return *reinterpret_cast<Chunk *const *>(data + chunk_size_);
+}
+
+void ArenaPool::RecycleChunk(Chunk *chunk) {
+  // the offset of a replaced chunk stays past its end until it is reused,
+  // so no value is carved from a chunk in the free list
+  if (chunk == current_chunk_.load() || chunk->is_free == true ||
+      chunk->freed_size.load() != chunk->used_size.load()) {
+    return;
+  }
+
+  chunk->is_free = true;
+  free_chunks_.push_back(chunk);
+}
+
+}  // namespace type
+}  // namespace peloton
@@ -1241,6 +1241,9 @@ std::string JoinTypeToString(JoinType type) {
     case JoinType::SEMI: {
       return "SEMI";
     }
+    case JoinType::ANTI: {
+      return "ANTI";
+    }
     default: {
       throw ConversionException(
           StringUtil::Format("No string conversion for JoinType value '%d'",
@@ -1264,6 +1267,8 @@ JoinType StringToJoinType(const std::string& str) {
     return JoinType::OUTER;
   } else if (upper_str == "SEMI") {
     return JoinType::SEMI;
+  } else if (upper_str == "ANTI") {
+    return JoinType::ANTI;
   } else {
     throw ConversionException(StringUtil::Format(
         "No JoinType conversion from string '%s'", upper_str.c_str()));
@@ -2091,6 +2096,9 @@ std::string GarbageCollectionTypeToString(GarbageCollectionType type) {
     case GarbageCollectionType::ON: {
       return "ON";
     }
+    case GarbageCollectionType::COOPERATIVE: {
+      return "COOPERATIVE";
+    }
     default: {
       throw ConversionException(
           StringUtil::Format("No string conversion for GarbageCollectionType value '%d'",
@@ -2108,6 +2116,8 @@ GarbageCollectionType StringToGarbageCollectionType(const std::string &str) {
     return GarbageCollectionType::OFF;
   } else if (upper_str == "ON") {
     return GarbageCollectionType::ON;
+  } else if (upper_str == "COOPERATIVE") {
+    return GarbageCollectionType::COOPERATIVE;
   } else {
     throw ConversionException(StringUtil::Format(
         "No GarbageCollectionType conversion from string '%s'", upper_str.c_str()));
@@ -2120,6 +2130,50 @@ std::ostream& operator<<(std::ostream& os, const GarbageCollectionType& type) {
   return os;
 }
 
+//===--------------------------------------------------------------------===//
+// Version Storage Types
+//===--------------------------------------------------------------------===//
+
+std::string VersionStorageTypeToString(VersionStorageType type) {
+  switch (type) {
+    case VersionStorageType::INVALID: {
+      return "INVALID";
+    }
+    case VersionStorageType::TUPLE: {
+      return "TUPLE";
+    }
+    case VersionStorageType::DELTA: {
+      return "DELTA";
+    }
+    default: {
+      throw ConversionException(
+          StringUtil::Format("No string conversion for VersionStorageType value '%d'",
+                             static_cast<int>(type)));
+    }
+  }
+  return "INVALID";
+}
+
+VersionStorageType StringToVersionStorageType(const std::string &str) {
+  std::string upper_str = StringUtil::Upper(str);
+  if (upper_str == "INVALID") {
+    return VersionStorageType::INVALID;
+  } else if (upper_str == "TUPLE") {
+    return VersionStorageType::TUPLE;
+  } else if (upper_str == "DELTA") {
+    return VersionStorageType::DELTA;
+  } else {
+    throw ConversionException(StringUtil::Format(
+        "No VersionStorageType conversion from string '%s'", upper_str.c_str()));
+  }
+  return VersionStorageType::INVALID;
+}
+
+std::ostream& operator<<(std::ostream& os, const VersionStorageType& type) {
+  os << VersionStorageTypeToString(type);
+  return os;
+}
+
 //===--------------------------------------------------------------------===//
 // LoggingType - String Utilities
 //===--------------------------------------------------------------------===//
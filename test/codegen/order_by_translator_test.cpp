@@ -14,6 +14,7 @@
 #include "common/harness.h"
 #include "planner/order_by_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "type/value_factory.h"
 
 #include "codegen/codegen_test_util.h"
 
@@ -206,5 +207,45 @@ TEST_F(OrderByTranslatorTest, MultiIntColMixedTest) {
       }));
 }
 
+TEST_F(OrderByTranslatorTest, SingleIntColDescLimitTest) {
+  //
+  // SELECT * FROM test_table ORDER BY a DESC LIMIT 5 OFFSET 2;
+  //
+
+  // Load table with 20 rows
+  uint32_t num_test_rows = 20;
+  LoadTestTable(TestTableId(), num_test_rows);
+
+  std::unique_ptr<planner::OrderByPlan> order_by_plan{
+      new planner::OrderByPlan({0}, {true}, {0, 1, 2, 3})};
+  order_by_plan->SetLimit(true);
+  order_by_plan->SetLimitNumber(5);
+  order_by_plan->SetLimitOffset(2);
+  std::unique_ptr<planner::SeqScanPlan> seq_scan_plan{new planner::SeqScanPlan(
+      &GetTestTable(TestTableId()), nullptr, {0, 1, 2, 3})};
+
+  order_by_plan->AddChild(std::move(seq_scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  order_by_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(*order_by_plan, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  // Only the first offset + limit rows are kept, in descending order
+  auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(7U, results.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    auto expected = type::ValueFactory::GetIntegerValue(
+        TestingExecutorUtil::PopulatedValue(num_test_rows - 1 - i, 0));
+    EXPECT_EQ(type::CMP_TRUE, results[i].GetValue(0).CompareEquals(expected));
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
\ No newline at end of file
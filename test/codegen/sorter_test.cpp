@@ -10,11 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "common/harness.h"
 #include "common/timer.h"
 #include "codegen/utils/sorter.h"
+#include "executor/executor_context.h"
 
 namespace peloton {
 namespace test {
@@ -27,9 +29,10 @@ struct TestTuple {
   uint32_t col_d;
 };
 
-// The comparison function for TestTuples. We sort on column B.
+// The comparison function for TestTuples. We sort on column B in descending
+// order.
 static int CompareTuples(const TestTuple *a, const TestTuple *b) {
-  return a->col_b < b->col_b;
+  return a->col_b > b->col_b ? -1 : (a->col_b < b->col_b ? 1 : 0);
 }
 
 class SorterTest : public PelotonTest {
@@ -73,17 +76,19 @@ class SorterTest : public PelotonTest {
     LOG_INFO("Sorting %lu tuples took %.2f ms", num_tuples_to_insert,
              timer.GetDuration());
 
-    // Check sorted results
+    // Check sorted results, one batch at a time
     uint64_t res_tuples = 0;
     uint32_t last_col_b = std::numeric_limits<uint32_t>::max();
-    for (auto iter : sorter) {
-      const auto *tt = reinterpret_cast<const TestTuple *>(iter);
-      if (last_col_b != std::numeric_limits<uint32_t>::max()) {
-        EXPECT_GE(last_col_b, tt->col_b);
+    do {
+      for (auto iter : sorter) {
+        const auto *tt = reinterpret_cast<const TestTuple *>(iter);
+        if (last_col_b != std::numeric_limits<uint32_t>::max()) {
+          EXPECT_GE(last_col_b, tt->col_b);
+        }
+        last_col_b = tt->col_b;
+        res_tuples++;
       }
-      last_col_b = tt->col_b;
-      res_tuples++;
-    }
+    } while (sorter.NextBatch());
 
     EXPECT_EQ(num_tuples_to_insert, res_tuples);
   }
@@ -97,6 +102,65 @@ TEST_F(SorterTest, CanSortTuples) {
   TestSort(10);
 }
 
+TEST_F(SorterTest, CanKeepTopKTuples) {
+  // Sort on column B in ascending order
+  auto compare = [](const void *a, const void *b) {
+    const auto *ta = reinterpret_cast<const TestTuple *>(a);
+    const auto *tb = reinterpret_cast<const TestTuple *>(b);
+    return ta->col_b < tb->col_b ? -1 : (ta->col_b > tb->col_b ? 1 : 0);
+  };
+
+  const uint64_t top_k = 50;
+  const uint32_t num_tuples = 10000;
+
+  codegen::utils::Sorter top_k_sorter;
+  top_k_sorter.Init(compare, sizeof(TestTuple), top_k);
+
+  std::vector<uint32_t> col_b_values;
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    TestTuple *tuple =
+        reinterpret_cast<TestTuple *>(top_k_sorter.StoreInputTuple());
+    tuple->col_a = i;
+    tuple->col_b = rand() % 1000;
+    tuple->col_c = 0;
+    tuple->col_d = 0;
+    col_b_values.push_back(tuple->col_b);
+    top_k_sorter.KeepTopK();
+
+    // Never more than the kept tuples are buffered
+    EXPECT_LE(top_k_sorter.GetNumTuples(), top_k);
+  }
+
+  top_k_sorter.Sort();
+
+  // The kept tuples are the first in the sort order
+  std::sort(col_b_values.begin(), col_b_values.end());
+  uint64_t res_tuples = 0;
+  for (auto iter : top_k_sorter) {
+    const auto *tt = reinterpret_cast<const TestTuple *>(iter);
+    EXPECT_EQ(col_b_values[res_tuples], tt->col_b);
+    res_tuples++;
+  }
+  EXPECT_EQ(top_k, res_tuples);
+
+  top_k_sorter.Destroy();
+}
+
+TEST_F(SorterTest, CanSpillSortedRuns) {
+  // The smallest budget spills a run every time the buffer is full
+  executor::ExecutorContext context{nullptr};
+  context.SetMemoryBudget(1);
+
+  // Re-initialize the sorter with the budget of the context
+  sorter.Destroy();
+  sorter.Init(
+      reinterpret_cast<int (*)(const void *, const void *)>(CompareTuples),
+      sizeof(TestTuple), codegen::utils::Sorter::kNoLimit, &context);
+
+  // Enough tuples for more runs than are merged at once
+  TestSort(100000);
+}
+
 TEST_F(SorterTest, BenchmarkSorter) {
   // Test sorting 5 million input tuples
   TestSort(5000000);
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// worker_pool_test.cpp
+//
+// Identification: test/common/worker_pool_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "common/harness.h"
+#include "common/worker_pool.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Worker Pool Test
+//===--------------------------------------------------------------------===//
+
+class WorkerPoolTests : public PelotonTest {};
+
+TEST_F(WorkerPoolTests, RunTasksTest) {
+  const size_t unit_count = 1000;
+  std::vector<std::atomic<size_t>> run_counts(unit_count);
+  for (auto &run_count : run_counts) {
+    run_count = 0;
+  }
+
+  WorkerPool::GetInstance().RunTasks(
+      unit_count, [&](size_t unit) { run_counts[unit]++; });
+
+  for (auto &run_count : run_counts) {
+    EXPECT_EQ(1, run_count);
+  }
+}
+
+TEST_F(WorkerPoolTests, RunTasksErrorTest) {
+  std::atomic<size_t> run_count(0);
+  EXPECT_THROW(WorkerPool::GetInstance().RunTasks(100, [&](size_t unit) {
+    run_count++;
+    if (unit == 10) {
+      throw std::runtime_error("unit failed");
+    }
+  }), std::runtime_error);
+  EXPECT_LE(11, run_count);
+}
+
+TEST_F(WorkerPoolTests, NestedRunTasksTest) {
+  // every pool thread may be busy with an outer task, so the inner tasks
+  // must complete on their calling threads alone
+  std::atomic<size_t> run_count(0);
+  WorkerPool::GetInstance().RunTasks(16, [&](size_t) {
+    WorkerPool::GetInstance().RunTasks(16, [&](size_t) { run_count++; });
+  });
+  EXPECT_EQ(16 * 16, run_count);
+}
+
+TEST_F(WorkerPoolTests, WorkerGroupTest) {
+  auto &worker_pool = WorkerPool::GetInstance();
+  std::atomic<size_t> job_count(0);
+  std::atomic<size_t> start_count(0);
+
+  WorkerGroup worker_group;
+  size_t helper_count = worker_group.Start(
+      worker_pool.GetWorkerCount() + 4, [&](size_t) { job_count++; },
+      [&]() { start_count++; });
+  EXPECT_EQ(worker_pool.GetWorkerCount(), helper_count);
+
+  // the helpers that have not started by now never run the job
+  size_t ran_count = worker_group.Join();
+  EXPECT_LE(ran_count, helper_count);
+  EXPECT_EQ(ran_count, job_count);
+  EXPECT_EQ(ran_count, start_count);
+}
+
+}  // namespace test
+}  // namespace peloton
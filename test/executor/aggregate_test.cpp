@@ -22,6 +22,7 @@
 #include "type/value.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/aggregate_executor.h"
+#include "executor/aggregator.h"
 #include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
@@ -752,6 +753,342 @@ TEST_F(AggregateTests, HashCountDistinctGroupByTest) {
   EXPECT_TRUE(cmp == type::CMP_TRUE);
 }
 
+TEST_F(AggregateTests, HashSpillGroupByTest) {
+  // SELECT a, COUNT(*) from table GROUP BY a;
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Create a table and wrap it in logical tiles
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), 2 * tuple_count, false,
+                                   false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  // (1-5) Setup plan node
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns = {0};
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  planner::AggregatePlan::AggTerm countStar(
+      ExpressionType::AGGREGATE_COUNT_STAR, nullptr);
+  agg_terms.push_back(countStar);
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  auto data_table_schema = data_table.get()->GetSchema();
+  std::vector<catalog::Column> columns;
+  columns.push_back(data_table_schema->GetColumn(0));
+  columns.push_back(
+      catalog::Column(type::Type::BIGINT,
+                      type::Type::GetTypeSize(type::Type::BIGINT), "count"));
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  // OK) Create the plan node
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AggregateType::HASH);
+
+  // Create and set up executor, with a budget too small for a second group
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  context->SetMemoryBudget(1);
+
+  executor::AggregateExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  // Verify result: every group is output once, with all of its tuples
+  std::set<int32_t> groups;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (auto tuple_id : *result_tile) {
+      groups.insert(result_tile->GetValue(tuple_id, 0).GetAs<int32_t>());
+      EXPECT_EQ(1, result_tile->GetValue(tuple_id, 1).GetAs<int64_t>());
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_EQ((size_t)(2 * tuple_count), groups.size());
+}
+
+TEST_F(AggregateTests, HashSumMinMaxGroupByTest) {
+  // SELECT a, SUM(b), MIN(b), MAX(b), COUNT(b) from table GROUP BY a;
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Create a table and wrap it in logical tiles
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), 2 * tuple_count, false,
+                                   false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  // (1-5) Setup plan node
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns = {0};
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {
+      {0, {0, 0}}, {1, {1, 0}}, {2, {1, 1}}, {3, {1, 2}}, {4, {1, 3}}};
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  for (auto agg_type :
+       {ExpressionType::AGGREGATE_SUM, ExpressionType::AGGREGATE_MIN,
+        ExpressionType::AGGREGATE_MAX, ExpressionType::AGGREGATE_COUNT}) {
+    agg_terms.emplace_back(agg_type,
+                           expression::ExpressionUtil::TupleValueFactory(
+                               type::Type::INTEGER, 0, 1));
+  }
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  auto data_table_schema = data_table.get()->GetSchema();
+  std::vector<catalog::Column> columns;
+  columns.push_back(data_table_schema->GetColumn(0));
+  for (int column_itr = 0; column_itr < 3; column_itr++) {
+    columns.push_back(data_table_schema->GetColumn(1));
+  }
+  columns.push_back(
+      catalog::Column(type::Type::BIGINT,
+                      type::Type::GetTypeSize(type::Type::BIGINT), "count"));
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  // OK) Create the plan node
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AggregateType::HASH);
+
+  // Create and set up executor
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::AggregateExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  // Verify result: the first column has two groups of tuple_count tuples,
+  // each with consecutive values in the second column
+  std::set<int32_t> groups;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (auto tuple_id : *result_tile) {
+      int32_t group = result_tile->GetValue(tuple_id, 0).GetAs<int32_t>();
+      groups.insert(group);
+
+      int64_t sum = 0;
+      int32_t min = INT32_MAX;
+      int32_t max = INT32_MIN;
+      for (int row_id = 0; row_id < 2 * tuple_count; row_id++) {
+        if (TestingExecutorUtil::PopulatedValue(row_id / tuple_count, 0) !=
+            group) {
+          continue;
+        }
+        int32_t value = TestingExecutorUtil::PopulatedValue(row_id, 1);
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+      }
+      EXPECT_EQ(sum, result_tile->GetValue(tuple_id, 1).GetAs<int32_t>());
+      EXPECT_EQ(min, result_tile->GetValue(tuple_id, 2).GetAs<int32_t>());
+      EXPECT_EQ(max, result_tile->GetValue(tuple_id, 3).GetAs<int32_t>());
+      EXPECT_EQ(tuple_count,
+                result_tile->GetValue(tuple_id, 4).GetAs<int64_t>());
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_EQ((size_t)2, groups.size());
+}
+
+// SELECT a, COUNT(*) from table GROUP BY a, over enough tiles for the flat
+// hash aggregator to start its workers. Each tile group of a table with a
+// unique first column is fed twice, so every group is counted twice, in
+// different hash tables once the workers are started.
+static void RunHashParallelGroupBy(size_t memory_budget) {
+  const int tuples_per_tile_group = HASH_AGGREGATE_PARALLEL_MIN_TUPLE_COUNT /
+                                    HASH_AGGREGATE_PARALLEL_MIN_TILE_COUNT;
+  const int tile_group_count = HASH_AGGREGATE_PARALLEL_MIN_TILE_COUNT;
+  const int tuple_count = tuples_per_tile_group * tile_group_count;
+
+  // Create a table and wrap each tile group in two logical tiles
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                   false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> source_logical_tiles;
+  for (int round = 0; round < 2; round++) {
+    for (int offset = 0; offset < tile_group_count; offset++) {
+      source_logical_tiles.emplace_back(
+          executor::LogicalTileFactory::WrapTileGroup(
+              data_table->GetTileGroup(offset)));
+    }
+  }
+
+  // (1-5) Setup plan node
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns = {0};
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  planner::AggregatePlan::AggTerm countStar(
+      ExpressionType::AGGREGATE_COUNT_STAR, nullptr);
+  agg_terms.push_back(countStar);
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  auto data_table_schema = data_table.get()->GetSchema();
+  std::vector<catalog::Column> columns;
+  columns.push_back(data_table_schema->GetColumn(0));
+  columns.push_back(
+      catalog::Column(type::Type::BIGINT,
+                      type::Type::GetTypeSize(type::Type::BIGINT), "count"));
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  // OK) Create the plan node
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AggregateType::HASH);
+
+  // Create and set up executor
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  context->SetMemoryBudget(memory_budget);
+
+  executor::AggregateExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  {
+    testing::Sequence execute_sequence;
+    for (size_t tile_itr = 0; tile_itr < source_logical_tiles.size();
+         tile_itr++) {
+      EXPECT_CALL(child_executor, DExecute())
+          .InSequence(execute_sequence)
+          .WillOnce(Return(true));
+    }
+    EXPECT_CALL(child_executor, DExecute())
+        .InSequence(execute_sequence)
+        .WillOnce(Return(false));
+  }
+  {
+    testing::Sequence get_output_sequence;
+    for (auto& source_logical_tile : source_logical_tiles) {
+      EXPECT_CALL(child_executor, GetOutput())
+          .InSequence(get_output_sequence)
+          .WillOnce(Return(source_logical_tile.release()));
+    }
+  }
+
+  EXPECT_TRUE(executor.Init());
+
+  // Verify result: every group is output once, with both of its tuples
+  std::set<int32_t> groups;
+  size_t result_count = 0;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (auto tuple_id : *result_tile) {
+      groups.insert(result_tile->GetValue(tuple_id, 0).GetAs<int32_t>());
+      EXPECT_EQ(2, result_tile->GetValue(tuple_id, 1).GetAs<int64_t>());
+      result_count++;
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_EQ((size_t)tuple_count, groups.size());
+  EXPECT_EQ((size_t)tuple_count, result_count);
+}
+
+TEST_F(AggregateTests, HashParallelGroupByTest) {
+  // the partial aggregates of the workers are merged in memory
+  RunHashParallelGroupBy(SIZE_MAX);
+}
+
+TEST_F(AggregateTests, HashParallelSpillGroupByTest) {
+  // the tables of the calling thread and of the workers spill their groups,
+  // and the spilled partitions hold too many groups to be merged at once, so
+  // they are partitioned again
+  RunHashParallelGroupBy(64 * 1024);
+}
+
 TEST_F(AggregateTests, PlainSumCountDistinctTest) {
   // SELECT SUM(a), COUNT(b), COUNT(DISTINCT b) from table
   const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
@@ -10,17 +10,25 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdio>
+#include <fstream>
 
 #include "catalog/catalog.h"
+#include "common/exception.h"
 #include "common/harness.h"
 #include "common/logger.h"
 #include "common/statement.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/testing_transaction_util.h"
 #include "executor/copy_executor.h"
+#include "executor/csv_loader.h"
 #include "executor/seq_scan_executor.h"
+#include "executor/table_exporter.h"
 #include "optimizer/simple_optimizer.h"
 #include "parser/postgresparser.h"
 #include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
 #include "tcop/tcop.h"
 
 #include "gtest/gtest.h"
@@ -138,5 +146,288 @@ TEST_F(CopyTests, Copying) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Run a COPY statement that scans or loads the table itself
+static void ExecuteCopy(const std::string& copy_sql, size_t& tuples_loaded,
+                        size_t& bytes_written) {
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  LOG_INFO("Query: %s", copy_sql.c_str());
+
+  optimizer::SimpleOptimizer optimizer;
+  auto& peloton_parser = parser::PostgresParser::GetInstance();
+  auto copy_stmt = peloton_parser.BuildParseTree(copy_sql);
+  auto copy_plan = optimizer.BuildPelotonPlanTree(copy_stmt);
+  EXPECT_EQ(0U, copy_plan->GetChildren().size());
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  executor::CopyExecutor copy_executor(copy_plan.get(), context.get());
+  EXPECT_TRUE(copy_executor.Init());
+  EXPECT_TRUE(copy_executor.Execute());
+
+  tuples_loaded = copy_executor.GetTotalTuplesLoaded();
+  bytes_written = copy_executor.GetTotalBytesWritten();
+  txn_manager.CommitTransaction(txn);
+}
+
+// The lines of a file, sorted, as the export writes tile groups in any order
+static std::vector<std::string> ReadSortedLines(const std::string& file_path) {
+  std::vector<std::string> lines;
+  std::ifstream file(file_path);
+  std::string line;
+  while (std::getline(file, line)) {
+    lines.push_back(line);
+  }
+  std::sort(lines.begin(), lines.end());
+  return lines;
+}
+
+TEST_F(CopyTests, CopyingFrom) {
+  auto catalog = catalog::Catalog::GetInstance();
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase("emp_db", txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Create a table with primary key
+  TestingStatsUtil::CreateTable(true);
+
+  // Write a csv file with quoted fields, null fields and a duplicate key
+  size_t num_tuples = 100;
+  std::string file_path = "./copy_input.csv";
+  auto write_file = [&](bool with_duplicate) {
+    FILE* file = fopen(file_path.c_str(), "w");
+    ASSERT_TRUE(file != nullptr);
+    for (size_t i = 0; i < num_tuples; i++) {
+      if (i % 3 == 0) {
+        fprintf(file, "%lu,\"eeeee,\"\"eeeee\"\"\neeeee\"\n", i);
+      } else if (i % 3 == 1) {
+        fprintf(file, "%lu,\r\n", i);
+      } else {
+        fprintf(file, "%lu,eeeeeeeeee\n", i);
+      }
+    }
+    if (with_duplicate == true) {
+      fprintf(file, "0,eeeeeeeeee\n");
+    }
+    fclose(file);
+  };
+  std::string copy_sql =
+      "COPY emp_db.department_table FROM '" + file_path + "' DELIMITER ',';";
+  auto table = catalog->GetTableWithName("emp_db", "department_table");
+
+  // The duplicate key fails the statement, and no row is loaded
+  write_file(true);
+  {
+    txn = txn_manager.BeginTransaction();
+    optimizer::SimpleOptimizer optimizer;
+    auto& peloton_parser = parser::PostgresParser::GetInstance();
+    auto copy_stmt = peloton_parser.BuildParseTree(copy_sql);
+    auto copy_plan = optimizer.BuildPelotonPlanTree(copy_stmt);
+
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+    executor::CopyExecutor copy_executor(copy_plan.get(), context.get());
+    EXPECT_TRUE(copy_executor.Init());
+    EXPECT_THROW(copy_executor.Execute(), ConstraintException);
+    EXPECT_EQ(ResultType::FAILURE, txn->GetResult());
+    txn_manager.AbortTransaction(txn);
+  }
+
+  std::string output_path = "./copy_output.csv";
+  txn = txn_manager.BeginTransaction();
+  {
+    executor::TableExporter exporter(table, CopyType::EXPORT_CSV, ',');
+    exporter.Export(output_path, txn);
+    EXPECT_EQ(0U, exporter.GetExportedTupleCount());
+  }
+  txn_manager.CommitTransaction(txn);
+
+  // Without it, all rows are loaded
+  write_file(false);
+  size_t tuples_loaded, bytes_written;
+  ExecuteCopy(copy_sql, tuples_loaded, bytes_written);
+  EXPECT_EQ(num_tuples, tuples_loaded);
+
+  txn = txn_manager.BeginTransaction();
+  {
+    executor::TableExporter exporter(table, CopyType::EXPORT_CSV, ',');
+    exporter.Export(output_path, txn);
+    EXPECT_EQ(num_tuples, exporter.GetExportedTupleCount());
+  }
+  txn_manager.CommitTransaction(txn);
+
+  remove(output_path.c_str());
+  remove(file_path.c_str());
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog->DropDatabaseWithName("emp_db", txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+// Load a buffer in chunks that start anywhere, also inside quoted parts
+TEST_F(CopyTests, ChunkedCopyingFrom) {
+  auto catalog = catalog::Catalog::GetInstance();
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase("emp_db", txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingStatsUtil::CreateTable(false);
+  auto table = catalog->GetTableWithName("emp_db", "department_table");
+
+  // quoted line breaks and delimiters, quotes within a field and all forms
+  // of line breaks
+  size_t num_tuples = 30;
+  std::string data;
+  for (size_t i = 0; i < num_tuples; i++) {
+    data += std::to_string(i);
+    if (i % 5 == 0) {
+      data += ",\"e\ne,\"\"e\r\n\"\n";
+    } else if (i % 5 == 1) {
+      data += ",e\"\n,\"e\r";
+    } else if (i % 5 == 2) {
+      data += ",\r\n";
+    } else if (i % 5 == 3) {
+      data += ",\"\"\n";
+    } else {
+      data += ",eeeee\n";
+    }
+  }
+
+  for (size_t chunk_size = 1; chunk_size <= data.size(); chunk_size += 3) {
+    txn = txn_manager.BeginTransaction();
+    executor::CsvLoader loader(table, ',', chunk_size);
+    EXPECT_EQ(num_tuples, loader.Load(data.data(), data.size(), txn));
+    EXPECT_EQ((data.size() + chunk_size - 1) / chunk_size,
+              loader.GetChunkCount());
+    txn_manager.AbortTransaction(txn);
+  }
+
+  // the loader only parses csv
+  auto& peloton_parser = parser::PostgresParser::GetInstance();
+  EXPECT_THROW(peloton_parser.BuildParseTree(
+                   "COPY emp_db.department_table FROM './copy_input.txt' "
+                   "WITH (FORMAT text);"),
+               NotImplementedException);
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog->DropDatabaseWithName("emp_db", txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(CopyTests, ParallelCopyingTo) {
+  auto catalog = catalog::Catalog::GetInstance();
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase("emp_db", txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingStatsUtil::CreateTable(false);
+
+  // Write a csv file in the form that the export produces. In the binary
+  // form, varchar values keep their terminating null character.
+  size_t num_tuples = 100;
+  size_t binary_size = strlen(EXPORT_BINARY_MAGIC) + 4 + 2 + 4;
+  std::string input_path = "./copy_input.csv";
+  FILE* file = fopen(input_path.c_str(), "w");
+  ASSERT_TRUE(file != nullptr);
+  for (size_t i = 0; i < num_tuples; i++) {
+    if (i % 3 == 0) {
+      fprintf(file, "%lu,\"eeeee,\"\"eeeee\"\"\"\n", i);
+      binary_size += 4 + 4 + 14;
+    } else if (i % 3 == 1) {
+      fprintf(file, "%lu,\n", i);
+      binary_size += 4 + 4;
+    } else {
+      fprintf(file, "%lu,eeeeeeeeee\n", i);
+      binary_size += 4 + 4 + 11;
+    }
+  }
+  size_t input_size = ftell(file);
+  fclose(file);
+
+  size_t tuples_loaded, bytes_written;
+  ExecuteCopy("COPY emp_db.department_table FROM '" + input_path + "';",
+              tuples_loaded, bytes_written);
+  EXPECT_EQ(num_tuples, tuples_loaded);
+
+  // The rows are written back in the same form, in any order
+  std::string output_path = "./copy_output.csv";
+  ExecuteCopy("COPY emp_db.department_table TO '" + output_path +
+                  "' WITH (FORMAT csv);",
+              tuples_loaded, bytes_written);
+  EXPECT_EQ(input_size, bytes_written);
+  EXPECT_EQ(ReadSortedLines(input_path), ReadSortedLines(output_path));
+
+  // The loaded tuples are in a single tile group
+  ExecuteCopy("COPY emp_db.department_table TO '" + output_path +
+                  "' WITH (FORMAT binary);",
+              tuples_loaded, bytes_written);
+  EXPECT_EQ(binary_size, bytes_written);
+
+  std::ifstream binary_file(output_path, std::ios::binary);
+  std::string magic(strlen(EXPORT_BINARY_MAGIC), '\0');
+  binary_file.read(&magic[0], magic.size());
+  EXPECT_EQ(EXPORT_BINARY_MAGIC, magic);
+
+  remove(input_path.c_str());
+  remove(output_path.c_str());
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog->DropDatabaseWithName("emp_db", txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+// Export a delta-stored table as the exporting transaction sees it
+TEST_F(CopyTests, ExportDeltaTableTest) {
+  concurrency::EpochManagerFactory::GetInstance().Reset();
+  storage::DataTable* table = TestingTransactionUtil::CreateTable();
+  table->SetVersionStorageType(VersionStorageType::DELTA);
+
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // starts before (0, 0) is updated to (0, 1)
+  auto old_txn = txn_manager.BeginTransaction();
+  {
+    TransactionScheduler scheduler(1, table, &txn_manager);
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(0).Commit();
+    scheduler.Run();
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+  }
+  auto new_txn = txn_manager.BeginTransaction();
+
+  std::vector<std::string> old_lines, new_lines;
+  for (int key = 0; key < 10; key++) {
+    old_lines.push_back(std::to_string(key) + ",0");
+    new_lines.push_back(std::to_string(key) + (key == 0 ? ",1" : ",0"));
+  }
+  std::sort(old_lines.begin(), old_lines.end());
+  std::sort(new_lines.begin(), new_lines.end());
+
+  std::string output_path = "./copy_delta_output.csv";
+  {
+    executor::TableExporter exporter(table, CopyType::EXPORT_CSV, ',');
+    exporter.Export(output_path, old_txn);
+    EXPECT_EQ(10U, exporter.GetExportedTupleCount());
+    EXPECT_EQ(old_lines, ReadSortedLines(output_path));
+  }
+  {
+    executor::TableExporter exporter(table, CopyType::EXPORT_CSV, ',');
+    exporter.Export(output_path, new_txn);
+    EXPECT_EQ(10U, exporter.GetExportedTupleCount());
+    EXPECT_EQ(new_lines, ReadSortedLines(output_path));
+  }
+
+  txn_manager.CommitTransaction(old_txn);
+  txn_manager.CommitTransaction(new_txn);
+
+  remove(output_path.c_str());
+}
+
 }  // End test namespace
 }  // End peloton namespace
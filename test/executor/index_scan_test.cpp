@@ -14,6 +14,7 @@
 
 #include "executor/testing_executor_util.h"
 #include "catalog/catalog.h"
+#include "catalog/manager.h"
 #include "common/harness.h"
 #include "common/logger.h"
 #include "common/statement.h"
@@ -34,6 +35,8 @@
 #include "planner/index_scan_plan.h"
 #include "planner/insert_plan.h"
 #include "storage/data_table.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
 #include "tcop/tcop.h"
 
 
@@ -172,5 +175,124 @@ TEST_F(IndexScanTests, MultiColumnPredicateTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Scan the primary index in key order, with the optional key conditions, and
+// return the keys and the number of result tiles
+static size_t RunKeyOrderedScan(storage::DataTable *data_table,
+                                const std::vector<oid_t> &key_column_ids,
+                                const std::vector<ExpressionType> &expr_types,
+                                const std::vector<type::Value> &values,
+                                std::vector<int> &keys) {
+  std::vector<expression::AbstractExpression *> runtime_keys;
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      data_table->GetIndex(0), key_column_ids, expr_types, values,
+      runtime_keys);
+  planner::IndexScanPlan node(data_table, nullptr, {0, 1},
+                              index_scan_desc);
+  node.SetKeyOrdered(true);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::IndexScanExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+
+  size_t tile_count = 0;
+  while (executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    EXPECT_LT(0U, result_tile->GetTupleCount());
+    for (auto tuple_id : *result_tile) {
+      keys.push_back(result_tile->GetValue(tuple_id, 0).GetAs<int32_t>());
+    }
+    tile_count++;
+  }
+
+  txn_manager.CommitTransaction(txn);
+  return tile_count;
+}
+
+// Key ordered scan of a table whose physical order is unrelated to the keys
+TEST_F(IndexScanTests, KeyOrderedScanTest) {
+  const int tuple_count = 2000;
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable());
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  for (int rowid = 0; rowid < tuple_count; rowid++) {
+    // a permutation of the keys 0, 10, ..., 19990
+    int key = ((rowid * 7919) % tuple_count) * 10;
+    storage::Tuple tuple(data_table->GetSchema(), true);
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(key), testing_pool);
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(rowid),
+                   testing_pool);
+    tuple.SetValue(2, type::ValueFactory::GetDecimalValue(rowid),
+                   testing_pool);
+    tuple.SetValue(3, type::ValueFactory::GetVarcharValue(
+                          std::to_string(rowid)), testing_pool);
+
+    ItemPointer *index_entry_ptr = nullptr;
+    ItemPointer tuple_slot_id =
+        data_table->InsertTuple(&tuple, txn, &index_entry_ptr);
+    txn_manager.PerformInsert(txn, tuple_slot_id, index_entry_ptr);
+  }
+  txn_manager.CommitTransaction(txn);
+
+  // the tuples of a batch of index entries are copied into a single tile,
+  // instead of a tile per block run
+  std::vector<int> keys;
+  size_t tile_count = RunKeyOrderedScan(data_table.get(), {}, {}, {}, keys);
+  EXPECT_EQ(static_cast<size_t>(tuple_count), keys.size());
+  EXPECT_GE(static_cast<size_t>((tuple_count + KEY_ORDERED_TILE_SIZE - 1) /
+                                KEY_ORDERED_TILE_SIZE),
+            tile_count);
+  for (size_t index = 0; index < keys.size(); index++) {
+    EXPECT_EQ(static_cast<int>(index) * 10, keys[index]);
+  }
+
+  // 100 < key < 500
+  keys.clear();
+  RunKeyOrderedScan(
+      data_table.get(), {0, 0}, {ExpressionType::COMPARE_GREATERTHAN,
+                                 ExpressionType::COMPARE_LESSTHAN},
+      {type::ValueFactory::GetIntegerValue(100).Copy(),
+       type::ValueFactory::GetIntegerValue(500).Copy()},
+      keys);
+  EXPECT_EQ(39U, keys.size());
+  for (size_t index = 0; index < keys.size(); index++) {
+    EXPECT_EQ(110 + static_cast<int>(index) * 10, keys[index]);
+  }
+
+  // a copy stays in place for as long as a result tile reads from it, even
+  // after the scan is gone
+  std::vector<expression::AbstractExpression *> runtime_keys;
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      data_table->GetIndex(0), {}, {}, {}, runtime_keys);
+  planner::IndexScanPlan node(data_table.get(), nullptr, {0, 1},
+                              index_scan_desc);
+  node.SetKeyOrdered(true);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  std::unique_ptr<executor::LogicalTile> result_tile;
+  {
+    executor::IndexScanExecutor executor(&node, context.get());
+    EXPECT_TRUE(executor.Init());
+    EXPECT_TRUE(executor.Execute());
+    result_tile.reset(executor.GetOutput());
+  }
+
+  auto &manager = catalog::Manager::GetInstance();
+  oid_t copy_tile_group_id =
+      result_tile->GetBaseTile(0)->GetTileGroup()->GetTileGroupId();
+  EXPECT_TRUE(manager.GetTileGroup(copy_tile_group_id) != nullptr);
+  result_tile.reset();
+  EXPECT_TRUE(manager.GetTileGroup(copy_tile_group_id) == nullptr);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -14,6 +14,7 @@
 
 #include "executor/testing_executor_util.h"
 #include "executor/testing_join_util.h"
+#include "common/container_tuple.h"
 #include "common/harness.h"
 
 #include "executor/logical_tile.h"
@@ -25,6 +26,7 @@
 #include "executor/index_scan_executor.h"
 #include "executor/merge_join_executor.h"
 #include "executor/nested_loop_join_executor.h"
+#include "executor/seq_scan_executor.h"
 
 #include "expression/abstract_expression.h"
 #include "expression/expression_util.h"
@@ -35,6 +37,7 @@
 #include "planner/index_scan_plan.h"
 #include "planner/merge_join_plan.h"
 #include "planner/nested_loop_join_plan.h"
+#include "planner/seq_scan_plan.h"
 
 #include "storage/data_table.h"
 #include "storage/tile.h"
@@ -80,6 +83,8 @@ std::vector<JoinType> join_types = {JoinType::INNER, JoinType::LEFT,
 void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
                      oid_t join_test_type);
 void ExecuteNestedLoopJoinTest(JoinType join_type);
+void ExecuteMergeJoinIndexScanTest(JoinType join_type);
+void ExecuteSemiJoinTest(PlanNodeType join_algorithm, JoinType join_type);
 
 void PopulateTable(storage::DataTable *table, int num_rows, bool random,
                    concurrency::Transaction *current_txn);
@@ -219,6 +224,20 @@ TEST_F(JoinTests, BasicNestedLoopTest) {
   ExecuteNestedLoopJoinTest(JoinType::INNER);
 }
 
+TEST_F(JoinTests, SemiAntiJoinTest) {
+  for (auto join_type : {JoinType::SEMI, JoinType::ANTI}) {
+    ExecuteSemiJoinTest(PlanNodeType::HASHJOIN, join_type);
+    ExecuteSemiJoinTest(PlanNodeType::NESTLOOP, join_type);
+  }
+}
+
+TEST_F(JoinTests, MergeJoinIndexScanTest) {
+  for (auto join_type : join_types) {
+    LOG_TRACE("JOIN TYPE :: %s", JoinTypeToString(join_type).c_str());
+    ExecuteMergeJoinIndexScanTest(join_type);
+  }
+}
+
 void PopulateTable(storage::DataTable *table, int num_rows, bool random,
                    concurrency::Transaction *current_txn) {
   // Random values
@@ -422,6 +441,238 @@ void ExecuteNestedLoopJoinTest(JoinType join_type) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Merge join of the primary key index scans of two tables
+void ExecuteMergeJoinIndexScanTest(JoinType join_type) {
+  size_t tile_group_size = TESTS_TUPLES_PER_TILEGROUP;
+  size_t left_table_tile_group_count = 3;
+  size_t right_table_tile_group_count = 2;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  // Left table has 3 tile groups (15 tuples), with keys 0, 10, ..., 140
+  std::unique_ptr<storage::DataTable> left_table(
+      TestingExecutorUtil::CreateTable(tile_group_size));
+  TestingExecutorUtil::PopulateTable(
+      left_table.get(), tile_group_size * left_table_tile_group_count, false,
+      false, false, txn);
+
+  // Right table has 2 tile groups (10 tuples), with keys 0, 50, ..., 450
+  std::unique_ptr<storage::DataTable> right_table(
+      TestingExecutorUtil::CreateTable(tile_group_size));
+  PopulateTable(right_table.get(),
+                tile_group_size * right_table_tile_group_count, false, txn);
+
+  txn_manager.CommitTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  // Scan all keys of the primary key indexes, in key order
+  std::vector<expression::AbstractExpression *> runtime_keys;
+  planner::IndexScanPlan::IndexScanDesc left_index_scan_desc(
+      left_table->GetIndex(0), {}, {}, {}, runtime_keys);
+  planner::IndexScanPlan left_table_node(left_table.get(), nullptr, {},
+                                         left_index_scan_desc);
+  left_table_node.SetKeyOrdered(true);
+  executor::IndexScanExecutor left_table_scan_executor(&left_table_node,
+                                                       context.get());
+
+  planner::IndexScanPlan::IndexScanDesc right_index_scan_desc(
+      right_table->GetIndex(0), {}, {}, {}, runtime_keys);
+  planner::IndexScanPlan right_table_node(right_table.get(), nullptr, {},
+                                          right_index_scan_desc);
+  right_table_node.SetKeyOrdered(true);
+  executor::IndexScanExecutor right_table_scan_executor(&right_table_node,
+                                                        context.get());
+
+  // LEFT.A = RIGHT.A
+  std::vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+  join_clauses.emplace_back(
+      new expression::TupleValueExpression(type::Type::INTEGER, 0, 0),
+      new expression::TupleValueExpression(type::Type::INTEGER, 1, 0), false);
+
+  auto projection = TestingJoinUtil::CreateProjection();
+  auto schema = CreateJoinSchema();
+
+  planner::MergeJoinPlan merge_join_node(join_type, nullptr,
+                                         std::move(projection), schema,
+                                         join_clauses);
+  executor::MergeJoinExecutor merge_join_executor(&merge_join_node,
+                                                  context.get());
+  merge_join_executor.AddChild(&left_table_scan_executor);
+  merge_join_executor.AddChild(&right_table_scan_executor);
+
+  oid_t result_tuple_count = 0;
+  oid_t tuples_with_null = 0;
+  int last_left_key = -1;
+  int last_right_key = -1;
+
+  EXPECT_TRUE(merge_join_executor.Init());
+  while (merge_join_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_logical_tile(
+        merge_join_executor.GetOutput());
+    result_tuple_count += result_logical_tile->GetTupleCount();
+    tuples_with_null += CountTuplesWithNullFields(result_logical_tile.get());
+
+    // The keys come out in order, and match unless one side is null
+    for (auto tuple_id : *result_logical_tile) {
+      auto left_key = result_logical_tile->GetValue(tuple_id, 3);
+      auto right_key = result_logical_tile->GetValue(tuple_id, 2);
+      if (left_key.IsNull() == false) {
+        EXPECT_LT(last_left_key, left_key.GetAs<int32_t>());
+        last_left_key = left_key.GetAs<int32_t>();
+      }
+      if (right_key.IsNull() == false) {
+        EXPECT_LT(last_right_key, right_key.GetAs<int32_t>());
+        last_right_key = right_key.GetAs<int32_t>();
+      }
+      if (left_key.IsNull() == false && right_key.IsNull() == false) {
+        EXPECT_EQ(left_key.GetAs<int32_t>(), right_key.GetAs<int32_t>());
+      }
+    }
+  }
+
+  txn_manager.CommitTransaction(txn);
+
+  // Keys 0, 50 and 100 are in both tables
+  switch (join_type) {
+    case JoinType::INNER:
+      EXPECT_EQ(result_tuple_count, 3);
+      EXPECT_EQ(tuples_with_null, 0);
+      break;
+    case JoinType::LEFT:
+      EXPECT_EQ(result_tuple_count, 15);
+      EXPECT_EQ(tuples_with_null, 12);
+      break;
+    case JoinType::RIGHT:
+      EXPECT_EQ(result_tuple_count, 10);
+      EXPECT_EQ(tuples_with_null, 7);
+      break;
+    case JoinType::OUTER:
+      EXPECT_EQ(result_tuple_count, 22);
+      EXPECT_EQ(tuples_with_null, 19);
+      break;
+    default:
+      break;
+  }
+}
+
+// Semi or anti join of two tables on their first column
+void ExecuteSemiJoinTest(PlanNodeType join_algorithm, JoinType join_type) {
+  size_t tile_group_size = TESTS_TUPLES_PER_TILEGROUP;
+  size_t left_table_tile_group_count = 3;
+  size_t right_table_tile_group_count = 2;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  // Left table has 3 tile groups (15 tuples), with keys 0, 10, ..., 140
+  std::unique_ptr<storage::DataTable> left_table(
+      TestingExecutorUtil::CreateTable(tile_group_size));
+  TestingExecutorUtil::PopulateTable(
+      left_table.get(), tile_group_size * left_table_tile_group_count, false,
+      false, false, txn);
+
+  // Right table has 2 tile groups (10 tuples), with keys 0, 50, ..., 450
+  std::unique_ptr<storage::DataTable> right_table(
+      TestingExecutorUtil::CreateTable(tile_group_size));
+  PopulateTable(right_table.get(),
+                tile_group_size * right_table_tile_group_count, false, txn);
+
+  txn_manager.CommitTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::SeqScanPlan left_table_node(left_table.get(), nullptr,
+                                       {0, 1, 2, 3});
+  executor::SeqScanExecutor left_table_scan_executor(&left_table_node,
+                                                     context.get());
+
+  // Only the columns of the left table are output
+  std::shared_ptr<const catalog::Schema> schema(
+      catalog::Schema::CopySchema(left_table->GetSchema()));
+
+  oid_t result_tuple_count = 0;
+  auto validate = [&](executor::LogicalTile *result_logical_tile) {
+    EXPECT_EQ(4, result_logical_tile->GetColumnCount());
+    for (auto tuple_id : *result_logical_tile) {
+      int key = result_logical_tile->GetValue(tuple_id, 0).GetAs<int32_t>();
+      bool matched = (key % 50 == 0);
+      EXPECT_EQ(join_type == JoinType::SEMI, matched);
+      result_tuple_count++;
+    }
+  };
+
+  if (join_algorithm == PlanNodeType::HASHJOIN) {
+    planner::SeqScanPlan right_table_node(right_table.get(), nullptr,
+                                          {0, 1, 2, 3});
+    executor::SeqScanExecutor right_table_scan_executor(&right_table_node,
+                                                        context.get());
+
+    std::vector<std::unique_ptr<const expression::AbstractExpression>>
+        hash_keys;
+    hash_keys.emplace_back(
+        new expression::TupleValueExpression(type::Type::INTEGER, 1, 0));
+    planner::HashPlan hash_plan_node(hash_keys);
+    executor::HashExecutor hash_executor(&hash_plan_node, context.get());
+    hash_executor.AddChild(&right_table_scan_executor);
+
+    planner::HashJoinPlan hash_join_plan_node(join_type, nullptr, nullptr,
+                                              schema);
+    executor::HashJoinExecutor hash_join_executor(&hash_join_plan_node,
+                                                  context.get());
+    hash_join_executor.AddChild(&left_table_scan_executor);
+    hash_join_executor.AddChild(&hash_executor);
+
+    EXPECT_TRUE(hash_join_executor.Init());
+    while (hash_join_executor.Execute() == true) {
+      std::unique_ptr<executor::LogicalTile> result_logical_tile(
+          hash_join_executor.GetOutput());
+      validate(result_logical_tile.get());
+    }
+  } else {
+    // Look up the right table with the key of each left tuple
+    std::vector<expression::AbstractExpression *> runtime_keys;
+    planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+        right_table->GetIndex(0), {0}, {ExpressionType::COMPARE_EQUAL},
+        {type::ValueFactory::GetParameterOffsetValue(0).Copy()}, runtime_keys);
+    planner::IndexScanPlan right_table_node(right_table.get(), nullptr, {0, 1},
+                                            index_scan_desc);
+    executor::IndexScanExecutor right_table_scan_executor(&right_table_node,
+                                                          context.get());
+
+    std::vector<oid_t> join_column_ids_left = {0};
+    std::vector<oid_t> join_column_ids_right = {0};
+    planner::NestedLoopJoinPlan nested_loop_join_node(
+        join_type, nullptr, nullptr, schema, join_column_ids_left,
+        join_column_ids_right);
+    executor::NestedLoopJoinExecutor nested_loop_join_executor(
+        &nested_loop_join_node, context.get());
+    nested_loop_join_executor.AddChild(&left_table_scan_executor);
+    nested_loop_join_executor.AddChild(&right_table_scan_executor);
+
+    EXPECT_TRUE(nested_loop_join_executor.Init());
+    while (nested_loop_join_executor.Execute() == true) {
+      std::unique_ptr<executor::LogicalTile> result_logical_tile(
+          nested_loop_join_executor.GetOutput());
+      validate(result_logical_tile.get());
+    }
+  }
+
+  txn_manager.CommitTransaction(txn);
+
+  // Keys 0, 50 and 100 are in both tables
+  if (join_type == JoinType::SEMI) {
+    EXPECT_EQ(3, result_tuple_count);
+  } else {
+    EXPECT_EQ(12, result_tuple_count);
+  }
+}
+
 void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
                      oid_t join_test_type) {
   //===--------------------------------------------------------------------===//
@@ -206,5 +206,39 @@ TEST_F(LogicalTileTests, TileMaterializationTest) {
   LOG_TRACE("%s", logical_tile->GetInfo().c_str());
 }
 
+TEST_F(LogicalTileTests, PositionListTest) {
+  // Consecutive positions are stored as a range
+  executor::LogicalTile::PositionList range_list(
+      std::vector<oid_t>({3, 4, 5, 6}));
+  EXPECT_TRUE(range_list.IsRange());
+  EXPECT_EQ(4, range_list.size());
+  EXPECT_EQ(5, range_list[2]);
+
+  range_list.push_back(7);
+  EXPECT_TRUE(range_list.IsRange());
+  EXPECT_EQ(7, range_list[4]);
+
+  // A position out of the range expands the list
+  range_list.push_back(NULL_OID);
+  EXPECT_FALSE(range_list.IsRange());
+  EXPECT_EQ(6, range_list.size());
+  for (oid_t offset = 0; offset < 5; offset++) {
+    EXPECT_EQ(3 + offset, range_list[offset]);
+  }
+  EXPECT_EQ(NULL_OID, range_list[5]);
+
+  executor::LogicalTile::PositionList sparse_list(
+      std::vector<oid_t>({0, 2, 3}));
+  EXPECT_FALSE(sparse_list.IsRange());
+  EXPECT_EQ(3, sparse_list.size());
+  EXPECT_EQ(2, sparse_list[1]);
+
+  executor::LogicalTile::PositionList empty_list;
+  EXPECT_TRUE(empty_list.empty());
+  empty_list.push_back(8);
+  EXPECT_TRUE(empty_list.IsRange());
+  EXPECT_EQ(8, empty_list[0]);
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
@@ -68,6 +70,88 @@ void RunTest(executor::OrderByExecutor &executor, size_t expected_num_tuples,
   }
 }
 
+// Sorts on keys that are not a prefix of the columns (ORDER BY column 3 ASC,
+// column 1 DESC) and checks the order of the output against the table
+void RunStringAscIntDescTest(size_t limit, size_t memory_budget) {
+  std::vector<oid_t> sort_keys({3, 1});
+  std::vector<bool> descend_flags({false, true});
+  std::vector<oid_t> output_columns({0, 1, 2, 3});
+  planner::OrderByPlan node(sort_keys, descend_flags, output_columns);
+  if (limit != 0) {
+    node.SetLimit(true);
+    node.SetLimitNumber(limit);
+    node.SetLimitOffset(0);
+  }
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+  context->SetMemoryBudget(memory_budget);
+
+  // Create and set up executor
+  executor::OrderByExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  // Create a table and wrap it in logical tile
+  size_t tile_size = 20;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tile_size));
+  bool random = true;
+  TestingExecutorUtil::PopulateTable(data_table.get(), tile_size * 2, false,
+                                     random, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::vector<std::pair<std::string, int32_t>> expected_values;
+  for (oid_t tile_group_itr = 0; tile_group_itr < 2; tile_group_itr++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_itr);
+    for (oid_t tuple_id = 0; tuple_id < tile_size; tuple_id++) {
+      expected_values.emplace_back(
+          tile_group->GetValue(tuple_id, 3).ToString(),
+          tile_group->GetValue(tuple_id, 1).GetAs<int32_t>());
+    }
+  }
+  std::sort(expected_values.begin(), expected_values.end(),
+            [](const std::pair<std::string, int32_t> &a,
+               const std::pair<std::string, int32_t> &b) {
+              if (a.first != b.first) return a.first < b.first;
+              return a.second > b.second;
+            });
+  if (limit != 0) expected_values.resize(limit);
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  std::vector<std::pair<std::string, int32_t>> result_values;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      result_values.emplace_back(
+          result_tile->GetValue(tuple_id, 3).ToString(),
+          result_tile->GetValue(tuple_id, 1).GetAs<int32_t>());
+    }
+  }
+
+  EXPECT_EQ(expected_values, result_values);
+}
+
 TEST_F(OrderByTests, IntAscTest) {
   // Create the plan node
   std::vector<oid_t> sort_keys({1});
@@ -300,6 +384,157 @@ TEST_F(OrderByTests, StringDescIntAscTest) {
 
   RunTest(executor, tile_size * 2, sort_keys, descend_flags);
 }
+TEST_F(OrderByTests, IntDescLimitTest) {
+  // Create the plan node
+  std::vector<oid_t> sort_keys({1});
+  std::vector<bool> descend_flags({true});
+  std::vector<oid_t> output_columns({0, 1, 2, 3});
+  planner::OrderByPlan node(sort_keys, descend_flags, output_columns);
+  node.SetLimit(true);
+  node.SetLimitNumber(5);
+  node.SetLimitOffset(3);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+
+  // Create and set up executor
+  executor::OrderByExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  // Create a table and wrap it in logical tile
+  size_t tile_size = 20;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tile_size));
+  bool random = true;
+  TestingExecutorUtil::PopulateTable(data_table.get(), tile_size * 2, false,
+                                   random, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The offset and limit tuples with the largest values
+  std::vector<int32_t> expected_values;
+  for (oid_t tile_group_itr = 0; tile_group_itr < 2; tile_group_itr++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_itr);
+    for (oid_t tuple_id = 0; tuple_id < tile_size; tuple_id++) {
+      expected_values.push_back(
+          tile_group->GetValue(tuple_id, 1).GetAs<int32_t>());
+    }
+  }
+  std::sort(expected_values.begin(), expected_values.end(),
+            std::greater<int32_t>());
+  expected_values.resize(8);
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  std::vector<int32_t> result_values;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      result_values.push_back(
+          result_tile->GetValue(tuple_id, 1).GetAs<int32_t>());
+    }
+  }
+
+  EXPECT_EQ(expected_values, result_values);
+}
+
+TEST_F(OrderByTests, StringAscIntDescLimitTest) {
+  RunStringAscIntDescTest(7, SIZE_MAX);
+}
+
+TEST_F(OrderByTests, IntDescSpillTest) {
+  // Create the plan node
+  std::vector<oid_t> sort_keys({1});
+  std::vector<bool> descend_flags({true});
+  std::vector<oid_t> output_columns({0, 1, 2, 3});
+  planner::OrderByPlan node(sort_keys, descend_flags, output_columns);
+
+  // Every input tile goes to its own sorted run
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+  context->SetMemoryBudget(1);
+
+  // Create and set up executor
+  executor::OrderByExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  // Create a table and wrap it in logical tile
+  size_t tile_size = 20;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tile_size));
+  bool random = true;
+  TestingExecutorUtil::PopulateTable(data_table.get(), tile_size * 2, false,
+                                   random, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::vector<int32_t> expected_values;
+  for (oid_t tile_group_itr = 0; tile_group_itr < 2; tile_group_itr++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_itr);
+    for (oid_t tuple_id = 0; tuple_id < tile_size; tuple_id++) {
+      expected_values.push_back(
+          tile_group->GetValue(tuple_id, 1).GetAs<int32_t>());
+    }
+  }
+  std::sort(expected_values.begin(), expected_values.end(),
+            std::greater<int32_t>());
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  std::vector<int32_t> result_values;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      result_values.push_back(
+          result_tile->GetValue(tuple_id, 1).GetAs<int32_t>());
+    }
+  }
+
+  EXPECT_EQ(expected_values, result_values);
+}
+
+TEST_F(OrderByTests, StringAscIntDescSpillTest) {
+  // Every input tile goes to its own sorted run
+  RunStringAscIntDescTest(0, 1);
+}
 }
 
 }  // namespace test
@@ -245,5 +245,100 @@ TEST_F(ProjectionTests, BasicTargetTest) {
   RunTest(executor, 1);
 }
 
+TEST_F(ProjectionTests, LateMaterializationTest) {
+  MockExecutor child_executor;
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  size_t tile_size = 5;
+
+  // Create a table and wrap it in logical tile
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tile_size));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tile_size, false, false,
+                                   false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+  source_logical_tile1->RemoveVisibility(1);
+  auto base_tile = source_logical_tile1->GetBaseTile(1);
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()));
+
+  // Create the plan node
+  TargetList target_list;
+  DirectMapList direct_map_list;
+
+  /////////////////////////////////////////////////////////
+  // PROJECTION 1, TARGET 0 + 20
+  /////////////////////////////////////////////////////////
+
+  // construct schema
+  std::vector<catalog::Column> columns;
+  auto orig_schema = data_table.get()->GetSchema();
+  columns.push_back(orig_schema->GetColumn(1));
+  columns.push_back(orig_schema->GetColumn(0));
+  std::shared_ptr<const catalog::Schema> schema(new catalog::Schema(columns));
+
+  // direct map
+  DirectMap direct_map = std::make_pair(0, std::make_pair(0, 1));
+  direct_map_list.push_back(direct_map);
+
+  // target list
+  auto const_val = new expression::ConstantValueExpression(
+      type::ValueFactory::GetIntegerValue(20));
+  auto tuple_value_expr =
+      expression::ExpressionUtil::TupleValueFactory(type::Type::INTEGER, 0, 0);
+  expression::AbstractExpression *expr =
+      expression::ExpressionUtil::OperatorFactory(ExpressionType::OPERATOR_PLUS,
+                                                  type::Type::INTEGER,
+                                                  tuple_value_expr, const_val);
+
+  planner::DerivedAttribute attribute;
+  attribute.expr = expr;
+  attribute.attribute_info.type = expr->GetValueType();
+
+  Target target = std::make_pair(1, attribute);
+  target_list.push_back(target);
+
+  std::unique_ptr<const planner::ProjectInfo> project_info(
+      new planner::ProjectInfo(std::move(target_list),
+                               std::move(direct_map_list)));
+
+  planner::ProjectionPlan node(std::move(project_info), schema);
+
+  // Create and set up executor
+  executor::ExecutorContext context(txn);
+  context.SetLateMaterialization(true);
+  executor::ProjectionExecutor executor(&node, &context);
+  executor.AddChild(&child_executor);
+
+  EXPECT_TRUE(executor.Init());
+  EXPECT_TRUE(executor.Execute());
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  EXPECT_FALSE(executor.Execute());
+
+  // The directly mapped column is left in the table
+  EXPECT_EQ(base_tile, result_tile->GetBaseTile(0));
+  EXPECT_EQ(tile_size - 1, result_tile->GetTupleCount());
+
+  for (oid_t tuple_id : *result_tile) {
+    EXPECT_NE(1, tuple_id);
+    type::Value value1 = result_tile->GetValue(tuple_id, 0);
+    type::Value value2 = result_tile->GetValue(tuple_id, 1);
+    EXPECT_EQ(TestingExecutorUtil::PopulatedValue(tuple_id, 1),
+              value1.GetAs<int32_t>());
+    EXPECT_EQ(TestingExecutorUtil::PopulatedValue(tuple_id, 0) + 20,
+              value2.GetAs<int32_t>());
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,205 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// radix_hash_table_test.cpp
+//
+// Identification: test/executor/radix_hash_table_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/bloom_filter.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "executor/radix_hash_table.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Radix Hash Table Tests
+//===--------------------------------------------------------------------===//
+
+class RadixHashTableTests : public PelotonTest {};
+
+static storage::DataTable *CreateHashTable(int tuple_count, bool random) {
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(1000, false));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, random,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+  return table.release();
+}
+
+static std::vector<std::unique_ptr<executor::LogicalTile>> WrapTable(
+    storage::DataTable *table) {
+  std::vector<std::unique_ptr<executor::LogicalTile>> tiles;
+  for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+    tiles.emplace_back(executor::LogicalTileFactory::WrapTileGroup(
+        table->GetTileGroup(offset)));
+  }
+  return tiles;
+}
+
+TEST_F(RadixHashTableTests, BuildAndProbeTest) {
+  // the second column holds random values with many duplicates
+  const int build_tuple_count = 4 * RADIX_PARTITION_SIZE;
+  std::unique_ptr<storage::DataTable> build_table(
+      CreateHashTable(build_tuple_count, true));
+  std::unique_ptr<storage::DataTable> probe_table(CreateHashTable(5000, false));
+  std::vector<oid_t> column_ids({1});
+
+  auto build_tiles = WrapTable(build_table.get());
+  std::vector<executor::LogicalTile *> build_tile_ptrs;
+  std::map<int32_t, size_t> key_counts;
+  for (auto &tile : build_tiles) {
+    build_tile_ptrs.push_back(tile.get());
+    for (oid_t tuple_id : *tile) {
+      key_counts[tile->GetValue(tuple_id, 1).GetAs<int32_t>()]++;
+    }
+  }
+
+  executor::RadixHashTable hash_table;
+  hash_table.Build(build_tile_ptrs, column_ids);
+  EXPECT_EQ((size_t)build_tuple_count, hash_table.GetSize());
+  EXPECT_LT(1U, hash_table.GetPartitionCount());
+
+  // only the first tuple of each key stays visible
+  size_t visible_count = 0;
+  for (auto &tile : build_tiles) {
+    visible_count += tile->GetTupleCount();
+  }
+  EXPECT_EQ(key_counts.size(), visible_count);
+
+  auto probe_tiles = WrapTable(probe_table.get());
+  std::vector<executor::LogicalTile *> probe_tile_ptrs;
+  for (auto &tile : probe_tiles) {
+    probe_tile_ptrs.push_back(tile.get());
+  }
+
+  std::vector<std::vector<executor::RadixHashTable::Match>> matches;
+  hash_table.Probe(probe_tile_ptrs, matches);
+  EXPECT_EQ(probe_tiles.size(), matches.size());
+
+  for (size_t tile_itr = 0; tile_itr < probe_tiles.size(); tile_itr++) {
+    auto probe_tile = probe_tiles[tile_itr].get();
+    std::map<oid_t, size_t> match_counts;
+    for (auto &match : matches[tile_itr]) {
+      auto key = probe_tile->GetValue(match.probe_offset, 1);
+      auto build_key = build_tiles[match.location.tile_offset]->GetValue(
+          match.location.tuple_offset, 1);
+      EXPECT_EQ(type::CMP_TRUE, key.CompareEquals(build_key));
+      match_counts[match.probe_offset]++;
+    }
+
+    for (oid_t tuple_id : *probe_tile) {
+      auto key = probe_tile->GetValue(tuple_id, 1).GetAs<int32_t>();
+      size_t expected_count =
+          key_counts.count(key) == 0 ? 0 : key_counts[key];
+      EXPECT_EQ(expected_count, match_counts[tuple_id]);
+    }
+  }
+}
+
+TEST_F(RadixHashTableTests, ValueKeyTest) {
+  // the keys hold a varchar column, which is compared as values
+  const int build_tuple_count = 4 * RADIX_PARTITION_SIZE;
+  std::unique_ptr<storage::DataTable> build_table(
+      CreateHashTable(build_tuple_count, true));
+  std::unique_ptr<storage::DataTable> probe_table(CreateHashTable(5000, true));
+  std::vector<oid_t> column_ids({1, 3});
+
+  auto build_tiles = WrapTable(build_table.get());
+  std::vector<executor::LogicalTile *> build_tile_ptrs;
+  std::map<std::pair<int32_t, std::string>, size_t> key_counts;
+  for (auto &tile : build_tiles) {
+    build_tile_ptrs.push_back(tile.get());
+    for (oid_t tuple_id : *tile) {
+      key_counts[std::make_pair(tile->GetValue(tuple_id, 1).GetAs<int32_t>(),
+                                tile->GetValue(tuple_id, 3).ToString())]++;
+    }
+  }
+
+  executor::RadixHashTable hash_table;
+  hash_table.Build(build_tile_ptrs, column_ids);
+
+  auto probe_tiles = WrapTable(probe_table.get());
+  std::vector<executor::LogicalTile *> probe_tile_ptrs;
+  for (auto &tile : probe_tiles) {
+    probe_tile_ptrs.push_back(tile.get());
+  }
+
+  std::vector<std::vector<executor::RadixHashTable::Match>> matches;
+  hash_table.Probe(probe_tile_ptrs, matches);
+
+  for (size_t tile_itr = 0; tile_itr < probe_tiles.size(); tile_itr++) {
+    auto probe_tile = probe_tiles[tile_itr].get();
+    std::map<oid_t, size_t> match_counts;
+    for (auto &match : matches[tile_itr]) {
+      match_counts[match.probe_offset]++;
+    }
+
+    for (oid_t tuple_id : *probe_tile) {
+      auto key =
+          std::make_pair(probe_tile->GetValue(tuple_id, 1).GetAs<int32_t>(),
+                         probe_tile->GetValue(tuple_id, 3).ToString());
+      size_t expected_count =
+          key_counts.count(key) == 0 ? 0 : key_counts[key];
+      EXPECT_EQ(expected_count, match_counts[tuple_id]);
+    }
+  }
+}
+
+TEST_F(RadixHashTableTests, BloomFilterTest) {
+  const int build_tuple_count = 4 * RADIX_PARTITION_SIZE;
+  std::unique_ptr<storage::DataTable> build_table(
+      CreateHashTable(build_tuple_count, false));
+  std::vector<oid_t> column_ids({1});
+
+  auto build_tiles = WrapTable(build_table.get());
+  std::vector<executor::LogicalTile *> build_tile_ptrs;
+  for (auto &tile : build_tiles) {
+    build_tile_ptrs.push_back(tile.get());
+  }
+
+  executor::RadixHashTable hash_table;
+  hash_table.Build(build_tile_ptrs, column_ids);
+  auto filter = hash_table.BuildBloomFilter();
+
+  // Every key of the table passes, and few of the others do
+  size_t false_positive_count = 0;
+  for (int tuple_id = 0; tuple_id < build_tuple_count; tuple_id++) {
+    size_t hash_code = 0;
+    type::ValueFactory::GetIntegerValue(
+        TestingExecutorUtil::PopulatedValue(tuple_id, 1))
+        .HashCombine(hash_code);
+    EXPECT_TRUE(
+        filter->MayContain(executor::RadixHashTable::HashKey(hash_code)));
+
+    hash_code = 0;
+    type::ValueFactory::GetIntegerValue(
+        TestingExecutorUtil::PopulatedValue(tuple_id, 1) + 5)
+        .HashCombine(hash_code);
+    if (filter->MayContain(executor::RadixHashTable::HashKey(hash_code))) {
+      false_positive_count++;
+    }
+  }
+  EXPECT_GT((size_t)build_tuple_count / 20, false_positive_count);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -28,6 +28,7 @@
 #include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
+#include "executor/parallel_seq_scan_executor.h"
 #include "executor/seq_scan_executor.h"
 #include "expression/abstract_expression.h"
 #include "expression/expression_util.h"
@@ -188,7 +189,7 @@ executor::LogicalTile *GetNextTile(executor::AbstractExecutor &executor) {
 
 /**
  * @brief Runs actual test used by some or all of the test cases below.
- * @param executor Sequential scan executor to be tested.
+ * @param executor Sequential scan executor to be tested, serial or parallel.
  * @param expected_num_tiles Expected number of output tiles.
  * @param expected_num_cols Expected number of columns in the output
  *        logical tile(s).
@@ -197,7 +198,7 @@ executor::LogicalTile *GetNextTile(executor::AbstractExecutor &executor) {
  * that use it (especially the part that verifies values). Please be mindful
  * if you're making changes.
  */
-void RunTest(executor::SeqScanExecutor &executor, int expected_num_tiles,
+void RunTest(executor::AbstractExecutor &executor, int expected_num_tiles,
              int expected_num_cols) {
   EXPECT_TRUE(executor.Init());
   std::vector<std::unique_ptr<executor::LogicalTile>> result_tiles;
@@ -269,6 +270,72 @@ TEST_F(SeqScanTests, TwoTileGroupsWithPredicateTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Sequential scan of table with predicate, split across workers. The tiles
+// may come out in any order.
+TEST_F(SeqScanTests, ParallelScanWithPredicateTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+
+  std::vector<oid_t> column_ids({0, 1, 3});
+
+  planner::SeqScanPlan node(table.get(), CreatePredicate(g_tuple_ids),
+                            column_ids);
+
+  // the table is too small to be scanned in parallel by default
+  EXPECT_FALSE(executor::ParallelSeqScanExecutor::IsParallelizable(node));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::ParallelSeqScanExecutor executor(&node, context.get());
+  RunTest(executor, table->GetTileGroupCount(), column_ids.size());
+  EXPECT_LE(1, executor.GetWorkerCount());
+
+  // an exhausted scan is not started over until it is reset
+  EXPECT_FALSE(executor.Execute());
+
+  // the scan starts over after a reset
+  executor.ResetState();
+  size_t tile_count = 0;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    EXPECT_EQ(g_tuple_ids.size(), result_tile->GetTupleCount());
+    tile_count++;
+  }
+  EXPECT_EQ(table->GetTileGroupCount(), tile_count);
+  EXPECT_FALSE(executor.Execute());
+
+  txn_manager.CommitTransaction(txn);
+}
+
+// Parallel scan by a transaction of the tuples it inserted itself, whose
+// visibility is checked by the consumer rather than by the workers.
+TEST_F(SeqScanTests, ParallelScanOwnedTuplesTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP * 4;
+  std::unique_ptr<storage::DataTable> table(TestingExecutorUtil::CreateTable());
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, false,
+                                     false, txn);
+
+  planner::SeqScanPlan node(table.get(), nullptr, std::vector<oid_t>({0}));
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  executor::ParallelSeqScanExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+
+  size_t result_tuple_count = 0;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    result_tuple_count += result_tile->GetTupleCount();
+  }
+  EXPECT_EQ(static_cast<size_t>(tuple_count), result_tuple_count);
+
+  txn_manager.CommitTransaction(txn);
+}
+
 // Sequential scan of logical tile with predicate.
 TEST_F(SeqScanTests, NonLeafNodePredicateTest) {
   // No table for this case as seq scan is not a leaf node.
@@ -15,12 +15,17 @@
 #include <string>
 #include <vector>
 
+#include "common/container_tuple.h"
 #include "common/harness.h"
 
 #include "expression/expression_util.h"
 #include "expression/function_expression.h"
 #include "expression/comparison_expression.h"
 #include "expression/case_expression.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
 #include "type/value.h"
 #include "type/value_factory.h"
 #include "storage/tuple.h"
@@ -414,5 +419,121 @@ TEST_F(ExpressionTests, SimpleCaseWithDefault) {
   EXPECT_EQ(type::CmpBool::CMP_TRUE, expected.CompareEquals(result));
 }
 
+// The batch evaluation keeps the tuples the evaluation of each one accepts
+TEST_F(ExpressionTests, BatchEvaluationTest) {
+  const int tuple_count = 40;
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = table->GetTileGroup(0);
+  auto null_value = type::ValueFactory::GetNullValueByType(type::Type::INTEGER);
+  tile_group->SetValue(null_value, 3, 1);
+
+  auto column = [](type::Type::TypeId type_id, int column_id) {
+    return expression::ExpressionUtil::TupleValueFactory(type_id, 0,
+                                                         column_id);
+  };
+  auto integer = [](int value) {
+    return expression::ExpressionUtil::ConstantValueFactory(
+        type::ValueFactory::GetIntegerValue(value));
+  };
+  auto decimal = [](double value) {
+    return expression::ExpressionUtil::ConstantValueFactory(
+        type::ValueFactory::GetDecimalValue(value));
+  };
+
+  std::vector<ExpPtr> predicates;
+  // a >= 50 AND c < 202.5
+  predicates.emplace_back(expression::ExpressionUtil::ConjunctionFactory(
+      ExpressionType::CONJUNCTION_AND,
+      expression::ExpressionUtil::ComparisonFactory(
+          ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+          column(type::Type::INTEGER, 0), integer(50)),
+      expression::ExpressionUtil::ComparisonFactory(
+          ExpressionType::COMPARE_LESSTHAN, column(type::Type::DECIMAL, 2),
+          decimal(202.5))));
+  // (a + b) * 2 > 600 OR b = 31
+  predicates.emplace_back(expression::ExpressionUtil::ConjunctionFactory(
+      ExpressionType::CONJUNCTION_OR,
+      expression::ExpressionUtil::ComparisonFactory(
+          ExpressionType::COMPARE_GREATERTHAN,
+          expression::ExpressionUtil::OperatorFactory(
+              ExpressionType::OPERATOR_MULTIPLY, type::Type::INTEGER,
+              expression::ExpressionUtil::OperatorFactory(
+                  ExpressionType::OPERATOR_PLUS, type::Type::INTEGER,
+                  column(type::Type::INTEGER, 0),
+                  column(type::Type::INTEGER, 1)),
+              integer(2)),
+          integer(600)),
+      expression::ExpressionUtil::ComparisonFactory(
+          ExpressionType::COMPARE_EQUAL, column(type::Type::INTEGER, 1),
+          integer(31))));
+  // b / 7 <> c - 2.0
+  predicates.emplace_back(expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_NOTEQUAL,
+      expression::ExpressionUtil::OperatorFactory(
+          ExpressionType::OPERATOR_DIVIDE, type::Type::INTEGER,
+          column(type::Type::INTEGER, 1), integer(7)),
+      expression::ExpressionUtil::OperatorFactory(
+          ExpressionType::OPERATOR_MINUS, type::Type::DECIMAL,
+          column(type::Type::DECIMAL, 2), decimal(2.0))));
+  // a / -1 < -100
+  predicates.emplace_back(expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_LESSTHAN,
+      expression::ExpressionUtil::OperatorFactory(
+          ExpressionType::OPERATOR_DIVIDE, type::Type::INTEGER,
+          column(type::Type::INTEGER, 0), integer(-1)),
+      integer(-100)));
+  // d = '51', which has no batch kernel
+  predicates.emplace_back(expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_EQUAL, column(type::Type::VARCHAR, 3),
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetVarcharValue("51"))));
+
+  std::vector<oid_t> all_tuples;
+  for (oid_t tuple_id = 0; tuple_id < (oid_t)tuple_count; tuple_id++) {
+    all_tuples.push_back(tuple_id);
+  }
+
+  for (auto &predicate : predicates) {
+    std::vector<oid_t> expected;
+    for (auto tuple_id : all_tuples) {
+      expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                           tuple_id);
+      if (predicate->Evaluate(&tuple, nullptr, nullptr).IsTrue()) {
+        expected.push_back(tuple_id);
+      }
+    }
+    EXPECT_FALSE(expected.empty());
+    EXPECT_LT(expected.size(), all_tuples.size());
+
+    std::vector<oid_t> selection(all_tuples);
+    predicate->EvaluateBatch(tile_group.get(), selection, nullptr);
+    EXPECT_EQ(expected, selection);
+  }
+
+  // a * 10000000 > 0 overflows, which fails the batch as it fails the last
+  // tuple
+  ExpPtr overflow_predicate(expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_GREATERTHAN,
+      expression::ExpressionUtil::OperatorFactory(
+          ExpressionType::OPERATOR_MULTIPLY, type::Type::INTEGER,
+          column(type::Type::INTEGER, 0), integer(10000000)),
+      integer(0)));
+  expression::ContainerTuple<storage::TileGroup> last_tuple(
+      tile_group.get(), tuple_count - 1);
+  EXPECT_THROW(overflow_predicate->Evaluate(&last_tuple, nullptr, nullptr),
+               Exception);
+  std::vector<oid_t> selection(all_tuples);
+  EXPECT_THROW(
+      overflow_predicate->EvaluateBatch(tile_group.get(), selection, nullptr),
+      Exception);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,294 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor_test.cpp
+//
+// Identification: test/gc/tile_group_compactor_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/testing_transaction_util.h"
+#include "executor/testing_executor_util.h"
+#include "catalog/catalog.h"
+#include "catalog/manager.h"
+#include "common/harness.h"
+#include "gc/tile_group_compactor.h"
+#include "gc/transaction_level_gc_manager.h"
+#include "concurrency/epoch_manager.h"
+
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/database.h"
+
+namespace peloton {
+
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Compactor Tests
+//===--------------------------------------------------------------------===//
+
+class TileGroupCompactorTests : public PelotonTest {};
+
+// collect the garbage produced in the current epoch
+void CollectEpochGarbage(gc::TransactionLevelGCManager &gc_manager) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  gc_manager.Unlink(0, epoch_manager.GetExpiredEpochId());
+
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  gc_manager.Reclaim(0, epoch_manager.GetExpiredEpochId());
+}
+
+TEST_F(TileGroupCompactorTests, CompactionTest) {
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+
+  auto &compactor = gc::TileGroupCompactor::GetInstance();
+
+  auto catalog = catalog::Catalog::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("DATABASE");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(catalog->HasDatabase(db_id));
+
+  // two full tile groups of 100 tuples each
+  const int num_key = 200;
+  std::unique_ptr<storage::DataTable> table(
+    TestingTransactionUtil::CreateTable(num_key, "TABLE", db_id, INVALID_OID, 1234, true));
+
+  auto first_tile_group_id = table->GetTileGroup(0)->GetTileGroupId();
+  auto tile_group_count = table->GetTileGroupCount();
+  EXPECT_FALSE(table->IsActiveTileGroup(first_tile_group_id));
+
+  // delete most of the tuples of the first tile group
+  const int delete_num = 90;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  {
+    TransactionScheduler scheduler(1, table.get(), &txn_manager);
+    for (int i = 0; i < delete_num; i++) {
+      scheduler.Txn(0).Delete(i);
+    }
+    scheduler.Txn(0).Commit();
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+  }
+
+  CollectEpochGarbage(gc_manager);
+
+  // the first tile group is marked as compacting
+  EXPECT_EQ(0U, compactor.CompactTable(table.get()));
+  EXPECT_TRUE(table->GetTileGroup(0)->GetHeader()->IsCompacting());
+  EXPECT_FALSE(table->GetTileGroup(1)->GetHeader()->IsCompacting());
+
+  // the remaining tuples are moved out once the marking epoch expires
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  EXPECT_EQ(0U, compactor.CompactTable(table.get()));
+
+  CollectEpochGarbage(gc_manager);
+
+  // the emptied tile group is dropped
+  EXPECT_EQ(1U, compactor.CompactTable(table.get()));
+
+  EXPECT_TRUE(catalog::Manager::GetInstance().GetTileGroup(
+                  first_tile_group_id) == nullptr);
+
+  // the offsets of the other tile groups are unchanged
+  EXPECT_EQ(tile_group_count, table->GetTileGroupCount());
+  EXPECT_EQ(INVALID_OID, table->GetTileGroup(0)->GetTileGroupId());
+  EXPECT_EQ(0U, table->GetTileGroup(0)->GetNextTupleSlot());
+
+  // a tile group missing from the catalog without being dropped by the
+  // compactor is not mistaken for a dropped one
+  auto second_tile_group = table->GetTileGroup(1);
+  catalog::Manager::GetInstance().DropTileGroup(
+      second_tile_group->GetTileGroupId());
+  EXPECT_TRUE(table->GetTileGroup(1) == nullptr);
+  catalog::Manager::GetInstance().AddTileGroup(
+      second_tile_group->GetTileGroupId(), second_tile_group);
+
+  // the moved tuples are still reachable through the index and by scans
+  {
+    TransactionScheduler scheduler(1, table.get(), &txn_manager);
+    scheduler.Txn(0).Read(delete_num);
+    scheduler.Txn(0).Read(num_key - 1);
+    scheduler.Txn(0).Scan(0);
+    scheduler.Txn(0).Commit();
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+    EXPECT_EQ(0, scheduler.schedules[0].results[0]);
+    EXPECT_EQ(0, scheduler.schedules[0].results[1]);
+    EXPECT_EQ(static_cast<size_t>(2 + num_key - delete_num),
+              scheduler.schedules[0].results.size());
+  }
+
+  table.release();
+
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("DATABASE");
+  EXPECT_FALSE(catalog->HasDatabase(db_id));
+
+}
+
+TEST_F(TileGroupCompactorTests, ReorganizationTest) {
+
+  // only new tile groups of the hybrid layout mode get the tuned layout
+  peloton_layout_mode = LAYOUT_TYPE_HYBRID;
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+
+  auto &compactor = gc::TileGroupCompactor::GetInstance();
+
+  auto catalog = catalog::Catalog::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("DATABASE");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(catalog->HasDatabase(db_id));
+
+  // two full tile groups of 100 tuples each
+  const int num_key = 200;
+  std::unique_ptr<storage::DataTable> table(
+    TestingTransactionUtil::CreateTable(num_key, "TABLE", db_id, INVALID_OID, 1234, true));
+
+  auto first_tile_group_id = table->GetTileGroup(0)->GetTileGroupId();
+
+  // tune the table into a column layout
+  column_map_type column_layout;
+  oid_t column_count = table->GetSchema()->GetColumnCount();
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    column_layout[column_id] = std::make_pair(column_id, 0);
+  }
+  table->SetDefaultLayout(column_layout);
+
+  // a single tile group is picked
+  EXPECT_EQ(1U, compactor.ReorganizeTable(table.get(), 0.0001, 1));
+  EXPECT_TRUE(table->GetTileGroup(0)->GetHeader()->IsCompacting());
+
+  // its tuples are moved into tile groups of the new layout
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  EXPECT_EQ(0U, compactor.CompactTable(table.get()));
+
+  // none of them lands in the active tile groups of the old layout
+  oid_t tile_group_count = table->GetTileGroupCount();
+  for (oid_t offset = 2; offset < tile_group_count; offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    if (tile_group->GetActiveTupleCount() > 0) {
+      EXPECT_EQ(column_layout, tile_group->GetColumnMap());
+    }
+  }
+
+  CollectEpochGarbage(gc_manager);
+
+  EXPECT_EQ(1U, compactor.CompactTable(table.get()));
+  EXPECT_TRUE(catalog::Manager::GetInstance().GetTileGroup(
+                  first_tile_group_id) == nullptr);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  {
+    TransactionScheduler scheduler(1, table.get(), &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Scan(0);
+    scheduler.Txn(0).Commit();
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+    EXPECT_EQ(0, scheduler.schedules[0].results[0]);
+    EXPECT_EQ(static_cast<size_t>(1 + num_key),
+              scheduler.schedules[0].results.size());
+  }
+
+  table.release();
+
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("DATABASE");
+  EXPECT_FALSE(catalog->HasDatabase(db_id));
+
+  peloton_layout_mode = LAYOUT_TYPE_ROW;
+}
+
+TEST_F(TileGroupCompactorTests, FreezeTest) {
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  auto &compactor = gc::TileGroupCompactor::GetInstance();
+
+  auto catalog = catalog::Catalog::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("DATABASE");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(catalog->HasDatabase(db_id));
+
+  // two full tile groups of 100 tuples each
+  const int num_key = 200;
+  std::unique_ptr<storage::DataTable> table(
+    TestingTransactionUtil::CreateTable(num_key, "TABLE", db_id, INVALID_OID, 1234, true));
+
+  auto first_tile_group_header = table->GetTileGroup(0)->GetHeader();
+
+  // the first tile group is found cold, and frozen once that epoch expires
+  EXPECT_EQ(0U, compactor.FreezeTable(table.get()));
+  EXPECT_FALSE(first_tile_group_header->IsFrozen());
+
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  EXPECT_LE(1U, compactor.FreezeTable(table.get()));
+  EXPECT_TRUE(first_tile_group_header->IsFrozen());
+
+  // the frozen tuples are still readable, and the first update unfreezes them
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  {
+    TransactionScheduler scheduler(1, table.get(), &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(0).Commit();
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+    EXPECT_EQ(0, scheduler.schedules[0].results[0]);
+  }
+
+  EXPECT_FALSE(first_tile_group_header->IsFrozen());
+
+  {
+    TransactionScheduler scheduler(1, table.get(), &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Scan(0);
+    scheduler.Txn(0).Commit();
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+    EXPECT_EQ(1, scheduler.schedules[0].results[0]);
+    EXPECT_EQ(static_cast<size_t>(1 + num_key),
+              scheduler.schedules[0].results.size());
+  }
+
+  // the unfrozen tile group is no longer cold
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  compactor.FreezeTable(table.get());
+  EXPECT_FALSE(first_tile_group_header->IsFrozen());
+
+  table.release();
+
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("DATABASE");
+  EXPECT_FALSE(catalog->HasDatabase(db_id));
+
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -200,6 +200,254 @@ TEST_F(TransactionLevelGCManagerTests, GCTest) {
 }
 
 
+TEST_F(TransactionLevelGCManagerTests, FreeSlotReuseTest) {
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+
+  auto catalog = catalog::Catalog::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("DATABASE");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(catalog->HasDatabase(db_id));
+
+  const int num_key = 5;
+  std::unique_ptr<storage::DataTable> table(
+    TestingTransactionUtil::CreateTable(num_key, "TABLE", db_id, INVALID_OID, 1234, true));
+
+  // update every tuple in a single transaction
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  TransactionScheduler scheduler(1, table.get(), &txn_manager);
+  for (int i = 0; i < num_key; i++) {
+    scheduler.Txn(0).Update(i, 1);
+  }
+  scheduler.Txn(0).Commit();
+  scheduler.Run();
+
+  EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+
+  epoch_manager.SetCurrentEpochId(2);
+  EXPECT_EQ(1, gc_manager.Unlink(0, epoch_manager.GetExpiredEpochId()));
+
+  epoch_manager.SetCurrentEpochId(3);
+  EXPECT_EQ(1, gc_manager.Reclaim(0, epoch_manager.GetExpiredEpochId()));
+
+  // the old versions are handed out as a batch of the same tile group,
+  // in the order of their offsets
+  ItemPointer first_location = gc_manager.ReturnFreeSlot(table->GetOid());
+  EXPECT_FALSE(first_location.IsNull());
+
+  ItemPointer last_location = first_location;
+  for (int i = 1; i < num_key; i++) {
+    ItemPointer location = gc_manager.ReturnFreeSlot(table->GetOid());
+    EXPECT_FALSE(location.IsNull());
+    EXPECT_EQ(first_location.block, location.block);
+    EXPECT_LT(last_location.offset, location.offset);
+    last_location = location;
+  }
+
+  EXPECT_TRUE(gc_manager.ReturnFreeSlot(table->GetOid()).IsNull());
+
+  table.release();
+
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("DATABASE");
+  EXPECT_FALSE(catalog->HasDatabase(db_id));
+
+}
+
+// Free slots cached by a thread are given back to the table, instead of being
+// dropped, when a table is registered and when the thread is idle.
+TEST_F(TransactionLevelGCManagerTests, FreeSlotCacheFlushTest) {
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+
+  auto catalog = catalog::Catalog::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("DATABASE");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(catalog->HasDatabase(db_id));
+
+  const int num_key = 5;
+  std::unique_ptr<storage::DataTable> table(
+    TestingTransactionUtil::CreateTable(num_key, "TABLE", db_id, INVALID_OID, 1234, true));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  TransactionScheduler scheduler(1, table.get(), &txn_manager);
+  for (int i = 0; i < num_key; i++) {
+    scheduler.Txn(0).Update(i, 1);
+  }
+  scheduler.Txn(0).Commit();
+  scheduler.Run();
+
+  EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+
+  epoch_manager.SetCurrentEpochId(2);
+  EXPECT_EQ(1, gc_manager.Unlink(0, epoch_manager.GetExpiredEpochId()));
+
+  epoch_manager.SetCurrentEpochId(3);
+  EXPECT_EQ(1, gc_manager.Reclaim(0, epoch_manager.GetExpiredEpochId()));
+
+  // another thread takes the batch, and keeps all but one slot cached
+  std::atomic<bool> taken(false);
+  std::atomic<bool> finished(false);
+  std::thread worker([&] {
+    EXPECT_FALSE(gc_manager.ReturnFreeSlot(table->GetOid()).IsNull());
+    taken = true;
+    while (finished == false) {
+      std::this_thread::yield();
+    }
+  });
+  while (taken == false) {
+    std::this_thread::yield();
+  }
+  EXPECT_TRUE(gc_manager.ReturnFreeSlot(table->GetOid()).IsNull());
+
+  // the gc drains the cache once the thread has been idle for an epoch
+  epoch_manager.SetCurrentEpochId(5);
+  gc_manager.CollectGarbage(0);
+
+  EXPECT_FALSE(gc_manager.ReturnFreeSlot(table->GetOid()).IsNull());
+
+  // registering a table gives the cached slots back rather than losing them
+  const oid_t other_table_id = 4321;
+  gc_manager.RegisterTable(other_table_id);
+  for (int i = 2; i < num_key; i++) {
+    EXPECT_FALSE(gc_manager.ReturnFreeSlot(table->GetOid()).IsNull());
+  }
+  EXPECT_TRUE(gc_manager.ReturnFreeSlot(table->GetOid()).IsNull());
+  gc_manager.DeregisterTable(other_table_id);
+
+  finished = true;
+  worker.join();
+
+  table.release();
+
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("DATABASE");
+  EXPECT_FALSE(catalog->HasDatabase(db_id));
+
+}
+
+TEST_F(TransactionLevelGCManagerTests, CooperativeGCTest) {
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  std::vector<std::unique_ptr<std::thread>> gc_threads;
+
+  gc::GCManagerFactory::Configure(1, true);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+
+  EXPECT_TRUE(gc_manager.IsCooperative());
+
+  // no gc thread is started in cooperative mode
+  gc_manager.StartGC(gc_threads);
+  EXPECT_EQ(0U, gc_threads.size());
+
+  auto catalog = catalog::Catalog::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("DATABASE");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(catalog->HasDatabase(db_id));
+
+  // create a table with only one key
+  const int num_key = 1;
+  std::unique_ptr<storage::DataTable> table(
+    TestingTransactionUtil::CreateTable(num_key, "TABLE", db_id, INVALID_OID, 1234, true));
+
+  //===========================
+  // update a version here.
+  //===========================
+  // the worker hands over the old version when it commits,
+  // but it cannot collect it before the epoch expires.
+  const int update_num = 1;
+  UpdateTuple(table.get(), update_num, num_key);
+
+  epoch_manager.SetCurrentEpochId(2);
+
+  // the next worker of the partition unlinks the old version
+  EXPECT_EQ(1, gc_manager.CollectGarbage(0));
+
+  // nothing else expires in this epoch
+  EXPECT_EQ(0, gc_manager.CollectGarbage(0));
+
+  epoch_manager.SetCurrentEpochId(3);
+
+  // the old version is reclaimed and its slot can be reused
+  EXPECT_EQ(1, gc_manager.CollectGarbage(0));
+
+  EXPECT_FALSE(gc_manager.ReturnFreeSlot(table->GetOid()).IsNull());
+
+  //===========================
+  // expire more versions in an epoch than fit in a batch.
+  //===========================
+  const int txn_count = COOPERATIVE_ATTEMPT_COUNT + 100;
+  for (int i = 0; i < txn_count; i++) {
+    UpdateTuple(table.get(), update_num, num_key);
+  }
+
+  epoch_manager.SetCurrentEpochId(4);
+
+  // every commit collects at most a batch, so that none of them stalls
+  EXPECT_EQ(COOPERATIVE_ATTEMPT_COUNT, gc_manager.CollectGarbage(0));
+  EXPECT_EQ(txn_count - COOPERATIVE_ATTEMPT_COUNT,
+            gc_manager.CollectGarbage(0));
+  EXPECT_EQ(0, gc_manager.CollectGarbage(0));
+
+  epoch_manager.SetCurrentEpochId(5);
+
+  // the versions are reclaimed a batch at a time as well
+  EXPECT_EQ(COOPERATIVE_ATTEMPT_COUNT, gc_manager.CollectGarbage(0));
+  EXPECT_EQ(txn_count - COOPERATIVE_ATTEMPT_COUNT,
+            gc_manager.CollectGarbage(0));
+
+  gc_manager.StopGC();
+
+  // turning gc off also stops the workers from collecting
+  gc::GCManagerFactory::Configure(0);
+  EXPECT_FALSE(gc_manager.IsCooperative());
+
+  gc::GCManagerFactory::Configure(1);
+  EXPECT_FALSE(gc_manager.IsCooperative());
+
+  table.release();
+
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("DATABASE");
+  EXPECT_FALSE(catalog->HasDatabase(db_id));
+
+}
+
+TEST_F(TransactionLevelGCManagerTests, UnorderedUnlinkQueueTest) {
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+
+  // the commits of concurrent transactions hand over their garbage out of
+  // epoch order
+  std::shared_ptr<GCSet> gc_set(new GCSet());
+  gc_manager.RecycleTransaction(gc_set, 3, 0);
+  gc_manager.RecycleTransaction(gc_set, 2, 0);
+  gc_manager.RecycleTransaction(gc_set, 3, 0);
+
+  // none of them is expired yet, so all are kept in the local queue
+  EXPECT_EQ(0, gc_manager.Unlink(0, 1));
+
+  // the expired garbage behind unexpired garbage is unlinked as well
+  EXPECT_EQ(1, gc_manager.Unlink(0, 2));
+  EXPECT_EQ(2, gc_manager.Unlink(0, 3));
+
+  EXPECT_EQ(3, gc_manager.Reclaim(0, MAX_EID - 1));
+}
+
 }  // End test namespace
 }  // End peloton namespace
 
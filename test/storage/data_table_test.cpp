@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "common/exception.h"
 #include "common/harness.h"
 
 #include "storage/data_table.h"
@@ -72,6 +73,220 @@ TEST_F(DataTableTests, TransformTileGroupTest) {
   data_table->TransformTileGroup(0, theta);
 }
 
+// Count the tuples of the tile groups from the offset on that the transaction
+// sees
+static size_t CountVisibleTuples(storage::DataTable *table,
+                                 concurrency::Transaction *txn,
+                                 oid_t tile_group_offset) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  size_t visible_count = 0;
+  for (oid_t offset = tile_group_offset; offset < table->GetTileGroupCount();
+       offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    auto tile_group_header = tile_group->GetHeader();
+    for (oid_t tuple_id = 0; tuple_id < tile_group->GetNextTupleSlot();
+         tuple_id++) {
+      if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) ==
+          VisibilityType::OK) {
+        EXPECT_TRUE(tile_group_header->GetIndirection(tuple_id) != nullptr);
+        visible_count++;
+      }
+    }
+  }
+  return visible_count;
+}
+
+TEST_F(DataTableTests, BulkLoadTest) {
+  const int tuples_per_tile_group = 5;
+  const int tuple_count = 12;
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group));
+  auto tile_group_count = table->GetTileGroupCount();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  for (int tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    tuples.push_back(
+        TestingExecutorUtil::GetTuple(table.get(), tuple_id, testing_pool));
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  table->BulkLoadTuples(tuples, txn);
+  EXPECT_EQ(tile_group_count + 3, table->GetTileGroupCount());
+
+  // the tuples are owned through their tile groups, not the read/write set
+  EXPECT_TRUE(txn->GetReadWriteSet().empty());
+  EXPECT_EQ(3U, txn->GetBulkLoadSet().size());
+
+  // the loading transaction sees its tuples, other transactions only after
+  // it commits.
+  auto other_txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(tuple_count,
+            CountVisibleTuples(table.get(), txn, tile_group_count));
+  EXPECT_EQ(0U, CountVisibleTuples(table.get(), other_txn, tile_group_count));
+  txn_manager.CommitTransaction(other_txn);
+  txn_manager.CommitTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(tuple_count,
+            CountVisibleTuples(table.get(), txn, tile_group_count));
+  txn_manager.CommitTransaction(txn);
+
+  for (oid_t index_itr = 0; index_itr < table->GetIndexCount(); index_itr++) {
+    std::vector<ItemPointer *> index_entries;
+    table->GetIndex(index_itr)->ScanAllKeys(index_entries);
+    EXPECT_EQ(tuple_count, index_entries.size());
+  }
+}
+
+TEST_F(DataTableTests, BulkLoadConstraintTest) {
+  const int tuples_per_tile_group = 5;
+  const int tuple_count = 12;
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group));
+  auto tile_group_count = table->GetTileGroupCount();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  for (int tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    tuples.push_back(
+        TestingExecutorUtil::GetTuple(table.get(), tuple_id, testing_pool));
+  }
+
+  // violates the primary key
+  tuples.push_back(TestingExecutorUtil::GetTuple(table.get(), 0, testing_pool));
+
+  // the load fails as a whole, and none of its tuples are ever seen
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_THROW(table->BulkLoadTuples(tuples, txn), ConstraintException);
+  txn_manager.AbortTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(0U, CountVisibleTuples(table.get(), txn, tile_group_count));
+  txn_manager.CommitTransaction(txn);
+
+  // nor do the keys it inserted stand in the way of a later load
+  tuples.pop_back();
+  txn = txn_manager.BeginTransaction();
+  table->BulkLoadTuples(tuples, txn);
+  txn_manager.CommitTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(tuple_count,
+            CountVisibleTuples(table.get(), txn, tile_group_count));
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(DataTableTests, BulkLoadWithoutIndexTest) {
+  const int tuples_per_tile_group = 5;
+  const int tuple_count = 7;
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, false));
+  auto tile_group_count = table->GetTileGroupCount();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  for (int tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    tuples.push_back(
+        TestingExecutorUtil::GetTuple(table.get(), tuple_id, testing_pool));
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  table->BulkLoadTuples(tuples, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // updates and deletes reach the tuples through their indirection
+  for (oid_t offset = tile_group_count; offset < table->GetTileGroupCount();
+       offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    auto tile_group_header = tile_group->GetHeader();
+    for (oid_t tuple_id = 0; tuple_id < tile_group->GetNextTupleSlot();
+         tuple_id++) {
+      auto indirection = tile_group_header->GetIndirection(tuple_id);
+      ASSERT_TRUE(indirection != nullptr);
+      EXPECT_EQ(tile_group->GetTileGroupId(), indirection->block);
+      EXPECT_EQ(tuple_id, indirection->offset);
+    }
+  }
+}
+
+TEST_F(DataTableTests, BulkLoadAbortTest) {
+  const int tuples_per_tile_group = 5;
+  const int tuple_count = 7;
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group));
+  auto tile_group_count = table->GetTileGroupCount();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  for (int tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    tuples.push_back(
+        TestingExecutorUtil::GetTuple(table.get(), tuple_id, testing_pool));
+  }
+
+  // the tuples of an aborted load are never seen
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  table->BulkLoadTuples(tuples, txn);
+  txn_manager.AbortTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(0U, CountVisibleTuples(table.get(), txn, tile_group_count));
+  txn_manager.CommitTransaction(txn);
+
+  // nor do their keys stand in the way of a later load
+  txn = txn_manager.BeginTransaction();
+  table->BulkLoadTuples(tuples, txn);
+  txn_manager.CommitTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(tuple_count,
+            CountVisibleTuples(table.get(), txn, tile_group_count));
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(DataTableTests, ConcurrentInsertTest) {
+  const int tuples_per_tile_group = 5;
+  const int thread_count = 4;
+  const int tuple_count_per_thread = 100;
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, false));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  LaunchParallelTest(thread_count, [&](UNUSED_ATTRIBUTE uint64_t thread_itr) {
+    auto txn = txn_manager.BeginTransaction();
+    TestingExecutorUtil::PopulateTable(table.get(), tuple_count_per_thread,
+                                       false, false, false, txn);
+    txn_manager.CommitTransaction(txn);
+  });
+
+  // every tuple got its own slot, and only the active tile groups are not
+  // full yet
+  size_t tuple_count = 0;
+  size_t partial_tile_group_count = 0;
+  for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    auto active_tuple_count = tile_group->GetActiveTupleCount();
+    tuple_count += active_tuple_count;
+    if (active_tuple_count != tuples_per_tile_group) {
+      EXPECT_TRUE(table->IsActiveTileGroup(tile_group->GetTileGroupId()));
+      partial_tile_group_count++;
+    }
+  }
+  EXPECT_EQ(thread_count * tuple_count_per_thread, tuple_count);
+  EXPECT_EQ(thread_count * tuple_count_per_thread, table->GetTupleCount());
+  EXPECT_GE(storage::DataTable::default_active_tilegroup_count_,
+            partial_tile_group_count);
+}
+
 std::unique_ptr<storage::DataTable> data_table_test_table;
 
 TEST_F(DataTableTests, GlobalTableTest) {
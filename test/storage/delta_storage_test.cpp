@@ -0,0 +1,219 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// delta_storage_test.cpp
+//
+// Identification: test/storage/delta_storage_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+#include "concurrency/epoch_manager.h"
+#include "concurrency/testing_transaction_util.h"
+#include "storage/data_table.h"
+#include "storage/delta_storage.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Delta Storage Tests
+//===--------------------------------------------------------------------===//
+
+class DeltaStorageTests : public PelotonTest {};
+
+static storage::DataTable *CreateDeltaTable() {
+  concurrency::EpochManagerFactory::GetInstance().Reset();
+  storage::DataTable *table = TestingTransactionUtil::CreateTable();
+  table->SetVersionStorageType(VersionStorageType::DELTA);
+  return table;
+}
+
+TEST_F(DeltaStorageTests, UpdateInPlaceTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &delta_storage = storage::DeltaStorage::GetInstance();
+  storage::DataTable *table = CreateDeltaTable();
+
+  auto tile_group = table->GetTileGroup(0);
+  auto tuple_count = tile_group->GetNextTupleSlot();
+
+  {
+    TransactionScheduler scheduler(3, table, &txn_manager);
+    // T0 updates (0, 0) to (0, 1) and reads its own write
+    // T1 starts before T0 commits and must keep reading (0, 0)
+    scheduler.Txn(1).Read(0);
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(1).Read(0);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Read(0);
+    scheduler.Txn(1).Commit();
+    // observer
+    scheduler.Txn(2).Read(0);
+    scheduler.Txn(2).Commit();
+
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+    EXPECT_TRUE(scheduler.schedules[1].txn_result == ResultType::SUCCESS);
+    EXPECT_TRUE(scheduler.schedules[2].txn_result == ResultType::SUCCESS);
+    EXPECT_EQ(1, scheduler.schedules[0].results[0]);
+    EXPECT_EQ(0, scheduler.schedules[1].results[0]);
+    EXPECT_EQ(0, scheduler.schedules[1].results[1]);
+    EXPECT_EQ(0, scheduler.schedules[1].results[2]);
+    EXPECT_EQ(1, scheduler.schedules[2].results[0]);
+  }
+
+  // no new version was allocated for the update
+  EXPECT_EQ(tuple_count, tile_group->GetNextTupleSlot());
+  EXPECT_LT(0U, delta_storage.GetPendingDeltaCount());
+
+  // merge the delta into the tuple slot
+  delta_storage.Clear();
+  EXPECT_EQ(0U, delta_storage.GetPendingDeltaCount());
+  EXPECT_TRUE(tile_group->GetHeader()->GetDeltaPointer(0) == nullptr);
+
+  {
+    TransactionScheduler scheduler(1, table, &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Scan(0);
+    scheduler.Txn(0).Commit();
+
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+    EXPECT_EQ(1, scheduler.schedules[0].results[0]);
+    // the scan returns all 10 tuples, (0, 1) first
+    EXPECT_EQ(11U, scheduler.schedules[0].results.size());
+    EXPECT_EQ(1, scheduler.schedules[0].results[1]);
+  }
+}
+
+TEST_F(DeltaStorageTests, AbortTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &delta_storage = storage::DeltaStorage::GetInstance();
+  storage::DataTable *table = CreateDeltaTable();
+
+  {
+    TransactionScheduler scheduler(2, table, &txn_manager);
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(0).Update(0, 2);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Abort();
+    // observer
+    scheduler.Txn(1).Read(0);
+    scheduler.Txn(1).Commit();
+
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::ABORTED);
+    EXPECT_TRUE(scheduler.schedules[1].txn_result == ResultType::SUCCESS);
+    EXPECT_EQ(2, scheduler.schedules[0].results[0]);
+    EXPECT_EQ(0, scheduler.schedules[1].results[0]);
+  }
+
+  EXPECT_TRUE(table->GetTileGroup(0)->GetHeader()->GetDeltaPointer(0) ==
+              nullptr);
+
+  delta_storage.Clear();
+  EXPECT_EQ(0U, delta_storage.GetPendingDeltaCount());
+}
+
+TEST_F(DeltaStorageTests, WriteConflictTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &delta_storage = storage::DeltaStorage::GetInstance();
+  storage::DataTable *table = CreateDeltaTable();
+
+  {
+    TransactionScheduler scheduler(3, table, &txn_manager);
+    // T0 updates (0, 0) to (0, 1)
+    // T1 updates (0, 0) to (0, 2)
+    // T0 commits
+    // T1 commits
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(1).Update(0, 2);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Commit();
+    // observer
+    scheduler.Txn(2).Read(0);
+    scheduler.Txn(2).Commit();
+
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+    EXPECT_TRUE(scheduler.schedules[1].txn_result == ResultType::ABORTED);
+    EXPECT_EQ(1, scheduler.schedules[2].results[0]);
+  }
+
+  {
+    TransactionScheduler scheduler(2, table, &txn_manager);
+    // T1 starts before T0 commits and must not overwrite T0's update
+    scheduler.Txn(1).Read(1);
+    scheduler.Txn(0).Update(1, 1);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Update(1, 2);
+    scheduler.Txn(1).Commit();
+
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+    EXPECT_TRUE(scheduler.schedules[1].txn_result == ResultType::ABORTED);
+  }
+
+  delta_storage.Clear();
+  EXPECT_EQ(0U, delta_storage.GetPendingDeltaCount());
+}
+
+TEST_F(DeltaStorageTests, BoundedChainTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto &delta_storage = storage::DeltaStorage::GetInstance();
+  storage::DataTable *table = CreateDeltaTable();
+  auto tile_group_header = table->GetTileGroup(0)->GetHeader();
+
+  // no gc runs, so the writers must keep the chain short themselves
+  const int update_count = 3 * DELTA_CHAIN_MERGE_LENGTH;
+  for (int value = 1; value <= update_count; value++) {
+    TransactionScheduler scheduler(1, table, &txn_manager);
+    scheduler.Txn(0).Update(0, value);
+    scheduler.Txn(0).Commit();
+
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+
+    // the committed delta expires with the next epoch
+    epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 2);
+
+    size_t chain_length = 0;
+    for (auto delta = tile_group_header->GetDeltaPointer(0); delta != nullptr;
+         delta = delta->next.load()) {
+      chain_length++;
+    }
+    EXPECT_GE(static_cast<size_t>(DELTA_CHAIN_MERGE_LENGTH), chain_length);
+  }
+
+  {
+    TransactionScheduler scheduler(1, table, &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Commit();
+
+    scheduler.Run();
+
+    EXPECT_TRUE(scheduler.schedules[0].txn_result == ResultType::SUCCESS);
+    EXPECT_EQ(update_count, scheduler.schedules[0].results[0]);
+  }
+
+  // the deltas merged by the writers are retired by the gc
+  delta_storage.Clear();
+  EXPECT_EQ(0U, delta_storage.GetPendingDeltaCount());
+  EXPECT_TRUE(tile_group_header->GetDeltaPointer(0) == nullptr);
+}
+
+}  // End test namespace
+}  // End peloton namespace
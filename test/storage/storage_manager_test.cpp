@@ -54,5 +54,116 @@ TEST_F(StorageManagerTests, BasicTest) {
   }
 }
 
+/**
+ * Test that large allocations are carved from huge page slabs
+ *
+ */
+TEST_F(StorageManagerTests, HugePageSlabTest) {
+  peloton::storage::StorageManager storage_manager;
+
+  // small allocations stay on the heap
+  auto small_location = storage_manager.Allocate(BackendType::MM, 256);
+  EXPECT_EQ(0U, storage_manager.GetSlabCount());
+  EXPECT_EQ(0U, storage_manager.GetMappedSize());
+
+  // several tiles share a slab
+  size_t length = 256 * 1024;
+  std::vector<void *> locations;
+  for (size_t itr = 0; itr < 4; itr++) {
+    auto location = storage_manager.Allocate(BackendType::MM, length);
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(location) % 64);
+    PL_MEMSET(location, '-', length);
+    locations.push_back(location);
+  }
+  EXPECT_EQ(1U, storage_manager.GetSlabCount());
+
+  // allocations larger than a slab are mapped on their own
+  size_t large_length = 3 * HUGE_PAGE_SIZE;
+  auto large_location = storage_manager.Allocate(BackendType::MM, large_length);
+  PL_MEMSET(large_location, '-', large_length);
+  EXPECT_EQ(1U, storage_manager.GetSlabCount());
+  EXPECT_EQ(static_cast<size_t>(HUGE_PAGE_SIZE + 4 * HUGE_PAGE_SIZE),
+            storage_manager.GetMappedSize());
+
+  storage_manager.Release(BackendType::MM, large_location);
+  EXPECT_EQ(static_cast<size_t>(HUGE_PAGE_SIZE),
+            storage_manager.GetMappedSize());
+
+  // the current slab is kept for later allocations
+  for (auto location : locations) {
+    storage_manager.Release(BackendType::MM, location);
+  }
+  EXPECT_EQ(1U, storage_manager.GetSlabCount());
+
+  storage_manager.Release(BackendType::MM, small_location);
+  EXPECT_EQ(6U, storage_manager.GetAllocationCount());
+}
+
+/**
+ * Test that released slab ranges are reused, and that slabs are unmapped once
+ * all of their ranges are released
+ *
+ */
+TEST_F(StorageManagerTests, SlabReuseTest) {
+  peloton::storage::StorageManager storage_manager;
+
+  // fill the first slab with ranges of 512KB, including their headers
+  size_t length = 512 * 1024 - 64;
+  std::vector<void *> locations;
+  for (size_t itr = 0; itr < 4; itr++) {
+    locations.push_back(storage_manager.Allocate(BackendType::MM, length));
+  }
+  EXPECT_EQ(1U, storage_manager.GetSlabCount());
+
+  // a released range is reused by the next allocation of its size, instead
+  // of mapping a new slab
+  storage_manager.Release(BackendType::MM, locations[1]);
+  auto reused_location = storage_manager.Allocate(BackendType::MM, length);
+  EXPECT_EQ(locations[1], reused_location);
+  EXPECT_EQ(1U, storage_manager.GetSlabCount());
+
+  // a range of another size needs a new slab
+  auto other_location = storage_manager.Allocate(BackendType::MM, length / 2);
+  EXPECT_EQ(2U, storage_manager.GetSlabCount());
+
+  // the first slab is unmapped with the release of its last range
+  storage_manager.Release(BackendType::MM, locations[0]);
+  storage_manager.Release(BackendType::MM, reused_location);
+  storage_manager.Release(BackendType::MM, locations[2]);
+  EXPECT_EQ(2U, storage_manager.GetSlabCount());
+  storage_manager.Release(BackendType::MM, locations[3]);
+  EXPECT_EQ(1U, storage_manager.GetSlabCount());
+  EXPECT_EQ(static_cast<size_t>(HUGE_PAGE_SIZE),
+            storage_manager.GetMappedSize());
+
+  // the current slab is rewound once it is empty
+  storage_manager.Release(BackendType::MM, other_location);
+  auto rewound_location = storage_manager.Allocate(BackendType::MM, length);
+  EXPECT_EQ(other_location, rewound_location);
+  storage_manager.Release(BackendType::MM, rewound_location);
+  EXPECT_EQ(1U, storage_manager.GetSlabCount());
+}
+
+/**
+ * Test that allocations on ssd and hdd are kept in memory
+ *
+ */
+TEST_F(StorageManagerTests, FileBackendTest) {
+  peloton::storage::StorageManager storage_manager;
+
+  size_t length = 256 * 1024;
+  for (auto backend_type : {BackendType::SSD, BackendType::HDD}) {
+    auto location = storage_manager.Allocate(backend_type, length);
+    PL_MEMSET(location, '-', length);
+
+    // there is no data file to write back to
+    storage_manager.Sync(backend_type, location, length);
+    EXPECT_EQ(0U, storage_manager.GetMsyncCount());
+
+    storage_manager.Release(backend_type, location);
+  }
+  EXPECT_EQ(2U, storage_manager.GetAllocationCount());
+}
+
 }  // End test namespace
 }  // End peloton namespace
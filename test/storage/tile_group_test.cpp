@@ -16,6 +16,8 @@
 #include "type/value_factory.h"
 #include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_factory.h"
 #include "storage/tile.h"
@@ -543,5 +545,39 @@ TEST_F(TileGroupTests, TileCopyTest) {
   delete schema;
 }
 
+TEST_F(TileGroupTests, LayoutTest) {
+  // column 0 in the first tile, columns 1 and 2 in the second one
+  storage::column_map_type column_map;
+  column_map[0] = std::make_pair(0, 0);
+  column_map[1] = std::make_pair(1, 0);
+  column_map[2] = std::make_pair(1, 1);
+
+  storage::TileGroupLayout layout(column_map);
+  EXPECT_EQ(3U, layout.GetColumnCount());
+
+  for (auto &entry : column_map) {
+    oid_t tile_offset, tile_column_offset;
+    layout.LocateTileAndColumn(entry.first, tile_offset, tile_column_offset);
+    EXPECT_EQ(entry.second.first, tile_offset);
+    EXPECT_EQ(entry.second.second, tile_column_offset);
+  }
+
+  // the tile groups of a table share their layout
+  const int tuples_per_tile_group = 5;
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, false));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), 3 * tuples_per_tile_group,
+                                     false, false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto first_layout = table->GetTileGroup(0)->GetLayout();
+  for (oid_t offset = 1; offset < table->GetTileGroupCount(); offset++) {
+    EXPECT_EQ(first_layout, table->GetTileGroup(offset)->GetLayout());
+  }
+}
+
 }  // End test namespace
 }  // End peloton namespace
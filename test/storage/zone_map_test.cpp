@@ -0,0 +1,266 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map_test.cpp
+//
+// Identification: test/storage/zone_map_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+#include "concurrency/epoch_manager.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "executor/testing_executor_util.h"
+#include "executor/update_executor.h"
+#include "expression/expression_util.h"
+#include "gc/transaction_level_gc_manager.h"
+#include "planner/seq_scan_plan.h"
+#include "planner/update_plan.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/zone_map.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Zone Map Tests
+//===--------------------------------------------------------------------===//
+
+class ZoneMapTests : public PelotonTest {};
+
+// three tile groups, holding 0..90, 100..190 and 200..290 in the first column
+static storage::DataTable *CreateZoneMapTable() {
+  const int tuples_per_tile_group = 10;
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, false));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), 3 * tuples_per_tile_group,
+                                     false, false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  return table.release();
+}
+
+static expression::AbstractExpression *CreateComparison(
+    ExpressionType comparison_type, int value) {
+  auto tuple_value =
+      expression::ExpressionUtil::TupleValueFactory(type::Type::INTEGER, 0, 0);
+  auto constant_value = expression::ExpressionUtil::ConstantValueFactory(
+      type::ValueFactory::GetIntegerValue(value));
+  return expression::ExpressionUtil::ComparisonFactory(
+      comparison_type, tuple_value, constant_value);
+}
+
+TEST_F(ZoneMapTests, SynopsisTest) {
+  std::unique_ptr<storage::DataTable> table(CreateZoneMapTable());
+
+  for (oid_t offset = 0; offset < 3; offset++) {
+    auto zone_map = table->GetTileGroup(offset)->GetZoneMap();
+    EXPECT_TRUE(zone_map->HasValues(0));
+    EXPECT_EQ(0U, zone_map->GetNullCount(0));
+    EXPECT_EQ(type::CMP_TRUE,
+              zone_map->GetMinValue(0).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(100 * offset)));
+    EXPECT_EQ(type::CMP_TRUE,
+              zone_map->GetMaxValue(0).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(100 * offset + 90)));
+  }
+
+  // a rebuilt zone map has the same bounds
+  auto zone_map = table->GetTileGroup(1)->GetZoneMap();
+  zone_map->Invalidate();
+  EXPECT_EQ(type::CMP_TRUE, zone_map->GetMinValue(0).CompareEquals(
+                                type::ValueFactory::GetIntegerValue(100)));
+  EXPECT_EQ(type::CMP_TRUE, zone_map->GetMaxValue(0).CompareEquals(
+                                type::ValueFactory::GetIntegerValue(190)));
+
+  // writes widen the bounds
+  auto value = type::ValueFactory::GetIntegerValue(1000);
+  table->GetTileGroup(1)->SetValue(value, 0, 0);
+  EXPECT_EQ(type::CMP_TRUE, zone_map->GetMaxValue(0).CompareEquals(value));
+}
+
+TEST_F(ZoneMapTests, DecimalAndVarcharSynopsisTest) {
+  std::unique_ptr<storage::DataTable> table(CreateZoneMapTable());
+  auto tile_group = table->GetTileGroup(1);
+  auto zone_map = tile_group->GetZoneMap();
+
+  // the decimal column holds 102..192, widened by a negative value
+  EXPECT_EQ(type::CMP_TRUE, zone_map->GetMinValue(2).CompareEquals(
+                                type::ValueFactory::GetDecimalValue(102)));
+  EXPECT_EQ(type::CMP_TRUE, zone_map->GetMaxValue(2).CompareEquals(
+                                type::ValueFactory::GetDecimalValue(192)));
+  auto decimal_value = type::ValueFactory::GetDecimalValue(-0.5);
+  tile_group->SetValue(decimal_value, 0, 2);
+  EXPECT_EQ(type::CMP_TRUE,
+            zone_map->GetMinValue(2).CompareEquals(decimal_value));
+
+  // the varchar column holds "103".."193", and its bounds are recomputed
+  // after a write
+  EXPECT_EQ(type::CMP_TRUE, zone_map->GetMinValue(3).CompareEquals(
+                                type::ValueFactory::GetVarcharValue("103")));
+  EXPECT_EQ(type::CMP_TRUE, zone_map->GetMaxValue(3).CompareEquals(
+                                type::ValueFactory::GetVarcharValue("193")));
+  auto varchar_value = type::ValueFactory::GetVarcharValue("999");
+  tile_group->SetValue(varchar_value, 1, 3);
+  EXPECT_EQ(type::CMP_TRUE,
+            zone_map->GetMaxValue(3).CompareEquals(varchar_value));
+  EXPECT_EQ(0U, zone_map->GetNullCount(3));
+}
+
+TEST_F(ZoneMapTests, PredicateTest) {
+  std::unique_ptr<storage::DataTable> table(CreateZoneMapTable());
+
+  // 150 <= a AND 250 > a
+  auto lower_bound =
+      CreateComparison(ExpressionType::COMPARE_GREATERTHANOREQUALTO, 150);
+  auto upper_bound = expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_GREATERTHAN,
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetIntegerValue(250)),
+      expression::ExpressionUtil::TupleValueFactory(type::Type::INTEGER, 0, 0));
+  std::unique_ptr<expression::AbstractExpression> range(
+      expression::ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_AND, lower_bound, upper_bound));
+
+  std::vector<storage::ZoneMapPredicate> predicates;
+  storage::ZoneMap::GetPredicates(range.get(), nullptr, predicates);
+  EXPECT_EQ(2U, predicates.size());
+  EXPECT_TRUE(predicates[1].comparison_type == ExpressionType::COMPARE_LESSTHAN);
+
+  EXPECT_FALSE(table->GetTileGroup(0)->GetZoneMap()->MayMatch(predicates));
+  EXPECT_TRUE(table->GetTileGroup(1)->GetZoneMap()->MayMatch(predicates));
+  EXPECT_TRUE(table->GetTileGroup(2)->GetZoneMap()->MayMatch(predicates));
+
+  // a = 95 falls between the first two tile groups
+  std::unique_ptr<expression::AbstractExpression> equality(
+      CreateComparison(ExpressionType::COMPARE_EQUAL, 95));
+  predicates.clear();
+  storage::ZoneMap::GetPredicates(equality.get(), nullptr, predicates);
+  EXPECT_EQ(1U, predicates.size());
+  for (oid_t offset = 0; offset < 3; offset++) {
+    EXPECT_FALSE(
+        table->GetTileGroup(offset)->GetZoneMap()->MayMatch(predicates));
+  }
+
+  // a <> 95 cannot be checked
+  std::unique_ptr<expression::AbstractExpression> inequality(
+      CreateComparison(ExpressionType::COMPARE_NOTEQUAL, 95));
+  predicates.clear();
+  storage::ZoneMap::GetPredicates(inequality.get(), nullptr, predicates);
+  EXPECT_EQ(0U, predicates.size());
+}
+
+// The varlen bounds outlive the old versions that the GC reclaims, together
+// with their varlen values
+TEST_F(ZoneMapTests, ReclaimedVarcharTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+
+  // one full tile group holding "3".."93" in the varchar column
+  const int tuple_count = 10;
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // SET d = 'zzz', for every tuple
+  auto update_value = type::ValueFactory::GetVarcharValue("zzz");
+  txn = txn_manager.BeginTransaction();
+  {
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+
+    TargetList target_list;
+    DirectMapList direct_map_list;
+    planner::DerivedAttribute attribute;
+    attribute.expr =
+        expression::ExpressionUtil::ConstantValueFactory(update_value);
+    attribute.attribute_info.type = attribute.expr->GetValueType();
+    target_list.emplace_back(3, attribute);
+    for (oid_t column_id = 0; column_id < 3; column_id++) {
+      direct_map_list.emplace_back(column_id,
+                                   std::pair<oid_t, oid_t>(0, column_id));
+    }
+    std::unique_ptr<const planner::ProjectInfo> project_info(
+        new planner::ProjectInfo(std::move(target_list),
+                                 std::move(direct_map_list)));
+    planner::UpdatePlan update_node(table.get(), std::move(project_info));
+    executor::UpdateExecutor update_executor(&update_node, context.get());
+
+    std::unique_ptr<planner::SeqScanPlan> seq_scan_node(
+        new planner::SeqScanPlan(table.get(), nullptr, {0}));
+    executor::SeqScanExecutor seq_scan_executor(seq_scan_node.get(),
+                                                context.get());
+    update_node.AddChild(std::move(seq_scan_node));
+    update_executor.AddChild(&seq_scan_executor);
+
+    EXPECT_TRUE(update_executor.Init());
+    while (update_executor.Execute())
+      ;
+  }
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // the old versions are reclaimed, and their varlen values freed
+  epoch_manager.SetCurrentEpochId(2);
+  gc_manager.Unlink(0, epoch_manager.GetExpiredEpochId());
+  epoch_manager.SetCurrentEpochId(3);
+  EXPECT_LT(0, gc_manager.Reclaim(0, epoch_manager.GetExpiredEpochId()));
+
+  auto zone_map = table->GetTileGroup(0)->GetZoneMap();
+  EXPECT_EQ(type::CMP_TRUE, zone_map->GetMinValue(3).CompareEquals(
+                                type::ValueFactory::GetVarcharValue("13")));
+  EXPECT_EQ(type::CMP_TRUE, zone_map->GetMaxValue(3).CompareEquals(
+                                type::ValueFactory::GetVarcharValue("93")));
+
+  // WHERE d = <value>
+  auto scan = [&](const type::Value &value) {
+    auto scan_txn = txn_manager.BeginTransaction();
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(scan_txn));
+    auto predicate = expression::ExpressionUtil::ComparisonFactory(
+        ExpressionType::COMPARE_EQUAL,
+        expression::ExpressionUtil::TupleValueFactory(type::Type::VARCHAR, 0,
+                                                      3),
+        expression::ExpressionUtil::ConstantValueFactory(value));
+    planner::SeqScanPlan seq_scan_node(table.get(), predicate, {0, 3});
+    executor::SeqScanExecutor seq_scan_executor(&seq_scan_node, context.get());
+    EXPECT_TRUE(seq_scan_executor.Init());
+
+    size_t result_count = 0;
+    while (seq_scan_executor.Execute() == true) {
+      std::unique_ptr<executor::LogicalTile> result_tile(
+          seq_scan_executor.GetOutput());
+      result_count += result_tile->GetTupleCount();
+    }
+    txn_manager.CommitTransaction(scan_txn);
+    return result_count;
+  };
+
+  EXPECT_EQ(static_cast<size_t>(tuple_count), scan(update_value));
+  EXPECT_EQ(0U, scan(type::ValueFactory::GetVarcharValue("13")));
+
+  gc::GCManagerFactory::Configure(0);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -13,6 +13,7 @@
 #include <limits.h>
 #include <pthread.h>
 
+#include "type/arena_pool.h"
 #include "type/ephemeral_pool.h"
 #include "gtest/gtest.h"
 #include "common/harness.h"
@@ -57,5 +58,151 @@ TEST_F(PoolTests, AllocateOnceTest) {
   delete pool;
 }
 
+// Bump-allocate from the arena
+TEST_F(PoolTests, ArenaAllocateTest) {
+  type::ArenaPool pool(1024);
+
+  // small values share a chunk, each with an 8 byte size prefix
+  std::vector<char *> locations;
+  for (size_t itr = 0; itr < 16; itr++) {
+    auto location = reinterpret_cast<char *>(pool.Allocate(56));
+    EXPECT_TRUE(location != nullptr);
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(location) % 8);
+    memset(location, (int)itr, 56);
+    locations.push_back(location);
+  }
+  EXPECT_EQ(1U, pool.GetChunkCount());
+
+  // a full chunk is replaced
+  pool.Allocate(56);
+  EXPECT_EQ(2U, pool.GetChunkCount());
+
+  // large values are allocated on their own
+  auto large_location = pool.Allocate(str_len);
+  EXPECT_TRUE(large_location != nullptr);
+  EXPECT_EQ(2U, pool.GetChunkCount());
+  pool.Free(large_location);
+
+  // freeing a small value leaves the others intact
+  pool.Free(locations[0]);
+  for (size_t itr = 1; itr < locations.size(); itr++) {
+    EXPECT_EQ((char)itr, locations[itr][55]);
+  }
+}
+
+// Reuse the chunks whose values have all been freed
+TEST_F(PoolTests, ArenaRecycleTest) {
+  type::ArenaPool pool(1024);
+
+  std::vector<char *> locations;
+  for (size_t itr = 0; itr < 16; itr++) {
+    locations.push_back(reinterpret_cast<char *>(pool.Allocate(56)));
+  }
+  auto last_location = reinterpret_cast<char *>(pool.Allocate(56));
+  memset(last_location, 1, 56);
+  EXPECT_EQ(2U, pool.GetChunkCount());
+
+  // the chunk in use is not recycled
+  pool.Free(last_location);
+  EXPECT_EQ(0U, pool.GetFreeChunkCount());
+
+  // the first chunk is recycled once all of its values are freed
+  for (size_t itr = 0; itr < 15; itr++) {
+    pool.Free(locations[itr]);
+  }
+  EXPECT_EQ(0U, pool.GetFreeChunkCount());
+  pool.Free(locations[15]);
+  EXPECT_EQ(1U, pool.GetFreeChunkCount());
+
+  // and reused instead of a new chunk once the second one is full
+  for (size_t itr = 0; itr < 16; itr++) {
+    pool.Allocate(56);
+  }
+  EXPECT_EQ(2U, pool.GetChunkCount());
+  EXPECT_EQ(0U, pool.GetFreeChunkCount());
+  EXPECT_EQ(2U * 1024, pool.GetAllocatedSize());
+}
+
+// Values shared by several owners are kept until each owner frees them
+TEST_F(PoolTests, ArenaSharedValueTest) {
+  type::ArenaPool pool(1024);
+
+  // a large value is not released by the first owner
+  auto large_location = reinterpret_cast<char *>(pool.Allocate(str_len));
+  memset(large_location, 1, str_len);
+  pool.AddReference(large_location);
+  pool.Free(large_location);
+  EXPECT_EQ(1, large_location[str_len - 1]);
+  pool.Free(large_location);
+
+  // nor does a small one count as freed
+  std::vector<char *> locations;
+  for (size_t itr = 0; itr < 17; itr++) {
+    locations.push_back(reinterpret_cast<char *>(pool.Allocate(56)));
+  }
+  pool.AddReference(locations[0]);
+  for (size_t itr = 0; itr < 16; itr++) {
+    pool.Free(locations[itr]);
+  }
+  EXPECT_EQ(0U, pool.GetFreeChunkCount());
+  pool.Free(locations[0]);
+  EXPECT_EQ(1U, pool.GetFreeChunkCount());
+}
+
+// Allocate from the arena concurrently
+TEST_F(PoolTests, ArenaConcurrentAllocateTest) {
+  type::ArenaPool pool;
+  const size_t thread_count = 4;
+  const size_t size = 24;
+  std::vector<std::vector<char *>> locations(thread_count);
+
+  LaunchParallelTest(thread_count, [&](uint64_t thread_itr) {
+    for (size_t itr = 0; itr < M; itr++) {
+      auto location = reinterpret_cast<char *>(pool.Allocate(size));
+      memset(location, (int)thread_itr, size);
+      locations[thread_itr].push_back(location);
+    }
+  });
+
+  // no two values overlap
+  for (size_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    for (auto location : locations[thread_itr]) {
+      for (size_t offset = 0; offset < size; offset++) {
+        EXPECT_EQ((char)thread_itr, location[offset]);
+      }
+    }
+  }
+  EXPECT_EQ(pool.GetChunkCount() * ARENA_CHUNK_SIZE, pool.GetAllocatedSize());
+}
+
+// Free values concurrently with allocations from the same chunks
+TEST_F(PoolTests, ArenaConcurrentFreeTest) {
+  type::ArenaPool pool;
+  const size_t thread_count = 4;
+  const size_t size = 24;
+
+  LaunchParallelTest(thread_count, [&](uint64_t thread_itr) {
+    std::vector<char *> locations;
+    for (size_t itr = 0; itr < M; itr++) {
+      auto location = reinterpret_cast<char *>(pool.Allocate(size));
+      memset(location, (int)thread_itr, size);
+      locations.push_back(location);
+      if (locations.size() == 100) {
+        for (auto location : locations) {
+          EXPECT_EQ((char)thread_itr, location[size - 1]);
+          pool.Free(location);
+        }
+        locations.clear();
+      }
+    }
+    for (auto location : locations) {
+      pool.Free(location);
+    }
+  });
+
+  // every chunk but the current one is recycled
+  EXPECT_EQ(pool.GetChunkCount() - 1, pool.GetFreeChunkCount());
+}
+
 }
 }
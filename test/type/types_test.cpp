@@ -329,7 +329,8 @@ TEST_F(TypesTests, HybridScanTypeTest) {
 TEST_F(TypesTests, JoinTypeTest) {
   std::vector<JoinType> list = {JoinType::INVALID, JoinType::LEFT,
                                 JoinType::RIGHT,   JoinType::INNER,
-                                JoinType::OUTER,   JoinType::SEMI};
+                                JoinType::OUTER,   JoinType::SEMI,
+                                JoinType::ANTI};
 
   // Make sure that ToString and FromString work
   for (auto val : list) {
@@ -512,7 +513,8 @@ TEST_F(TypesTests, CheckpointingTypeTest) {
 
 TEST_F(TypesTests, GarbageCollectionTypeTest) {
   std::vector<GarbageCollectionType> list = {
-      GarbageCollectionType::INVALID, GarbageCollectionType::OFF, GarbageCollectionType::ON
+      GarbageCollectionType::INVALID, GarbageCollectionType::OFF, GarbageCollectionType::ON,
+      GarbageCollectionType::COOPERATIVE
   };
 
   // Make sure that ToString and FromString work
@@ -531,6 +533,27 @@ TEST_F(TypesTests, GarbageCollectionTypeTest) {
                peloton::Exception);
 }
 
+TEST_F(TypesTests, VersionStorageTypeTest) {
+  std::vector<VersionStorageType> list = {
+      VersionStorageType::INVALID, VersionStorageType::TUPLE, VersionStorageType::DELTA
+  };
+
+  // Make sure that ToString and FromString work
+  for (auto val : list) {
+    std::string str = peloton::VersionStorageTypeToString(val);
+    EXPECT_TRUE(str.size() > 0);
+
+    auto newVal = peloton::StringToVersionStorageType(str);
+    EXPECT_EQ(val, newVal);
+  }
+
+  // Then make sure that we can't cast garbage
+  std::string invalid("WU TANG");
+  EXPECT_THROW(peloton::StringToVersionStorageType(invalid), peloton::Exception);
+  EXPECT_THROW(peloton::VersionStorageTypeToString(static_cast<VersionStorageType>(-99999)),
+               peloton::Exception);
+}
+
 TEST_F(TypesTests, ProtocolTypeTest) {
   std::vector<ProtocolType> list = {
       ProtocolType::INVALID, 